@@ -0,0 +1,184 @@
+#include "callback_executor.h"
+#include "log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace mavsdk {
+
+CallbackExecutor::CallbackExecutor(Time& time, unsigned num_shards) : _time(time)
+{
+    num_shards = std::max(num_shards, 1u);
+    _shards.reserve(num_shards);
+    for (unsigned i = 0; i < num_shards; ++i) {
+        _shards.push_back(std::make_unique<Shard>());
+    }
+
+    // Only start the threads once all shards exist.
+    for (auto& shard : _shards) {
+        shard->thread = std::thread(&CallbackExecutor::run, this, std::ref(*shard));
+    }
+}
+
+CallbackExecutor::~CallbackExecutor()
+{
+    stop();
+}
+
+void CallbackExecutor::post(uint64_t shard_key, Callback callback)
+{
+    auto& shard = *_shards[shard_key % _shards.size()];
+
+    const auto queue_depth = shard.queue.size();
+    if (queue_depth == 10) {
+        LogWarn()
+            << "User callback queue too slow.\n"
+               "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+
+    } else if (queue_depth == 99) {
+        LogErr()
+            << "User callback queue overflown\n"
+               "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+
+    } else if (queue_depth == 100) {
+        return;
+    }
+
+    if (queue_depth + 1 > shard.max_queue_depth.load(std::memory_order_relaxed)) {
+        shard.max_queue_depth.store(queue_depth + 1, std::memory_order_relaxed);
+    }
+
+    if (callback.receive_time == SteadyTimePoint{}) {
+        callback.receive_time = _time.steady_time();
+    }
+    shard.queue.enqueue(std::move(callback));
+}
+
+void CallbackExecutor::stop()
+{
+    _should_exit = true;
+
+    for (auto& shard : _shards) {
+        shard->queue.stop();
+    }
+    for (auto& shard : _shards) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+void CallbackExecutor::run(Shard& shard)
+{
+    while (!_should_exit) {
+        auto callback = shard.queue.dequeue();
+        if (!callback) {
+            continue;
+        }
+
+        const auto started_ns = now_ns();
+        const auto latency_ns = std::max<int64_t>(
+            0,
+            started_ns - std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             callback.value().receive_time.time_since_epoch())
+                             .count());
+
+        shard.filename = callback.value().filename;
+        shard.linenumber = callback.value().linenumber;
+        shard.started_ns = std::max<int64_t>(1, started_ns);
+
+        callback.value().func();
+
+        const auto duration_ns = std::max<int64_t>(0, now_ns() - started_ns);
+        shard.started_ns = 0;
+
+        auto& callback_site = site(shard, callback.value());
+        callback_site.queue_delay.record(static_cast<uint64_t>(latency_ns));
+        callback_site.duration.record(static_cast<uint64_t>(duration_ns));
+
+        // Only this thread writes the metrics of its shard.
+        shard.callbacks_run.fetch_add(1, std::memory_order_relaxed);
+        shard.total_latency_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+        if (latency_ns > shard.max_latency_ns.load(std::memory_order_relaxed)) {
+            shard.max_latency_ns.store(latency_ns, std::memory_order_relaxed);
+        }
+    }
+}
+
+CallbackStatsCollector::Site& CallbackExecutor::site(Shard& shard, const Callback& callback)
+{
+    const auto key = std::make_pair(callback.filename, callback.linenumber);
+    auto it = shard.sites.find(key);
+    if (it != shard.sites.end()) {
+        return *it->second;
+    }
+
+    auto& new_site = _stats.site(
+        callback.filename != nullptr ? callback.filename : "unknown", callback.linenumber);
+    shard.sites.emplace(key, &new_site);
+    return new_site;
+}
+
+void CallbackExecutor::check_durations(double timeout_s, bool callback_debugging)
+{
+    for (auto& shard : _shards) {
+        const auto started_ns = shard->started_ns.load();
+        if (started_ns == 0 || started_ns == shard->reported_ns) {
+            continue;
+        }
+
+        if (static_cast<double>(now_ns() - started_ns) * 1e-9 < timeout_s) {
+            continue;
+        }
+
+        // Only report each callback once.
+        shard->reported_ns = started_ns;
+
+        if (callback_debugging) {
+            LogWarn() << "Callback called from " << shard->filename.load() << ":"
+                      << shard->linenumber.load() << " took more than " << timeout_s
+                      << " second to run.";
+            fflush(stdout);
+            fflush(stderr);
+            abort();
+        } else {
+            LogWarn()
+                << "Callback took more than " << timeout_s << " second to run.\n"
+                << "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+        }
+    }
+}
+
+std::vector<CallbackExecutor::ShardMetrics> CallbackExecutor::metrics() const
+{
+    std::vector<ShardMetrics> result;
+    result.reserve(_shards.size());
+
+    for (const auto& shard : _shards) {
+        ShardMetrics metrics{};
+        metrics.queue_depth = shard->queue.size();
+        metrics.max_queue_depth = shard->max_queue_depth.load(std::memory_order_relaxed);
+        metrics.callbacks_run = shard->callbacks_run.load(std::memory_order_relaxed);
+        if (metrics.callbacks_run > 0) {
+            metrics.mean_queue_latency_s =
+                static_cast<double>(shard->total_latency_ns.load(std::memory_order_relaxed)) *
+                1e-9 / static_cast<double>(metrics.callbacks_run);
+        }
+        metrics.max_queue_latency_s =
+            static_cast<double>(shard->max_latency_ns.load(std::memory_order_relaxed)) * 1e-9;
+        result.push_back(metrics);
+    }
+
+    return result;
+}
+
+int64_t CallbackExecutor::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               _time.steady_time().time_since_epoch())
+        .count();
+}
+
+} // namespace mavsdk
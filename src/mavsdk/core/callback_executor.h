@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "callback_list.h"
+#include "callback_stats.h"
+#include "mavsdk_time.h"
+#include "safe_queue.h"
+
+namespace mavsdk {
+
+// Runs user callbacks on a pool of threads.
+//
+// Each callback is posted with a shard key and every shard has its own queue
+// and thread. Callbacks with the same key therefore run in order, while a
+// slow callback only holds up the callbacks of its own shard.
+class CallbackExecutor {
+public:
+    struct Callback {
+        UserCallbackFunction func{};
+        // Points to a string literal, see call_user_callback.
+        const char* filename{nullptr};
+        int linenumber{0};
+        // When the message that led to this callback was received, the
+        // queueing delay is measured from there. Set by post if left empty.
+        SteadyTimePoint receive_time{};
+    };
+
+    struct ShardMetrics {
+        std::size_t queue_depth{0};
+        std::size_t max_queue_depth{0};
+        uint64_t callbacks_run{0};
+        double mean_queue_latency_s{0.0};
+        double max_queue_latency_s{0.0};
+    };
+
+    CallbackExecutor(Time& time, unsigned num_shards);
+    ~CallbackExecutor();
+
+    CallbackExecutor(const CallbackExecutor&) = delete;
+    CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+    void post(uint64_t shard_key, Callback callback);
+
+    // Stops all threads, callbacks still queued are dropped.
+    void stop();
+
+    // Warns about callbacks running for longer than timeout_s, or aborts if
+    // callback debugging is on. Meant to be called periodically.
+    void check_durations(double timeout_s, bool callback_debugging);
+
+    std::vector<ShardMetrics> metrics() const;
+
+    // Queueing delay and duration of callbacks per call site.
+    CallbackStatsCollector& stats() { return _stats; }
+
+    unsigned num_shards() const { return static_cast<unsigned>(_shards.size()); }
+
+private:
+    struct SiteHash {
+        std::size_t operator()(const std::pair<const char*, int>& key) const
+        {
+            return std::hash<const char*>{}(key.first) ^ std::hash<int>{}(key.second);
+        }
+    };
+
+    struct Shard {
+        SafeQueue<Callback> queue{};
+        std::thread thread{};
+
+        // The callback currently running, if started_ns is not 0.
+        std::atomic<int64_t> started_ns{0};
+        std::atomic<const char*> filename{nullptr};
+        std::atomic<int> linenumber{0};
+        // Only used by check_durations.
+        int64_t reported_ns{0};
+
+        std::atomic<std::size_t> max_queue_depth{0};
+        std::atomic<uint64_t> callbacks_run{0};
+        std::atomic<int64_t> total_latency_ns{0};
+        std::atomic<int64_t> max_latency_ns{0};
+
+        // Sites already looked up by this shard's thread, so the shared
+        // collector only needs to be locked for new call sites.
+        std::unordered_map<std::pair<const char*, int>, CallbackStatsCollector::Site*, SiteHash>
+            sites{};
+    };
+
+    void run(Shard& shard);
+    CallbackStatsCollector::Site& site(Shard& shard, const Callback& callback);
+    int64_t now_ns();
+
+    Time& _time;
+    CallbackStatsCollector _stats{};
+    std::vector<std::unique_ptr<Shard>> _shards{};
+    std::atomic<bool> _should_exit{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,174 @@
+#include "callback_executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+CallbackExecutor::Callback make_callback(UserCallbackFunction&& func)
+{
+    return CallbackExecutor::Callback{std::move(func), __FILE__, __LINE__, {}};
+}
+
+template<typename Predicate> bool wait_for(Predicate predicate)
+{
+    for (unsigned i = 0; i < 200; ++i) {
+        if (predicate()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(CallbackExecutor, OrderWithinShard)
+{
+    Time time{};
+    CallbackExecutor executor{time, 4};
+
+    std::mutex mutex;
+    std::vector<std::vector<int>> results(2);
+    std::atomic<unsigned> num_run{0};
+
+    for (int i = 0; i < 50; ++i) {
+        for (uint64_t key = 0; key < 2; ++key) {
+            executor.post(key, make_callback([&, key, i]() {
+                              std::lock_guard<std::mutex> lock(mutex);
+                              results[key].push_back(i);
+                              ++num_run;
+                          }));
+        }
+    }
+
+    ASSERT_TRUE(wait_for([&]() { return num_run == 100; }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& result : results) {
+        ASSERT_EQ(result.size(), 50);
+        for (int i = 0; i < 50; ++i) {
+            EXPECT_EQ(result[i], i);
+        }
+    }
+}
+
+TEST(CallbackExecutor, BlockedShardDoesNotStallOthers)
+{
+    Time time{};
+    CallbackExecutor executor{time, 2};
+
+    std::promise<void> unblock;
+    auto unblocked = unblock.get_future().share();
+    std::atomic<bool> other_run{false};
+
+    executor.post(0, make_callback([unblocked]() { unblocked.wait(); }));
+    executor.post(1, make_callback([&]() { other_run = true; }));
+
+    EXPECT_TRUE(wait_for([&]() { return other_run.load(); }));
+
+    unblock.set_value();
+}
+
+TEST(CallbackExecutor, Metrics)
+{
+    Time time{};
+    CallbackExecutor executor{time, 2};
+    ASSERT_EQ(executor.num_shards(), 2);
+
+    std::promise<void> unblock;
+    auto unblocked = unblock.get_future().share();
+    std::atomic<unsigned> num_run{0};
+
+    executor.post(0, make_callback([unblocked, &num_run]() {
+                      unblocked.wait();
+                      ++num_run;
+                  }));
+    for (unsigned i = 0; i < 3; ++i) {
+        executor.post(0, make_callback([&num_run]() { ++num_run; }));
+    }
+
+    // Give the first callback time to start, the others stay queued.
+    ASSERT_TRUE(wait_for([&]() { return executor.metrics()[0].queue_depth == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    unblock.set_value();
+    ASSERT_TRUE(wait_for([&]() { return num_run == 4; }));
+    ASSERT_TRUE(wait_for([&]() { return executor.metrics()[0].callbacks_run == 4; }));
+
+    const auto metrics = executor.metrics();
+    EXPECT_EQ(metrics[0].queue_depth, 0);
+    EXPECT_GE(metrics[0].max_queue_depth, 3);
+    EXPECT_GE(metrics[0].max_queue_latency_s, 0.02);
+    EXPECT_GT(metrics[0].mean_queue_latency_s, 0.0);
+    EXPECT_EQ(metrics[1].callbacks_run, 0);
+    EXPECT_EQ(metrics[1].max_queue_depth, 0);
+}
+
+TEST(CallbackExecutor, StatsPerCallSite)
+{
+    Time time{};
+    CallbackExecutor executor{time, 2};
+
+    std::atomic<unsigned> num_run{0};
+    for (uint64_t key = 0; key < 4; ++key) {
+        executor.post(key, CallbackExecutor::Callback{[&]() { ++num_run; }, "fast.cpp", 1, {}});
+    }
+    executor.post(
+        0,
+        CallbackExecutor::Callback{
+            [&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++num_run;
+            },
+            "slow.cpp",
+            2,
+            {}});
+
+    ASSERT_TRUE(wait_for([&]() { return num_run == 5; }));
+    ASSERT_TRUE(wait_for([&]() {
+        const auto stats = executor.stats().stats();
+        return stats.size() == 2 && stats[0].duration.count + stats[1].duration.count == 5;
+    }));
+
+    // Sorted by slowest first.
+    const auto stats = executor.stats().stats();
+    EXPECT_EQ(stats[0].location, "slow.cpp:2");
+    EXPECT_EQ(stats[0].duration.count, 1);
+    EXPECT_GE(stats[0].duration.max_s, 0.02);
+    EXPECT_EQ(stats[1].location, "fast.cpp:1");
+    EXPECT_EQ(stats[1].queue_delay.count, 4);
+    EXPECT_LT(stats[1].duration.max_s, stats[0].duration.max_s);
+
+    executor.stats().reset();
+    EXPECT_EQ(executor.stats().stats()[0].duration.count, 0);
+}
+
+TEST(CallbackExecutor, QueueDelayFromReceiveTime)
+{
+    Time time{};
+    CallbackExecutor executor{time, 1};
+
+    // As if the message had been received a while before the callback was posted.
+    std::atomic<bool> run{false};
+    executor.post(
+        0,
+        CallbackExecutor::Callback{
+            [&]() { run = true; },
+            "received.cpp",
+            1,
+            time.steady_time() - std::chrono::milliseconds(50)});
+
+    ASSERT_TRUE(wait_for([&]() { return run.load(); }));
+    ASSERT_TRUE(wait_for([&]() { return executor.metrics()[0].callbacks_run == 1; }));
+
+    EXPECT_GE(executor.metrics()[0].max_queue_latency_s, 0.05);
+    EXPECT_GE(executor.stats().stats()[0].queue_delay.min_s, 0.045);
+}
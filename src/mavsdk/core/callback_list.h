@@ -7,20 +7,28 @@
 #include <utility>
 #include <vector>
 #include "handle.h"
+#include "inline_function.h"
 
 namespace mavsdk {
 
+// Closure queued to call a user callback. It has room for the subscription
+// and a copy of typical arguments, e.g. a telemetry struct, without
+// allocating.
+using UserCallbackFunction = InlineFunction<void(), 128>;
+
 template<typename... Args> class CallbackList {
 public:
     CallbackList();
     ~CallbackList();
 
     Handle<Args...> subscribe(const std::function<void(Args...)>& callback);
+    // Callbacks beyond max_rate_hz are dropped before they get queued.
+    Handle<Args...> subscribe(const std::function<void(Args...)>& callback, double max_rate_hz);
     void unsubscribe(Handle<Args...> handle);
     void operator()(Args... args);
     [[nodiscard]] bool empty();
     void clear();
-    void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func);
+    void queue(Args... args, const std::function<void(UserCallbackFunction&&)>& queue_func);
 
 private:
     std::unique_ptr<CallbackListImpl<Args...>> _impl;
@@ -20,6 +20,13 @@ Handle<Args...> CallbackList<Args...>::subscribe(const std::function<void(Args..
     return _impl->subscribe(callback);
 }
 
+template<typename... Args>
+Handle<Args...>
+CallbackList<Args...>::subscribe(const std::function<void(Args...)>& callback, double max_rate_hz)
+{
+    return _impl->subscribe(callback, max_rate_hz);
+}
+
 template<typename... Args> void CallbackList<Args...>::unsubscribe(Handle<Args...> handle)
 {
     _impl->unsubscribe(handle);
@@ -40,7 +47,9 @@ template<typename... Args> void CallbackList<Args...>::clear()
     _impl->clear();
 }
 
-template<typename... Args> void CallbackList<Args...>::queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
+template<typename... Args>
+void CallbackList<Args...>::queue(
+    Args... args, const std::function<void(UserCallbackFunction&&)>& queue_func)
 {
     _impl->queue(args..., queue_func);
 }
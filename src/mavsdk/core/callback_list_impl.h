@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -11,11 +14,32 @@
 
 namespace mavsdk {
 
+// The list of subscriptions is an immutable snapshot which is replaced as a
+// whole whenever a subscription is added or removed (read-copy-update).
+//
+// Delivering callbacks therefore doesn't need a lock: it registers as reader,
+// iterates over the current snapshot and deregisters again. Replaced
+// snapshots are retired and only deleted once no reader is active, so a
+// snapshot stays valid while it is iterated over, even if a callback
+// unsubscribes itself.
 template<typename... Args> class CallbackListImpl {
 public:
-    Handle<Args...> subscribe(const std::function<void(Args...)>& callback)
+    CallbackListImpl() = default;
+    ~CallbackListImpl()
     {
-        check_removals();
+        delete _list.load();
+        for (auto* list : _retired) {
+            delete list;
+        }
+    }
+
+    CallbackListImpl(const CallbackListImpl&) = delete;
+    CallbackListImpl& operator=(const CallbackListImpl&) = delete;
+
+    Handle<Args...>
+    subscribe(const std::function<void(Args...)>& callback, double max_rate_hz = 0.0)
+    {
+        std::lock_guard<std::mutex> lock(_write_mutex);
 
         // We need to return a handle, even if the callback is nullptr to
         // unsubscribe. That's fine, the handle just won't remove anything
@@ -23,12 +47,14 @@ public:
         auto handle = Handle<Args...>(_last_id++);
 
         if (callback != nullptr) {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _list.emplace_back(handle, callback);
+            auto new_list = std::make_unique<List>(*_list.load());
+            new_list->push_back(
+                std::make_shared<Entry>(handle, callback, interval_from_rate(max_rate_hz)));
+            replace_list(std::move(new_list));
         } else {
             LogErr() << "Use new unsubscribe methods instead of subscribe(nullptr)\n"
                      << "See: https://mavsdk.mavlink.io/main/en/cpp/api_changes.html#unsubscribe";
-            try_clear();
+            replace_list(std::make_unique<List>());
         }
 
         return handle;
@@ -42,103 +68,187 @@ public:
             return;
         }
 
-        // We want to allow unsubscribing while in a callback. This would
-        // normally lead to a deadlock. Therefore, we just try to grab the
-        // lock here, and if it's already taken, we schedule the removal
-        // for later.
-        std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
-        if (lock.owns_lock()) {
-            _list.erase(
-                std::remove_if(
-                    _list.begin(),
-                    _list.end(),
-                    [&](auto& pair) { return pair.first._id == handle._id; }),
-                _list.end());
-        } else {
-            std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-            _remove_later.push_back(handle._id);
-        }
+        // Callbacks are not called with this lock held, so unsubscribing
+        // from within a callback is fine.
+        std::lock_guard<std::mutex> lock(_write_mutex);
+
+        auto new_list = std::make_unique<List>(*_list.load());
+        new_list->erase(
+            std::remove_if(
+                new_list->begin(),
+                new_list->end(),
+                [&](auto& entry) { return entry->handle._id == handle._id; }),
+            new_list->end());
+        replace_list(std::move(new_list));
     }
 
     void exec(Args... args)
     {
-        check_removals();
+        ReadGuard guard(*this);
 
-        std::lock_guard<std::mutex> lock(_mutex);
-        for (const auto& pair : _list) {
-            pair.second(args...);
+        for (auto& entry : *guard.list()) {
+            if (is_due(*entry)) {
+                entry->callback(args...);
+            }
         }
     }
 
-    void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
+    void queue(Args... args, const std::function<void(UserCallbackFunction&&)>& queue_func)
     {
-        check_removals();
-
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        for (const auto& pair : _list) {
-            queue_func([callback = pair.second, args...]() { callback(args...); });
+        ReadGuard guard(*this);
+
+        for (auto& entry : *guard.list()) {
+            // Rate limited subscriptions skip the sample before the closure
+            // is built and queued, so dropped samples cost nothing more.
+            if (is_due(*entry)) {
+                // Holding on to the entry rather than copying the callback
+                // keeps the closure small enough to be stored inline.
+                queue_func(UserCallbackFunction{[entry, args...]() { entry->callback(args...); }});
+            }
         }
     }
 
     bool empty()
     {
-        // check_removals();
-
-        // std::lock_guard<std::mutex> lock(_mutex);
-        return _list.empty();
+        ReadGuard guard(*this);
+        return guard.list()->empty();
     }
 
     void clear()
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _list.clear();
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        replace_list(std::make_unique<List>());
     }
 
 private:
-    void check_removals()
+    struct Entry {
+        Entry(
+            Handle<Args...> new_handle,
+            std::function<void(Args...)> new_callback,
+            std::chrono::steady_clock::duration new_min_interval) :
+            handle(new_handle),
+            callback(std::move(new_callback)),
+            min_interval(new_min_interval)
+        {}
+
+        const Handle<Args...> handle;
+        const std::function<void(Args...)> callback;
+        // A zero interval means every sample is delivered.
+        const std::chrono::steady_clock::duration min_interval;
+        // Time since epoch of the steady clock, shared by concurrent deliveries.
+        std::atomic<std::chrono::steady_clock::rep> next_due{0};
+    };
+
+    // Entries are shared between snapshots, they only get copied when the
+    // list is replaced.
+    using List = std::vector<std::shared_ptr<Entry>>;
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(CallbackListImpl& parent) : _parent(parent)
+        {
+            // Register before loading the list, see replace_list.
+            _parent._active_readers.fetch_add(1);
+            _list = _parent._list.load();
+        }
+        ~ReadGuard()
+        {
+            if (_parent._active_readers.fetch_sub(1) == 1 && _parent._has_retired.load()) {
+                _parent.try_reclaim();
+            }
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const List* list() const { return _list; }
+
+    private:
+        CallbackListImpl& _parent;
+        const List* _list{nullptr};
+    };
+
+    static std::chrono::steady_clock::duration interval_from_rate(double max_rate_hz)
     {
-        std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-
-        // We could probably just grab the lock here but it's safer not to
-        // acquire both locks to avoid deadlocks.
-        if (_mutex.try_lock()) {
-            if (_remove_all_later) {
-                _remove_all_later = false;
-                _list.clear();
-                _remove_later.clear();
+        if (!(max_rate_hz > 0.0)) {
+            return {};
+        }
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / max_rate_hz));
+    }
+
+    static bool is_due(Entry& entry)
+    {
+        if (entry.min_interval == std::chrono::steady_clock::duration::zero()) {
+            return true;
+        }
+
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        const auto interval = entry.min_interval.count();
+
+        auto next_due = entry.next_due.load(std::memory_order_relaxed);
+        std::chrono::steady_clock::rep new_next_due;
+        do {
+            if (now < next_due) {
+                return false;
             }
 
-            for (auto& id : _remove_later) {
-                _list.erase(
-                    std::remove_if(
-                        _list.begin(),
-                        _list.end(),
-                        [&](auto& pair) { return pair.first._id == id; }),
-                    _list.end());
+            // Advance by the interval rather than from now to keep the average
+            // rate despite jitter, but don't burst to catch up after a gap.
+            new_next_due = next_due + interval;
+            if (new_next_due <= now) {
+                new_next_due = now + interval;
             }
-            _mutex.unlock();
+        } while (!entry.next_due.compare_exchange_weak(
+            next_due, new_next_due, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    // Needs to be called with _write_mutex held.
+    void replace_list(std::unique_ptr<List> new_list)
+    {
+        _retired.push_back(_list.exchange(new_list.release()));
+        _has_retired = true;
+        reclaim();
+    }
+
+    // Needs to be called with _write_mutex held.
+    void reclaim()
+    {
+        // A reader registers before it loads the list. So if there is no
+        // reader now, any reader coming later is going to see the new list and
+        // none of the retired ones can still be in use.
+        if (_active_readers.load() != 0) {
+            return;
         }
+
+        for (auto* list : _retired) {
+            delete list;
+        }
+        _retired.clear();
+        _has_retired = false;
     }
 
-    void try_clear()
+    // Called by the last reader leaving, e.g. after a callback unsubscribed
+    // itself. If a writer is busy, the next writer or reader cleans up.
+    void try_reclaim()
     {
-        std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+        std::unique_lock<std::mutex> lock(_write_mutex, std::try_to_lock);
         if (lock.owns_lock()) {
-            _list.clear();
-        } else {
-            std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-            _remove_all_later = true;
+            reclaim();
         }
     }
 
-    mutable std::mutex _mutex{};
+    std::mutex _write_mutex{};
     uint64_t _last_id{1}; // Start at 1 because 0 is the "null handle"
-    std::vector<std::pair<Handle<Args...>, std::function<void(Args...)>>> _list{};
 
-    mutable std::mutex _remove_later_mutex{};
-    std::vector<uint64_t> _remove_later{};
-    bool _remove_all_later{false};
+    std::atomic<const List*> _list{new List()};
+    std::atomic<unsigned> _active_readers{0};
+
+    // Replaced lists which might still be used by readers.
+    std::vector<const List*> _retired{};
+    std::atomic<bool> _has_retired{false};
 };
 
 } // namespace mavsdk
@@ -1,11 +1,15 @@
 #include "callback_list.h"
 #include "callback_list.tpp"
 #include "log.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 namespace mavsdk {
 
 template class CallbackList<int, double>;
+template class CallbackList<int>;
 template class CallbackList<>;
 
 } // namespace mavsdk
@@ -98,3 +102,66 @@ TEST(CallbackList, UnsubscribeAllWithNullptr)
     // It should only be called once.
     EXPECT_EQ(num_called, 1);
 }
+
+TEST(CallbackList, RateLimitedSubscription)
+{
+    unsigned limited_called = 0;
+    unsigned unlimited_called = 0;
+
+    CallbackList<> cl;
+    cl.subscribe([&]() { ++limited_called; }, 1.0);
+    cl.subscribe([&]() { ++unlimited_called; });
+
+    // A burst well within one second only gets through once.
+    for (unsigned i = 0; i < 100; ++i) {
+        cl();
+    }
+
+    EXPECT_EQ(limited_called, 1);
+    EXPECT_EQ(unlimited_called, 100);
+
+    // Queueing is throttled the same way.
+    unsigned queued = 0;
+    cl.queue([&](UserCallbackFunction&& func) {
+        ++queued;
+        func();
+    });
+    EXPECT_EQ(queued, 1);
+    EXPECT_EQ(limited_called, 1);
+    EXPECT_EQ(unlimited_called, 101);
+}
+
+TEST(CallbackList, SubscribeWhileDelivering)
+{
+    CallbackList<int> cl;
+    std::atomic<unsigned> called{0};
+    std::atomic<bool> done{false};
+
+    cl.subscribe([&](int) { ++called; });
+
+    std::vector<std::thread> deliverers;
+    for (unsigned i = 0; i < 3; ++i) {
+        deliverers.emplace_back([&]() {
+            while (!done) {
+                cl(42);
+            }
+        });
+    }
+
+    while (called == 0) {
+        std::this_thread::yield();
+    }
+
+    // Adding and removing subscriptions must not disturb concurrent deliveries.
+    for (unsigned i = 0; i < 1000; ++i) {
+        auto handle = cl.subscribe([](int) {});
+        cl.unsubscribe(handle);
+    }
+
+    done = true;
+    for (auto& deliverer : deliverers) {
+        deliverer.join();
+    }
+
+    EXPECT_FALSE(cl.empty());
+}
@@ -0,0 +1,77 @@
+#include "callback_stats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace mavsdk {
+
+namespace {
+
+Mavsdk::CallbackLatency summarize(const LatencyHistogram& histogram)
+{
+    Mavsdk::CallbackLatency latency{};
+    latency.count = histogram.count();
+    latency.min_s = static_cast<double>(histogram.min_ns()) * 1e-9;
+    latency.mean_s = histogram.mean_ns() * 1e-9;
+    latency.p50_s = static_cast<double>(histogram.percentile_ns(50.0)) * 1e-9;
+    latency.p90_s = static_cast<double>(histogram.percentile_ns(90.0)) * 1e-9;
+    latency.p99_s = static_cast<double>(histogram.percentile_ns(99.0)) * 1e-9;
+    latency.p999_s = static_cast<double>(histogram.percentile_ns(99.9)) * 1e-9;
+    latency.max_s = static_cast<double>(histogram.max_ns()) * 1e-9;
+    return latency;
+}
+
+} // namespace
+
+CallbackStatsCollector::Site& CallbackStatsCollector::site(const char* filename, int linenumber)
+{
+    std::lock_guard<std::mutex> lock(_sites_mutex);
+
+    // The same file name can be a different pointer in different translation
+    // units, so compare the string.
+    auto it = std::find_if(_sites.begin(), _sites.end(), [&](const auto& site) {
+        return site->linenumber == linenumber &&
+               (site->filename == filename || std::strcmp(site->filename, filename) == 0);
+    });
+    if (it != _sites.end()) {
+        return **it;
+    }
+
+    _sites.push_back(std::make_unique<Site>(filename, linenumber));
+    return *_sites.back();
+}
+
+std::vector<Mavsdk::CallbackStats> CallbackStatsCollector::stats() const
+{
+    std::lock_guard<std::mutex> lock(_sites_mutex);
+
+    std::vector<Mavsdk::CallbackStats> result;
+    result.reserve(_sites.size());
+    for (const auto& site : _sites) {
+        Mavsdk::CallbackStats stats{};
+        stats.location = std::string(site->filename) + ":" + std::to_string(site->linenumber);
+        stats.queue_delay = summarize(site->queue_delay);
+        stats.duration = summarize(site->duration);
+        result.push_back(stats);
+    }
+
+    // Slowest first, that's usually what we are looking for.
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.duration.max_s > rhs.duration.max_s;
+    });
+
+    return result;
+}
+
+void CallbackStatsCollector::reset()
+{
+    std::lock_guard<std::mutex> lock(_sites_mutex);
+
+    for (auto& site : _sites) {
+        site->queue_delay.reset();
+        site->duration.reset();
+    }
+}
+
+} // namespace mavsdk
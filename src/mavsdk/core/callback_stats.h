@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "latency_histogram.h"
+#include "mavsdk.h"
+
+namespace mavsdk {
+
+// Collects queueing delay and duration of user callbacks per call site, i.e.
+// per filename:linenumber where the callback was queued.
+class CallbackStatsCollector {
+public:
+    struct Site {
+        Site(const char* new_filename, int new_linenumber) :
+            filename(new_filename),
+            linenumber(new_linenumber)
+        {}
+
+        const char* const filename;
+        const int linenumber;
+        LatencyHistogram queue_delay{};
+        LatencyHistogram duration{};
+    };
+
+    // Returns the site for a call site, creating it if needed. Sites are
+    // never removed, so the reference can be cached.
+    Site& site(const char* filename, int linenumber);
+
+    std::vector<Mavsdk::CallbackStats> stats() const;
+    void reset();
+
+private:
+    mutable std::mutex _sites_mutex{};
+    std::vector<std::unique_ptr<Site>> _sites{};
+};
+
+} // namespace mavsdk
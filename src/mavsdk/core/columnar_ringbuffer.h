@@ -0,0 +1,138 @@
+#pragma once
+
+#include "history_column.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Ring buffer storing each member of a sample in its own column, so that
+// reading one value over time touches contiguous memory.
+//
+// Unlike Ringbuffer<T, N> the capacity is given at construction, but it is
+// allocated once and then never changes, so pushing never allocates.
+template<typename... Columns> class ColumnarRingbuffer {
+public:
+    // std::vector<bool> can't provide contiguous views.
+    static_assert((!std::is_same_v<Columns, bool> && ...), "Use uint8_t instead of bool");
+
+    explicit ColumnarRingbuffer(std::size_t capacity) : _capacity(capacity)
+    {
+        std::apply([&](auto&... columns) { (columns.resize(_capacity), ...); }, _columns);
+    }
+    ~ColumnarRingbuffer() = default;
+
+    ColumnarRingbuffer(const ColumnarRingbuffer&) = delete;
+    ColumnarRingbuffer& operator=(const ColumnarRingbuffer&) = delete;
+    ColumnarRingbuffer(ColumnarRingbuffer&&) = default;
+    ColumnarRingbuffer& operator=(ColumnarRingbuffer&&) = default;
+
+    void push(const Columns&... values)
+    {
+        if (_capacity == 0) {
+            return;
+        }
+
+        push_columns(std::index_sequence_for<Columns...>{}, values...);
+
+        _next = (_next + 1) % _capacity;
+        if (_size < _capacity) {
+            ++_size;
+        }
+    }
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _capacity; }
+
+    void clear()
+    {
+        _next = 0;
+        _size = 0;
+    }
+
+    // Sample at index, 0 being the oldest.
+    template<std::size_t I> const auto& at(std::size_t index) const
+    {
+        return std::get<I>(_columns)[physical(index)];
+    }
+
+    // View of column I over the samples [begin, end), 0 being the oldest.
+    template<std::size_t I> auto column(std::size_t begin, std::size_t end) const
+    {
+        using T = std::tuple_element_t<I, std::tuple<Columns...>>;
+
+        end = std::min(end, _size);
+        if (begin >= end) {
+            return HistoryColumn<T>{};
+        }
+
+        const auto& storage = std::get<I>(_columns);
+        const std::size_t start = physical(begin);
+        const std::size_t count = end - begin;
+        const std::size_t first_size = std::min(count, _capacity - start);
+
+        return HistoryColumn<T>{
+            storage.data() + start, first_size, storage.data(), count - first_size};
+    }
+
+    // Copy of the samples [begin, end), e.g. to read them without holding a lock.
+    ColumnarRingbuffer copy(std::size_t begin, std::size_t end) const
+    {
+        end = std::min(end, _size);
+        ColumnarRingbuffer result{begin < end ? end - begin : 0};
+        for (std::size_t index = begin; index < end; ++index) {
+            copy_sample(std::index_sequence_for<Columns...>{}, index, result);
+        }
+        return result;
+    }
+
+    // Index of the first sample for which column I is not less than value.
+    // Column I needs to be sorted, e.g. a monotonic timestamp.
+    template<std::size_t I, typename T> std::size_t lower_bound(const T& value) const
+    {
+        std::size_t low = 0;
+        std::size_t high = _size;
+        while (low < high) {
+            const std::size_t mid = low + (high - low) / 2;
+            if (at<I>(mid) < value) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+private:
+    std::size_t physical(std::size_t index) const
+    {
+        // The oldest sample is the one that gets overwritten next.
+        const std::size_t oldest = (_size < _capacity) ? 0 : _next;
+        return (oldest + index) % _capacity;
+    }
+
+    template<std::size_t... Is>
+    void push_columns(std::index_sequence<Is...>, const Columns&... values)
+    {
+        ((std::get<Is>(_columns)[_next] = values), ...);
+    }
+
+    template<std::size_t... Is>
+    void copy_sample(
+        std::index_sequence<Is...>, std::size_t index, ColumnarRingbuffer& result) const
+    {
+        result.push(at<Is>(index)...);
+    }
+
+    std::tuple<std::vector<Columns>...> _columns{};
+    std::size_t _capacity;
+    std::size_t _next{0};
+    std::size_t _size{0};
+};
+
+} // namespace mavsdk
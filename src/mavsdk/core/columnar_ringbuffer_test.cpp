@@ -0,0 +1,109 @@
+#include "columnar_ringbuffer.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(ColumnarRingbuffer, PushAndRead)
+{
+    ColumnarRingbuffer<uint64_t, double> buffer{3};
+    EXPECT_EQ(buffer.size(), 0);
+    EXPECT_EQ(buffer.capacity(), 3);
+
+    buffer.push(1, 1.5);
+    buffer.push(2, 2.5);
+    EXPECT_EQ(buffer.size(), 2);
+
+    EXPECT_EQ(buffer.at<0>(0), 1);
+    EXPECT_EQ(buffer.at<0>(1), 2);
+    EXPECT_DOUBLE_EQ(buffer.at<1>(1), 2.5);
+
+    auto column = buffer.column<1>(0, buffer.size());
+    ASSERT_EQ(column.size(), 2);
+    EXPECT_EQ(column.second_size(), 0);
+    EXPECT_DOUBLE_EQ(column[0], 1.5);
+    EXPECT_DOUBLE_EQ(column[1], 2.5);
+}
+
+TEST(ColumnarRingbuffer, OverwriteOldest)
+{
+    ColumnarRingbuffer<uint64_t, float> buffer{3};
+
+    for (uint64_t i = 1; i <= 5; ++i) {
+        buffer.push(i, static_cast<float>(i) * 10.0f);
+    }
+    EXPECT_EQ(buffer.size(), 3);
+
+    // Storage has wrapped, so the view is split in two parts.
+    auto times = buffer.column<0>(0, buffer.size());
+    ASSERT_EQ(times.size(), 3);
+    EXPECT_EQ(times.first_size(), 1);
+    EXPECT_EQ(times.second_size(), 2);
+    EXPECT_EQ(times[0], 3);
+    EXPECT_EQ(times[1], 4);
+    EXPECT_EQ(times[2], 5);
+
+    auto values = buffer.column<1>(1, 3);
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_FLOAT_EQ(values[0], 40.0f);
+    EXPECT_FLOAT_EQ(values[1], 50.0f);
+}
+
+TEST(ColumnarRingbuffer, RangeQuery)
+{
+    ColumnarRingbuffer<uint64_t, int> buffer{4};
+
+    for (int i = 0; i < 6; ++i) {
+        buffer.push(static_cast<uint64_t>(i) * 100, i);
+    }
+
+    // Contains times 200, 300, 400, 500.
+    EXPECT_EQ(buffer.lower_bound<0>(uint64_t{0}), 0);
+    EXPECT_EQ(buffer.lower_bound<0>(uint64_t{250}), 1);
+    EXPECT_EQ(buffer.lower_bound<0>(uint64_t{500}), 3);
+    EXPECT_EQ(buffer.lower_bound<0>(uint64_t{501}), 4);
+
+    const auto begin = buffer.lower_bound<0>(uint64_t{300});
+    const auto end = buffer.lower_bound<0>(uint64_t{450});
+    auto values = buffer.column<1>(begin, end);
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_EQ(values[0], 3);
+    EXPECT_EQ(values[1], 4);
+
+    EXPECT_TRUE(buffer.column<1>(end, begin).empty());
+}
+
+TEST(ColumnarRingbuffer, Copy)
+{
+    ColumnarRingbuffer<uint64_t, int> buffer{4};
+
+    for (int i = 0; i < 6; ++i) {
+        buffer.push(static_cast<uint64_t>(i) * 100, i);
+    }
+
+    // The range wraps around the end of the storage, the copy doesn't.
+    auto copy = buffer.copy(1, 4);
+    ASSERT_EQ(copy.size(), 3);
+    auto values = copy.column<1>(0, copy.size());
+    EXPECT_EQ(values.second_size(), 0);
+    EXPECT_EQ(values[0], 3);
+    EXPECT_EQ(values[2], 5);
+
+    // Later pushes don't change the copy.
+    buffer.push(600, 6);
+    EXPECT_EQ(copy.at<0>(0), 300);
+
+    EXPECT_EQ(buffer.copy(3, 1).size(), 0);
+}
+
+TEST(ColumnarRingbuffer, Clear)
+{
+    ColumnarRingbuffer<int> buffer{2};
+    buffer.push(1);
+    buffer.push(2);
+    buffer.clear();
+    EXPECT_EQ(buffer.size(), 0);
+
+    buffer.push(3);
+    EXPECT_EQ(buffer.at<0>(0), 3);
+}
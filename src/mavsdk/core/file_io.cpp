@@ -0,0 +1,139 @@
+#include "file_io.h"
+
+#include <cstdio>
+#include <filesystem>
+
+#ifdef WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mavsdk {
+
+bool write_file_atomically(
+    const std::string& path, const std::function<bool(std::ofstream& file)>& write)
+{
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        if (!write(file) || !file) {
+            file.close();
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+
+    // Unlike std::rename, this also replaces an existing file on Windows.
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+#ifdef WINDOWS
+
+int open_raw_file(const std::string& path, RawFileMode mode)
+{
+    int flags = _O_BINARY;
+    switch (mode) {
+        case RawFileMode::Read:
+            flags |= _O_RDONLY;
+            break;
+        case RawFileMode::Write:
+            flags |= _O_WRONLY;
+            break;
+        case RawFileMode::Create:
+            flags |= _O_WRONLY | _O_CREAT;
+            break;
+        case RawFileMode::Truncate:
+            flags |= _O_WRONLY | _O_CREAT | _O_TRUNC;
+            break;
+    }
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+
+int64_t raw_file_size(int fd)
+{
+    struct _stat64 st;
+    return _fstat64(fd, &st) == 0 ? st.st_size : -1;
+}
+
+int read_at(int fd, uint8_t* data, uint32_t size, uint32_t offset)
+{
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+        return -1;
+    }
+    return _read(fd, data, size);
+}
+
+int write_at(int fd, const uint8_t* data, uint32_t size, uint32_t offset)
+{
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+        return -1;
+    }
+    return _write(fd, data, size);
+}
+
+void close_raw_file(int fd)
+{
+    _close(fd);
+}
+
+#else
+
+int open_raw_file(const std::string& path, RawFileMode mode)
+{
+    int flags = O_CLOEXEC;
+    switch (mode) {
+        case RawFileMode::Read:
+            flags |= O_RDONLY;
+            break;
+        case RawFileMode::Write:
+            flags |= O_WRONLY;
+            break;
+        case RawFileMode::Create:
+            flags |= O_WRONLY | O_CREAT;
+            break;
+        case RawFileMode::Truncate:
+            flags |= O_WRONLY | O_CREAT | O_TRUNC;
+            break;
+    }
+    return ::open(path.c_str(), flags, 0666);
+}
+
+int64_t raw_file_size(int fd)
+{
+    struct stat st;
+    return ::fstat(fd, &st) == 0 ? st.st_size : -1;
+}
+
+int read_at(int fd, uint8_t* data, uint32_t size, uint32_t offset)
+{
+    return static_cast<int>(::pread(fd, data, size, offset));
+}
+
+int write_at(int fd, const uint8_t* data, uint32_t size, uint32_t offset)
+{
+    return static_cast<int>(::pwrite(fd, data, size, offset));
+}
+
+void close_raw_file(int fd)
+{
+    ::close(fd);
+}
+
+#endif
+
+} // namespace mavsdk
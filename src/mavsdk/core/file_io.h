@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+
+namespace mavsdk {
+
+// Small binary files such as caches and indices.
+
+template<typename T> void write_raw(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T> bool read_raw(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+// Writes to a temporary file next to path first and then renames it, so a
+// crash never leaves a truncated file behind. Returns false if the file
+// could not be written or write returned false.
+bool write_file_atomically(
+    const std::string& path, const std::function<bool(std::ofstream& file)>& write);
+
+// Files that are read and written at the offset given instead of seeking an
+// iostream back and forth, e.g. chunks arriving out of order. The functions
+// return -1 on error, like the POSIX calls they wrap.
+
+enum class RawFileMode {
+    Read, // Existing file, read only.
+    Write, // Existing file, write only.
+    Create, // Write only, created if missing, keeps the content.
+    Truncate, // Write only, created if missing, emptied otherwise.
+};
+
+int open_raw_file(const std::string& path, RawFileMode mode);
+int64_t raw_file_size(int fd);
+// On Windows these seek first, so calls on the same file must not overlap.
+int read_at(int fd, uint8_t* data, uint32_t size, uint32_t offset);
+int write_at(int fd, const uint8_t* data, uint32_t size, uint32_t offset);
+void close_raw_file(int fd);
+
+} // namespace mavsdk
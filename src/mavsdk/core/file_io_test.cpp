@@ -0,0 +1,96 @@
+#include "file_io.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+using namespace mavsdk;
+
+static std::string temp_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::string read_content(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string content;
+    std::getline(file, content, '\0');
+    return content;
+}
+
+TEST(FileIo, WriteFileAtomically)
+{
+    const auto path = temp_path("mavsdk_file_io_test.bin");
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(write_file_atomically(path, [](std::ofstream& file) {
+        write_raw(file, uint32_t{42});
+        return true;
+    }));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    std::ifstream file(path, std::ios::binary);
+    uint32_t value = 0;
+    EXPECT_TRUE(read_raw(file, value));
+    EXPECT_EQ(value, 42u);
+    EXPECT_FALSE(read_raw(file, value));
+    file.close();
+
+    // An existing file is replaced.
+    EXPECT_TRUE(write_file_atomically(path, [](std::ofstream& file) {
+        file << "new";
+        return true;
+    }));
+    EXPECT_EQ(read_content(path), "new");
+
+    // A failed write leaves the existing file alone.
+    EXPECT_FALSE(write_file_atomically(path, [](std::ofstream& file) {
+        file << "partial";
+        return false;
+    }));
+    EXPECT_EQ(read_content(path), "new");
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    std::filesystem::remove(path);
+}
+
+TEST(FileIo, WriteAndReadAtOffsets)
+{
+    const auto path = temp_path("mavsdk_file_io_test_raw.bin");
+    std::filesystem::remove(path);
+
+    EXPECT_LT(open_raw_file(path, RawFileMode::Write), 0);
+
+    const uint8_t first[] = {1, 2, 3};
+    const uint8_t second[] = {4, 5};
+
+    int fd = open_raw_file(path, RawFileMode::Truncate);
+    ASSERT_GE(fd, 0);
+    // Out of order, as chunks of a download might arrive.
+    EXPECT_EQ(write_at(fd, second, sizeof(second), 3), 2);
+    EXPECT_EQ(write_at(fd, first, sizeof(first), 0), 3);
+    EXPECT_EQ(raw_file_size(fd), 5);
+    close_raw_file(fd);
+
+    // Create keeps what is there.
+    fd = open_raw_file(path, RawFileMode::Create);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(raw_file_size(fd), 5);
+    close_raw_file(fd);
+
+    fd = open_raw_file(path, RawFileMode::Read);
+    ASSERT_GE(fd, 0);
+    uint8_t data[5]{};
+    EXPECT_EQ(read_at(fd, data, 2, 2), 2);
+    EXPECT_EQ(data[0], 3);
+    EXPECT_EQ(data[1], 4);
+    EXPECT_EQ(read_at(fd, data, sizeof(data), 5), 0);
+    close_raw_file(fd);
+
+    fd = open_raw_file(path, RawFileMode::Truncate);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(raw_file_size(fd), 0);
+    close_raw_file(fd);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,184 @@
+#include "fleet_table.h"
+#include "mavsdk_math.h"
+
+#include <cmath>
+#include <limits>
+
+namespace mavsdk {
+
+void FleetTable::process_message(const mavlink_message_t& message, uint64_t receive_time_us)
+{
+    update_last_seen(message.sysid, receive_time_us);
+
+    switch (message.msgid) {
+        case MAVLINK_MSG_ID_HEARTBEAT: {
+            mavlink_heartbeat_t heartbeat;
+            mavlink_msg_heartbeat_decode(&message, &heartbeat);
+            // Only the autopilot's mode is of interest, not the one of e.g. a
+            // camera or gimbal of the same system.
+            if (heartbeat.autopilot != MAV_AUTOPILOT_INVALID) {
+                update_heartbeat(message.sysid, heartbeat.base_mode, heartbeat.custom_mode);
+            }
+            break;
+        }
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT: {
+            mavlink_global_position_int_t global_position_int;
+            mavlink_msg_global_position_int_decode(&message, &global_position_int);
+            update_position(
+                message.sysid,
+                global_position_int.lat * 1e-7,
+                global_position_int.lon * 1e-7,
+                global_position_int.alt * 1e-3f,
+                global_position_int.relative_alt * 1e-3f);
+            break;
+        }
+        case MAVLINK_MSG_ID_ATTITUDE: {
+            mavlink_attitude_t attitude;
+            mavlink_msg_attitude_decode(&message, &attitude);
+            update_attitude(
+                message.sysid,
+                to_deg_from_rad(attitude.roll),
+                to_deg_from_rad(attitude.pitch),
+                to_deg_from_rad(attitude.yaw));
+            break;
+        }
+        case MAVLINK_MSG_ID_SYS_STATUS: {
+            mavlink_sys_status_t sys_status;
+            mavlink_msg_sys_status_decode(&message, &sys_status);
+            update_battery(
+                message.sysid,
+                (sys_status.battery_remaining != -1) ?
+                    static_cast<float>(sys_status.battery_remaining) :
+                    NAN,
+                (sys_status.voltage_battery != std::numeric_limits<uint16_t>::max()) ?
+                    sys_status.voltage_battery * 1e-3f :
+                    NAN);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+template<typename F> void FleetTable::update_row(uint8_t system_id, F&& func)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_present[system_id]) {
+        _present[system_id] = true;
+        _latitude_deg[system_id] = double(NAN);
+        _longitude_deg[system_id] = double(NAN);
+        _absolute_altitude_m[system_id] = NAN;
+        _relative_altitude_m[system_id] = NAN;
+        _roll_deg[system_id] = NAN;
+        _pitch_deg[system_id] = NAN;
+        _yaw_deg[system_id] = NAN;
+        _battery_remaining_percent[system_id] = NAN;
+        _battery_voltage_v[system_id] = NAN;
+    }
+
+    func();
+    ++_versions[system_id];
+}
+
+void FleetTable::update_heartbeat(uint8_t system_id, uint8_t base_mode, uint32_t custom_mode)
+{
+    update_row(system_id, [&]() {
+        _base_mode[system_id] = base_mode;
+        _custom_mode[system_id] = custom_mode;
+    });
+}
+
+void FleetTable::update_position(
+    uint8_t system_id,
+    double latitude_deg,
+    double longitude_deg,
+    float absolute_altitude_m,
+    float relative_altitude_m)
+{
+    update_row(system_id, [&]() {
+        _latitude_deg[system_id] = latitude_deg;
+        _longitude_deg[system_id] = longitude_deg;
+        _absolute_altitude_m[system_id] = absolute_altitude_m;
+        _relative_altitude_m[system_id] = relative_altitude_m;
+    });
+}
+
+void FleetTable::update_attitude(uint8_t system_id, float roll_deg, float pitch_deg, float yaw_deg)
+{
+    update_row(system_id, [&]() {
+        _roll_deg[system_id] = roll_deg;
+        _pitch_deg[system_id] = pitch_deg;
+        _yaw_deg[system_id] = yaw_deg;
+    });
+}
+
+void FleetTable::update_battery(uint8_t system_id, float remaining_percent, float voltage_v)
+{
+    update_row(system_id, [&]() {
+        _battery_remaining_percent[system_id] = remaining_percent;
+        _battery_voltage_v[system_id] = voltage_v;
+    });
+}
+
+void FleetTable::update_last_seen(uint8_t system_id, uint64_t receive_time_us)
+{
+    _last_seen_us[system_id].store(receive_time_us, std::memory_order_relaxed);
+}
+
+void FleetTable::snapshot(Mavsdk::FleetSnapshot& snapshot, uint64_t now_us) const
+{
+    // Remember what the caller has seen so far to find the changed rows.
+    std::array<uint32_t, MAX_ROWS> previous_versions{};
+    for (std::size_t i = 0; i < snapshot.system_ids.size() && i < snapshot.versions.size(); ++i) {
+        previous_versions[snapshot.system_ids[i]] = snapshot.versions[i];
+    }
+
+    snapshot.system_ids.clear();
+    snapshot.latitude_deg.clear();
+    snapshot.longitude_deg.clear();
+    snapshot.absolute_altitude_m.clear();
+    snapshot.relative_altitude_m.clear();
+    snapshot.roll_deg.clear();
+    snapshot.pitch_deg.clear();
+    snapshot.yaw_deg.clear();
+    snapshot.battery_remaining_percent.clear();
+    snapshot.battery_voltage_v.clear();
+    snapshot.base_mode.clear();
+    snapshot.custom_mode.clear();
+    snapshot.seconds_since_last_seen.clear();
+    snapshot.versions.clear();
+    snapshot.changed_rows.clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (std::size_t system_id = 0; system_id < MAX_ROWS; ++system_id) {
+        if (!_present[system_id]) {
+            continue;
+        }
+
+        if (_versions[system_id] != previous_versions[system_id]) {
+            snapshot.changed_rows.push_back(snapshot.system_ids.size());
+        }
+
+        const uint64_t last_seen_us = _last_seen_us[system_id].load(std::memory_order_relaxed);
+
+        snapshot.system_ids.push_back(static_cast<uint8_t>(system_id));
+        snapshot.latitude_deg.push_back(_latitude_deg[system_id]);
+        snapshot.longitude_deg.push_back(_longitude_deg[system_id]);
+        snapshot.absolute_altitude_m.push_back(_absolute_altitude_m[system_id]);
+        snapshot.relative_altitude_m.push_back(_relative_altitude_m[system_id]);
+        snapshot.roll_deg.push_back(_roll_deg[system_id]);
+        snapshot.pitch_deg.push_back(_pitch_deg[system_id]);
+        snapshot.yaw_deg.push_back(_yaw_deg[system_id]);
+        snapshot.battery_remaining_percent.push_back(_battery_remaining_percent[system_id]);
+        snapshot.battery_voltage_v.push_back(_battery_voltage_v[system_id]);
+        snapshot.base_mode.push_back(_base_mode[system_id]);
+        snapshot.custom_mode.push_back(_custom_mode[system_id]);
+        snapshot.seconds_since_last_seen.push_back(
+            (now_us > last_seen_us) ? static_cast<double>(now_us - last_seen_us) * 1e-6 : 0.0);
+        snapshot.versions.push_back(_versions[system_id]);
+    }
+}
+
+} // namespace mavsdk
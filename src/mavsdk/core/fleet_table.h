@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "mavlink_include.h"
+#include "mavsdk.h"
+
+namespace mavsdk {
+
+// Latest state of every system, kept on the receive path.
+//
+// Rather than having a Telemetry plugin and several subscriptions per
+// system, a ground station showing many vehicles can take one snapshot of
+// this table per frame.
+//
+// The data is stored column by column and indexed by system ID, so copying
+// one column for all systems touches contiguous memory. Every row has a
+// version which is incremented whenever its data changes, so a reader can
+// tell which rows changed since its last snapshot.
+class FleetTable {
+public:
+    static constexpr std::size_t MAX_ROWS = 256;
+
+    void process_message(const mavlink_message_t& message, uint64_t receive_time_us);
+
+    void update_heartbeat(uint8_t system_id, uint8_t base_mode, uint32_t custom_mode);
+    void update_position(
+        uint8_t system_id,
+        double latitude_deg,
+        double longitude_deg,
+        float absolute_altitude_m,
+        float relative_altitude_m);
+    void update_attitude(uint8_t system_id, float roll_deg, float pitch_deg, float yaw_deg);
+    void update_battery(uint8_t system_id, float remaining_percent, float voltage_v);
+    void update_last_seen(uint8_t system_id, uint64_t receive_time_us);
+
+    // Fills the snapshot, reusing its memory. The rows which changed compared
+    // to what was in the snapshot before are listed in changed_rows.
+    void snapshot(Mavsdk::FleetSnapshot& snapshot, uint64_t now_us) const;
+
+private:
+    template<typename F> void update_row(uint8_t system_id, F&& func);
+
+    mutable std::mutex _mutex{};
+
+    std::array<bool, MAX_ROWS> _present{};
+    std::array<uint32_t, MAX_ROWS> _versions{};
+    std::array<double, MAX_ROWS> _latitude_deg{};
+    std::array<double, MAX_ROWS> _longitude_deg{};
+    std::array<float, MAX_ROWS> _absolute_altitude_m{};
+    std::array<float, MAX_ROWS> _relative_altitude_m{};
+    std::array<float, MAX_ROWS> _roll_deg{};
+    std::array<float, MAX_ROWS> _pitch_deg{};
+    std::array<float, MAX_ROWS> _yaw_deg{};
+    std::array<float, MAX_ROWS> _battery_remaining_percent{};
+    std::array<float, MAX_ROWS> _battery_voltage_v{};
+    std::array<uint8_t, MAX_ROWS> _base_mode{};
+    std::array<uint32_t, MAX_ROWS> _custom_mode{};
+
+    // Updated for every message, so without taking the lock and without
+    // marking the row as changed.
+    std::array<std::atomic<uint64_t>, MAX_ROWS> _last_seen_us{};
+};
+
+} // namespace mavsdk
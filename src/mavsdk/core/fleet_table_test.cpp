@@ -0,0 +1,75 @@
+#include "fleet_table.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(FleetTable, EmptyWithoutData)
+{
+    FleetTable fleet_table;
+    fleet_table.update_last_seen(1, 1000);
+
+    Mavsdk::FleetSnapshot snapshot;
+    fleet_table.snapshot(snapshot, 2000);
+    EXPECT_TRUE(snapshot.system_ids.empty());
+    EXPECT_TRUE(snapshot.changed_rows.empty());
+}
+
+TEST(FleetTable, RowsByColumn)
+{
+    FleetTable fleet_table;
+    fleet_table.update_position(42, 47.1, 8.5, 500.0f, 10.0f);
+    fleet_table.update_attitude(3, 1.0f, 2.0f, 3.0f);
+    fleet_table.update_last_seen(42, 1000000);
+
+    Mavsdk::FleetSnapshot snapshot;
+    fleet_table.snapshot(snapshot, 3000000);
+
+    // Ordered by system ID.
+    ASSERT_EQ(snapshot.system_ids.size(), 2);
+    EXPECT_EQ(snapshot.system_ids[0], 3);
+    EXPECT_EQ(snapshot.system_ids[1], 42);
+
+    EXPECT_FLOAT_EQ(snapshot.yaw_deg[0], 3.0f);
+    EXPECT_TRUE(std::isnan(snapshot.latitude_deg[0]));
+
+    EXPECT_DOUBLE_EQ(snapshot.latitude_deg[1], 47.1);
+    EXPECT_FLOAT_EQ(snapshot.relative_altitude_m[1], 10.0f);
+    EXPECT_TRUE(std::isnan(snapshot.battery_voltage_v[1]));
+    EXPECT_DOUBLE_EQ(snapshot.seconds_since_last_seen[1], 2.0);
+
+    EXPECT_EQ(snapshot.changed_rows, (std::vector<size_t>{0, 1}));
+}
+
+TEST(FleetTable, ChangedRows)
+{
+    FleetTable fleet_table;
+    fleet_table.update_heartbeat(1, 0, 0);
+    fleet_table.update_heartbeat(2, 0, 0);
+    fleet_table.update_heartbeat(3, 0, 0);
+
+    Mavsdk::FleetSnapshot snapshot;
+    fleet_table.snapshot(snapshot, 0);
+    EXPECT_EQ(snapshot.changed_rows.size(), 3);
+
+    // Nothing changed.
+    fleet_table.snapshot(snapshot, 0);
+    EXPECT_TRUE(snapshot.changed_rows.empty());
+
+    // Being seen is not a change.
+    fleet_table.update_last_seen(2, 100);
+    fleet_table.snapshot(snapshot, 0);
+    EXPECT_TRUE(snapshot.changed_rows.empty());
+
+    fleet_table.update_battery(2, 50.0f, 12.1f);
+    fleet_table.snapshot(snapshot, 0);
+    EXPECT_EQ(snapshot.changed_rows, std::vector<size_t>{1});
+    EXPECT_FLOAT_EQ(snapshot.battery_remaining_percent[1], 50.0f);
+
+    // A new row shifts the rows after it which doesn't count as a change.
+    fleet_table.update_heartbeat(0, 0, 0);
+    fleet_table.snapshot(snapshot, 0);
+    EXPECT_EQ(snapshot.changed_rows, std::vector<size_t>{0});
+    EXPECT_EQ(snapshot.system_ids.size(), 4);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mavsdk {
+
+/**
+ * @brief Read-only view of one column of a telemetry history.
+ *
+ * The history is stored in a ring buffer, so a time range can wrap around
+ * the end of the storage. The view therefore consists of up to two contiguous
+ * parts: `first()` followed by `second()`. The view points into a copy of the
+ * queried range and is only valid while it is being accessed from the query
+ * callback.
+ */
+template<typename T> class HistoryColumn {
+public:
+    HistoryColumn() = default;
+    HistoryColumn(
+        const T* first, std::size_t first_size, const T* second, std::size_t second_size) :
+        _first(first),
+        _first_size(first_size),
+        _second(second),
+        _second_size(second_size)
+    {}
+    ~HistoryColumn() = default;
+
+    /**
+     * @brief Number of samples in the view.
+     */
+    std::size_t size() const { return _first_size + _second_size; }
+
+    /**
+     * @brief Whether the view contains no samples.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Sample at index, 0 being the oldest sample in the view.
+     */
+    const T& operator[](std::size_t index) const
+    {
+        return index < _first_size ? _first[index] : _second[index - _first_size];
+    }
+
+    /**
+     * @brief First contiguous part of the view.
+     */
+    const T* first() const { return _first; }
+
+    /**
+     * @brief Number of samples in the first part.
+     */
+    std::size_t first_size() const { return _first_size; }
+
+    /**
+     * @brief Second contiguous part of the view, continuing after the first.
+     */
+    const T* second() const { return _second; }
+
+    /**
+     * @brief Number of samples in the second part.
+     */
+    std::size_t second_size() const { return _second_size; }
+
+private:
+    const T* _first{nullptr};
+    std::size_t _first_size{0};
+    const T* _second{nullptr};
+    std::size_t _second_size{0};
+};
+
+} // namespace mavsdk
@@ -223,6 +223,81 @@ public:
                   provided */
     };
 
+    /**
+     * @brief How user callbacks are distributed over the callback threads.
+     */
+    enum class CallbackSharding {
+        System, /**< @brief All callbacks of a system run in order on the same thread. */
+        Subscription, /**< @brief Callbacks of each stream of a system (e.g. position) run
+                         in order on the same thread, different streams can run in parallel.
+                         All subscribers of one stream share that thread. */
+    };
+
+    /**
+     * @brief Metrics of one callback thread.
+     *
+     * Latencies are measured like in CallbackStats.
+     */
+    struct CallbackShardMetrics {
+        size_t queue_depth{0}; /**< @brief Callbacks currently queued. */
+        size_t max_queue_depth{0}; /**< @brief Most callbacks queued at once. */
+        uint64_t callbacks_run{0}; /**< @brief Callbacks run so far. */
+        double mean_queue_latency_s{0.0}; /**< @brief Mean time from receiving to running. */
+        double max_queue_latency_s{0.0}; /**< @brief Max time from receiving to running. */
+    };
+
+    /**
+     * @brief Distribution of a callback latency.
+     *
+     * Percentiles are accurate to about 6%.
+     */
+    struct CallbackLatency {
+        uint64_t count{0}; /**< @brief Number of samples. */
+        double min_s{0.0}; /**< @brief Minimum in seconds. */
+        double mean_s{0.0}; /**< @brief Mean in seconds. */
+        double p50_s{0.0}; /**< @brief Median in seconds. */
+        double p90_s{0.0}; /**< @brief 90th percentile in seconds. */
+        double p99_s{0.0}; /**< @brief 99th percentile in seconds. */
+        double p999_s{0.0}; /**< @brief 99.9th percentile in seconds. */
+        double max_s{0.0}; /**< @brief Maximum in seconds. */
+    };
+
+    /**
+     * @brief Latency statistics of the user callbacks queued at one place in MAVSDK.
+     *
+     * Delays are measured from when the message that led to the callback was
+     * received, or from queueing if the callback wasn't due to a message.
+     */
+    struct CallbackStats {
+        std::string location{}; /**< @brief Where the callback is queued, filename:linenumber. */
+        CallbackLatency queue_delay{}; /**< @brief Time from receiving until the callback runs. */
+        CallbackLatency duration{}; /**< @brief Time the callback takes to run. */
+    };
+
+    /**
+     * @brief Latest state of all systems, one row per system.
+     *
+     * The data is stored column by column: row i of every column belongs to
+     * system_ids[i]. Values which have not been received yet are NaN.
+     */
+    struct FleetSnapshot {
+        std::vector<uint8_t> system_ids{}; /**< @brief System ID of each row, ascending. */
+        std::vector<double> latitude_deg{}; /**< @brief Latitude in degrees. */
+        std::vector<double> longitude_deg{}; /**< @brief Longitude in degrees. */
+        std::vector<float> absolute_altitude_m{}; /**< @brief Altitude AMSL in metres. */
+        std::vector<float> relative_altitude_m{}; /**< @brief Altitude above takeoff in metres. */
+        std::vector<float> roll_deg{}; /**< @brief Roll angle in degrees. */
+        std::vector<float> pitch_deg{}; /**< @brief Pitch angle in degrees. */
+        std::vector<float> yaw_deg{}; /**< @brief Yaw angle in degrees. */
+        std::vector<float> battery_remaining_percent{}; /**< @brief Remaining battery. */
+        std::vector<float> battery_voltage_v{}; /**< @brief Battery voltage in volts. */
+        std::vector<uint8_t> base_mode{}; /**< @brief Base mode of the autopilot. */
+        std::vector<uint32_t> custom_mode{}; /**< @brief Custom mode of the autopilot. */
+        std::vector<double> seconds_since_last_seen{}; /**< @brief Age of the last message. */
+        std::vector<uint32_t> versions{}; /**< @brief Incremented whenever the row changes. */
+        std::vector<size_t> changed_rows{}; /**< @brief Rows changed since the last fill. */
+    };
+
     /**
      * @brief Possible configurations.
      */
@@ -290,12 +365,98 @@ public:
          */
         void set_component_type(ComponentType component_type);
 
+        /**
+         * @brief Get the number of threads used to call user callbacks.
+         * @return number of callback threads, 1 by default
+         */
+        unsigned get_callback_threads() const;
+
+        /**
+         * @brief Set the number of threads used to call user callbacks.
+         *
+         * With more than one thread, callbacks of independent vehicles (or
+         * streams, see CallbackSharding) can run in parallel.
+         *
+         * @note This only takes effect when passed to the Mavsdk constructor.
+         */
+        void set_callback_threads(unsigned callback_threads);
+
+        /**
+         * @brief Get how callbacks are distributed over the callback threads.
+         * @return the callback sharding, CallbackSharding::System by default
+         */
+        CallbackSharding get_callback_sharding() const;
+
+        /**
+         * @brief Set how callbacks are distributed over the callback threads.
+         *
+         * @note This only takes effect when passed to the Mavsdk constructor.
+         */
+        void set_callback_sharding(CallbackSharding callback_sharding);
+
+        /**
+         * @brief Get the directory used to cache parameters.
+         * @return the directory, empty (no caching) by default
+         */
+        std::string get_param_cache_directory() const;
+
+        /**
+         * @brief Set the directory used to cache parameters.
+         *
+         * The parameters of each component are stored there after being
+         * downloaded. On the next download, the autopilot's parameter hash
+         * is checked first, and if nothing changed the cached parameters
+         * are used instead of downloading them all again.
+         *
+         * @note This is currently only supported for PX4.
+         */
+        void set_param_cache_directory(const std::string& param_cache_directory);
+
+        /**
+         * @brief Get the directory used to keep an index of the log files.
+         * @return the directory, empty (no index) by default
+         */
+        std::string get_log_cache_directory() const;
+
+        /**
+         * @brief Set the directory used to keep an index of the log files.
+         *
+         * The list of log files of each system is stored there, together
+         * with the logs that have been downloaded completely. As long as the
+         * autopilot reports the same logs, the list is answered from the
+         * index and only the newest entry is requested again, and logs that
+         * were downloaded already are not downloaded again.
+         */
+        void set_log_cache_directory(const std::string& log_cache_directory);
+
+        /**
+         * @brief Get the directory used to cache camera definitions.
+         * @return the directory, empty (no caching on disk) by default
+         */
+        std::string get_camera_definition_cache_directory() const;
+
+        /**
+         * @brief Set the directory used to cache camera definitions.
+         *
+         * Camera definition files are stored there by URI and version after
+         * being downloaded, so a camera reporting the same definition is set
+         * up without downloading it again. Within the process, definitions
+         * are downloaded and parsed only once either way.
+         */
+        void set_camera_definition_cache_directory(
+            const std::string& camera_definition_cache_directory);
+
     private:
         uint8_t _system_id;
         uint8_t _component_id;
         bool _always_send_heartbeats;
         bool _disable_send_heartbeats;
         ComponentType _component_type;
+        unsigned _callback_threads{1};
+        CallbackSharding _callback_sharding{CallbackSharding::System};
+        std::string _param_cache_directory{};
+        std::string _log_cache_directory{};
+        std::string _camera_definition_cache_directory{};
 
         static Mavsdk::ComponentType component_type_for_component_id(uint8_t component_id);
     };
@@ -408,6 +569,44 @@ public:
      */
     std::shared_ptr<ServerComponent> server_component_by_id(uint8_t component_id);
 
+    /**
+     * @brief Get metrics of the threads calling user callbacks.
+     *
+     * @return One entry per callback thread, see Configuration::set_callback_threads.
+     */
+    std::vector<CallbackShardMetrics> callback_shard_metrics() const;
+
+    /**
+     * @brief Get latency statistics of user callbacks.
+     *
+     * These are always collected and can be used to find slow subscribers.
+     * They can also be logged by sending SIGUSR1 to the process if the
+     * environment variable MAVSDK_CALLBACK_STATS_SIGNAL is set to 1.
+     *
+     * @return One entry per location queueing callbacks, slowest first.
+     */
+    std::vector<CallbackStats> callback_stats() const;
+
+    /**
+     * @brief Reset latency statistics of user callbacks.
+     */
+    void reset_callback_stats();
+
+    /**
+     * @brief Get the latest state of all systems at once.
+     *
+     * This is kept up to date as messages arrive, without any plugins or
+     * subscriptions, and is meant to be polled e.g. once per frame by a
+     * ground station showing many vehicles.
+     *
+     * The snapshot passed in is filled, reusing its memory. The rows which
+     * changed compared to its previous content are listed in changed_rows,
+     * so keep passing in the same snapshot.
+     *
+     * @param snapshot The snapshot to fill.
+     */
+    void fleet_snapshot(FleetSnapshot& snapshot) const;
+
     /**
      * @brief Intercept incoming messages.
      *
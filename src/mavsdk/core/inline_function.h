@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mavsdk {
+
+template<typename Signature, std::size_t Capacity> class InlineFunction;
+
+// Move-only replacement for std::function which stores the callable inside
+// the object instead of on the heap, so creating, moving and calling it
+// doesn't allocate.
+//
+// Callables bigger than Capacity (or with unusual alignment) still work but
+// are put on the heap, so Capacity should be chosen for the common case.
+template<typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    static_assert(Capacity >= sizeof(void*), "Capacity needs to fit at least a pointer");
+
+    InlineFunction() = default;
+    InlineFunction(std::nullptr_t) {}
+
+    template<
+        typename F,
+        typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, InlineFunction> &&
+            std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    InlineFunction(F&& func)
+    {
+        using Callable = std::decay_t<F>;
+        if constexpr (stored_inline<Callable>()) {
+            new (&_storage) Callable(std::forward<F>(func));
+            _ops = &inline_ops<Callable>;
+        } else {
+            new (&_storage) Callable*(new Callable(std::forward<F>(func)));
+            _ops = &heap_ops<Callable>;
+        }
+    }
+
+    ~InlineFunction() { reset(); }
+
+    InlineFunction(InlineFunction&& other) noexcept { take(other); }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    R operator()(Args... args) { return _ops->invoke(&_storage, std::forward<Args>(args)...); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    template<typename Callable> static constexpr bool stored_inline()
+    {
+        return sizeof(Callable) <= Capacity && alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* from, void* to);
+        void (*destroy)(void* storage);
+    };
+
+    template<typename Callable> static Callable* inline_callable(void* storage)
+    {
+        return std::launder(static_cast<Callable*>(storage));
+    }
+
+    template<typename Callable> static Callable*& heap_callable(void* storage)
+    {
+        return *std::launder(static_cast<Callable**>(storage));
+    }
+
+    template<typename Callable>
+    static constexpr Ops inline_ops{
+        [](void* storage, Args&&... args) -> R {
+            return (*inline_callable<Callable>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* from, void* to) {
+            new (to) Callable(std::move(*inline_callable<Callable>(from)));
+            inline_callable<Callable>(from)->~Callable();
+        },
+        [](void* storage) { inline_callable<Callable>(storage)->~Callable(); }};
+
+    template<typename Callable>
+    static constexpr Ops heap_ops{
+        [](void* storage, Args&&... args) -> R {
+            return (*heap_callable<Callable>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* from, void* to) { new (to) Callable*(heap_callable<Callable>(from)); },
+        [](void* storage) { delete heap_callable<Callable>(storage); }};
+
+    void take(InlineFunction& other)
+    {
+        if (other._ops != nullptr) {
+            other._ops->move(&other._storage, &_storage);
+            _ops = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+    void reset()
+    {
+        if (_ops != nullptr) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char _storage[Capacity];
+    const Ops* _ops{nullptr};
+};
+
+} // namespace mavsdk
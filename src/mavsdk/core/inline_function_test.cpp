@@ -0,0 +1,168 @@
+#include "inline_function.h"
+#include "callback_list.h"
+#include "callback_list.tpp"
+#include "safe_queue.h"
+#include "log.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Allocations are only counted on the thread and for the scope of a
+// CountAllocations, otherwise operator new below just passes through.
+thread_local uint64_t* allocation_counter = nullptr;
+
+class CountAllocations {
+public:
+    explicit CountAllocations(uint64_t& counter) { allocation_counter = &counter; }
+    ~CountAllocations() { allocation_counter = nullptr; }
+
+    CountAllocations(const CountAllocations&) = delete;
+    CountAllocations& operator=(const CountAllocations&) = delete;
+};
+
+} // namespace
+
+// Similar to Telemetry::Position.
+struct DeliverySample {
+    double latitude_deg{0.0};
+    double longitude_deg{0.0};
+    float absolute_altitude_m{0.0f};
+    float relative_altitude_m{0.0f};
+};
+
+// The allocations happen inside std::function and the standard containers, so
+// there is no other place to count them. Abort instead of throwing, so this
+// also builds without exceptions.
+void* operator new(std::size_t size)
+{
+    if (allocation_counter != nullptr) {
+        ++(*allocation_counter);
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    std::abort();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace mavsdk {
+
+template class CallbackList<DeliverySample>;
+
+} // namespace mavsdk
+
+using namespace mavsdk;
+
+TEST(InlineFunction, CallAndMove)
+{
+    int called = 0;
+    InlineFunction<int(int), 32> func{[&called](int value) {
+        ++called;
+        return value * 2;
+    }};
+    ASSERT_TRUE(func);
+    EXPECT_EQ(func(21), 42);
+
+    InlineFunction<int(int), 32> moved{std::move(func)};
+    EXPECT_FALSE(func);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(moved(1), 2);
+    EXPECT_EQ(called, 2);
+
+    InlineFunction<int(int), 32> empty{};
+    EXPECT_FALSE(empty);
+    empty = std::move(moved);
+    EXPECT_EQ(empty(2), 4);
+}
+
+TEST(InlineFunction, MoveOnlyCapture)
+{
+    auto value = std::make_unique<int>(42);
+    InlineFunction<int(), 32> func{[value = std::move(value)]() { return *value; }};
+    EXPECT_EQ(func(), 42);
+}
+
+TEST(InlineFunction, TooBigForStorage)
+{
+    std::array<char, 64> big{};
+    big[63] = 'x';
+    auto lambda = [big]() { return big[63]; };
+    static_assert(!InlineFunction<char(), 32>::stored_inline<decltype(lambda)>());
+
+    InlineFunction<char(), 32> func{lambda};
+    InlineFunction<char(), 32> moved{std::move(func)};
+    EXPECT_EQ(moved(), 'x');
+}
+
+TEST(InlineFunction, DestroysCallable)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        InlineFunction<void(), 32> func{[counter]() { ++(*counter); }};
+        EXPECT_EQ(counter.use_count(), 2);
+        func();
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+    EXPECT_EQ(*counter, 1);
+}
+
+TEST(InlineFunction, DeliveryWithoutAllocations)
+{
+    // Same path as telemetry: queue a sample for each subscription and have it
+    // called from a queue of user callbacks.
+    CallbackList<DeliverySample> callback_list;
+    SafeQueue<UserCallbackFunction> queue;
+
+    double sum = 0.0;
+    callback_list.subscribe([&](DeliverySample sample) { sum += sample.latitude_deg; });
+    callback_list.subscribe([&](DeliverySample sample) { sum += sample.longitude_deg; });
+
+    auto deliver = [&](unsigned num) {
+        for (unsigned i = 0; i < num; ++i) {
+            callback_list.queue(DeliverySample{1.0, 2.0, 3.0f, 4.0f}, [&](auto&& func) {
+                queue.enqueue(std::move(func));
+            });
+            while (queue.size() > 0) {
+                queue.dequeue().value()();
+            }
+        }
+    };
+
+    // Warm up so the queue has its slots.
+    deliver(10);
+
+    constexpr unsigned num_messages = 100000;
+    uint64_t allocations = 0;
+    const auto before = std::chrono::steady_clock::now();
+
+    {
+        CountAllocations count_allocations{allocations};
+        deliver(num_messages);
+    }
+
+    const auto duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - before)
+                                 .count();
+
+    LogInfo() << "Delivery: " << static_cast<double>(duration_ns) / num_messages
+              << " ns per message, " << allocations << " allocations";
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_DOUBLE_EQ(sum, 3.0 * (num_messages + 10));
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace mavsdk {
+
+// Histogram of durations in nanoseconds with a bounded relative error,
+// similar to an HDR histogram.
+//
+// Values below 16 are counted exactly, above that every power of two is split
+// into 16 linear buckets, so a bucket is never wider than 1/16 of its values.
+// Values of 2^40 ns (about 18 minutes) and more go into the last bucket.
+//
+// Recording only does relaxed atomic increments and can be done from any
+// thread. Reading while recording gives a slightly inconsistent but still
+// meaningful result.
+class LatencyHistogram {
+public:
+    void record(uint64_t value_ns)
+    {
+        _buckets[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum_ns.fetch_add(value_ns, std::memory_order_relaxed);
+
+        auto min_ns = _min_ns.load(std::memory_order_relaxed);
+        while (value_ns < min_ns &&
+               !_min_ns.compare_exchange_weak(min_ns, value_ns, std::memory_order_relaxed)) {
+        }
+        auto max_ns = _max_ns.load(std::memory_order_relaxed);
+        while (value_ns > max_ns &&
+               !_max_ns.compare_exchange_weak(max_ns, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+    uint64_t min_ns() const
+    {
+        return count() > 0 ? _min_ns.load(std::memory_order_relaxed) : 0;
+    }
+
+    uint64_t max_ns() const { return _max_ns.load(std::memory_order_relaxed); }
+
+    double mean_ns() const
+    {
+        const auto num = count();
+        return num > 0 ?
+                   static_cast<double>(_sum_ns.load(std::memory_order_relaxed)) /
+                       static_cast<double>(num) :
+                   0.0;
+    }
+
+    // Returns the highest value in the bucket containing the given percentile,
+    // but never more than the max recorded.
+    uint64_t percentile_ns(double percentile) const
+    {
+        uint64_t total = 0;
+        for (const auto& bucket : _buckets) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total));
+        if (target == 0) {
+            target = 1;
+        }
+
+        uint64_t cumulative = 0;
+        for (unsigned i = 0; i < NUM_BUCKETS; ++i) {
+            cumulative += _buckets[i].load(std::memory_order_relaxed);
+            if (cumulative >= target) {
+                const auto upper = bucket_upper_ns(i);
+                return upper < max_ns() ? upper : max_ns();
+            }
+        }
+        return max_ns();
+    }
+
+    void reset()
+    {
+        for (auto& bucket : _buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        _count.store(0, std::memory_order_relaxed);
+        _sum_ns.store(0, std::memory_order_relaxed);
+        _min_ns.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        _max_ns.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 40;
+    static constexpr unsigned NUM_BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static constexpr unsigned bucket_index(uint64_t value_ns)
+    {
+        if (value_ns < SUB_BUCKETS) {
+            return static_cast<unsigned>(value_ns);
+        }
+
+        constexpr uint64_t max_value = (uint64_t(1) << MAX_EXPONENT) - 1;
+        if (value_ns > max_value) {
+            value_ns = max_value;
+        }
+
+        const unsigned exponent = highest_bit(value_ns);
+        const unsigned shift = exponent - SUB_BUCKET_BITS;
+        const auto mantissa = static_cast<unsigned>(value_ns >> shift);
+        return (shift + 1) * SUB_BUCKETS + (mantissa - SUB_BUCKETS);
+    }
+
+    static constexpr uint64_t bucket_upper_ns(unsigned index)
+    {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+
+        const unsigned shift = index / SUB_BUCKETS - 1;
+        const uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    static constexpr unsigned highest_bit(uint64_t value)
+    {
+        unsigned result = 0;
+        for (unsigned step = 32; step > 0; step /= 2) {
+            if (value >> step) {
+                value >>= step;
+                result += step;
+            }
+        }
+        return result;
+    }
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> _buckets{};
+    std::atomic<uint64_t> _count{0};
+    std::atomic<uint64_t> _sum_ns{0};
+    std::atomic<uint64_t> _min_ns{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> _max_ns{0};
+};
+
+} // namespace mavsdk
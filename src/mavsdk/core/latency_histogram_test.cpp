@@ -0,0 +1,54 @@
+#include "latency_histogram.h"
+
+#include <memory>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(LatencyHistogram, BucketsAreContiguous)
+{
+    for (unsigned i = 0; i + 1 < LatencyHistogram::NUM_BUCKETS; ++i) {
+        const auto upper = LatencyHistogram::bucket_upper_ns(i);
+        EXPECT_EQ(LatencyHistogram::bucket_index(upper), i);
+        EXPECT_EQ(LatencyHistogram::bucket_index(upper + 1), i + 1);
+    }
+
+    EXPECT_EQ(
+        LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::NUM_BUCKETS - 1);
+}
+
+TEST(LatencyHistogram, RelativeError)
+{
+    for (uint64_t value = 1; value < (uint64_t(1) << 40); value = value * 3 + 1) {
+        const auto upper =
+            LatencyHistogram::bucket_upper_ns(LatencyHistogram::bucket_index(value));
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value), static_cast<double>(value) / 16.0);
+    }
+}
+
+TEST(LatencyHistogram, Percentiles)
+{
+    auto histogram = std::make_unique<LatencyHistogram>();
+    EXPECT_EQ(histogram->count(), 0);
+    EXPECT_EQ(histogram->percentile_ns(50.0), 0);
+    EXPECT_EQ(histogram->min_ns(), 0);
+
+    // 1 us to 1 ms.
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram->record(i * 1000);
+    }
+
+    EXPECT_EQ(histogram->count(), 1000);
+    EXPECT_EQ(histogram->min_ns(), 1000);
+    EXPECT_EQ(histogram->max_ns(), 1000000);
+    EXPECT_DOUBLE_EQ(histogram->mean_ns(), 500500.0);
+    EXPECT_NEAR(histogram->percentile_ns(50.0), 500000.0, 500000.0 / 16.0);
+    EXPECT_NEAR(histogram->percentile_ns(99.0), 990000.0, 990000.0 / 16.0);
+    EXPECT_EQ(histogram->percentile_ns(100.0), 1000000);
+
+    histogram->reset();
+    EXPECT_EQ(histogram->count(), 0);
+    EXPECT_EQ(histogram->max_ns(), 0);
+    EXPECT_EQ(histogram->percentile_ns(99.0), 0);
+}
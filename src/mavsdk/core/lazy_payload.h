@@ -0,0 +1,77 @@
+#pragma once
+
+#include "seqlock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace mavsdk {
+
+// Keeps the latest received payload of a message until it is needed.
+//
+// Converting a received message into the types handed out to users and
+// caching it costs time on the receive thread, which is wasted if nobody
+// subscribed and the value is never polled. With this, a payload can either
+// be decoded right away (e.g. because there are subscribers) or just be
+// stored together with its receive time.
+//
+// A stored payload is never decoded into the cache later on. Readers copy it
+// out of a Seqlock and convert it into a local value instead, so neither side
+// takes a lock and readers never write shared state. Only the receive thread
+// decodes into the cache, in the order the payloads arrive.
+//
+// Each payload also gets a receive sequence number, so that values carried by
+// more than one message can be taken from the one received last.
+template<typename Payload> class LazyPayload {
+public:
+    struct Received {
+        Payload payload;
+        uint64_t receive_time_us;
+    };
+
+    template<typename Decode>
+    void receive(
+        const Payload& payload,
+        uint64_t receive_time_us,
+        uint64_t sequence,
+        bool decode_now,
+        Decode&& decode)
+    {
+        _sequence.store(sequence, std::memory_order_release);
+        if (decode_now) {
+            // Decoded first, so that a reader that finds nothing pending gets
+            // this value and not the one before.
+            decode(payload, receive_time_us);
+            _pending.store(false, std::memory_order_release);
+        } else {
+            _received.store(Received{payload, receive_time_us});
+            _pending.store(true, std::memory_order_release);
+        }
+    }
+
+    // Copy of the latest payload if it has not been decoded on receive.
+    std::optional<Received> load_pending() const
+    {
+        // Cheap check for the common case of nothing to do.
+        if (!_pending.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        return _received.load();
+    }
+
+    bool pending() const { return _pending.load(std::memory_order_acquire); }
+
+    // Sequence number of the latest payload, which is also the one being
+    // decoded while inside the decode function.
+    uint64_t sequence() const { return _sequence.load(std::memory_order_acquire); }
+
+    void clear() { _pending.store(false, std::memory_order_release); }
+
+private:
+    Seqlock<Received> _received{};
+    std::atomic<uint64_t> _sequence{0};
+    std::atomic<bool> _pending{false};
+};
+
+} // namespace mavsdk
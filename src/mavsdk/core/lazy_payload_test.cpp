@@ -0,0 +1,116 @@
+#include "lazy_payload.h"
+
+#include <atomic>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Payload {
+    int32_t lat{0};
+    int32_t lon{0};
+};
+
+} // namespace
+
+TEST(LazyPayload, DecodesOnlyWhenNeeded)
+{
+    LazyPayload<Payload> lazy_payload;
+    unsigned decoded = 0;
+
+    auto decode = [&](const Payload&, uint64_t) { ++decoded; };
+
+    // Nothing received yet.
+    EXPECT_FALSE(lazy_payload.load_pending());
+
+    // Only the latest payload is kept, with its receive time.
+    lazy_payload.receive(Payload{1, 2}, 10, 1, false, decode);
+    lazy_payload.receive(Payload{3, 4}, 20, 2, false, decode);
+    EXPECT_EQ(decoded, 0);
+    EXPECT_TRUE(lazy_payload.pending());
+
+    auto pending = lazy_payload.load_pending();
+    ASSERT_TRUE(pending);
+    EXPECT_EQ(pending->payload.lat, 3);
+    EXPECT_EQ(pending->receive_time_us, 20);
+
+    // Reading doesn't consume it.
+    EXPECT_TRUE(lazy_payload.pending());
+    EXPECT_EQ(decoded, 0);
+
+    lazy_payload.clear();
+    EXPECT_FALSE(lazy_payload.load_pending());
+}
+
+TEST(LazyPayload, SequenceOfLatestPayload)
+{
+    LazyPayload<Payload> lazy_payload;
+    EXPECT_EQ(lazy_payload.sequence(), 0);
+
+    uint64_t sequence_while_decoding = 0;
+    auto decode = [&](const Payload&, uint64_t) {
+        sequence_while_decoding = lazy_payload.sequence();
+    };
+
+    lazy_payload.receive(Payload{1, 2}, 10, 5, false, decode);
+    EXPECT_EQ(lazy_payload.sequence(), 5);
+    EXPECT_EQ(sequence_while_decoding, 0);
+
+    lazy_payload.receive(Payload{3, 4}, 20, 8, true, decode);
+    EXPECT_EQ(sequence_while_decoding, 8);
+    EXPECT_EQ(lazy_payload.sequence(), 8);
+}
+
+TEST(LazyPayload, DecodeNowDropsPending)
+{
+    LazyPayload<Payload> lazy_payload;
+    Payload result{};
+
+    auto decode = [&](const Payload& payload, uint64_t) { result = payload; };
+
+    lazy_payload.receive(Payload{1, 2}, 10, 1, false, decode);
+    lazy_payload.receive(Payload{3, 4}, 20, 2, true, decode);
+    EXPECT_EQ(result.lat, 3);
+
+    // The older payload must not be handed out anymore.
+    EXPECT_FALSE(lazy_payload.load_pending());
+}
+
+TEST(LazyPayload, ConcurrentReceiveAndRead)
+{
+    LazyPayload<Payload> lazy_payload;
+    std::atomic<int32_t> decoded{0};
+
+    auto decode = [&](const Payload& payload, uint64_t) { decoded = payload.lat; };
+
+    std::thread receiver([&]() {
+        for (int32_t i = 1; i <= 100000; ++i) {
+            const auto time = static_cast<uint64_t>(i);
+            lazy_payload.receive(Payload{i, i}, time, time, i % 7 == 0, decode);
+        }
+    });
+
+    // Readers never see a torn payload or one older than what they saw before.
+    // The last payload is not decoded right away, so this ends once it is read.
+    int32_t latest = 0;
+    bool went_back = false;
+    bool torn = false;
+    while (latest < 100000) {
+        auto pending = lazy_payload.load_pending();
+        const int32_t lat = pending ? pending->payload.lat : decoded.load();
+        if (pending && pending->payload.lon != lat) {
+            torn = true;
+        }
+        if (lat < latest) {
+            went_back = true;
+        }
+        latest = lat;
+    }
+
+    receiver.join();
+    EXPECT_FALSE(torn);
+    EXPECT_FALSE(went_back);
+    EXPECT_EQ(latest, 100000);
+}
@@ -126,6 +126,25 @@ void MavlinkCommandSender::queue_command_async(
     _work_queue.push_back(new_work);
 }
 
+void MavlinkCommandSender::queue_pipelined_command_async(
+    const CommandLong& command, const CommandResultCallback& callback)
+{
+    if (_command_debugging) {
+        LogDebug() << "COMMAND_LONG " << (int)(command.command) << " to send pipelined to "
+                   << (int)(command.target_system_id) << ", " << (int)(command.target_component_id);
+    }
+
+    auto new_work = std::make_shared<Work>();
+    new_work->timeout_s = _system_impl.timeout_s();
+    new_work->command = command;
+    new_work->identification = identification_from_command(command);
+    new_work->callback = callback;
+    new_work->time_started = _system_impl.get_time().steady_time();
+    new_work->retries_to_do = 0;
+    new_work->pipelined = true;
+    _work_queue.push_back(new_work);
+}
+
 void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
 {
     mavlink_command_ack_t command_ack;
@@ -373,7 +392,8 @@ void MavlinkCommandSender::do_work()
 
             // Check if command with same command ID is already being sent.
             if (other_work->already_sent &&
-                other_work->identification.command == work->identification.command) {
+                other_work->identification.command == work->identification.command &&
+                !(other_work->pipelined && work->pipelined)) {
                 if (_command_debugging) {
                     LogDebug() << "Command " << static_cast<int>(work->identification.command)
                                << " is already being sent, waiting...";
@@ -79,6 +79,15 @@ public:
     void queue_command_async(const CommandInt& command, const CommandResultCallback& callback);
     void queue_command_async(const CommandLong& command, const CommandResultCallback& callback);
 
+    // Pipelined commands don't wait for the ack of earlier pipelined commands
+    // with the same command ID. As the ack doesn't say which of them it is
+    // for, acks are matched in order, which relies on the receiver handling
+    // commands in order. They are not retransmitted because a retransmission
+    // could not be told apart either, so a lost command or ack shows up as a
+    // timeout and the caller has to retry.
+    void queue_pipelined_command_async(
+        const CommandLong& command, const CommandResultCallback& callback);
+
     void do_work();
 
     static const int DEFAULT_COMPONENT_ID_AUTOPILOT = MAV_COMP_ID_AUTOPILOT1;
@@ -118,6 +127,7 @@ private:
         double timeout_s{0.5};
         int retries_to_do{3};
         bool already_sent{false};
+        bool pipelined{false};
     };
 
     template<typename CommandType>
@@ -6,7 +6,6 @@
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
-#include <numeric>
 
 #include "crc32.h"
 
@@ -36,6 +35,8 @@ MavlinkFtpClient::~MavlinkFtpClient()
 
 void MavlinkFtpClient::do_work()
 {
+    continue_mirrors();
+
     LockedQueue<Work>::Guard work_queue_guard(_work_queue);
 
     auto work = work_queue_guard.get_front();
@@ -137,7 +138,14 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
         return;
     }
 
-    if (work->last_opcode != payload->req_opcode) {
+    // During a burst download, gaps are read while the burst is still going on.
+    const bool burst_with_reads = std::holds_alternative<DownloadBurstItem>(work->item) &&
+                                  (work->last_opcode == CMD_BURST_READ_FILE ||
+                                   work->last_opcode == CMD_READ_FILE) &&
+                                  (payload->req_opcode == CMD_BURST_READ_FILE ||
+                                   payload->req_opcode == CMD_READ_FILE);
+
+    if (work->last_opcode != payload->req_opcode && !burst_with_reads) {
         // Ignore
         LogWarn() << "Ignore: last: " << (int)work->last_opcode
                   << ", req: " << (int)payload->req_opcode;
@@ -153,8 +161,10 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
     std::visit(
         overloaded{
             [&](DownloadItem& item) {
-                if (payload->opcode == RSP_ACK) {
+                if (payload->opcode == RSP_ACK ||
+                    (payload->req_opcode == CMD_CALC_FILE_CRC32 && item.check.active)) {
                     if (payload->req_opcode == CMD_OPEN_FILE_RO ||
+                        payload->req_opcode == CMD_CALC_FILE_CRC32 ||
                         payload->req_opcode == CMD_READ_FILE) {
                         // Whenever we do get an ack,
                         // reset the retry counter.
@@ -167,7 +177,10 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
                     } else if (payload->req_opcode == CMD_TERMINATE_SESSION) {
                         stop_timer();
                         item.ofstream.close();
-                        item.callback(ClientResult::Success, {});
+                        item.callback(
+                            truncate_local_file(
+                                item.local_file_path, item.local_file_size, item.file_size),
+                            {});
                         work_queue_guard.pop_front();
 
                     } else {
@@ -181,8 +194,10 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
                 }
             },
             [&](DownloadBurstItem& item) {
-                if (payload->opcode == RSP_ACK) {
+                if (payload->opcode == RSP_ACK ||
+                    (payload->req_opcode == CMD_CALC_FILE_CRC32 && item.check.active)) {
                     if (payload->req_opcode == CMD_OPEN_FILE_RO ||
+                        payload->req_opcode == CMD_CALC_FILE_CRC32 ||
                         payload->req_opcode == CMD_BURST_READ_FILE ||
                         payload->req_opcode == CMD_READ_FILE) {
                         // Whenever we do get an ack,
@@ -196,7 +211,10 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
                     } else if (payload->req_opcode == CMD_TERMINATE_SESSION) {
                         stop_timer();
                         item.ofstream.close();
-                        item.callback(ClientResult::Success, {});
+                        item.callback(
+                            truncate_local_file(
+                                item.local_file_path, item.local_file_size, item.file_size),
+                            {});
                         work_queue_guard.pop_front();
 
                     } else {
@@ -211,22 +229,32 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
                 }
             },
             [&](UploadItem& item) {
-                if (payload->opcode == RSP_ACK) {
+                if (payload->opcode == RSP_ACK ||
+                    (payload->req_opcode == CMD_CALC_FILE_CRC32 && item.check.active)) {
                     if (payload->req_opcode == CMD_CREATE_FILE ||
                         payload->req_opcode == CMD_OPEN_FILE_WO ||
-                        payload->req_opcode == CMD_WRITE_FILE) {
+                        payload->req_opcode == CMD_WRITE_FILE ||
+                        payload->req_opcode == CMD_TERMINATE_SESSION ||
+                        (payload->req_opcode == CMD_CALC_FILE_CRC32 && item.check.active)) {
                         // Whenever we do get an ack,
                         // reset the retry counter.
                         work->retries = RETRIES;
 
-                        if (!upload_continue(*work, item)) {
+                        if (!upload_continue(*work, item, payload)) {
                             stop_timer();
                             work_queue_guard.pop_front();
                         }
-                    } else if (payload->req_opcode == CMD_TERMINATE_SESSION) {
+                    } else if (payload->req_opcode == CMD_CALC_FILE_CRC32) {
                         stop_timer();
                         item.ifstream.close();
-                        item.callback(ClientResult::Success, {});
+                        uint32_t remote_crc;
+                        std::memcpy(&remote_crc, payload->data, sizeof(uint32_t));
+                        if (remote_crc == item.local_crc) {
+                            item.callback(ClientResult::Success, {});
+                        } else {
+                            LogErr() << "Uploaded file has a different checksum";
+                            item.callback(ClientResult::ProtocolError, {});
+                        }
                         work_queue_guard.pop_front();
 
                     } else {
@@ -234,8 +262,20 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
                     }
 
                 } else if (payload->opcode == RSP_NAK) {
+                    if (payload->req_opcode == CMD_OPEN_FILE_WO) {
+                        // Nothing there yet to resume.
+                        upload_open(*work, item, CMD_CREATE_FILE);
+                        return;
+                    }
                     stop_timer();
-                    item.callback(result_from_nak(payload), {});
+                    auto result = result_from_nak(payload);
+                    if (payload->req_opcode == CMD_CALC_FILE_CRC32 &&
+                        result == ClientResult::Unsupported) {
+                        // Nothing to verify against, the file has been written anyway.
+                        LogWarn() << "Could not verify upload, no checksum support";
+                        result = ClientResult::Success;
+                    }
+                    item.callback(result, {});
                     work_queue_guard.pop_front();
                 }
             },
@@ -341,12 +381,10 @@ void MavlinkFtpClient::process_mavlink_ftp_message(const mavlink_message_t& msg)
 
                 } else if (payload->opcode == RSP_NAK) {
                     stop_timer();
-                    if (payload->data[0] == ERR_EOF) {
-                        std::sort(item.dirs.begin(), item.dirs.end());
-                        item.callback(ClientResult::Success, item.dirs);
-                    } else {
-                        item.callback(result_from_nak(payload), {});
-                    }
+                    list_dir_finished(
+                        item,
+                        payload->data[0] == ERR_EOF ? ClientResult::Success :
+                                                      result_from_nak(payload));
                     work_queue_guard.pop_front();
                 }
             }},
@@ -363,13 +401,24 @@ bool MavlinkFtpClient::download_start(Work& work, DownloadItem& item)
         LogDebug() << "Trying to open write to local path: " << local_path.string();
     }
 
-    item.ofstream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    // What is there from an earlier download is kept, only what differs is fetched.
+    item.local_file_path = local_path.string();
+    std::error_code ec;
+    if (fs::is_regular_file(local_path, ec)) {
+        item.local_file_size = static_cast<uint32_t>(fs::file_size(local_path, ec));
+        item.ofstream.open(
+            local_path, std::fstream::in | std::fstream::out | std::fstream::binary);
+    } else {
+        item.ofstream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    }
     if (!item.ofstream) {
         LogErr() << "Could not open it!";
         item.callback(ClientResult::FileIoError, {});
         return false;
     }
 
+    item.start_time = _time.steady_time();
+
     work.last_opcode = CMD_OPEN_FILE_RO;
     work.payload = {};
     work.payload.seq_number = work.last_sent_seq_number++;
@@ -390,77 +439,366 @@ bool MavlinkFtpClient::download_continue(Work& work, DownloadItem& item, Payload
 {
     if (payload->req_opcode == CMD_OPEN_FILE_RO) {
         item.file_size = *(reinterpret_cast<uint32_t*>(payload->data));
+        _session = payload->session;
 
         if (_debugging) {
             LogWarn() << "Download continue, got file size: " << item.file_size;
         }
 
+        const auto file_size = static_cast<uint32_t>(item.file_size);
+        if (!start_block_check(
+                item.check,
+                item.local_file_path,
+                item.remote_path,
+                std::min(item.local_file_size, file_size),
+                file_size)) {
+            item.callback(ClientResult::FileIoError, {});
+            return false;
+        }
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        item.reads.to_request = item.check.different;
+
+    } else if (payload->req_opcode == CMD_CALC_FILE_CRC32) {
+        block_crc_answered(item.check, *payload);
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        item.bytes_transferred = same_bytes(item.check);
+        item.reads.to_request = item.check.different;
+
+        // Blocks that are the same already count as transferred.
+        item.callback(
+            ClientResult::Next,
+            transfer_progress(
+                static_cast<uint32_t>(item.bytes_transferred),
+                static_cast<uint32_t>(item.file_size),
+                item.start_time,
+                item.reads.repeated_bytes));
+
     } else if (payload->req_opcode == CMD_READ_FILE) {
         if (_debugging) {
-            LogWarn() << "Download continue, write: " << std::to_string(payload->size);
+            LogWarn() << "Download continue, write: " << std::to_string(payload->size)
+                      << " at " << payload->offset;
         }
 
-        if (item.bytes_transferred < item.file_size) {
-            item.ofstream.write(reinterpret_cast<const char*>(payload->data), payload->size);
-            if (!item.ofstream) {
-                item.callback(ClientResult::FileIoError, {});
-                return false;
-            }
-            item.bytes_transferred += payload->size;
+        if (!request_answered(item.reads, payload->offset, payload->size)) {
+            // A late answer to a request we have already repeated.
+            return true;
+        }
 
-            if (_debugging) {
-                LogDebug() << "Written " << item.bytes_transferred << " of " << item.file_size
-                           << " bytes";
-            }
+        // Answers can arrive in any order, so each is written where it belongs.
+        item.ofstream.seekp(payload->offset);
+        item.ofstream.write(reinterpret_cast<const char*>(payload->data), payload->size);
+        if (!item.ofstream) {
+            item.callback(ClientResult::FileIoError, {});
+            return false;
+        }
+        item.bytes_transferred += payload->size;
+
+        if (_debugging) {
+            LogDebug() << "Written " << item.bytes_transferred << " of " << item.file_size
+                       << " bytes";
         }
+
         item.callback(
             ClientResult::Next,
-            ProgressData{
+            transfer_progress(
                 static_cast<uint32_t>(item.bytes_transferred),
-                static_cast<uint32_t>(item.file_size)});
+                static_cast<uint32_t>(item.file_size),
+                item.start_time,
+                item.reads.repeated_bytes));
     }
 
-    if (item.bytes_transferred < item.file_size) {
-        work.last_opcode = CMD_READ_FILE;
+    if (!item.reads.to_request.empty() || !item.reads.in_flight.empty()) {
+        request_reads(work, item.reads);
+    } else {
+        if (_debugging) {
+            LogDebug() << "All bytes written, terminating session";
+            log_transfer_stats(
+                "Downloaded",
+                static_cast<uint32_t>(item.bytes_transferred),
+                item.start_time,
+                item.reads.repeated_bytes);
+        }
+
+        download_end(work);
+    }
+
+    return true;
+}
+
+void MavlinkFtpClient::download_end(Work& work)
+{
+    // Final step
+    work.last_opcode = CMD_TERMINATE_SESSION;
+
+    work.payload = {};
+    work.payload.seq_number = work.last_sent_seq_number++;
+    work.payload.session = _session;
+
+    work.payload.opcode = work.last_opcode;
+    work.payload.offset = 0;
+    work.payload.size = 0;
+
+    start_timer();
+    send_mavlink_ftp_message(work.payload);
+}
+
+void MavlinkFtpClient::request_reads(Work& work, PipelinedRequests& reads)
+{
+    work.last_opcode = CMD_READ_FILE;
+
+    while (reads.in_flight.size() < reads.window.size() && !reads.to_request.empty()) {
+        auto& range = reads.to_request.front();
+        const uint32_t size = std::min(range.size, static_cast<uint32_t>(max_data_length));
+
         work.payload = {};
         work.payload.seq_number = work.last_sent_seq_number++;
         work.payload.session = _session;
         work.payload.opcode = work.last_opcode;
-        work.payload.offset = item.bytes_transferred;
-
-        work.payload.size =
-            std::min(static_cast<size_t>(max_data_length), item.file_size - item.bytes_transferred);
+        work.payload.offset = range.offset;
+        work.payload.size = size;
 
         if (_debugging) {
-            LogWarn() << "Request size: " << std::to_string(work.payload.size) << " of left "
-                      << int(item.file_size - item.bytes_transferred);
+            LogDebug() << "Request " << size << " bytes at " << range.offset << ", "
+                       << reads.in_flight.size() + 1 << " in flight";
         }
 
-        start_timer();
+        reads.in_flight[range.offset] = PipelinedRequests::Request{size, _time.steady_time()};
         send_mavlink_ftp_message(work.payload);
 
-        return true;
-    } else {
-        if (_debugging) {
-            LogDebug() << "All bytes written, terminating session";
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0) {
+            reads.to_request.pop_front();
         }
+    }
+
+    // Waiting for the oldest request that is still in flight.
+    start_timer(reads.window.retransmit_timeout_s(MIN_REQUEST_TIMEOUT_S, _system_impl.timeout_s()));
+}
+
+bool MavlinkFtpClient::request_answered(
+    PipelinedRequests& requests, uint32_t offset, std::optional<uint32_t> size_done)
+{
+    auto it = requests.in_flight.find(offset);
+    if (it == requests.in_flight.end()) {
+        return false;
+    }
+    const uint32_t size = size_done.value_or(it->second.size);
+    if (size > it->second.size) {
+        return false;
+    }
+
+    const auto sent_time = it->second.sent_time;
+    requests.window.on_answer(_time.elapsed_since_s(sent_time));
+
+    if (size < it->second.size) {
+        // Less than asked for, the rest needs to be requested again.
+        requests.to_request.push_front(
+            PipelinedRequests::Range{offset + size, it->second.size - size});
+    }
+    requests.in_flight.erase(it);
+
+    // Answers generally arrive in the order of the requests. Requests that
+    // have been overtaken a few times are most likely lost and are repeated
+    // without waiting for the timeout.
+    std::vector<PipelinedRequests::Range> lost;
+    for (auto other = requests.in_flight.begin(); other != requests.in_flight.end();) {
+        if (other->second.sent_time < sent_time &&
+            ++other->second.overtaken >= REQUEST_OVERTAKEN_LOST) {
+            lost.push_back(PipelinedRequests::Range{other->first, other->second.size});
+            requests.repeated_bytes += other->second.size;
+            other = requests.in_flight.erase(other);
+        } else {
+            ++other;
+        }
+    }
+    if (!lost.empty()) {
+        requests.window.on_loss();
+        requests.to_request.insert(requests.to_request.begin(), lost.begin(), lost.end());
+    }
+
+    return true;
+}
+
+void MavlinkFtpClient::requests_timed_out(PipelinedRequests& requests)
+{
+    if (requests.in_flight.empty()) {
+        return;
+    }
+
+    requests.window.on_loss();
+
+    // Everything still in flight is requested again first, in order.
+    for (auto it = requests.in_flight.rbegin(); it != requests.in_flight.rend(); ++it) {
+        requests.to_request.push_front(PipelinedRequests::Range{it->first, it->second.size});
+        requests.repeated_bytes += it->second.size;
+    }
+    requests.in_flight.clear();
+}
+
+bool MavlinkFtpClient::start_block_check(
+    BlockCheck& check,
+    const std::string& local_path,
+    const std::string& remote_path,
+    uint32_t end,
+    uint32_t size)
+{
+    check = BlockCheck{};
+    check.remote_path = remote_path;
+    check.end = end;
+    check.size = size;
+
+    // The block length goes after the path.
+    if (remote_path.length() + 1 + sizeof(uint32_t) > max_data_length) {
+        check.end = 0;
+    }
+
+    if (check.end > 0) {
+        std::ifstream ifstream(local_path, std::fstream::binary);
+        std::vector<char> buffer(CHECK_BLOCK_SIZE);
+        for (uint32_t offset = 0; offset < check.end; offset += CHECK_BLOCK_SIZE) {
+            const uint32_t block_size = std::min(CHECK_BLOCK_SIZE, check.end - offset);
+            ifstream.read(buffer.data(), block_size);
+            if (!ifstream) {
+                LogWarn() << "Could not read '" << local_path << "' to compare";
+                return false;
+            }
+
+            Crc32 crc;
+            crc.add(reinterpret_cast<const uint8_t*>(buffer.data()), block_size);
+            check.local_crcs[offset] = crc.get();
+            check.requests.to_request.push_back(PipelinedRequests::Range{offset, block_size});
+        }
+    }
+
+    check.active = true;
+    if (check.requests.to_request.empty()) {
+        block_check_finished(check);
+    }
+    return true;
+}
+
+void MavlinkFtpClient::request_block_crcs(Work& work, BlockCheck& check)
+{
+    auto& requests = check.requests;
+    work.last_opcode = CMD_CALC_FILE_CRC32;
 
-        // Final step
-        work.last_opcode = CMD_TERMINATE_SESSION;
+    // Servers without block checksums calculate the CRC of the whole file for
+    // every request, so only one block is asked for until the first answer
+    // shows that the server supports them.
+    const std::size_t max_in_flight = check.block_crcs_supported ? requests.window.size() : 1;
+
+    while (requests.in_flight.size() < max_in_flight && !requests.to_request.empty()) {
+        const auto block = requests.to_request.front();
+        requests.to_request.pop_front();
 
         work.payload = {};
         work.payload.seq_number = work.last_sent_seq_number++;
-        work.payload.session = _session;
-
+        work.payload.session = 0;
         work.payload.opcode = work.last_opcode;
-        work.payload.offset = 0;
-        work.payload.size = 0;
-
-        start_timer();
+        work.payload.offset = block.offset;
+        const size_t path_size = check.remote_path.length() + 1;
+        std::memcpy(work.payload.data, check.remote_path.c_str(), path_size);
+        std::memcpy(&work.payload.data[path_size], &block.size, sizeof(uint32_t));
+        work.payload.size = path_size + sizeof(uint32_t);
+
+        requests.in_flight[block.offset] =
+            PipelinedRequests::Request{block.size, _time.steady_time(), work.payload.seq_number};
         send_mavlink_ftp_message(work.payload);
     }
 
-    return true;
+    start_timer(
+        requests.window.retransmit_timeout_s(MIN_REQUEST_TIMEOUT_S, _system_impl.timeout_s()));
+}
+
+void MavlinkFtpClient::block_crc_answered(BlockCheck& check, const PayloadHeader& payload)
+{
+    auto& requests = check.requests;
+
+    if (payload.opcode != RSP_ACK || payload.size < 2 * sizeof(uint32_t)) {
+        // The server can only checksum whole files, so everything is transferred.
+        LogInfo() << "No block checksums from server, transferring the whole file";
+        for (const auto& request : requests.in_flight) {
+            check.different.push_back(
+                PipelinedRequests::Range{request.first, request.second.size});
+        }
+        check.different.insert(
+            check.different.end(), requests.to_request.begin(), requests.to_request.end());
+        requests.in_flight.clear();
+        requests.to_request.clear();
+        block_check_finished(check);
+        return;
+    }
+
+    auto it = requests.in_flight.find(payload.offset);
+    if (it == requests.in_flight.end()) {
+        return;
+    }
+    const PipelinedRequests::Range block{payload.offset, it->second.size};
+    if (!request_answered(requests, payload.offset)) {
+        return;
+    }
+
+    check.block_crcs_supported = true;
+
+    uint32_t remote_crc;
+    uint32_t remote_size;
+    std::memcpy(&remote_crc, payload.data, sizeof(uint32_t));
+    std::memcpy(&remote_size, &payload.data[sizeof(uint32_t)], sizeof(uint32_t));
+
+    if (remote_size == block.size && remote_crc == check.local_crcs[block.offset]) {
+        check.same.push_back(block);
+    } else {
+        check.different.push_back(block);
+    }
+
+    if (requests.to_request.empty() && requests.in_flight.empty()) {
+        block_check_finished(check);
+    }
+}
+
+void MavlinkFtpClient::block_check_finished(BlockCheck& check)
+{
+    std::sort(
+        check.different.begin(),
+        check.different.end(),
+        [](const PipelinedRequests::Range& lhs, const PipelinedRequests::Range& rhs) {
+            return lhs.offset < rhs.offset;
+        });
+    if (check.size > check.end) {
+        check.different.push_back(PipelinedRequests::Range{check.end, check.size - check.end});
+    }
+    check.active = false;
+}
+
+uint32_t MavlinkFtpClient::same_bytes(const BlockCheck& check)
+{
+    uint32_t bytes = 0;
+    for (const auto& block : check.same) {
+        bytes += block.size;
+    }
+    return bytes;
+}
+
+MavlinkFtpClient::ClientResult MavlinkFtpClient::truncate_local_file(
+    const std::string& path, uint32_t local_size, uint32_t size)
+{
+    // A file from an earlier download might have been longer.
+    if (local_size > size) {
+        std::error_code ec;
+        fs::resize_file(path, size, ec);
+        if (ec) {
+            LogWarn() << "Could not truncate '" << path << "': " << ec.message();
+            return ClientResult::FileIoError;
+        }
+    }
+    return ClientResult::Success;
 }
 
 bool MavlinkFtpClient::download_burst_start(Work& work, DownloadBurstItem& item)
@@ -471,13 +809,24 @@ bool MavlinkFtpClient::download_burst_start(Work& work, DownloadBurstItem& item)
         LogDebug() << "Trying to open write to local path: " << local_path.string();
     }
 
-    item.ofstream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    // What is there from an earlier download is kept, only what differs is fetched.
+    item.local_file_path = local_path.string();
+    std::error_code ec;
+    if (fs::is_regular_file(local_path, ec)) {
+        item.local_file_size = static_cast<uint32_t>(fs::file_size(local_path, ec));
+        item.ofstream.open(
+            local_path, std::fstream::in | std::fstream::out | std::fstream::binary);
+    } else {
+        item.ofstream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    }
     if (!item.ofstream) {
         LogErr() << "Could not open it!";
         item.callback(ClientResult::FileIoError, {});
         return false;
     }
 
+    item.start_time = _time.steady_time();
+
     work.last_opcode = CMD_OPEN_FILE_RO;
     work.payload = {};
     work.payload.seq_number = work.last_sent_seq_number++;
@@ -499,157 +848,165 @@ bool MavlinkFtpClient::download_burst_continue(
 {
     if (payload->req_opcode == CMD_OPEN_FILE_RO) {
         std::memcpy(&(item.file_size), payload->data, sizeof(uint32_t));
+        _session = payload->session;
 
         if (_debugging) {
             LogDebug() << "Burst Download continue, got file size: " << item.file_size;
         }
 
-        request_burst(work, item);
+        if (!start_block_check(
+                item.check,
+                item.local_file_path,
+                item.remote_path,
+                std::min(item.local_file_size, item.file_size),
+                item.file_size)) {
+            item.callback(ClientResult::FileIoError, {});
+            return false;
+        }
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        return download_burst_checked(work, item);
+    }
+
+    if (payload->req_opcode == CMD_CALC_FILE_CRC32) {
+        block_crc_answered(item.check, *payload);
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        return download_burst_checked(work, item);
+    }
 
-    } else if (payload->req_opcode == CMD_BURST_READ_FILE) {
+    if (payload->req_opcode == CMD_BURST_READ_FILE) {
         if (_debugging) {
             LogDebug() << "Burst download continue, at: " << std::to_string(payload->offset)
                        << " write: " << std::to_string(payload->size);
         }
 
-        if (payload->offset != item.current_offset) {
-            if (payload->offset < item.current_offset) {
-                // Not sure why this would happen but we don't know how to deal with it and ignore
-                // it.
-                LogWarn() << "Got payload offset: " << payload->offset
-                          << ", next offset: " << item.current_offset;
-                return false;
-            }
+        if (!item.burst_synced && payload->offset == item.burst_start_offset) {
+            item.burst_synced = true;
+        }
 
-            // we missed a part
-            item.missing_data.emplace_back(DownloadBurstItem::MissingData{
-                item.current_offset, payload->offset - item.current_offset});
-            // write some 0 instead
-            std::vector<char> empty(payload->offset - item.current_offset);
-            item.ofstream.write(empty.data(), empty.size());
-            if (!item.ofstream) {
-                LogWarn() << "Write failed";
-                item.callback(ClientResult::FileIoError, {});
-                download_burst_end(work);
-                return false;
+        if (item.burst_synced) {
+            if (payload->offset > item.current_offset) {
+                // We missed a part, it is fetched with reads while the burst goes on.
+                item.burst_missing_bytes +=
+                    queue_missing(item, item.current_offset, payload->offset);
             }
+            item.current_offset =
+                std::max(item.current_offset, payload->offset + uint32_t(payload->size));
         }
 
-        // Write actual data to file.
-        item.ofstream.write(reinterpret_cast<const char*>(payload->data), payload->size);
-        if (!item.ofstream) {
-            LogWarn() << "Write failed";
+        if (!write_burst_data(item, *payload)) {
             item.callback(ClientResult::FileIoError, {});
             download_burst_end(work);
             return false;
         }
 
-        // Keep track of what was written.
-        item.current_offset = payload->offset + payload->size;
-
-        if (_debugging) {
-            LogDebug() << "Received " << payload->offset << " to "
-                       << payload->size + payload->offset;
-        }
-
-        if (payload->size + payload->offset >= item.file_size) {
-            if (_debugging) {
-                LogDebug() << "Burst complete";
-            }
-
-            if (item.missing_data.empty()) {
-                // No missing data, we're done.
-
-                // Final step
-                download_burst_end(work);
-            } else {
-                // The burst is supposedly complete but we still need data because
-                // we missed some, so request next without burst.
-                request_next_rest(work, item);
-            }
-        } else {
-            item.callback(
-                ClientResult::Next,
-                ProgressData{
-                    static_cast<uint32_t>(burst_bytes_transferred(item)),
-                    static_cast<uint32_t>(item.file_size)});
-
-            if (payload->burst_complete) {
-                // This burst is complete but the file isn't. we need to start a
-                // new one
-                request_burst(work, item);
-            } else {
-                // There might be more coming, just wait for now.
-                start_timer();
-            }
-        }
     } else if (payload->req_opcode == CMD_READ_FILE) {
         if (_debugging) {
-            LogWarn() << "Burst download continue missing pieces, write at " << payload->offset
-                      << " for " << std::to_string(payload->size);
+            LogDebug() << "Burst download continue missing pieces, write at " << payload->offset
+                       << " for " << std::to_string(payload->size);
         }
 
-        item.ofstream.seekp(payload->offset);
-        if (item.ofstream.fail()) {
-            LogWarn() << "Seek failed";
-            item.callback(ClientResult::FileIoError, {});
-            download_burst_end(work);
-            return false;
+        if (!request_answered(item.reads, payload->offset, payload->size)) {
+            // A late answer to a request we have already repeated or given up on.
+            return true;
         }
 
-        item.ofstream.write(reinterpret_cast<const char*>(payload->data), payload->size);
-        if (!item.ofstream) {
+        if (!write_burst_data(item, *payload)) {
             item.callback(ClientResult::FileIoError, {});
             download_burst_end(work);
             return false;
         }
 
-        auto& missing = item.missing_data.front();
-        if (missing.offset != payload->offset) {
-            LogErr() << "Offset mismatch";
-            item.callback(ClientResult::ProtocolError, {});
-            download_burst_end(work);
-            return false;
-        }
+    } else {
+        LogErr() << "Unexpected req_opcode";
+        download_burst_end(work);
+        return false;
+    }
 
-        if (missing.size <= payload->size) {
-            // we got all needed data for this chunk
-            item.missing_data.pop_front();
-        } else {
-            missing.offset += payload->size;
-            missing.size -= payload->size;
-        }
+    if (_debugging) {
+        LogDebug() << "Written " << item.bytes_transferred << " of " << item.file_size << " bytes";
+    }
 
-        // Check if this was the last one
-        if (item.file_size == payload->offset + payload->size) {
-            item.current_offset = item.file_size;
+    if (item.bytes_transferred == item.file_size) {
+        if (_debugging) {
+            log_transfer_stats(
+                "Downloaded",
+                item.bytes_transferred,
+                item.start_time,
+                item.reads.repeated_bytes + item.reburst_bytes);
         }
+        download_burst_end(work);
+        return true;
+    }
 
-        const size_t bytes_transferred = burst_bytes_transferred(item);
-
+    item.callback(
+        ClientResult::Next,
+        transfer_progress(
+            item.bytes_transferred,
+            item.file_size,
+            item.start_time,
+            item.reads.repeated_bytes + item.reburst_bytes));
+
+    const uint32_t burst_covered = item.current_offset - item.burst_start_offset;
+    if (item.burst_synced && burst_covered >= BURST_LOSS_MIN_CHUNKS * max_data_length &&
+        item.burst_missing_bytes > BURST_LOSS_SPIKE * burst_covered) {
+        // Filling this many holes one read at a time is slower than
+        // streaming everything again from the first one.
+        const uint32_t first_hole =
+            (item.received.empty() || item.received.begin()->first != 0) ?
+                0 :
+                item.received.begin()->second;
         if (_debugging) {
-            LogDebug() << "Written " << bytes_transferred << " of " << item.file_size << " bytes";
+            LogDebug() << "Lost " << item.burst_missing_bytes << " of " << burst_covered
+                       << " bytes, restarting burst at " << first_hole;
         }
+        restart_burst(work, item, first_hole);
+        return true;
+    }
 
-        if (item.missing_data.empty() && bytes_transferred == item.file_size) {
-            // Final step
-            download_burst_end(work);
-        } else {
-            item.callback(
-                ClientResult::Next,
-                ProgressData{
-                    static_cast<uint32_t>(bytes_transferred),
-                    static_cast<uint32_t>(item.file_size)});
-
-            request_next_rest(work, item);
-        }
+    if (payload->req_opcode == CMD_BURST_READ_FILE && payload->burst_complete &&
+        item.current_offset < item.file_size) {
+        // This burst is complete but the file isn't, we need to start a new one.
+        request_burst(work, item);
+    }
 
+    if (!item.reads.to_request.empty() || !item.reads.in_flight.empty()) {
+        request_reads(work, item.reads);
     } else {
-        LogErr() << "Unexpected req_opcode";
+        // There might be more coming, just wait for now.
+        start_timer();
+    }
+
+    return true;
+}
+
+bool MavlinkFtpClient::download_burst_checked(Work& work, DownloadBurstItem& item)
+{
+    for (const auto& block : item.check.same) {
+        item.bytes_transferred +=
+            add_received(item.received, block.offset, block.offset + block.size);
+    }
+
+    if (item.bytes_transferred == item.file_size) {
+        if (_debugging) {
+            log_transfer_stats(
+                "Downloaded",
+                item.bytes_transferred,
+                item.start_time,
+                item.reads.repeated_bytes + item.reburst_bytes);
+        }
         download_burst_end(work);
-        return false;
+        return true;
     }
 
+    // The burst starts at the first block that differs and covers everything after.
+    item.current_offset = item.check.different.front().offset;
+    request_burst(work, item);
     return true;
 }
 
@@ -671,7 +1028,9 @@ void MavlinkFtpClient::download_burst_end(Work& work)
 
 void MavlinkFtpClient::request_burst(Work& work, DownloadBurstItem& item)
 {
-    UNUSED(item);
+    item.burst_synced = false;
+    item.burst_start_offset = item.current_offset;
+    item.burst_missing_bytes = 0;
 
     work.last_opcode = CMD_BURST_READ_FILE;
     work.payload = {};
@@ -687,37 +1046,150 @@ void MavlinkFtpClient::request_burst(Work& work, DownloadBurstItem& item)
     send_mavlink_ftp_message(work.payload);
 }
 
-void MavlinkFtpClient::request_next_rest(Work& work, DownloadBurstItem& item)
+void MavlinkFtpClient::restart_burst(Work& work, DownloadBurstItem& item, uint32_t offset)
 {
-    const auto& missing = item.missing_data.front();
-    size_t size = std::min(missing.size, size_t(max_data_length));
+    // The new burst covers all holes from offset on, so the reads for them are dropped.
+    // Any late answers are still written as they arrive.
+    if (item.current_offset > offset) {
+        item.reburst_bytes += item.current_offset - offset;
+    }
+    item.reads.to_request.clear();
+    item.reads.in_flight.clear();
 
-    if (_debugging) {
-        LogDebug() << "Re-requesting from " << missing.offset << " with size " << size;
+    item.current_offset = offset;
+    request_burst(work, item);
+}
+
+void MavlinkFtpClient::burst_timed_out(Work& work, DownloadBurstItem& item)
+{
+    requests_timed_out(item.reads);
+
+    if (!item.burst_synced) {
+        // The burst request or its first packet got lost.
+        request_burst(work, item);
+    } else if (item.current_offset < item.file_size) {
+        if (item.current_offset == item.offset_at_last_timeout) {
+            // The burst stopped short of the end, e.g. because we missed the last packets.
+            // The rest is fetched with reads unless it is big enough for another burst.
+            if (item.file_size - item.current_offset > MAX_REQUEST_WINDOW * max_data_length) {
+                restart_burst(work, item, item.current_offset);
+            } else {
+                queue_missing(item, item.current_offset, item.file_size);
+                item.current_offset = item.file_size;
+            }
+        }
+        item.offset_at_last_timeout = item.current_offset;
     }
 
-    work.last_opcode = CMD_READ_FILE;
-    work.payload = {};
-    work.payload.seq_number = work.last_sent_seq_number++;
-    work.payload.session = _session;
-    work.payload.opcode = work.last_opcode;
-    work.payload.offset = missing.offset;
+    if (!item.reads.to_request.empty() || !item.reads.in_flight.empty()) {
+        request_reads(work, item.reads);
+    } else {
+        start_timer();
+    }
+}
 
-    work.payload.size = size;
+bool MavlinkFtpClient::write_burst_data(DownloadBurstItem& item, const PayloadHeader& payload)
+{
+    if (payload.offset + payload.size > item.file_size) {
+        LogWarn() << "Got data past the end of the file";
+        return true;
+    }
 
-    start_timer();
-    send_mavlink_ftp_message(work.payload);
+    // Data arrives in any order and partly more than once, so it is written where it
+    // belongs and only new bytes are counted.
+    item.ofstream.seekp(payload.offset);
+    item.ofstream.write(reinterpret_cast<const char*>(payload.data), payload.size);
+    if (!item.ofstream) {
+        LogWarn() << "Write failed";
+        return false;
+    }
+
+    item.bytes_transferred +=
+        add_received(item.received, payload.offset, payload.offset + payload.size);
+    return true;
+}
+
+uint32_t MavlinkFtpClient::queue_missing(DownloadBurstItem& item, uint32_t start, uint32_t end)
+{
+    // Only what hasn't already arrived some other way, e.g. from an earlier burst.
+    uint32_t queued = 0;
+    auto it = item.received.upper_bound(start);
+    if (it != item.received.begin()) {
+        --it;
+    }
+    for (; it != item.received.end() && it->first < end && start < end; ++it) {
+        if (it->second <= start) {
+            continue;
+        }
+        if (it->first > start) {
+            item.reads.to_request.push_back(PipelinedRequests::Range{start, it->first - start});
+            queued += it->first - start;
+        }
+        start = it->second;
+    }
+    if (start < end) {
+        item.reads.to_request.push_back(PipelinedRequests::Range{start, end - start});
+        queued += end - start;
+    }
+
+    return queued;
+}
+
+uint32_t MavlinkFtpClient::add_received(
+    std::map<uint32_t, uint32_t>& received, uint32_t start, uint32_t end)
+{
+    if (start >= end) {
+        return 0;
+    }
+
+    auto it = received.upper_bound(start);
+    if (it != received.begin() && std::prev(it)->second >= start) {
+        --it;
+    }
+
+    // Merge with all ranges touching the new one, the bytes they already had don't count.
+    uint32_t added = end - start;
+    uint32_t merged_start = start;
+    uint32_t merged_end = end;
+    while (it != received.end() && it->first <= end) {
+        const uint32_t overlap_start = std::max(it->first, start);
+        const uint32_t overlap_end = std::min(it->second, end);
+        if (overlap_end > overlap_start) {
+            added -= overlap_end - overlap_start;
+        }
+        merged_start = std::min(merged_start, it->first);
+        merged_end = std::max(merged_end, it->second);
+        it = received.erase(it);
+    }
+    received[merged_start] = merged_end;
+
+    return added;
 }
 
-size_t MavlinkFtpClient::burst_bytes_transferred(DownloadBurstItem& item)
+MavlinkFtpClient::ProgressData MavlinkFtpClient::transfer_progress(
+    uint32_t bytes_transferred,
+    uint32_t total_bytes,
+    SteadyTimePoint start_time,
+    uint32_t retransmitted_bytes)
 {
-    return item.current_offset - std::accumulate(
-                                     item.missing_data.begin(),
-                                     item.missing_data.end(),
-                                     size_t(0),
-                                     [](size_t acc, const DownloadBurstItem::MissingData& missing) {
-                                         return acc + missing.size;
-                                     });
+    const double elapsed_s = _time.elapsed_since_s(start_time);
+
+    ProgressData progress{};
+    progress.bytes_transferred = bytes_transferred;
+    progress.total_bytes = total_bytes;
+    progress.bytes_per_second =
+        elapsed_s > 0.0 ? static_cast<uint32_t>(bytes_transferred / elapsed_s) : 0;
+    progress.retransmitted_bytes = retransmitted_bytes;
+    return progress;
+}
+
+void MavlinkFtpClient::log_transfer_stats(
+    const char* transfer, uint32_t bytes, SteadyTimePoint start_time, uint32_t repeated_bytes)
+{
+    const double elapsed_s = _time.elapsed_since_s(start_time);
+    LogDebug() << transfer << " " << bytes << " bytes in " << elapsed_s << " s ("
+               << (elapsed_s > 0.0 ? static_cast<uint32_t>(bytes / elapsed_s) : 0)
+               << " bytes/s), " << repeated_bytes << " bytes requested again";
 }
 
 bool MavlinkFtpClient::upload_start(Work& work, UploadItem& item)
@@ -748,8 +1220,25 @@ bool MavlinkFtpClient::upload_start(Work& work, UploadItem& item)
         item.callback(ClientResult::InvalidParameter, {});
         return false;
     }
+    item.remote_file_path = remote_file_path.string();
+
+    auto result_crc = calc_local_file_crc32(item.local_file_path, item.local_crc);
+    if (result_crc != ClientResult::Success) {
+        item.callback(result_crc, {});
+        return false;
+    }
+
+    item.start_time = _time.steady_time();
 
-    work.last_opcode = CMD_CREATE_FILE;
+    // An existing file is opened first, so that only what differs needs to be written.
+    upload_open(work, item, CMD_OPEN_FILE_WO);
+
+    return true;
+}
+
+void MavlinkFtpClient::upload_open(Work& work, UploadItem& item, Opcode opcode)
+{
+    work.last_opcode = opcode;
     work.payload = {};
     work.payload.seq_number = work.last_sent_seq_number++;
     work.payload.session = 0;
@@ -757,68 +1246,206 @@ bool MavlinkFtpClient::upload_start(Work& work, UploadItem& item)
     work.payload.offset = 0;
     strncpy(
         reinterpret_cast<char*>(work.payload.data),
-        remote_file_path.string().c_str(),
+        item.remote_file_path.c_str(),
         max_data_length - 1);
-    work.payload.size = remote_file_path.string().size() + 1;
+    work.payload.size = item.remote_file_path.size() + 1;
 
     start_timer();
     send_mavlink_ftp_message(work.payload);
-
-    return true;
 }
 
-bool MavlinkFtpClient::upload_continue(Work& work, UploadItem& item)
+bool MavlinkFtpClient::upload_continue(Work& work, UploadItem& item, PayloadHeader* payload)
 {
-    if (item.bytes_transferred < item.file_size) {
-        work.last_opcode = CMD_WRITE_FILE;
+    const auto file_size = static_cast<uint32_t>(item.file_size);
 
-        work.payload = {};
-        work.payload.seq_number = work.last_sent_seq_number++;
-        work.payload.session = _session;
-
-        work.payload.opcode = work.last_opcode;
-        work.payload.offset = item.bytes_transferred;
-
-        std::size_t bytes_to_read =
-            std::min(item.file_size - item.bytes_transferred, std::size_t(max_data_length));
+    if (payload->req_opcode == CMD_CREATE_FILE) {
+        _session = payload->session;
+        if (file_size > 0) {
+            item.writes.to_request.push_back(PipelinedRequests::Range{0, file_size});
+        }
 
-        item.ifstream.read(reinterpret_cast<char*>(work.payload.data), bytes_to_read);
+    } else if (payload->req_opcode == CMD_OPEN_FILE_WO) {
+        _session = payload->session;
+        uint32_t remote_file_size;
+        std::memcpy(&remote_file_size, payload->data, sizeof(uint32_t));
 
-        // Get the number of bytes actually read.
-        int bytes_read = item.ifstream.gcount();
+        if (remote_file_size > file_size) {
+            item.recreate = true;
+            upload_end(work);
+            return true;
+        }
 
-        if (!item.ifstream) {
+        if (!start_block_check(
+                item.check,
+                item.local_file_path,
+                item.remote_file_path,
+                remote_file_size,
+                file_size)) {
             item.callback(ClientResult::FileIoError, {});
             return false;
         }
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        item.writes.to_request = item.check.different;
 
-        work.payload.size = bytes_read;
-        item.bytes_transferred += bytes_read;
+    } else if (payload->req_opcode == CMD_CALC_FILE_CRC32) {
+        block_crc_answered(item.check, *payload);
+        if (item.check.active) {
+            request_block_crcs(work, item.check);
+            return true;
+        }
+        item.bytes_transferred = same_bytes(item.check);
+        item.writes.to_request = item.check.different;
 
-        start_timer();
-        send_mavlink_ftp_message(work.payload);
+        // Blocks that are the same already count as transferred.
+        item.callback(
+            ClientResult::Next,
+            transfer_progress(
+                static_cast<uint32_t>(item.bytes_transferred),
+                static_cast<uint32_t>(item.file_size),
+                item.start_time,
+                item.writes.repeated_bytes));
+
+    } else if (payload->req_opcode == CMD_WRITE_FILE) {
+        auto it = item.writes.in_flight.find(payload->offset);
+        if (it == item.writes.in_flight.end() ||
+            uint16_t(it->second.seq_number + 1) != payload->seq_number) {
+            // Older servers don't echo the offset of a write, so go by the sequence number.
+            it = std::find_if(
+                item.writes.in_flight.begin(), item.writes.in_flight.end(), [&](const auto& write) {
+                    return uint16_t(write.second.seq_number + 1) == payload->seq_number;
+                });
+        }
+        if (it == item.writes.in_flight.end()) {
+            // A late ack to a write we have already repeated.
+            return true;
+        }
+        const uint32_t size = it->second.size;
+        if (!request_answered(item.writes, it->first)) {
+            return true;
+        }
+        item.bytes_transferred += size;
 
-    } else {
-        // Final step
-        work.last_opcode = CMD_TERMINATE_SESSION;
+        if (_debugging) {
+            LogDebug() << "Written " << item.bytes_transferred << " of " << item.file_size
+                       << " bytes";
+        }
+
+        item.callback(
+            ClientResult::Next,
+            transfer_progress(
+                static_cast<uint32_t>(item.bytes_transferred),
+                static_cast<uint32_t>(item.file_size),
+                item.start_time,
+                item.writes.repeated_bytes));
+
+    } else if (payload->req_opcode == CMD_TERMINATE_SESSION) {
+        if (item.recreate) {
+            item.recreate = false;
+            upload_open(work, item, CMD_CREATE_FILE);
+        } else {
+            upload_verify(work, item);
+        }
+        return true;
+    }
+
+    if (!item.writes.to_request.empty() || !item.writes.in_flight.empty()) {
+        return request_writes(work, item);
+    }
+
+    if (_debugging) {
+        log_transfer_stats(
+            "Uploaded",
+            static_cast<uint32_t>(item.bytes_transferred),
+            item.start_time,
+            item.writes.repeated_bytes);
+    }
+    upload_end(work);
+    return true;
+}
+
+void MavlinkFtpClient::upload_end(Work& work)
+{
+    work.last_opcode = CMD_TERMINATE_SESSION;
+
+    work.payload = {};
+    work.payload.seq_number = work.last_sent_seq_number++;
+    work.payload.session = _session;
+
+    work.payload.opcode = work.last_opcode;
+    work.payload.offset = 0;
+    work.payload.size = 0;
+
+    start_timer();
+    send_mavlink_ftp_message(work.payload);
+}
+
+void MavlinkFtpClient::upload_verify(Work& work, UploadItem& item)
+{
+    // Acks only say that the chunks arrived, the checksum of the closed file
+    // tells whether they all ended up in the right place.
+    work.last_opcode = CMD_CALC_FILE_CRC32;
+    work.payload = {};
+    work.payload.seq_number = work.last_sent_seq_number++;
+    work.payload.session = 0;
+    work.payload.opcode = work.last_opcode;
+    work.payload.offset = 0;
+    strncpy(
+        reinterpret_cast<char*>(work.payload.data),
+        item.remote_file_path.c_str(),
+        max_data_length - 1);
+    work.payload.size = item.remote_file_path.length() + 1;
+
+    start_timer();
+    send_mavlink_ftp_message(work.payload);
+}
+
+bool MavlinkFtpClient::request_writes(Work& work, UploadItem& item)
+{
+    auto& writes = item.writes;
+    work.last_opcode = CMD_WRITE_FILE;
+
+    while (writes.in_flight.size() < writes.window.size() && !writes.to_request.empty()) {
+        auto& range = writes.to_request.front();
+        const uint32_t size = std::min(range.size, static_cast<uint32_t>(max_data_length));
 
         work.payload = {};
         work.payload.seq_number = work.last_sent_seq_number++;
         work.payload.session = _session;
-
         work.payload.opcode = work.last_opcode;
-        work.payload.offset = 0;
-        work.payload.size = 0;
+        work.payload.offset = range.offset;
 
-        start_timer();
+        // Chunks can be sent again later, so they are read where they are in the file.
+        item.ifstream.clear();
+        item.ifstream.seekg(range.offset);
+        item.ifstream.read(reinterpret_cast<char*>(work.payload.data), size);
+        if (!item.ifstream) {
+            item.callback(ClientResult::FileIoError, {});
+            return false;
+        }
+        work.payload.size = size;
+
+        if (_debugging) {
+            LogDebug() << "Write " << size << " bytes at " << range.offset << ", "
+                       << writes.in_flight.size() + 1 << " in flight";
+        }
+
+        writes.in_flight[range.offset] =
+            PipelinedRequests::Request{size, _time.steady_time(), work.payload.seq_number};
         send_mavlink_ftp_message(work.payload);
-    }
 
-    item.callback(
-        ClientResult::Next,
-        ProgressData{
-            static_cast<uint32_t>(item.bytes_transferred), static_cast<uint32_t>(item.file_size)});
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0) {
+            writes.to_request.pop_front();
+        }
+    }
 
+    // Waiting for the oldest write that is still unacked.
+    start_timer(
+        writes.window.retransmit_timeout_s(MIN_REQUEST_TIMEOUT_S, _system_impl.timeout_s()));
     return true;
 }
 
@@ -979,14 +1606,14 @@ bool MavlinkFtpClient::list_dir_continue(Work& work, ListDirItem& item, PayloadH
     }
 
     if (payload->size == 0) {
-        std::sort(item.dirs.begin(), item.dirs.end());
-        item.callback(ClientResult::Success, item.dirs);
+        list_dir_finished(item, ClientResult::Success);
         return false;
     }
 
     // Make sure there is a zero termination.
     payload->data[payload->size - 1] = '\0';
 
+    std::vector<DirectoryEntry> entries;
     size_t i = 0;
     while (i + 1 < payload->size) {
         const int entry_len = std::strlen(reinterpret_cast<char*>(&payload->data[i]));
@@ -1004,7 +1631,24 @@ bool MavlinkFtpClient::list_dir_continue(Work& work, ListDirItem& item, PayloadH
             continue;
         }
 
-        item.dirs.push_back(entry);
+        if (!item.entries_callback) {
+            item.dirs.push_back(entry);
+            continue;
+        }
+
+        // Files come as "F<name>\t<size>", directories as "D<name>".
+        DirectoryEntry directory_entry;
+        directory_entry.is_directory = entry[0] == 'D';
+        const auto tab = entry.find('\t');
+        directory_entry.name = entry.substr(1, tab == std::string::npos ? tab : tab - 1);
+        if (tab != std::string::npos) {
+            directory_entry.size = std::strtoul(entry.c_str() + tab + 1, nullptr, 10);
+        }
+        entries.push_back(std::move(directory_entry));
+    }
+
+    if (!entries.empty()) {
+        item.entries_callback(ClientResult::Next, entries);
     }
 
     work.last_opcode = CMD_LIST_DIRECTORY;
@@ -1022,6 +1666,21 @@ bool MavlinkFtpClient::list_dir_continue(Work& work, ListDirItem& item, PayloadH
     return true;
 }
 
+void MavlinkFtpClient::list_dir_finished(ListDirItem& item, ClientResult result)
+{
+    if (item.entries_callback) {
+        item.entries_callback(result, {});
+        return;
+    }
+
+    if (result == ClientResult::Success) {
+        std::sort(item.dirs.begin(), item.dirs.end());
+        item.callback(result, item.dirs);
+    } else {
+        item.callback(result, {});
+    }
+}
+
 MavlinkFtpClient::ClientResult MavlinkFtpClient::result_from_nak(PayloadHeader* payload)
 {
     ServerResult sr = static_cast<ServerResult>(payload->data[0]);
@@ -1103,6 +1762,233 @@ void MavlinkFtpClient::list_directory_async(const std::string& path, ListDirecto
     _work_queue.push_back(std::make_shared<Work>(std::move(new_work)));
 }
 
+void MavlinkFtpClient::list_directory_entries_async(
+    const std::string& path, ListEntriesCallback callback)
+{
+    auto item = ListDirItem{};
+    item.path = path;
+    item.entries_callback = callback;
+    auto new_work = Work{std::move(item)};
+
+    _work_queue.push_back(std::make_shared<Work>(std::move(new_work)));
+}
+
+void MavlinkFtpClient::mirror_directory_async(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    bool use_burst,
+    MirrorCallback callback)
+{
+    auto mirror = std::make_shared<Mirror>();
+    mirror->remote_dir = remote_dir;
+    mirror->local_dir = local_dir;
+    mirror->use_burst = use_burst;
+    mirror->callback = callback;
+    mirror->dirs.push_back("");
+
+    std::lock_guard<std::mutex> lock(_mirrors_mutex);
+    _mirrors.push_back(mirror);
+}
+
+void MavlinkFtpClient::continue_mirrors()
+{
+    // The callbacks of the queued work take the mirrors lock while the work
+    // queue is locked, so work is only queued once the lock is released.
+    std::vector<std::function<void()>> actions;
+
+    {
+        std::lock_guard<std::mutex> lock(_mirrors_mutex);
+
+        for (auto it = _mirrors.begin(); it != _mirrors.end();) {
+            auto mirror = *it;
+
+            if (mirror->result == ClientResult::Success && !mirror->listing &&
+                !mirror->dirs.empty()) {
+                const auto dir = mirror->dirs.front();
+                mirror->dirs.pop_front();
+                mirror->listing = true;
+                actions.emplace_back([this, mirror, dir]() {
+                    list_directory_entries_async(
+                        join_path(mirror->remote_dir, dir),
+                        [this, mirror, dir](ClientResult result, auto&& entries) {
+                            mirror_listed(*mirror, dir, result, entries);
+                        });
+                });
+            }
+
+            while (mirror->result == ClientResult::Success &&
+                   mirror->transfers < MAX_MIRROR_TRANSFERS &&
+                   (!mirror->downloads.empty() || !mirror->files.empty())) {
+                const bool checked = !mirror->downloads.empty();
+                auto& queue = checked ? mirror->downloads : mirror->files;
+                const auto file = queue.front();
+                queue.pop_front();
+
+                const auto remote_path = join_path(mirror->remote_dir, file.path);
+                const auto local_path = fs::path(mirror->local_dir) / fs::path(file.path);
+
+                if (!is_inside_directory(local_path, mirror->local_dir)) {
+                    LogErr() << "Refusing to write " << local_path.string() << " outside of "
+                             << mirror->local_dir;
+                    mirror->result = ClientResult::InvalidParameter;
+                    break;
+                }
+
+                std::error_code ec;
+                if (!checked && fs::is_regular_file(local_path, ec) &&
+                    fs::file_size(local_path, ec) == file.size) {
+                    // Same size, the checksum decides.
+                    ++mirror->transfers;
+                    actions.emplace_back([this, mirror, file, remote_path, local_path]() {
+                        are_files_identical_async(
+                            local_path.string(),
+                            remote_path,
+                            [this, mirror, file](ClientResult result, bool identical) {
+                                std::lock_guard<std::mutex> mirrors_lock(_mirrors_mutex);
+                                --mirror->transfers;
+                                if (result == ClientResult::Success && identical) {
+                                    ++mirror->progress.files_skipped;
+                                } else {
+                                    mirror->downloads.push_back(file);
+                                }
+                            });
+                    });
+                    continue;
+                }
+
+                fs::create_directories(local_path.parent_path(), ec);
+                if (ec) {
+                    LogErr() << "Could not create " << local_path.parent_path().string() << ": "
+                             << ec.message();
+                    mirror->result = ClientResult::FileIoError;
+                    break;
+                }
+
+                ++mirror->transfers;
+                actions.emplace_back([this, mirror, file, remote_path, local_path]() {
+                    download_async(
+                        remote_path,
+                        local_path.parent_path().string(),
+                        mirror->use_burst,
+                        [this, mirror, file](ClientResult result, ProgressData) {
+                            if (result == ClientResult::Next) {
+                                return;
+                            }
+                            std::lock_guard<std::mutex> mirrors_lock(_mirrors_mutex);
+                            if (result == ClientResult::Success) {
+                                ++mirror->progress.files_downloaded;
+                                mirror->progress.bytes_downloaded += file.size;
+                            }
+                            mirror_transfer_done(*mirror, result);
+                        });
+                });
+            }
+
+            const bool finished = !mirror->listing && mirror->transfers == 0 &&
+                                  (mirror->result != ClientResult::Success ||
+                                   (mirror->dirs.empty() && mirror->files.empty() &&
+                                    mirror->downloads.empty()));
+
+            const auto progress = mirror->progress;
+            const uint32_t files_done = progress.files_downloaded + progress.files_skipped;
+            if (finished) {
+                const auto result = mirror->result;
+                actions.emplace_back(
+                    [mirror, result, progress]() { mirror->callback(result, progress); });
+                it = _mirrors.erase(it);
+                continue;
+            }
+
+            if (files_done != mirror->files_reported) {
+                mirror->files_reported = files_done;
+                actions.emplace_back([mirror, progress]() {
+                    mirror->callback(ClientResult::Next, progress);
+                });
+            }
+            ++it;
+        }
+    }
+
+    for (auto& action : actions) {
+        action();
+    }
+}
+
+void MavlinkFtpClient::mirror_listed(
+    Mirror& mirror,
+    const std::string& dir,
+    ClientResult result,
+    const std::vector<DirectoryEntry>& entries)
+{
+    std::lock_guard<std::mutex> lock(_mirrors_mutex);
+
+    if (result != ClientResult::Next) {
+        mirror.listing = false;
+        if (result != ClientResult::Success && mirror.result == ClientResult::Success) {
+            mirror.result = result;
+        }
+        return;
+    }
+
+    // Files can be checked while the rest of the directory is still being listed.
+    for (const auto& entry : entries) {
+        if (entry.name == "." || entry.name == "..") {
+            continue;
+        }
+        // The names end up in local paths, so they must not lead outside of
+        // the directory being mirrored.
+        if (!is_single_path_component(entry.name)) {
+            LogErr() << "Invalid directory entry name: " << entry.name;
+            if (mirror.result == ClientResult::Success) {
+                mirror.result = ClientResult::ProtocolError;
+            }
+            return;
+        }
+        const auto path = join_path(dir, entry.name);
+        if (entry.is_directory) {
+            mirror.dirs.push_back(path);
+        } else {
+            mirror.files.push_back(Mirror::File{path, entry.size});
+            ++mirror.progress.files_found;
+        }
+    }
+}
+
+void MavlinkFtpClient::mirror_transfer_done(Mirror& mirror, ClientResult result)
+{
+    // Requires _mirrors_mutex
+    --mirror.transfers;
+    if (result != ClientResult::Success && mirror.result == ClientResult::Success) {
+        mirror.result = result;
+    }
+}
+
+std::string MavlinkFtpClient::join_path(const std::string& dir, const std::string& name)
+{
+    if (dir.empty()) {
+        return name;
+    }
+    if (name.empty()) {
+        return dir;
+    }
+    return dir.back() == '/' ? dir + name : dir + '/' + name;
+}
+
+bool MavlinkFtpClient::is_single_path_component(const std::string& name)
+{
+    if (name.empty() || name == "." || name == "..") {
+        return false;
+    }
+    // Backslashes are separators on Windows.
+    return name.find_first_of(std::string{"/\\\0", 3}) == std::string::npos;
+}
+
+bool MavlinkFtpClient::is_inside_directory(const fs::path& path, const fs::path& dir)
+{
+    const auto relative = path.lexically_normal().lexically_relative(dir.lexically_normal());
+    return !relative.empty() && *relative.begin() != ".." && *relative.begin() != ".";
+}
+
 void MavlinkFtpClient::create_directory_async(const std::string& path, ResultCallback callback)
 {
     auto item = CreateDirItem{};
@@ -1176,11 +2062,13 @@ void MavlinkFtpClient::send_mavlink_ftp_message(const PayloadHeader& payload)
     });
 }
 
-void MavlinkFtpClient::start_timer()
+void MavlinkFtpClient::start_timer(std::optional<double> duration_s)
 {
     _system_impl.unregister_timeout_handler(_timeout_cookie);
     _system_impl.register_timeout_handler(
-        [this]() { timeout(); }, _system_impl.timeout_s(), &_timeout_cookie);
+        [this]() { timeout(); },
+        duration_s ? duration_s.value() : _system_impl.timeout_s(),
+        &_timeout_cookie);
 }
 
 void MavlinkFtpClient::stop_timer()
@@ -1212,8 +2100,16 @@ void MavlinkFtpClient::timeout()
                     LogDebug() << "Retries left: " << work->retries;
                 }
 
-                start_timer();
-                send_mavlink_ftp_message(work->payload);
+                if (work->last_opcode == CMD_READ_FILE) {
+                    requests_timed_out(item.reads);
+                    request_reads(*work, item.reads);
+                } else if (item.check.active) {
+                    requests_timed_out(item.check.requests);
+                    request_block_crcs(*work, item.check);
+                } else {
+                    start_timer();
+                    send_mavlink_ftp_message(work->payload);
+                }
             },
             [&](DownloadBurstItem& item) {
                 if (--work->retries == 0) {
@@ -1225,37 +2121,15 @@ void MavlinkFtpClient::timeout()
                     LogDebug() << "Retries left: " << work->retries;
                 }
 
-                {
-                    // This happens when we missed the last ack containing burst complete.
-                    // We have already a file size, so we don't need to start at the
-                    // beginning any more.
-                    if (item.file_size != 0 && item.current_offset != 0) {
-                        // In that case start requesting what we missed.
-                        if (item.current_offset == item.file_size && item.missing_data.empty()) {
-                            // We are done anyway.
-                            item.callback(ClientResult::Success, {});
-                            download_burst_end(*work);
-                            work_queue_guard.pop_front();
-                        } else {
-                            // The burst is supposedly complete but we still need data because
-                            // we missed some, so request next without burst.
-                            // We presumably missed the very last chunk.
-                            if (item.current_offset < item.file_size) {
-                                item.missing_data.emplace_back(DownloadBurstItem::MissingData{
-                                    item.current_offset, item.file_size - item.current_offset});
-                                item.current_offset = item.file_size;
-                                if (_debugging) {
-                                    LogDebug() << "Adding " << item.current_offset << " with size "
-                                               << item.file_size - item.current_offset;
-                                }
-                            }
-                            request_next_rest(*work, item);
-                        }
-                    } else {
-                        // Otherwise, start burst again.
-                        start_timer();
-                        send_mavlink_ftp_message(work->payload);
-                    }
+                if (work->last_opcode == CMD_BURST_READ_FILE ||
+                    work->last_opcode == CMD_READ_FILE) {
+                    burst_timed_out(*work, item);
+                } else if (item.check.active) {
+                    requests_timed_out(item.check.requests);
+                    request_block_crcs(*work, item.check);
+                } else {
+                    start_timer();
+                    send_mavlink_ftp_message(work->payload);
                 }
             },
             [&](UploadItem& item) {
@@ -1268,8 +2142,18 @@ void MavlinkFtpClient::timeout()
                     LogDebug() << "Retries left: " << work->retries;
                 }
 
-                start_timer();
-                send_mavlink_ftp_message(work->payload);
+                if (work->last_opcode == CMD_WRITE_FILE) {
+                    requests_timed_out(item.writes);
+                    if (!request_writes(*work, item)) {
+                        work_queue_guard.pop_front();
+                    }
+                } else if (item.check.active) {
+                    requests_timed_out(item.check.requests);
+                    request_block_crcs(*work, item.check);
+                } else {
+                    start_timer();
+                    send_mavlink_ftp_message(work->payload);
+                }
             },
             [&](RemoveItem& item) {
                 if (--work->retries == 0) {
@@ -1338,7 +2222,7 @@ void MavlinkFtpClient::timeout()
             },
             [&](ListDirItem& item) {
                 if (--work->retries == 0) {
-                    item.callback(ClientResult::Timeout, {});
+                    list_dir_finished(item, ClientResult::Timeout);
                     work_queue_guard.pop_front();
                     return;
                 }
@@ -4,6 +4,9 @@
 #include <functional>
 #include <fstream>
 #include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <optional>
@@ -13,7 +16,9 @@
 #include <vector>
 
 #include "mavlink_include.h"
+#include "mavsdk_time.h"
 #include "locked_queue.h"
+#include "request_window.h"
 
 // As found in
 // https://stackoverflow.com/questions/1537964#answer-3312896
@@ -56,13 +61,30 @@ public:
     struct ProgressData {
         uint32_t bytes_transferred{}; /**< @brief The number of bytes already transferred. */
         uint32_t total_bytes{}; /**< @brief The total bytes to transfer. */
+        uint32_t bytes_per_second{}; /**< @brief Average throughput since the start. */
+        uint32_t retransmitted_bytes{}; /**< @brief Bytes requested or sent again after loss. */
+    };
+
+    struct DirectoryEntry {
+        std::string name{};
+        bool is_directory{false};
+        uint32_t size{0}; // Only known for files.
+    };
+
+    struct MirrorProgress {
+        uint32_t files_found{}; /**< @brief Files found below the directory so far. */
+        uint32_t files_downloaded{}; /**< @brief Files downloaded because they differed. */
+        uint32_t files_skipped{}; /**< @brief Files skipped because they were the same. */
+        uint64_t bytes_downloaded{}; /**< @brief Size of the files downloaded. */
     };
 
     using ResultCallback = std::function<void(ClientResult)>;
     using UploadCallback = std::function<void(ClientResult, ProgressData)>;
     using DownloadCallback = std::function<void(ClientResult, ProgressData)>;
     using ListDirectoryCallback = std::function<void(ClientResult, std::vector<std::string>)>;
+    using ListEntriesCallback = std::function<void(ClientResult, std::vector<DirectoryEntry>)>;
     using AreFilesIdenticalCallback = std::function<void(ClientResult, bool)>;
+    using MirrorCallback = std::function<void(ClientResult, MirrorProgress)>;
 
     void do_work();
 
@@ -77,6 +99,15 @@ public:
         const std::string& remote_folder,
         UploadCallback callback);
     void list_directory_async(const std::string& path, ListDirectoryCallback callback);
+    // Entries are passed on with Next page by page as they arrive, Success ends the list.
+    void list_directory_entries_async(const std::string& path, ListEntriesCallback callback);
+    // Downloads all files below remote_dir into local_dir, except for those
+    // that are there already with the same size and CRC32.
+    void mirror_directory_async(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        bool use_burst,
+        MirrorCallback callback);
     void create_directory_async(const std::string& path, ResultCallback callback);
     void remove_directory_async(const std::string& path, ResultCallback callback);
     void remove_file_async(const std::string& path, ResultCallback callback);
@@ -94,6 +125,22 @@ public:
 private:
     static constexpr unsigned RETRIES = 10;
 
+    static constexpr unsigned MAX_REQUEST_WINDOW = 16;
+    static constexpr double MIN_REQUEST_TIMEOUT_S = 0.05;
+    // Answers to later requests after which a request counts as lost.
+    static constexpr unsigned REQUEST_OVERTAKEN_LOST = 3;
+    // Share of a burst lost after which the burst is restarted at the first hole,
+    // judged once at least BURST_LOSS_MIN_CHUNKS chunks have been covered.
+    static constexpr double BURST_LOSS_SPIKE = 0.5;
+    static constexpr unsigned BURST_LOSS_MIN_CHUNKS = 32;
+
+    // Size of the blocks compared by CRC32 before transferring a file that is
+    // already partly there.
+    static constexpr uint32_t CHECK_BLOCK_SIZE = 32 * 1024;
+
+    // Checks and downloads a mirror keeps queued at a time.
+    static constexpr unsigned MAX_MIRROR_TRANSFERS = 4;
+
     /// @brief Maximum data size in RequestHeader::data
     static constexpr uint8_t max_data_length = 239;
 
@@ -137,6 +184,40 @@ private:
         RSP_NAK ///< Nak response
     };
 
+    // Several CMD_READ_FILE or CMD_WRITE_FILE requests in flight at different
+    // offsets, so that a transfer is not limited to one chunk per round trip.
+    struct PipelinedRequests {
+        struct Range {
+            uint32_t offset;
+            uint32_t size;
+        };
+        struct Request {
+            uint32_t size;
+            SteadyTimePoint sent_time;
+            uint16_t seq_number{0};
+            unsigned overtaken{0};
+        };
+        std::deque<Range> to_request{};
+        std::map<uint32_t, Request> in_flight{}; // by offset
+        RequestWindow window{MAX_REQUEST_WINDOW};
+        uint32_t repeated_bytes{0};
+    };
+
+    // Compares the blocks of a file that is already partly there on both ends
+    // by CRC32, so that only the blocks that differ need to be transferred.
+    // This uses CMD_CALC_FILE_CRC32 with a block length after the path.
+    struct BlockCheck {
+        std::string remote_path{};
+        std::map<uint32_t, uint32_t> local_crcs{}; // by offset
+        PipelinedRequests requests{};
+        std::vector<PipelinedRequests::Range> same{};
+        std::deque<PipelinedRequests::Range> different{}; // including anything past end
+        uint32_t end{0};
+        uint32_t size{0};
+        bool active{false};
+        bool block_crcs_supported{false}; // known once the first block is answered
+    };
+
     struct DownloadItem {
         std::string remote_path{};
         std::string local_folder{};
@@ -145,30 +226,53 @@ private:
         std::size_t file_size{0};
         std::size_t bytes_transferred{0};
         int last_progress_percentage{-1};
+        PipelinedRequests reads{};
+        SteadyTimePoint start_time{};
+        std::string local_file_path{};
+        uint32_t local_file_size{0};
+        BlockCheck check{};
     };
 
+    // The burst streams the file while the holes it leaves are filled in
+    // parallel with pipelined reads.
     struct DownloadBurstItem {
         std::string remote_path{};
         std::string local_folder{};
         DownloadCallback callback{};
         std::ofstream ofstream{};
         uint32_t file_size{0};
-        struct MissingData {
-            size_t offset;
-            size_t size;
-        };
-        std::deque<MissingData> missing_data{};
-        size_t current_offset{0};
+        std::map<uint32_t, uint32_t> received{}; // start to end, merged
+        uint32_t bytes_transferred{0};
+        // Offset up to which the current burst has got.
+        uint32_t current_offset{0};
+        uint32_t burst_start_offset{0};
+        uint32_t burst_missing_bytes{0};
+        // Until the first packet of a new burst, packets may still be from the last one.
+        bool burst_synced{false};
+        uint32_t offset_at_last_timeout{0};
+        uint32_t reburst_bytes{0};
+        PipelinedRequests reads{};
+        SteadyTimePoint start_time{};
+        std::string local_file_path{};
+        uint32_t local_file_size{0};
+        BlockCheck check{};
     };
 
     struct UploadItem {
         std::string local_file_path{};
         std::string remote_folder{};
+        std::string remote_file_path{};
         UploadCallback callback{};
         std::ifstream ifstream{};
         std::size_t file_size{0};
         std::size_t bytes_transferred{0};
         int last_progress_percentage{-1};
+        uint32_t local_crc{};
+        PipelinedRequests writes{};
+        SteadyTimePoint start_time{};
+        BlockCheck check{};
+        // The remote file is longer and can only be shortened by creating it anew.
+        bool recreate{false};
     };
 
     struct RemoveItem {
@@ -202,10 +306,34 @@ private:
     struct ListDirItem {
         std::string path{};
         ListDirectoryCallback callback{};
+        // If set, entries are streamed to this one instead.
+        ListEntriesCallback entries_callback{};
         uint32_t offset{0};
         std::vector<std::string> dirs{};
     };
 
+    // A mirror is not a work item itself, it queues listings, checks and
+    // downloads from do_work as earlier ones finish.
+    struct Mirror {
+        struct File {
+            std::string path{}; // relative to remote_dir and local_dir
+            uint32_t size{0};
+        };
+
+        std::string remote_dir{};
+        std::string local_dir{};
+        bool use_burst{false};
+        MirrorCallback callback{};
+        std::deque<std::string> dirs{}; // still to list
+        bool listing{false};
+        std::deque<File> files{}; // still to check
+        std::deque<File> downloads{}; // checked and different
+        unsigned transfers{0};
+        MirrorProgress progress{};
+        uint32_t files_reported{0};
+        ClientResult result{ClientResult::Success};
+    };
+
     using Item = std::variant<
         DownloadItem,
         DownloadBurstItem,
@@ -267,16 +395,54 @@ private:
 
     bool download_start(Work& work, DownloadItem& item);
     bool download_continue(Work& work, DownloadItem& item, PayloadHeader* payload);
+    void download_end(Work& work);
+
+    void request_reads(Work& work, PipelinedRequests& reads);
+    [[nodiscard]] bool request_answered(
+        PipelinedRequests& requests, uint32_t offset, std::optional<uint32_t> size_done = {});
+    void requests_timed_out(PipelinedRequests& requests);
 
     bool download_burst_start(Work& work, DownloadBurstItem& item);
     bool download_burst_continue(Work& work, DownloadBurstItem& item, PayloadHeader* payload);
+    bool download_burst_checked(Work& work, DownloadBurstItem& item);
     void download_burst_end(Work& work);
     void request_burst(Work& work, DownloadBurstItem& item);
-    void request_next_rest(Work& work, DownloadBurstItem& item);
-    size_t burst_bytes_transferred(DownloadBurstItem& item);
+    void restart_burst(Work& work, DownloadBurstItem& item, uint32_t offset);
+    void burst_timed_out(Work& work, DownloadBurstItem& item);
+    [[nodiscard]] bool write_burst_data(DownloadBurstItem& item, const PayloadHeader& payload);
+    uint32_t queue_missing(DownloadBurstItem& item, uint32_t start, uint32_t end);
+
+    ProgressData transfer_progress(
+        uint32_t bytes_transferred,
+        uint32_t total_bytes,
+        SteadyTimePoint start_time,
+        uint32_t retransmitted_bytes);
+
+    void log_transfer_stats(
+        const char* transfer, uint32_t bytes, SteadyTimePoint start_time, uint32_t repeated_bytes);
+
+    static uint32_t
+    add_received(std::map<uint32_t, uint32_t>& received, uint32_t start, uint32_t end);
+
+    [[nodiscard]] bool start_block_check(
+        BlockCheck& check,
+        const std::string& local_path,
+        const std::string& remote_path,
+        uint32_t end,
+        uint32_t size);
+    void request_block_crcs(Work& work, BlockCheck& check);
+    void block_crc_answered(BlockCheck& check, const PayloadHeader& payload);
+    static void block_check_finished(BlockCheck& check);
+    static uint32_t same_bytes(const BlockCheck& check);
+    static ClientResult
+    truncate_local_file(const std::string& path, uint32_t local_size, uint32_t size);
 
     bool upload_start(Work& work, UploadItem& item);
-    bool upload_continue(Work& work, UploadItem& item);
+    void upload_open(Work& work, UploadItem& item, Opcode opcode);
+    bool upload_continue(Work& work, UploadItem& item, PayloadHeader* payload);
+    void upload_end(Work& work);
+    void upload_verify(Work& work, UploadItem& item);
+    bool request_writes(Work& work, UploadItem& item);
 
     bool remove_start(Work& work, RemoveItem& item);
 
@@ -290,11 +456,24 @@ private:
 
     bool list_dir_start(Work& work, ListDirItem& item);
     bool list_dir_continue(Work& work, ListDirItem& item, PayloadHeader* payload);
+    static void list_dir_finished(ListDirItem& item, ClientResult result);
+
+    void continue_mirrors();
+    void mirror_listed(
+        Mirror& mirror,
+        const std::string& dir,
+        ClientResult result,
+        const std::vector<DirectoryEntry>& entries);
+    void mirror_transfer_done(Mirror& mirror, ClientResult result);
+    static std::string join_path(const std::string& dir, const std::string& name);
+    static bool is_single_path_component(const std::string& name);
+    static bool
+    is_inside_directory(const std::filesystem::path& path, const std::filesystem::path& dir);
 
     static ClientResult result_from_nak(PayloadHeader* payload);
 
     void timeout();
-    void start_timer();
+    void start_timer(std::optional<double> duration_s = {});
     void stop_timer();
 
     ClientResult calc_local_file_crc32(const std::string& path, uint32_t& csum);
@@ -315,8 +494,13 @@ private:
 
     void* _timeout_cookie = nullptr;
 
+    Time _time{};
+
     LockedQueue<Work> _work_queue{};
 
+    std::mutex _mirrors_mutex{};
+    std::vector<std::shared_ptr<Mirror>> _mirrors{};
+
     bool _debugging{false};
 };
 
@@ -2,11 +2,13 @@
 #include <fstream>
 #include <filesystem>
 #include <future>
+#include <limits>
 
 #include "mavlink_ftp_server.h"
 #include "server_component_impl.h"
 #include "unused.h"
 #include "crc32.h"
+#include "file_io.h"
 
 namespace mavsdk {
 
@@ -192,11 +194,24 @@ MavlinkFtpServer::~MavlinkFtpServer()
 {
     _server_component_impl.unregister_all_mavlink_message_handlers(this);
 
-    std::lock_guard<std::mutex> lock(_mutex);
-    _reset();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _burst_stop = true;
+        _reset();
+    }
+    _burst_cv.notify_all();
+    if (_burst_thread.joinable()) {
+        _burst_thread.join();
+    }
 }
 
 void MavlinkFtpServer::_send_mavlink_ftp_message(const PayloadHeader& payload)
+{
+    _send_mavlink_ftp_message(payload, _target_system_id, _target_component_id);
+}
+
+void MavlinkFtpServer::_send_mavlink_ftp_message(
+    const PayloadHeader& payload, uint8_t target_system_id, uint8_t target_component_id)
 {
     if (uint8_t(payload.opcode) == 0) {
         abort();
@@ -210,8 +225,8 @@ void MavlinkFtpServer::_send_mavlink_ftp_message(const PayloadHeader& payload)
             channel,
             &message,
             _network_id,
-            _target_system_id,
-            _target_component_id,
+            target_system_id,
+            target_component_id,
             reinterpret_cast<const uint8_t*>(&payload));
         return message;
     });
@@ -413,9 +428,6 @@ void MavlinkFtpServer::_work_open_file_readonly(const PayloadHeader& payload)
     response.req_opcode = payload.opcode;
 
     std::lock_guard<std::mutex> lock(_mutex);
-    if (_session_info.ifstream.is_open()) {
-        _reset();
-    }
 
     std::string path;
     {
@@ -463,34 +475,25 @@ void MavlinkFtpServer::_work_open_file_readonly(const PayloadHeader& payload)
         return;
     }
 
-    auto file_size = static_cast<uint32_t>(fs::file_size(path, ec));
-    if (ec) {
-        LogErr() << "Could not determine file size of '" << path << "': " << ec.message();
-        return;
-    }
-
-    if (_debugging) {
-        LogDebug() << "Determined filesize to be: " << file_size << " bytes";
-    }
-
-    std::ifstream ifstream;
-    ifstream.open(path, std::ios::in | std::ios::binary);
-
-    if (!ifstream.is_open()) {
+    auto maybe_session = _open_session(path, OpenMode::Read);
+    if (std::holds_alternative<ServerResult>(maybe_session)) {
         LogWarn() << "FTP: Open failed";
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
+        response.data[0] = std::get<ServerResult>(maybe_session);
         _send_mavlink_ftp_message(response);
         return;
     }
 
-    _session_info.ifstream = std::move(ifstream);
-    _session_info.file_size = file_size;
+    const auto session = std::get<uint8_t>(maybe_session);
+    const uint32_t file_size = _sessions[session].file_size;
+
+    if (_debugging) {
+        LogDebug() << "Determined filesize to be: " << file_size << " bytes";
+    }
 
     response.opcode = Opcode::RSP_ACK;
-    response.session = 0;
-    response.seq_number = payload.seq_number + 1;
+    response.session = session;
     response.size = sizeof(uint32_t);
     std::memcpy(response.data, &file_size, response.size);
 
@@ -505,10 +508,6 @@ void MavlinkFtpServer::_work_open_file_writeonly(const PayloadHeader& payload)
 
     std::lock_guard<std::mutex> lock(_mutex);
 
-    if (_session_info.ofstream.is_open()) {
-        _reset();
-    }
-
     std::string path;
     {
         std::lock_guard<std::mutex> tmp_lock(_tmp_files_mutex);
@@ -564,33 +563,26 @@ void MavlinkFtpServer::_work_open_file_writeonly(const PayloadHeader& payload)
         return;
     }
 
-    auto file_size = static_cast<uint32_t>(fs::file_size(path, ec));
-    if (ec) {
-        LogErr() << "Could not determine file size of '" << path << "': " << ec.message();
-        return;
-    }
-
-    if (_debugging) {
-        LogDebug() << "Determined filesize to be: " << file_size << " bytes";
-    }
-
-    std::ofstream ofstream;
-    ofstream.open(path, std::ios::out | std::ios::binary);
-
-    if (!ofstream.is_open()) {
+    // Keep what is there, the client might only write parts of it.
+    auto maybe_session = _open_session(path, OpenMode::Write);
+    if (std::holds_alternative<ServerResult>(maybe_session)) {
         LogWarn() << "FTP: Open failed";
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
+        response.data[0] = std::get<ServerResult>(maybe_session);
         _send_mavlink_ftp_message(response);
         return;
     }
 
-    _session_info.ofstream = std::move(ofstream);
-    _session_info.file_size = file_size;
+    const auto session = std::get<uint8_t>(maybe_session);
+    const uint32_t file_size = _sessions[session].file_size;
+
+    if (_debugging) {
+        LogDebug() << "Determined filesize to be: " << file_size << " bytes";
+    }
 
     response.opcode = Opcode::RSP_ACK;
-    response.session = 0;
+    response.session = session;
     response.size = sizeof(uint32_t);
     std::memcpy(response.data, &file_size, response.size);
 
@@ -604,9 +596,6 @@ void MavlinkFtpServer::_work_create_file(const PayloadHeader& payload)
     response.req_opcode = payload.opcode;
 
     std::lock_guard<std::mutex> lock(_mutex);
-    if (_session_info.ofstream.is_open()) {
-        _reset();
-    }
 
     std::string path;
     {
@@ -652,22 +641,17 @@ void MavlinkFtpServer::_work_create_file(const PayloadHeader& payload)
         LogDebug() << "Creating file: " << path;
     }
 
-    std::ofstream ofstream;
-    ofstream.open(path, std::ios::out | std::ios::binary);
-
-    if (!ofstream.is_open()) {
+    auto maybe_session = _open_session(path, OpenMode::Create);
+    if (std::holds_alternative<ServerResult>(maybe_session)) {
         LogWarn() << "FTP: Open failed";
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
+        response.data[0] = std::get<ServerResult>(maybe_session);
         _send_mavlink_ftp_message(response);
         return;
     }
 
-    _session_info.ofstream = std::move(ofstream);
-    _session_info.file_size = 0;
-
-    response.session = 0;
+    response.session = std::get<uint8_t>(maybe_session);
     response.size = 0;
     response.opcode = Opcode::RSP_ACK;
 
@@ -681,12 +665,17 @@ void MavlinkFtpServer::_work_read(const PayloadHeader& payload)
     response.req_opcode = payload.opcode;
 
     std::lock_guard<std::mutex> lock(_mutex);
-    if (payload.session != 0 || !_session_info.ifstream.is_open()) {
-        _reset();
+    auto* session = _session(payload);
+    if (session == nullptr || session->writable) {
+        response.opcode = Opcode::RSP_NAK;
+        response.size = 1;
+        response.data[0] = ServerResult::ERR_INVALID_SESSION;
+        _send_mavlink_ftp_message(response);
+        return;
     }
 
     // We have to test seek past EOF ourselves, lseek will allow seek past EOF
-    if (payload.offset >= _session_info.file_size) {
+    if (payload.offset >= session->file_size) {
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
         response.data[0] = ServerResult::ERR_EOF;
@@ -697,23 +686,12 @@ void MavlinkFtpServer::_work_read(const PayloadHeader& payload)
         return;
     }
 
-    _session_info.ifstream.seekg(payload.offset);
-    if (_session_info.ifstream.fail()) {
-        response.opcode = Opcode::RSP_NAK;
-        response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
-        LogWarn() << "Seek failed";
-        _send_mavlink_ftp_message(response);
-        return;
-    }
-
     if (_debugging) {
         LogWarn() << "Read at " << payload.offset << " for " << int(payload.size);
     }
 
-    _session_info.ifstream.read(reinterpret_cast<char*>(response.data), payload.size);
-
-    if (_session_info.ifstream.fail()) {
+    const int bytes_read = read_at(session->fd, response.data, payload.size, payload.offset);
+    if (bytes_read < 0) {
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
         response.data[0] = ServerResult::ERR_FAIL;
@@ -722,8 +700,6 @@ void MavlinkFtpServer::_work_read(const PayloadHeader& payload)
         return;
     }
 
-    const uint32_t bytes_read = _session_info.ifstream.gcount();
-
     response.offset = payload.offset;
     response.size = bytes_read;
     response.opcode = Opcode::RSP_ACK;
@@ -737,12 +713,18 @@ void MavlinkFtpServer::_work_burst(const PayloadHeader& payload)
     response.req_opcode = payload.opcode;
 
     std::lock_guard<std::mutex> lock(_mutex);
-    if (payload.session != 0 || !_session_info.ifstream.is_open()) {
-        _reset();
+    auto* session = _session(payload);
+    if (session == nullptr || session->writable) {
+        response.seq_number = payload.seq_number + 1;
+        response.opcode = Opcode::RSP_NAK;
+        response.size = 1;
+        response.data[0] = ServerResult::ERR_INVALID_SESSION;
+        _send_mavlink_ftp_message(response);
+        return;
     }
 
     // We have to test seek past EOF ourselves, lseek will allow seek past EOF
-    if (payload.offset >= _session_info.file_size) {
+    if (payload.offset >= session->file_size) {
         response.seq_number = payload.seq_number + 1;
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
@@ -755,92 +737,206 @@ void MavlinkFtpServer::_work_burst(const PayloadHeader& payload)
     }
 
     if (_debugging) {
-        LogDebug() << "Seek to " << payload.offset;
-    }
-    _session_info.ifstream.seekg(payload.offset);
-    if (_session_info.ifstream.fail()) {
-        response.seq_number = payload.seq_number + 1;
-        response.opcode = Opcode::RSP_NAK;
-        response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
-        LogErr() << "Seek failed";
-        _send_mavlink_ftp_message(response);
-        return;
+        LogDebug() << "Burst from " << payload.offset;
     }
 
-    _session_info.burst_offset = payload.offset;
-    _session_info.burst_chunk_size = payload.size;
-    _burst_seq = payload.seq_number + 1;
+    // A new burst on the same session replaces the previous one. It might be
+    // for a file that changed, so read it again.
+    session->read_ahead.clear();
+    session->burst_active = true;
+    session->burst_offset = payload.offset;
+    session->burst_chunk_size = payload.size;
+    session->burst_seq = payload.seq_number + 1;
+    session->target_system_id = _target_system_id;
+    session->target_component_id = _target_component_id;
 
-    if (_session_info.burst_thread.joinable()) {
-        _session_info.burst_stop = true;
-        _session_info.burst_thread.join();
+    if (!_burst_thread.joinable()) {
+        _burst_thread = std::thread([this]() { _burst_loop(); });
     }
+    _burst_cv.notify_one();
 
-    _session_info.burst_stop = false;
-
-    // Schedule sending out burst messages.
-    _session_info.burst_thread = std::thread([this]() {
-        while (!_session_info.burst_stop)
-            if (_send_burst_packet())
-                break;
-    });
+    // Don't send response as that's done in the burst loop.
+}
 
-    // Don't send response as that's done in the call every burst call above.
+void MavlinkFtpServer::set_burst_rate(double bytes_per_second)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _burst_rate = std::max(bytes_per_second, 0.0);
+    _burst_budget = 0.0;
+    _last_burst_budget_time = std::chrono::steady_clock::now();
+    _burst_cv.notify_one();
 }
 
-// Returns true if sending is complete
-bool MavlinkFtpServer::_send_burst_packet()
+MavlinkFtpServer::BurstStats MavlinkFtpServer::burst_stats()
 {
     std::lock_guard<std::mutex> lock(_mutex);
-    if (!_session_info.ifstream.is_open()) {
-        return false;
+    return _burst_stats;
+}
+
+void MavlinkFtpServer::_burst_loop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _burst_window_start = std::chrono::steady_clock::now();
+    while (!_burst_stop) {
+        if (!_wait_for_burst_budget(lock)) {
+            continue;
+        }
+
+        auto* session = _next_burst_session();
+        if (session == nullptr) {
+            _update_burst_throughput(true);
+            _burst_cv.wait(lock);
+            _burst_window_start = std::chrono::steady_clock::now();
+            _burst_window_bytes = 0;
+            _burst_window_full = false;
+            continue;
+        }
+
+        PayloadHeader burst_packet{};
+        burst_packet.req_opcode = Opcode::CMD_BURST_READ_FILE;
+        burst_packet.seq_number = session->burst_seq++;
+
+        _make_burst_packet(*session, burst_packet);
+        _account_burst_packet(burst_packet);
+
+        const auto target_system_id = session->target_system_id;
+        const auto target_component_id = session->target_component_id;
+
+        // Let requests in while the packet is queued.
+        lock.unlock();
+        _send_mavlink_ftp_message(burst_packet, target_system_id, target_component_id);
+        std::this_thread::yield();
+        lock.lock();
     }
+}
 
-    PayloadHeader burst_packet{};
-    burst_packet.req_opcode = Opcode::CMD_BURST_READ_FILE;
-    burst_packet.seq_number = _burst_seq++;
+bool MavlinkFtpServer::_wait_for_burst_budget(std::unique_lock<std::mutex>& lock)
+{
+    // Requires lock
 
-    _make_burst_packet(burst_packet);
+    if (_burst_rate <= 0.0) {
+        return true;
+    }
 
-    _send_mavlink_ftp_message(burst_packet);
+    // The budget only grows up to a short burst, so an idle link doesn't save
+    // up for a flood that the radio would have to drop.
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed_s = std::chrono::duration<double>(now - _last_burst_budget_time).count();
+    _last_burst_budget_time = now;
+    _burst_budget = std::min(
+        _burst_budget + elapsed_s * _burst_rate,
+        std::max(static_cast<double>(sizeof(PayloadHeader)), _burst_rate * MAX_BURST_BUDGET_S));
 
-    if (burst_packet.burst_complete == 1) {
+    if (_burst_budget >= 0.0) {
         return true;
     }
 
+    // Requests, new bursts and the destructor can wake us up early.
+    _burst_cv.wait_for(lock, std::chrono::duration<double>(-_burst_budget / _burst_rate));
     return false;
 }
 
-void MavlinkFtpServer::_make_burst_packet(PayloadHeader& packet)
+void MavlinkFtpServer::_account_burst_packet(const PayloadHeader& packet)
 {
-    uint32_t bytes_to_read = std::min(
-        static_cast<uint32_t>(_session_info.burst_chunk_size),
-        _session_info.file_size - _session_info.burst_offset);
+    // Requires lock
 
-    if (_debugging) {
-        LogDebug() << "Burst read of " << bytes_to_read << " bytes";
+    if (packet.opcode == Opcode::RSP_ACK) {
+        _burst_stats.bytes_sent += packet.size;
+        _burst_window_bytes += packet.size;
     }
-    _session_info.ifstream.read(reinterpret_cast<char*>(packet.data), bytes_to_read);
 
-    if (_session_info.ifstream.fail()) {
+    // What goes over the link: MAVLink framing, target ids, FTP header and data.
+    const uint32_t header_size = sizeof(PayloadHeader) - max_data_length;
+    _burst_budget -= MAVLINK_NUM_NON_PAYLOAD_BYTES + 3 + header_size + packet.size;
+
+    _update_burst_throughput(false);
+}
+
+void MavlinkFtpServer::_update_burst_throughput(bool bursts_over)
+{
+    // Requires lock
+
+    const auto now = std::chrono::steady_clock::now();
+    const double window_s = std::chrono::duration<double>(now - _burst_window_start).count();
+    // Bursts that are over before a full second still count, the tail of a
+    // longer one doesn't.
+    const bool short_bursts_over = bursts_over && !_burst_window_full && _burst_window_bytes > 0;
+    if (window_s >= 1.0 || (short_bursts_over && window_s > 0.0)) {
+        _burst_stats.bytes_per_second = _burst_window_bytes / window_s;
+        if (_debugging) {
+            LogDebug() << "Burst throughput: " << _burst_stats.bytes_per_second << " bytes/s";
+        }
+        _burst_window_start = now;
+        _burst_window_bytes = 0;
+        _burst_window_full = !bursts_over;
+    }
+}
+
+MavlinkFtpServer::SessionInfo* MavlinkFtpServer::_next_burst_session()
+{
+    // Requires lock
+
+    // Round robin, so concurrent bursts share the link evenly.
+    for (uint8_t i = 1; i <= max_sessions; ++i) {
+        const uint8_t index = (_last_burst_session + i) % max_sessions;
+        if (_sessions[index].burst_active) {
+            _last_burst_session = index;
+            return &_sessions[index];
+        }
+    }
+    return nullptr;
+}
+
+void MavlinkFtpServer::_make_burst_packet(SessionInfo& session, PayloadHeader& packet)
+{
+    // Requires lock
+
+    uint32_t bytes_to_read = std::min(
+        static_cast<uint32_t>(session.burst_chunk_size),
+        session.file_size - session.burst_offset);
+
+    const uint32_t read_ahead_end =
+        session.read_ahead_offset + static_cast<uint32_t>(session.read_ahead.size());
+    if (session.burst_offset < session.read_ahead_offset ||
+        session.burst_offset + bytes_to_read > read_ahead_end) {
+        if (_debugging) {
+            LogDebug() << "Burst read ahead at " << session.burst_offset;
+        }
+        session.read_ahead.resize(READ_AHEAD_SIZE);
+        const int bytes_read = read_at(
+            session.fd, session.read_ahead.data(), READ_AHEAD_SIZE, session.burst_offset);
+        session.read_ahead.resize(std::max(bytes_read, 0));
+        session.read_ahead_offset = session.burst_offset;
+    }
+
+    const uint32_t bytes_read = std::min(
+        bytes_to_read,
+        session.read_ahead_offset + static_cast<uint32_t>(session.read_ahead.size()) -
+            session.burst_offset);
+    if (bytes_read == 0) {
         packet.opcode = Opcode::RSP_NAK;
         packet.size = 1;
         packet.data[0] = ServerResult::ERR_FAIL;
+        session.burst_active = false;
         LogWarn() << "Burst read failed";
         return;
     }
 
-    const uint32_t bytes_read = _session_info.ifstream.gcount();
+    std::memcpy(
+        packet.data,
+        &session.read_ahead[session.burst_offset - session.read_ahead_offset],
+        bytes_read);
+
     packet.size = bytes_read;
     packet.opcode = Opcode::RSP_ACK;
 
-    packet.offset = _session_info.burst_offset;
-    _session_info.burst_offset += bytes_read;
+    packet.offset = session.burst_offset;
+    session.burst_offset += bytes_read;
 
-    if (_session_info.burst_offset == _session_info.file_size) {
+    if (session.burst_offset == session.file_size) {
         // Last read, we are done for this burst.
         packet.burst_complete = 1;
+        session.burst_active = false;
         if (_debugging) {
             LogDebug() << "Burst complete";
         }
@@ -854,22 +950,17 @@ void MavlinkFtpServer::_work_write(const PayloadHeader& payload)
     response.req_opcode = payload.opcode;
 
     std::lock_guard<std::mutex> lock(_mutex);
-    if (payload.session != 0 && !_session_info.ofstream.is_open()) {
-        _reset();
-    }
-
-    _session_info.ofstream.seekp(payload.offset);
-    if (_session_info.ifstream.fail()) {
+    auto* session = _session(payload);
+    if (session == nullptr || !session->writable) {
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
-        response.data[0] = ServerResult::ERR_FAIL;
-        LogWarn() << "Seek failed";
+        response.data[0] = ServerResult::ERR_INVALID_SESSION;
         _send_mavlink_ftp_message(response);
         return;
     }
 
-    _session_info.ofstream.write(reinterpret_cast<const char*>(payload.data), payload.size);
-    if (_session_info.ofstream.fail()) {
+    const int bytes_written = write_at(session->fd, payload.data, payload.size, payload.offset);
+    if (bytes_written != payload.size) {
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
         response.data[0] = ServerResult::ERR_FAIL;
@@ -878,6 +969,8 @@ void MavlinkFtpServer::_work_write(const PayloadHeader& payload)
         return;
     }
 
+    // Writes can be pipelined, the offset tells the client which one this is.
+    response.offset = payload.offset;
     response.opcode = Opcode::RSP_ACK;
     response.size = 0;
 
@@ -888,7 +981,9 @@ void MavlinkFtpServer::_work_terminate(const PayloadHeader& payload)
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _reset();
+        if (auto* session = _session(payload)) {
+            _close_session(*session);
+        }
     }
 
     auto response = PayloadHeader{};
@@ -899,20 +994,82 @@ void MavlinkFtpServer::_work_terminate(const PayloadHeader& payload)
     _send_mavlink_ftp_message(response);
 }
 
-void MavlinkFtpServer::_reset()
+std::variant<uint8_t, MavlinkFtpServer::ServerResult>
+MavlinkFtpServer::_open_session(const std::string& path, OpenMode mode)
 {
-    // requires lock
-    if (_session_info.ifstream.is_open()) {
-        _session_info.ifstream.close();
+    // Requires lock
+
+    // The file is opened first, so a failed open doesn't cost the client the
+    // session it still has.
+    auto raw_mode = RawFileMode::Write;
+    if (mode == OpenMode::Read) {
+        raw_mode = RawFileMode::Read;
+    } else if (mode == OpenMode::Create) {
+        raw_mode = RawFileMode::Truncate;
+    }
+    const int fd = open_raw_file(path, raw_mode);
+    if (fd < 0) {
+        return ServerResult::ERR_FAIL;
+    }
+
+    const auto size = raw_file_size(fd);
+    if (size < 0) {
+        LogErr() << "Could not determine file size of '" << path << "'";
+        close_raw_file(fd);
+        return ServerResult::ERR_FAIL;
+    }
+
+    // A client works on one file at a time, whatever it still has open is
+    // left over from a transfer it gave up on.
+    for (auto& session : _sessions) {
+        if (session.fd >= 0 && session.target_system_id == _target_system_id &&
+            session.target_component_id == _target_component_id) {
+            _close_session(session);
+        }
+    }
+
+    auto it = std::find_if(_sessions.begin(), _sessions.end(), [](const SessionInfo& session) {
+        return session.fd < 0;
+    });
+    if (it == _sessions.end()) {
+        close_raw_file(fd);
+        return ServerResult::ERR_NO_SESSIONS_AVAILABLE;
     }
 
-    if (_session_info.ofstream.is_open()) {
-        _session_info.ofstream.close();
+    *it = SessionInfo{};
+    it->fd = fd;
+    it->writable = mode != OpenMode::Read;
+    it->file_size = static_cast<uint32_t>(size);
+    it->target_system_id = _target_system_id;
+    it->target_component_id = _target_component_id;
+
+    return static_cast<uint8_t>(it - _sessions.begin());
+}
+
+MavlinkFtpServer::SessionInfo* MavlinkFtpServer::_session(const PayloadHeader& payload)
+{
+    // Requires lock
+
+    if (payload.session >= max_sessions || _sessions[payload.session].fd < 0) {
+        return nullptr;
     }
+    return &_sessions[payload.session];
+}
 
-    _session_info.burst_stop = true;
-    if (_session_info.burst_thread.joinable()) {
-        _session_info.burst_thread.join();
+void MavlinkFtpServer::_close_session(SessionInfo& session)
+{
+    // Requires lock
+    if (session.fd >= 0) {
+        close_raw_file(session.fd);
+    }
+    session = SessionInfo{};
+}
+
+void MavlinkFtpServer::_reset()
+{
+    // requires lock
+    for (auto& session : _sessions) {
+        _close_session(session);
     }
 }
 
@@ -1106,7 +1263,8 @@ void MavlinkFtpServer::_work_rename(const PayloadHeader& payload)
 }
 
 MavlinkFtpServer::ServerResult
-MavlinkFtpServer::_calc_local_file_crc32(const std::string& path, uint32_t& csum)
+MavlinkFtpServer::_calc_local_file_crc32(
+    const std::string& path, uint32_t offset, uint32_t length, uint32_t& csum, uint32_t& bytes_read)
 {
     std::error_code ec;
     if (!fs::exists(path, ec)) {
@@ -1120,21 +1278,29 @@ MavlinkFtpServer::_calc_local_file_crc32(const std::string& path, uint32_t& csum
         return ServerResult::ERR_FILE_IO_ERROR;
     }
 
-    // Read whole file in buffer size chunks
+    ifstream.seekg(offset);
+    if (ifstream.fail()) {
+        return ServerResult::ERR_FILE_IO_ERROR;
+    }
+
+    // Read the range in buffer size chunks
     Crc32 checksum;
     char buffer[18392];
+    bytes_read = 0;
     do {
-        ifstream.read(buffer, sizeof(buffer));
+        ifstream.read(
+            buffer, std::min(static_cast<uint32_t>(sizeof(buffer)), length - bytes_read));
 
         if (ifstream.fail() && !ifstream.eof()) {
             ifstream.close();
             return ServerResult::ERR_FILE_IO_ERROR;
         }
 
-        auto bytes_read = ifstream.gcount();
-        checksum.add((uint8_t*)buffer, bytes_read);
+        auto chunk_read = ifstream.gcount();
+        checksum.add((uint8_t*)buffer, chunk_read);
+        bytes_read += chunk_read;
 
-    } while (!ifstream.eof());
+    } while (!ifstream.eof() && bytes_read < length);
 
     ifstream.close();
 
@@ -1171,8 +1337,20 @@ void MavlinkFtpServer::_work_calc_file_CRC32(const PayloadHeader& payload)
         return;
     }
 
+    // As an extension, a length after the path asks for the checksum of just
+    // the block at the offset. The answer then also has the bytes covered.
+    const size_t path_size =
+        strnlen(reinterpret_cast<const char*>(payload.data), max_data_length) + 1;
+    const bool block = payload.size >= path_size + sizeof(uint32_t);
+    uint32_t length = std::numeric_limits<uint32_t>::max();
+    if (block) {
+        std::memcpy(&length, &payload.data[path_size], sizeof(uint32_t));
+    }
+
     uint32_t checksum;
-    ServerResult res = _calc_local_file_crc32(path, checksum);
+    uint32_t bytes_read;
+    ServerResult res =
+        _calc_local_file_crc32(path, block ? payload.offset : 0, length, checksum, bytes_read);
     if (res != ServerResult::SUCCESS) {
         response.opcode = Opcode::RSP_NAK;
         response.size = 1;
@@ -1183,7 +1361,12 @@ void MavlinkFtpServer::_work_calc_file_CRC32(const PayloadHeader& payload)
 
     response.opcode = Opcode::RSP_ACK;
     response.size = sizeof(uint32_t);
-    std::memcpy(response.data, &checksum, response.size);
+    std::memcpy(response.data, &checksum, sizeof(uint32_t));
+    if (block) {
+        response.offset = payload.offset;
+        response.size += sizeof(uint32_t);
+        std::memcpy(&response.data[sizeof(uint32_t)], &bytes_read, sizeof(uint32_t));
+    }
 
     _send_mavlink_ftp_message(response);
 }
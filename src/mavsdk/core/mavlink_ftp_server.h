@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cinttypes>
-#include <fstream>
+#include <condition_variable>
 #include <unordered_map>
 #include <mutex>
 #include <optional>
@@ -35,8 +37,19 @@ public:
         uint32_t total_bytes{}; /**< @brief The total bytes to transfer. */
     };
 
+    struct BurstStats {
+        uint64_t bytes_sent{0}; ///< File data sent in bursts so far.
+        double bytes_per_second{0.0}; ///< Achieved over the last second of bursting.
+    };
+
     void set_root_directory(const std::string& root_dir);
 
+    // Bytes per second on the link to spend on bursts, shared by all sessions.
+    // 0 sends as fast as the bursts can be queued. Over a serial link
+    // baudrate / 10 is what the link can carry.
+    void set_burst_rate(double bytes_per_second);
+    BurstStats burst_stats();
+
 private:
     ServerComponentImpl& _server_component_impl;
 
@@ -106,10 +119,40 @@ private:
         sizeof(PayloadHeader) == sizeof(mavlink_file_transfer_protocol_t::payload),
         "PayloadHeader size is incorrect.");
 
-    ServerResult _calc_local_file_crc32(const std::string& path, uint32_t& csum);
+    ServerResult _calc_local_file_crc32(
+        const std::string& path,
+        uint32_t offset,
+        uint32_t length,
+        uint32_t& csum,
+        uint32_t& bytes_read);
 
     void _send_mavlink_ftp_message(const PayloadHeader& payload);
+    void _send_mavlink_ftp_message(
+        const PayloadHeader& payload, uint8_t target_system_id, uint8_t target_component_id);
+
+    struct SessionInfo {
+        int fd{-1};
+        bool writable{false};
+        uint32_t file_size{0};
+        // Who opened the session, bursts are sent there.
+        uint8_t target_system_id{0};
+        uint8_t target_component_id{0};
+        bool burst_active{false};
+        uint32_t burst_offset{0};
+        uint8_t burst_chunk_size{0};
+        uint16_t burst_seq{0};
+        // Burst packets are cut from this instead of reading each one from the file.
+        std::vector<uint8_t> read_ahead{};
+        uint32_t read_ahead_offset{0};
+    };
+
+    static constexpr uint8_t max_sessions = 8;
 
+    enum class OpenMode { Read, Write, Create };
+
+    std::variant<uint8_t, ServerResult> _open_session(const std::string& path, OpenMode mode);
+    SessionInfo* _session(const PayloadHeader& payload);
+    void _close_session(SessionInfo& session);
     void _reset();
 
     void process_mavlink_ftp_message(const mavlink_message_t& msg);
@@ -134,19 +177,33 @@ private:
     void _work_rename(const PayloadHeader& payload);
     void _work_calc_file_CRC32(const PayloadHeader& payload);
 
-    bool _send_burst_packet();
-    void _make_burst_packet(PayloadHeader& packet);
+    void _burst_loop();
+    bool _wait_for_burst_budget(std::unique_lock<std::mutex>& lock);
+    void _account_burst_packet(const PayloadHeader& packet);
+    void _update_burst_throughput(bool bursts_over);
+    SessionInfo* _next_burst_session();
+    void _make_burst_packet(SessionInfo& session, PayloadHeader& packet);
 
     std::mutex _mutex{};
-    struct SessionInfo {
-        uint32_t file_size{0};
-        uint32_t burst_offset{0};
-        uint8_t burst_chunk_size{0};
-        std::ifstream ifstream;
-        std::ofstream ofstream;
-        bool burst_stop{false};
-        std::thread burst_thread;
-    } _session_info{};
+    std::array<SessionInfo, max_sessions> _sessions{};
+
+    // One thread sends the bursts of all sessions in turn, so they share the link.
+    std::thread _burst_thread{};
+    std::condition_variable _burst_cv{};
+    bool _burst_stop{false};
+    uint8_t _last_burst_session{0};
+
+    // Token bucket in bytes on the link, it may go negative by one packet.
+    static constexpr double MAX_BURST_BUDGET_S = 0.05;
+    static constexpr uint32_t READ_AHEAD_SIZE = 8192;
+    double _burst_rate{0.0};
+    double _burst_budget{0.0};
+    std::chrono::steady_clock::time_point _last_burst_budget_time{};
+
+    BurstStats _burst_stats{};
+    uint64_t _burst_window_bytes{0};
+    bool _burst_window_full{false};
+    std::chrono::steady_clock::time_point _burst_window_start{};
 
     uint8_t _network_id = 0;
     uint8_t _target_system_id = 0;
@@ -157,8 +214,6 @@ private:
     std::unordered_map<std::string, std::string> _tmp_files{};
     std::string _tmp_dir{};
 
-    uint16_t _burst_seq = 0;
-
     bool _debugging{false};
 };
 
@@ -1,43 +1,102 @@
 #include "mavlink_parameter_cache.h"
+#include "mavlink_parameter_helper.h"
+#include "file_io.h"
 
 #include <algorithm>
+#include <array>
+#include <fstream>
 
 namespace mavsdk {
 
+namespace {
+
+constexpr std::array<char, 4> cache_file_magic{'M', 'P', 'C', '1'};
+
+std::size_t value_size(uint8_t ext_type)
+{
+    switch (ext_type) {
+        case MAV_PARAM_EXT_TYPE_UINT8:
+        case MAV_PARAM_EXT_TYPE_INT8:
+            return 1;
+        case MAV_PARAM_EXT_TYPE_UINT16:
+        case MAV_PARAM_EXT_TYPE_INT16:
+            return 2;
+        case MAV_PARAM_EXT_TYPE_UINT32:
+        case MAV_PARAM_EXT_TYPE_INT32:
+        case MAV_PARAM_EXT_TYPE_REAL32:
+            return 4;
+        case MAV_PARAM_EXT_TYPE_UINT64:
+        case MAV_PARAM_EXT_TYPE_INT64:
+        case MAV_PARAM_EXT_TYPE_REAL64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+std::size_t hash_param_id(const std::array<char, PARAM_ID_LEN>& param_id)
+{
+    // FNV-1a, the ids are short and mostly differ in a few chars.
+    uint32_t hash = 2166136261u;
+    for (const char c : param_id) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
 MavlinkParameterCache::AddNewParamResult
 MavlinkParameterCache::add_new_param(const std::string& param_id, ParamValue value, int16_t index)
 {
-    if (exists(param_id)) {
+    const auto id = to_param_id(param_id);
+    if (!id) {
+        return AddNewParamResult::IdTooLong;
+    }
+
+    if (position_by_id(id.value()) != NO_POSITION) {
         return AddNewParamResult::AlreadyExists;
     }
 
-    if (static_cast<size_t>(_all_params.size() + 1) >
+    if (static_cast<size_t>(_entries.size() + 1) >
         static_cast<size_t>(std::numeric_limits<int16_t>::max())) {
         return AddNewParamResult::TooManyParams;
     }
 
-    _all_params.push_back(Param{
-        param_id,
+    if (!value.needs_extended()) {
+        ++_num_not_extended;
+    }
+
+    _entries.push_back(Entry{
+        id.value(),
         std::move(value),
-        (index != -1 ? static_cast<uint16_t>(index) : static_cast<uint16_t>(_all_params.size()))});
+        (index != -1 ? static_cast<uint16_t>(index) : static_cast<uint16_t>(_entries.size()))});
+
+    // Keep the load factor at or below one half, so probe sequences stay short.
+    if (_slots.size() < 2 * _entries.size()) {
+        rebuild_index();
+    } else {
+        insert_into_index(static_cast<uint16_t>(_entries.size() - 1));
+    }
     return MavlinkParameterCache::AddNewParamResult::Ok;
 }
 
 MavlinkParameterCache::UpdateExistingParamResult
 MavlinkParameterCache::update_existing_param(const std::string& param_id, ParamValue value)
 {
-    auto it = std::find_if(_all_params.begin(), _all_params.end(), [&](const auto& param) {
-        return (param_id == param.id);
-    });
+    const auto id = to_param_id(param_id);
+    const auto position = id ? position_by_id(id.value()) : NO_POSITION;
 
-    if (it == _all_params.end()) {
+    if (position == NO_POSITION) {
         return UpdateExistingParamResult::MissingParam;
     }
 
-    if (!it->value.is_same_type(value)) {
+    auto& entry = _entries[position];
+    if (!entry.value.is_same_type(value)) {
         return MavlinkParameterCache::UpdateExistingParamResult::WrongType;
     } else {
-        it->value.update_value_typesafe(value);
+        entry.value.update_value_typesafe(value);
         return MavlinkParameterCache::UpdateExistingParamResult::Ok;
     }
 }
@@ -45,36 +104,23 @@ MavlinkParameterCache::update_existing_param(const std::string& param_id, ParamV
 std::vector<MavlinkParameterCache::Param>
 MavlinkParameterCache::all_parameters(bool including_extended) const
 {
-    if (including_extended) {
-        return _all_params;
-    } else {
-        // TODO: we might want to cache this
-        std::vector<MavlinkParameterCache::Param> params_without_extended{};
-        std::copy_if(
-            _all_params.begin(),
-            _all_params.end(),
-            std::back_inserter(params_without_extended),
-            [](auto& entry) { return !entry.value.needs_extended(); });
-
-        return params_without_extended;
+    std::vector<MavlinkParameterCache::Param> params{};
+    params.reserve(count(including_extended));
+    for (const auto& entry : _entries) {
+        if (including_extended || !entry.value.needs_extended()) {
+            params.push_back(to_param(entry));
+        }
     }
+    return params;
 }
 
 std::map<std::string, ParamValue>
 MavlinkParameterCache::all_parameters_map(bool including_extended) const
 {
     std::map<std::string, ParamValue> mp{};
-    if (including_extended) {
-        for (const auto& param : _all_params) {
-            mp.insert({param.id, param.value});
-        }
-
-    } else {
-        for (const auto& param : _all_params) {
-            if (param.value.needs_extended()) {
-                continue;
-            }
-            mp.insert({param.id, param.value});
+    for (const auto& entry : _entries) {
+        if (including_extended || !entry.value.needs_extended()) {
+            mp.insert({extract_safe_param_id(entry.id.data()), entry.value});
         }
     }
 
@@ -84,80 +130,250 @@ MavlinkParameterCache::all_parameters_map(bool including_extended) const
 std::optional<MavlinkParameterCache::Param>
 MavlinkParameterCache::param_by_id(const std::string& param_id, bool including_extended) const
 {
-    const auto& params = all_parameters(including_extended);
+    const auto id = to_param_id(param_id);
+    if (!id) {
+        return {};
+    }
 
-    for (const auto& param : params) {
-        if (param.id == param_id) {
-            return param;
-        }
+    const auto position = position_by_id(id.value());
+    if (position == NO_POSITION ||
+        (!including_extended && _entries[position].value.needs_extended())) {
+        return {};
     }
 
-    return {};
+    return to_param(_entries[position]);
 }
 
 std::optional<MavlinkParameterCache::Param>
 MavlinkParameterCache::param_by_index(uint16_t param_index, bool including_extended) const
 {
-    const auto& params = all_parameters(including_extended);
-    if (param_index >= params.size()) {
-        LogErr() << "param at " << (int)param_index << " out of bounds (" << params.size() << ")";
+    const auto num = count(including_extended);
+    if (param_index >= num) {
+        LogErr() << "param at " << (int)param_index << " out of bounds (" << num << ")";
         return {};
     }
 
-    auto param = params[param_index];
-    if(param.index != param_index) {
-        for (const auto& p : params) {
-            if (p.index == param_index) {
-                param = p;
-                break;
-            }
-        }
+    const auto position = position_by_index(param_index);
+    if (position == NO_POSITION ||
+        (!including_extended && _entries[position].value.needs_extended())) {
+        return {};
     }
-    // Check that the redundant index matches the actual vector index.
-    if(param.index == param_index)
-        return {param};
-    else return {};
+
+    return to_param(_entries[position]);
 }
 
 uint16_t MavlinkParameterCache::count(bool including_extended) const
 {
-    const auto num = all_parameters(including_extended).size();
+    const auto num = including_extended ? _entries.size() : _num_not_extended;
     assert(num < std::numeric_limits<uint16_t>::max());
     return static_cast<uint16_t>(num);
 }
 
 void MavlinkParameterCache::clear()
 {
-    _all_params.clear();
+    _entries.clear();
+    _slots.clear();
+    _positions_by_index.clear();
+    _num_not_extended = 0;
 }
 
-bool MavlinkParameterCache::exists(const std::string& param_id) const
+bool MavlinkParameterCache::save(const std::string& path, uint32_t hash_check) const
 {
-    auto it = std::find_if(_all_params.begin(), _all_params.end(), [&](const auto& param) {
-        return (param_id == param.id);
+    const bool written = write_file_atomically(path, [&](std::ofstream& file) {
+        file.write(cache_file_magic.data(), cache_file_magic.size());
+        write_raw(file, hash_check);
+        write_raw(file, static_cast<uint16_t>(_entries.size()));
+
+        for (const auto& entry : _entries) {
+            const auto param = to_param(entry);
+            const uint8_t ext_type = param.value.get_mav_param_ext_type();
+            const auto bytes = param.value.get_128_bytes();
+            const uint8_t size = static_cast<uint8_t>(
+                param.value.is<std::string>() ?
+                    std::min(param.value.get<std::string>().size(), bytes.size()) :
+                    value_size(ext_type));
+
+            write_raw(file, param.index);
+            write_raw(file, static_cast<uint8_t>(param.id.size()));
+            file.write(param.id.data(), static_cast<std::streamsize>(param.id.size()));
+            write_raw(file, ext_type);
+            write_raw(file, size);
+            file.write(bytes.data(), size);
+        }
+        return true;
     });
-    return it != _all_params.end();
+
+    if (!written) {
+        LogWarn() << "Could not write param cache file " << path;
+    }
+    return written;
+}
+
+bool MavlinkParameterCache::load(const std::string& path, uint32_t hash_check)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::array<char, 4> magic{};
+    uint32_t file_hash_check;
+    uint16_t num_params;
+    if (!file.read(magic.data(), magic.size()) || magic != cache_file_magic ||
+        !read_raw(file, file_hash_check) || file_hash_check != hash_check ||
+        !read_raw(file, num_params)) {
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(num_params);
+
+    for (unsigned i = 0; i < num_params; ++i) {
+        uint16_t index;
+        uint8_t id_size;
+        if (!read_raw(file, index) || !read_raw(file, id_size) || id_size > PARAM_ID_LEN) {
+            return false;
+        }
+
+        ParamId id{};
+        uint8_t ext_type;
+        uint8_t size;
+        if (!file.read(id.data(), id_size) || !read_raw(file, ext_type) ||
+            !read_raw(file, size)) {
+            return false;
+        }
+
+        // Anything unexpected means the file is corrupt and we rather
+        // download everything again.
+        mavlink_param_ext_value_t ext_value{};
+        const bool valid_size = (ext_type == MAV_PARAM_EXT_TYPE_CUSTOM) ?
+                                    size <= sizeof(ext_value.param_value) :
+                                    (value_size(ext_type) != 0 && size == value_size(ext_type));
+        if (!valid_size || !file.read(ext_value.param_value, size)) {
+            return false;
+        }
+        ext_value.param_type = ext_type;
+
+        ParamValue value;
+        if (!value.set_from_mavlink_param_ext_value(ext_value)) {
+            return false;
+        }
+        entries.push_back(Entry{id, std::move(value), index});
+    }
+
+    _entries = std::move(entries);
+    _num_not_extended = static_cast<uint16_t>(
+        std::count_if(_entries.begin(), _entries.end(), [](const Entry& entry) {
+            return !entry.value.needs_extended();
+        }));
+
+    // Duplicate ids can only come from a corrupt file.
+    if (!rebuild_index()) {
+        clear();
+        return false;
+    }
+    return true;
 }
 
-std::optional<uint16_t> MavlinkParameterCache::next_missing_index(uint16_t count)
+std::optional<uint16_t> MavlinkParameterCache::next_missing_index(uint16_t count) const
 {
     // Extended doesn't matter here because we use this function in the sender
     // which is always either all extended or not.
-    std::sort(_all_params.begin(), _all_params.end(), [](const auto& lhs, const auto& rhs) {
-        return lhs.index < rhs.index;
-    });
-
     for (unsigned i = 0; i < count; ++i) {
-        if (_all_params.size() <= i) {
-            // We have reached the end but it's not complete yet.
-            return i;
-        }
-        if (_all_params[i].index > i) {
-            // We have found a hole to fill.
+        if (position_by_index(static_cast<uint16_t>(i)) == NO_POSITION) {
             return i;
         }
     }
     return {};
 }
 
+std::vector<uint16_t> MavlinkParameterCache::missing_indices(uint16_t count) const
+{
+    std::vector<uint16_t> missing;
+    for (unsigned i = 0; i < count; ++i) {
+        if (position_by_index(static_cast<uint16_t>(i)) == NO_POSITION) {
+            missing.push_back(static_cast<uint16_t>(i));
+        }
+    }
+    return missing;
+}
+
+std::optional<MavlinkParameterCache::ParamId>
+MavlinkParameterCache::to_param_id(const std::string& param_id)
+{
+    // Same as on the wire: up to 16 chars, only null terminated if shorter.
+    if (param_id.size() > PARAM_ID_LEN) {
+        return {};
+    }
+    ParamId id{};
+    std::copy(param_id.begin(), param_id.end(), id.begin());
+    return id;
+}
+
+MavlinkParameterCache::Param MavlinkParameterCache::to_param(const Entry& entry)
+{
+    return Param{extract_safe_param_id(entry.id.data()), entry.value, entry.index};
+}
+
+uint16_t MavlinkParameterCache::position_by_id(const ParamId& param_id) const
+{
+    if (_slots.empty()) {
+        return NO_POSITION;
+    }
+
+    const std::size_t mask = _slots.size() - 1;
+    for (std::size_t slot = hash_param_id(param_id) & mask;; slot = (slot + 1) & mask) {
+        const uint16_t position = _slots[slot];
+        if (position == NO_POSITION || _entries[position].id == param_id) {
+            return position;
+        }
+    }
+}
+
+uint16_t MavlinkParameterCache::position_by_index(uint16_t param_index) const
+{
+    return (param_index < _positions_by_index.size()) ? _positions_by_index[param_index] :
+                                                        NO_POSITION;
+}
+
+void MavlinkParameterCache::insert_into_index(uint16_t position)
+{
+    const auto& entry = _entries[position];
+
+    const std::size_t mask = _slots.size() - 1;
+    std::size_t slot = hash_param_id(entry.id) & mask;
+    while (_slots[slot] != NO_POSITION) {
+        slot = (slot + 1) & mask;
+    }
+    _slots[slot] = position;
+
+    if (entry.index >= _positions_by_index.size()) {
+        _positions_by_index.resize(entry.index + 1, NO_POSITION);
+    }
+    // With duplicate indices the first one wins.
+    if (_positions_by_index[entry.index] == NO_POSITION) {
+        _positions_by_index[entry.index] = position;
+    }
+}
+
+bool MavlinkParameterCache::rebuild_index()
+{
+    std::size_t num_slots = MIN_NUM_SLOTS;
+    while (num_slots < 2 * _entries.size()) {
+        num_slots *= 2;
+    }
+    _slots.assign(num_slots, NO_POSITION);
+    _positions_by_index.clear();
+
+    bool unique = true;
+    for (std::size_t position = 0; position < _entries.size(); ++position) {
+        if (position_by_id(_entries[position].id) != NO_POSITION) {
+            unique = false;
+            continue;
+        }
+        insert_into_index(static_cast<uint16_t>(position));
+    }
+    return unique;
+}
+
 } // namespace mavsdk
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "mavlink_parameter_helper.h"
 #include "param_value.h"
 
+#include <array>
 #include <limits>
 #include <map>
 #include <string>
@@ -21,6 +23,7 @@ public:
         Ok,
         AlreadyExists,
         TooManyParams,
+        IdTooLong,
     };
     AddNewParamResult
     add_new_param(const std::string& param_id, ParamValue value, int16_t index = -1);
@@ -44,14 +47,54 @@ public:
 
     [[nodiscard]] uint16_t count(bool including_extended) const;
 
-    [[nodiscard]] std::optional<uint16_t> next_missing_index(uint16_t count);
+    [[nodiscard]] std::optional<uint16_t> next_missing_index(uint16_t count) const;
+
+    // All indices below count not received yet, in ascending order.
+    [[nodiscard]] std::vector<uint16_t> missing_indices(uint16_t count) const;
 
     void clear();
 
+    // Stores all parameters in a compact binary file, together with the
+    // _HASH_CHECK value the autopilot reported for them.
+    [[nodiscard]] bool save(const std::string& path, uint32_t hash_check) const;
+
+    // Replaces all parameters with the ones from the file, but only if it
+    // was saved with the given _HASH_CHECK value, i.e. nothing changed since.
+    [[nodiscard]] bool load(const std::string& path, uint32_t hash_check);
+
 private:
-    [[nodiscard]] bool exists(const std::string& param_id) const;
+    using ParamId = std::array<char, PARAM_ID_LEN>;
+
+    // Params are kept in the order they were added with the id stored
+    // inline, so a long list doesn't mean a heap allocation per param.
+    struct Entry {
+        ParamId id;
+        ParamValue value;
+        uint16_t index;
+    };
+
+    static constexpr uint16_t NO_POSITION = std::numeric_limits<uint16_t>::max();
+    static constexpr std::size_t MIN_NUM_SLOTS = 64;
+
+    [[nodiscard]] static std::optional<ParamId> to_param_id(const std::string& param_id);
+    [[nodiscard]] static Param to_param(const Entry& entry);
+
+    [[nodiscard]] uint16_t position_by_id(const ParamId& param_id) const;
+    [[nodiscard]] uint16_t position_by_index(uint16_t param_index) const;
+    void insert_into_index(uint16_t position);
+    // Returns false if there are duplicate ids, only the first one is indexed.
+    bool rebuild_index();
+
+    std::vector<Entry> _entries;
+
+    // Open addressing hash table with the positions in _entries, keyed by id.
+    std::vector<uint16_t> _slots;
+
+    // Positions in _entries by param index, NO_POSITION if not received,
+    // which makes it the presence bitmap at the same time.
+    std::vector<uint16_t> _positions_by_index;
 
-    std::vector<Param> _all_params;
+    uint16_t _num_not_extended{0};
 };
 
 } // namespace mavsdk
@@ -1,4 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include "log.h"
 #include "param_value.h"
 #include "mavlink_parameter_cache.h"
 
@@ -104,3 +110,122 @@ TEST(MavlinkParameterCache, MissingIndicesNotSorted)
     // It should still work when not sorted.
     EXPECT_EQ(cache.next_missing_index(3), 2);
 }
+
+TEST(MavlinkParameterCache, SaveAndLoad)
+{
+    const auto path =
+        (std::filesystem::temp_directory_path() / "mavsdk_param_cache_test.bin").string();
+
+    MavlinkParameterCache cache;
+    ParamValue int_value;
+    int_value.set(static_cast<int32_t>(-42));
+    ParamValue float_value;
+    float_value.set(0.1f);
+    ParamValue custom_value;
+    custom_value.set(std::string("hello"));
+
+    cache.add_new_param("INT_PARAM", int_value);
+    cache.add_new_param("FLOAT_PARAM", float_value);
+    cache.add_new_param("CUSTOM_PARAM", custom_value);
+    ASSERT_TRUE(cache.save(path, 0x12345678));
+
+    // Only loaded if the hash matches.
+    MavlinkParameterCache loaded;
+    EXPECT_FALSE(loaded.load(path, 0x87654321));
+    EXPECT_EQ(loaded.count(true), 0);
+
+    // Whatever was there before is replaced, including the counts.
+    loaded.add_new_param("OLD_PARAM", int_value);
+    loaded.add_new_param("OTHER_OLD_PARAM", int_value);
+    loaded.add_new_param("THIRD_OLD_PARAM", int_value);
+
+    ASSERT_TRUE(loaded.load(path, 0x12345678));
+    EXPECT_EQ(loaded.all_parameters_map(true), cache.all_parameters_map(true));
+    EXPECT_EQ(loaded.param_by_index(1, true)->id, "FLOAT_PARAM");
+    EXPECT_EQ(loaded.count(true), 3);
+    EXPECT_EQ(loaded.count(false), 2);
+    EXPECT_EQ(loaded.param_by_index(1, false)->id, "FLOAT_PARAM");
+    EXPECT_FALSE(loaded.param_by_id("OLD_PARAM", true));
+
+    // A missing file is not an error, just nothing to use.
+    std::remove(path.c_str());
+    EXPECT_FALSE(loaded.load(path, 0x12345678));
+}
+
+TEST(MavlinkParameterCache, MissingIndices)
+{
+    MavlinkParameterCache cache;
+    ParamValue value;
+    value.set_int(42);
+
+    EXPECT_EQ(cache.missing_indices(3), (std::vector<uint16_t>{0, 1, 2}));
+
+    cache.add_new_param("PARAM4", value, 4);
+    cache.add_new_param("PARAM1", value, 1);
+    cache.add_new_param("PARAM9", value, 9);
+
+    EXPECT_EQ(cache.missing_indices(6), (std::vector<uint16_t>{0, 2, 3, 5}));
+    EXPECT_EQ(cache.missing_indices(2), std::vector<uint16_t>{0});
+}
+
+TEST(MavlinkParameterCache, LongIdRejected)
+{
+    MavlinkParameterCache cache;
+    ParamValue value;
+    value.set_int(42);
+
+    EXPECT_EQ(
+        cache.add_new_param("EXACTLY_16_CHARS", value),
+        MavlinkParameterCache::AddNewParamResult::Ok);
+    EXPECT_EQ(
+        cache.add_new_param("SEVENTEEN_CHARS__", value),
+        MavlinkParameterCache::AddNewParamResult::IdTooLong);
+
+    EXPECT_EQ(cache.param_by_id("EXACTLY_16_CHARS", true)->id, "EXACTLY_16_CHARS");
+    EXPECT_FALSE(cache.param_by_id("EXACTLY_16_CHARS_", true));
+}
+
+TEST(MavlinkParameterCache, ManyParams)
+{
+    // As received during a list download: in any order and with the
+    // number of params the larger autopilots have, times a few.
+    constexpr uint16_t num_params = 20000;
+
+    std::vector<uint16_t> indices(num_params);
+    for (uint16_t i = 0; i < num_params; ++i) {
+        indices[i] = i;
+    }
+    std::shuffle(indices.begin(), indices.end(), std::mt19937{42});
+
+    MavlinkParameterCache cache;
+    ParamValue value;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto index : indices) {
+        value.set(static_cast<int32_t>(index));
+        ASSERT_EQ(
+            cache.add_new_param("PARAM_" + std::to_string(index), value, index),
+            MavlinkParameterCache::AddNewParamResult::Ok);
+        // The client checks this for every param received.
+        EXPECT_LE(cache.count(false), num_params);
+    }
+
+    for (uint16_t i = 0; i < num_params; ++i) {
+        const auto id = "PARAM_" + std::to_string(i);
+        value.set(-static_cast<int32_t>(i));
+        ASSERT_EQ(
+            cache.update_existing_param(id, value),
+            MavlinkParameterCache::UpdateExistingParamResult::Ok);
+        ASSERT_EQ(cache.param_by_id(id, false)->value.get<int32_t>(), -i);
+        ASSERT_EQ(cache.param_by_index(i, false)->id, id);
+    }
+
+    EXPECT_EQ(cache.next_missing_index(num_params), std::nullopt);
+    EXPECT_TRUE(cache.missing_indices(num_params).empty());
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start);
+    LogInfo() << num_params << " params added, updated and looked up in " << elapsed.count()
+              << " ms";
+}
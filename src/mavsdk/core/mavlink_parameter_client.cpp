@@ -5,11 +5,19 @@
 #include "system_impl.h"
 #include "plugin_base.h"
 #include <algorithm>
+#include <cstring>
 #include <future>
 #include <utility>
 
 namespace mavsdk {
 
+namespace {
+
+// PX4 reports a hash over all parameters as this fake parameter.
+constexpr const char* hash_check_param_id = "_HASH_CHECK";
+
+} // namespace
+
 MavlinkParameterClient::MavlinkParameterClient(
     Sender& sender,
     MavlinkMessageHandler& message_handler,
@@ -371,7 +379,7 @@ void MavlinkParameterClient::get_all_params_async(GetAllParamsCallback callback,
     }
 
     auto new_work =
-        std::make_shared<WorkItem>(WorkItemGetAll{std::move(callback), 0, false}, cookie);
+        std::make_shared<WorkItem>(WorkItemGetAll{std::move(callback), 0, false, false}, cookie);
     _work_queue.push_back(new_work);
 }
 
@@ -408,6 +416,91 @@ void MavlinkParameterClient::clear_cache()
     _param_cache.clear();
 }
 
+void MavlinkParameterClient::set_cache_file(const std::string& path)
+{
+    _cache_file = path;
+}
+
+bool MavlinkParameterClient::should_check_hash()
+{
+    return !_cache_file.empty() && !_use_extended && _autopilot_callback() == Autopilot::Px4;
+}
+
+void MavlinkParameterClient::save_cache_file()
+{
+    if (_cache_file.empty() || !_hash_check) {
+        return;
+    }
+
+    if (!_param_cache.save(_cache_file, _hash_check.value())) {
+        LogWarn() << "Could not save params to " << _cache_file;
+    }
+}
+
+void MavlinkParameterClient::set_gap_fill_window(unsigned max_size)
+{
+    LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
+    _gap_fill_window.set_max_size(max_size);
+}
+
+void MavlinkParameterClient::start_gap_fill(uint16_t count)
+{
+    const auto missing_indices = _param_cache.missing_indices(count);
+    _missing_indices.assign(missing_indices.begin(), missing_indices.end());
+    _requested_indices.clear();
+    _gap_fill_progress = false;
+
+    if (_parameter_debugging) {
+        LogDebug() << "Filling " << _missing_indices.size() << " missing params";
+    }
+}
+
+bool MavlinkParameterClient::request_missing_params()
+{
+    while (_requested_indices.size() < _gap_fill_window.size() && !_missing_indices.empty()) {
+        const uint16_t param_index = _missing_indices.front();
+        _missing_indices.pop_front();
+
+        if (_parameter_debugging) {
+            LogDebug() << "Requesting missing parameter " << param_index;
+        }
+
+        std::array<char, PARAM_ID_LEN> param_id_buff{};
+        if (!send_get_param_message(param_id_buff, static_cast<int16_t>(param_index))) {
+            return false;
+        }
+        _requested_indices[param_index] = _sender.get_time().steady_time();
+    }
+    return true;
+}
+
+void MavlinkParameterClient::received_param_while_gap_filling(uint16_t param_index)
+{
+    _gap_fill_progress = true;
+
+    auto it = _requested_indices.find(param_index);
+    if (it != _requested_indices.end()) {
+        _gap_fill_window.on_answer(_sender.get_time().elapsed_since_s(it->second));
+        _requested_indices.erase(it);
+        return;
+    }
+
+    // It might still have been on its way from the list download.
+    auto missing_it = std::find(_missing_indices.begin(), _missing_indices.end(), param_index);
+    if (missing_it != _missing_indices.end()) {
+        _missing_indices.erase(missing_it);
+    }
+}
+
+void MavlinkParameterClient::restart_gap_fill_timeout()
+{
+    _timeout_handler.remove(_timeout_cookie);
+    _timeout_handler.add(
+        [this] { receive_timeout(); },
+        _gap_fill_window.retransmit_timeout_s(MIN_GAP_FILL_TIMEOUT_S, _timeout_s_callback()),
+        &_timeout_cookie);
+}
+
 void MavlinkParameterClient::do_work()
 {
     auto work_queue_guard = std::make_unique<LockedQueue<WorkItem>::Guard>(_work_queue);
@@ -456,7 +549,10 @@ void MavlinkParameterClient::do_work()
                     [this] { receive_timeout(); }, _timeout_s_callback(), &_timeout_cookie);
             },
             [&](WorkItemGetAll& item) {
-                if (!send_request_list_message()) {
+                _hash_check.reset();
+                item.checking_hash = should_check_hash();
+                if (!(item.checking_hash ? send_hash_check_request_message() :
+                                           send_request_list_message())) {
                     LogErr() << "Send message failed";
                     work_queue_guard->pop_front();
                     if (item.callback) {
@@ -621,6 +717,11 @@ bool MavlinkParameterClient::send_request_list_message()
     }
 }
 
+bool MavlinkParameterClient::send_hash_check_request_message()
+{
+    return send_get_param_message(param_id_to_message_buffer(hash_check_param_id), -1);
+}
+
 void MavlinkParameterClient::process_param_value(const mavlink_message_t& message)
 {
     mavlink_param_value_t param_value;
@@ -742,6 +843,55 @@ void MavlinkParameterClient::process_param_value(const mavlink_message_t& messag
                 }
             },
             [&](WorkItemGetAll& item) {
+                if (safe_param_id == hash_check_param_id) {
+                    // This is not an actual param, so it's not added to the
+                    // cache and doesn't count towards param_count.
+                    uint32_t hash_check;
+                    const float hash_check_bytes = received_value.get_4_float_bytes_bytewise();
+                    std::memcpy(&hash_check, &hash_check_bytes, sizeof(hash_check));
+                    _hash_check = hash_check;
+
+                    if (!item.checking_hash) {
+                        return;
+                    }
+                    item.checking_hash = false;
+
+                    if (_param_cache.load(_cache_file, hash_check)) {
+                        if (_parameter_debugging) {
+                            LogDebug() << "Params unchanged, using " << _cache_file;
+                        }
+                        _timeout_handler.remove(_timeout_cookie);
+                        work_queue_guard->pop_front();
+                        if (item.callback) {
+                            auto callback = item.callback;
+                            work_queue_guard.reset();
+                            callback(
+                                Result::Success, _param_cache.all_parameters_map(_use_extended));
+                        }
+                        return;
+                    }
+
+                    // Something changed, so we need to download everything.
+                    if (!send_request_list_message()) {
+                        LogErr() << "Send message failed";
+                        _timeout_handler.remove(_timeout_cookie);
+                        work_queue_guard->pop_front();
+                        if (item.callback) {
+                            auto callback = item.callback;
+                            work_queue_guard.reset();
+                            callback(Result::ConnectionError, {});
+                        }
+                        return;
+                    }
+                    _timeout_handler.refresh(_timeout_cookie);
+                    return;
+                }
+
+                if (item.checking_hash) {
+                    // Still waiting for the answer to _HASH_CHECK.
+                    return;
+                }
+
                 switch (_param_cache.add_new_param(
                     safe_param_id, received_value, param_value.param_index)) {
                     case MavlinkParameterCache::AddNewParamResult::AlreadyExists:
@@ -762,6 +912,7 @@ void MavlinkParameterClient::process_param_value(const mavlink_message_t& messag
                                 LogDebug() << "Param set complete: "
                                            << (_use_extended ? "extended" : "not extended");
                             }
+                            save_cache_file();
                             work_queue_guard->pop_front();
                             if (item.callback) {
                                 auto callback = item.callback;
@@ -776,22 +927,10 @@ void MavlinkParameterClient::process_param_value(const mavlink_message_t& messag
                                            << " so far " << param_value.param_count;
                             }
                             if (item.rerequesting) {
-                                auto maybe_next_missing_index =
-                                    _param_cache.next_missing_index(item.count);
-                                if (!maybe_next_missing_index.has_value()) {
-                                    LogErr() << "logic error, there should a missing index";
-                                    assert(false);
-                                }
-
-                                if (_parameter_debugging) {
-                                    LogDebug() << "Requesting missing parameter "
-                                               << (int)maybe_next_missing_index.value();
-                                }
-
-                                std::array<char, PARAM_ID_LEN> param_id_buff{};
-                                if (!send_get_param_message(
-                                        param_id_buff, maybe_next_missing_index.value())) {
+                                received_param_while_gap_filling(param_value.param_index);
+                                if (!request_missing_params()) {
                                     LogErr() << "Send message failed";
+                                    _timeout_handler.remove(_timeout_cookie);
                                     work_queue_guard->pop_front();
                                     if (item.callback) {
                                         auto callback = item.callback;
@@ -800,10 +939,11 @@ void MavlinkParameterClient::process_param_value(const mavlink_message_t& messag
                                     }
                                     return;
                                 }
+                                restart_gap_fill_timeout();
                             } else {
                                 // update the timeout handler, messages are still coming in.
+                                _timeout_handler.refresh(_timeout_cookie);
                             }
-                            _timeout_handler.refresh(&_timeout_cookie);
                         }
                         break;
                     case MavlinkParameterCache::AddNewParamResult::TooManyParams:
@@ -909,8 +1049,24 @@ void MavlinkParameterClient::process_param_ext_value(const mavlink_message_t& me
                                 LogDebug() << "Count expected " << _param_cache.count(_use_extended)
                                            << " but is " << param_ext_value.param_count;
                             }
-                            // update the timeout handler, messages are still coming in.
-                            _timeout_handler.refresh(&_timeout_cookie);
+                            if (item.rerequesting) {
+                                received_param_while_gap_filling(param_ext_value.param_index);
+                                if (!request_missing_params()) {
+                                    LogErr() << "Send message failed";
+                                    _timeout_handler.remove(_timeout_cookie);
+                                    work_queue_guard->pop_front();
+                                    if (item.callback) {
+                                        auto callback = item.callback;
+                                        work_queue_guard.reset();
+                                        callback(Result::ConnectionError, {});
+                                    }
+                                    return;
+                                }
+                                restart_gap_fill_timeout();
+                            } else {
+                                // update the timeout handler, messages are still coming in.
+                                _timeout_handler.refresh(_timeout_cookie);
+                            }
                         }
                         break;
                     case MavlinkParameterCache::AddNewParamResult::TooManyParams:
@@ -1090,6 +1246,24 @@ void MavlinkParameterClient::receive_timeout()
                     LogDebug() << "All params receive timeout with";
                 }
 
+                if (item.checking_hash) {
+                    // No answer to _HASH_CHECK, so just download everything.
+                    item.checking_hash = false;
+                    if (!send_request_list_message()) {
+                        LogErr() << "Send message failed";
+                        work_queue_guard->pop_front();
+                        if (item.callback) {
+                            auto callback = item.callback;
+                            work_queue_guard.reset();
+                            callback(Result::ConnectionError, {});
+                        }
+                        return;
+                    }
+                    _timeout_handler.add(
+                        [this] { receive_timeout(); }, _timeout_s_callback(), &_timeout_cookie);
+                    return;
+                }
+
                 if (item.count == 0) {
                     // We got 0 messages back from the server (param count unknown). Most likely the
                     // "list request" got lost before making it to the server,
@@ -1120,21 +1294,41 @@ void MavlinkParameterClient::receive_timeout()
                     }
 
                 } else {
-                    item.rerequesting = true;
-                    auto maybe_next_missing_index = _param_cache.next_missing_index(item.count);
-                    if (!maybe_next_missing_index.has_value()) {
-                        LogErr() << "logic error, there should a missing index";
-                        assert(false);
-                    }
+                    if (!item.rerequesting) {
+                        // The list download is over, request what is missing.
+                        item.rerequesting = true;
+                        start_gap_fill(item.count);
 
-                    if (_parameter_debugging) {
-                        LogDebug() << "Requesting missing parameter "
-                                   << (int)maybe_next_missing_index.value();
-                    }
+                    } else {
+                        // Whatever is still outstanding counts as lost and is
+                        // requested again first.
+                        if (!_requested_indices.empty()) {
+                            _gap_fill_window.on_loss();
+                            for (auto it = _requested_indices.rbegin();
+                                 it != _requested_indices.rend();
+                                 ++it) {
+                                _missing_indices.push_front(it->first);
+                            }
+                            _requested_indices.clear();
+                        }
 
-                    std::array<char, PARAM_ID_LEN> param_id_buff{};
+                        if (!_gap_fill_progress) {
+                            if (work->retries_to_do == 0) {
+                                LogErr() << "Missing params could not be retrieved";
+                                work_queue_guard->pop_front();
+                                if (item.callback) {
+                                    auto callback = item.callback;
+                                    work_queue_guard.reset();
+                                    callback(Result::Timeout, {});
+                                }
+                                return;
+                            }
+                            --work->retries_to_do;
+                        }
+                        _gap_fill_progress = false;
+                    }
 
-                    if (!send_get_param_message(param_id_buff, maybe_next_missing_index.value())) {
+                    if (!request_missing_params()) {
                         LogErr() << "Send message failed";
                         work_queue_guard->pop_front();
                         if (item.callback) {
@@ -1145,7 +1339,10 @@ void MavlinkParameterClient::receive_timeout()
                         return;
                     }
                     _timeout_handler.add(
-                        [this] { receive_timeout(); }, _timeout_s_callback(), &_timeout_cookie);
+                        [this] { receive_timeout(); },
+                        _gap_fill_window.retransmit_timeout_s(
+                            MIN_GAP_FILL_TIMEOUT_S, _timeout_s_callback()),
+                        &_timeout_cookie);
                 }
             }},
         work->work_item_variant);
@@ -9,10 +9,13 @@
 #include "mavlink_parameter_subscription.h"
 #include "mavlink_parameter_cache.h"
 #include "mavlink_parameter_helper.h"
+#include "mavsdk_time.h"
+#include "request_window.h"
 
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <string>
 #include <functional>
 #include <utility>
@@ -146,6 +149,15 @@ public:
 
     void clear_cache();
 
+    // With a cache file, get_all_params first asks for the autopilot's
+    // _HASH_CHECK and only downloads all params if they don't match the
+    // cached ones anymore. Currently only supported by PX4.
+    void set_cache_file(const std::string& path);
+
+    // Maximum number of missing params requested at once after the list
+    // download. The actual number adapts to loss.
+    void set_gap_fill_window(unsigned max_size);
+
     void do_work();
 
     friend std::ostream& operator<<(std::ostream&, const Result&);
@@ -168,6 +180,7 @@ private:
         const GetAllParamsCallback callback;
         uint16_t count;
         bool rerequesting;
+        bool checking_hash;
     };
 
     struct WorkItem {
@@ -192,6 +205,14 @@ private:
     bool send_get_param_message(
         const std::array<char, PARAM_ID_LEN>& param_id_buff, int16_t param_index);
     bool send_request_list_message();
+    bool send_hash_check_request_message();
+
+    void start_gap_fill(uint16_t count);
+    bool request_missing_params();
+    void received_param_while_gap_filling(uint16_t param_index);
+    void restart_gap_fill_timeout();
+    bool should_check_hash();
+    void save_cache_file();
 
     Sender& _sender;
     MavlinkMessageHandler& _message_handler;
@@ -207,6 +228,17 @@ private:
     void* _timeout_cookie = nullptr;
 
     MavlinkParameterCache _param_cache{};
+    std::string _cache_file{};
+    std::optional<uint32_t> _hash_check{};
+
+    // When filling gaps after the list download, several missing params are
+    // requested at once, see request_missing_params.
+    static constexpr unsigned DEFAULT_GAP_FILL_WINDOW = 16;
+    static constexpr double MIN_GAP_FILL_TIMEOUT_S = 0.05;
+    RequestWindow _gap_fill_window{DEFAULT_GAP_FILL_WINDOW};
+    std::deque<uint16_t> _missing_indices{};
+    std::map<uint16_t, SteadyTimePoint> _requested_indices{};
+    bool _gap_fill_progress{false};
 
     bool _parameter_debugging = false;
 
@@ -2,6 +2,7 @@
 #include "mavlink_address.h"
 #include "mavlink_parameter_helper.h"
 #include "plugin_base.h"
+#include <algorithm>
 #include <cassert>
 
 namespace mavsdk {
@@ -69,6 +70,7 @@ MavlinkParameterServer::~MavlinkParameterServer()
 
 void MavlinkParameterServer::publish_server_param(const std::string& name, bool extended)
 {
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
     const auto param_count = _param_cache.count(extended);
     const auto param_opt = _param_cache.param_by_id(name, true);
 
@@ -105,6 +107,8 @@ MavlinkParameterServer::provide_server_param(const std::string& name, const Para
             break;
         case MavlinkParameterCache::AddNewParamResult::TooManyParams:
             return Result::TooManyParams;
+        case MavlinkParameterCache::AddNewParamResult::IdTooLong:
+            return Result::ParamNameTooLong;
         default:
             LogErr() << "Unknown add_new_param result";
             assert(false);
@@ -436,7 +440,7 @@ void MavlinkParameterServer::process_param_request_list(const mavlink_message_t&
     if(list_request.target_component == MAV_COMP_ID_ALL && _sender.get_own_component_id() != MAV_COMP_ID_AUTOPILOT1) {
         return;
     }
-    broadcast_all_parameters(false);
+    start_list_stream(false);
 }
 
 void MavlinkParameterServer::process_param_ext_request_list(const mavlink_message_t& message)
@@ -451,113 +455,210 @@ void MavlinkParameterServer::process_param_ext_request_list(const mavlink_messag
         log_target_mismatch(ext_list_request.target_system, ext_list_request.target_component);
         return;
     }
-    broadcast_all_parameters(true);
+    start_list_stream(true);
 }
 
-void MavlinkParameterServer::broadcast_all_parameters(const bool extended)
+void MavlinkParameterServer::start_list_stream(const bool extended)
 {
     std::lock_guard<std::mutex> lock(_all_params_mutex);
-    const auto all_params = _param_cache.all_parameters(extended);
     if (_parameter_debugging) {
-        LogDebug() << "broadcast_all_parameters " << (extended ? "extended" : "") << ": "
-                   << all_params.size();
-    }
-    for (const auto& parameter : all_params) {
-        if (_parameter_debugging) {
-            LogDebug() << "sending param:" << parameter.id;
-        }
-        auto new_work = std::make_shared<WorkItem>(
-            parameter.id,
-            parameter.value,
-            WorkItemValue{parameter.index, static_cast<uint16_t>(all_params.size()), extended});
-        _work_queue.push_back(new_work);
+        LogDebug() << "start list stream " << (extended ? "extended" : "") << ": "
+                   << _param_cache.count(extended);
     }
+    // A new request while streaming means the client starts over as well.
+    auto& stream = extended ? _ext_list_stream : _list_stream;
+    stream = ListStream{true, 0};
+}
+
+void MavlinkParameterServer::set_list_stream_rate(double params_per_s)
+{
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _list_stream_rate = params_per_s;
 }
 
 void MavlinkParameterServer::do_work()
 {
-    LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
-    auto work = work_queue_guard.get_front();
-    if (!work) {
-        return;
-    }
-    const auto param_id_message_buffer = param_id_to_message_buffer(work->param_id);
+    // Single answers go first, they are few and a client is waiting for each.
+    while (true) {
+        LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
+        auto work = work_queue_guard.get_front();
+        if (!work) {
+            break;
+        }
 
-    std::visit(
-        overloaded{
-            [&](const WorkItemValue& specific) {
-                if (specific.extended) {
-                    const auto buf = work->param_value.get_128_bytes();
-                    if (!_sender.queue_message(
-                            [&](MavlinkAddress mavlink_address, uint8_t channel) {
-                                mavlink_message_t message;
-                                mavlink_msg_param_ext_value_pack_chan(
-                                    mavlink_address.system_id,
-                                    mavlink_address.component_id,
-                                    channel,
-                                    &message,
-                                    param_id_message_buffer.data(),
-                                    buf.data(),
-                                    work->param_value.get_mav_param_ext_type(),
-                                    specific.param_count,
-                                    specific.param_index);
-                                return message;
-                            })) {
+        std::visit(
+            overloaded{
+                [&](const WorkItemValue& specific) {
+                    if (!send_param_value(
+                            work->param_id,
+                            work->param_value,
+                            specific.param_index,
+                            specific.param_count,
+                            specific.extended)) {
                         LogErr() << "Error: Send message failed";
-                        work_queue_guard.pop_front();
-                        return;
-                    }
-                } else {
-                    float param_value;
-                    if (_sender.autopilot() == Autopilot::ArduPilot) {
-                        param_value = work->param_value.get_4_float_bytes_cast();
-                    } else {
-                        param_value = work->param_value.get_4_float_bytes_bytewise();
                     }
+                },
+                [&](const WorkItemAck& specific) {
+                    const auto param_id_message_buffer =
+                        param_id_to_message_buffer(work->param_id);
+                    auto buf = work->param_value.get_128_bytes();
                     if (!_sender.queue_message(
                             [&](MavlinkAddress mavlink_address, uint8_t channel) {
                                 mavlink_message_t message;
-                                mavlink_msg_param_value_pack_chan(
+                                mavlink_msg_param_ext_ack_pack_chan(
                                     mavlink_address.system_id,
                                     mavlink_address.component_id,
                                     channel,
                                     &message,
                                     param_id_message_buffer.data(),
-                                    param_value,
-                                    work->param_value.get_mav_param_type(),
-                                    specific.param_count,
-                                    specific.param_index);
+                                    buf.data(),
+                                    work->param_value.get_mav_param_ext_type(),
+                                    specific.param_ack);
                                 return message;
                             })) {
                         LogErr() << "Error: Send message failed";
-                        work_queue_guard.pop_front();
-                        return;
                     }
-                }
-                work_queue_guard.pop_front();
-            },
-            [&](const WorkItemAck& specific) {
-                auto buf = work->param_value.get_128_bytes();
-                if (!_sender.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
-                        mavlink_message_t message;
-                        mavlink_msg_param_ext_ack_pack_chan(
-                            mavlink_address.system_id,
-                            mavlink_address.component_id,
-                            channel,
-                            &message,
-                            param_id_message_buffer.data(),
-                            buf.data(),
-                            work->param_value.get_mav_param_ext_type(),
-                            specific.param_ack);
-                        return message;
-                    })) {
-                    LogErr() << "Error: Send message failed";
-                    work_queue_guard.pop_front();
-                    return;
-                }
-                work_queue_guard.pop_front();
-            }},
-        work->work_item_variant);
+                }},
+            work->work_item_variant);
+        work_queue_guard.pop_front();
+    }
+
+    continue_list_streams();
+}
+
+void MavlinkParameterServer::continue_list_streams()
+{
+    {
+        std::lock_guard<std::mutex> lock(_all_params_mutex);
+
+        // Token bucket: the budget grows with the rate but only up to a
+        // short burst, so an idle server doesn't save up for a flood.
+        auto& time = _sender.get_time();
+        const auto now = time.steady_time();
+        const double elapsed_s = time.elapsed_since_s(_last_list_stream_time);
+        _last_list_stream_time = now;
+        _list_stream_budget = std::min(
+            _list_stream_budget + elapsed_s * _list_stream_rate,
+            std::max(1.0, _list_stream_rate * MAX_LIST_STREAM_BURST_S));
+    }
+
+    while (true) {
+        bool extended;
+        {
+            std::lock_guard<std::mutex> lock(_all_params_mutex);
+            if (_list_stream_budget < 1.0) {
+                return;
+            }
+            // Both streams share the budget, one after the other.
+            if (!_list_stream.active && !_ext_list_stream.active) {
+                return;
+            }
+            extended = !_list_stream.active;
+        }
+
+        if (!send_next_list_param(extended)) {
+            // Try again on the next round.
+            return;
+        }
+    }
+}
+
+bool MavlinkParameterServer::send_next_list_param(bool extended)
+{
+    std::optional<MavlinkParameterCache::Param> param_opt;
+    uint16_t param_count;
+    {
+        std::lock_guard<std::mutex> lock(_all_params_mutex);
+        auto& stream = extended ? _ext_list_stream : _list_stream;
+
+        // Params are always added without index by the server, so indices
+        // go from 0 to the total count. The extended ones are skipped in
+        // the normal list.
+        const auto total_count = _param_cache.count(true);
+        while (stream.next_index < total_count) {
+            param_opt = _param_cache.param_by_index(stream.next_index, true);
+            if (param_opt.has_value() && (extended || !param_opt.value().value.needs_extended())) {
+                break;
+            }
+            param_opt.reset();
+            ++stream.next_index;
+        }
+
+        if (!param_opt.has_value()) {
+            stream.active = false;
+            return true;
+        }
+
+        // Params added in the meantime are included in the count and streamed
+        // at the end.
+        param_count = _param_cache.count(extended);
+    }
+
+    const auto& param = param_opt.value();
+    if (_parameter_debugging) {
+        LogDebug() << "sending param:" << param.id;
+    }
+    if (!send_param_value(param.id, param.value, param.index, param_count, extended)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    auto& stream = extended ? _ext_list_stream : _list_stream;
+    // Unless the stream has been restarted in the meantime.
+    if (stream.active && stream.next_index == param.index) {
+        ++stream.next_index;
+    }
+    _list_stream_budget -= 1.0;
+    return true;
+}
+
+bool MavlinkParameterServer::send_param_value(
+    const std::string& param_id,
+    const ParamValue& param_value,
+    uint16_t param_index,
+    uint16_t param_count,
+    bool extended)
+{
+    const auto param_id_message_buffer = param_id_to_message_buffer(param_id);
+
+    if (extended) {
+        const auto buf = param_value.get_128_bytes();
+        return _sender.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
+            mavlink_message_t message;
+            mavlink_msg_param_ext_value_pack_chan(
+                mavlink_address.system_id,
+                mavlink_address.component_id,
+                channel,
+                &message,
+                param_id_message_buffer.data(),
+                buf.data(),
+                param_value.get_mav_param_ext_type(),
+                param_count,
+                param_index);
+            return message;
+        });
+    } else {
+        float value;
+        if (_sender.autopilot() == Autopilot::ArduPilot) {
+            value = param_value.get_4_float_bytes_cast();
+        } else {
+            value = param_value.get_4_float_bytes_bytewise();
+        }
+        return _sender.queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
+            mavlink_message_t message;
+            mavlink_msg_param_value_pack_chan(
+                mavlink_address.system_id,
+                mavlink_address.component_id,
+                channel,
+                &message,
+                param_id_message_buffer.data(),
+                value,
+                param_value.get_mav_param_type(),
+                param_count,
+                param_index);
+            return message;
+        });
+    }
 }
 
 std::ostream& operator<<(std::ostream& str, const MavlinkParameterServer::Result& result)
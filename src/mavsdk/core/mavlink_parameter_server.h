@@ -2,6 +2,7 @@
 
 #include "sender.h"
 #include "mavlink_message_handler.h"
+#include "mavsdk_time.h"
 #include "timeout_handler.h"
 #include "timeout_s_callback.h"
 #include "param_value.h"
@@ -57,6 +58,10 @@ public:
     std::pair<Result, std::string> retrieve_server_param_custom(const std::string& name);
     std::pair<Result, ParamValue> retrieve_server_param(const std::string& name);
 
+    // Params per second sent in response to a list request, so that a long
+    // list neither floods the link nor delays other answers.
+    void set_list_stream_rate(double params_per_s);
+
     void do_work();
 
     friend std::ostream& operator<<(std::ostream&, const Result&);
@@ -79,7 +84,16 @@ private:
 
     void process_param_request_list(const mavlink_message_t& message);
     void process_param_ext_request_list(const mavlink_message_t& message);
-    void broadcast_all_parameters(bool extended);
+    void start_list_stream(bool extended);
+    void continue_list_streams();
+    [[nodiscard]] bool send_next_list_param(bool extended);
+
+    [[nodiscard]] bool send_param_value(
+        const std::string& param_id,
+        const ParamValue& param_value,
+        uint16_t param_index,
+        uint16_t param_count,
+        bool extended);
 
     bool target_matches(uint16_t target_sys_id, uint16_t target_comp_id, bool is_request);
     void log_target_mismatch(uint16_t target_sys_id, uint16_t target_comp_id);
@@ -119,6 +133,22 @@ private:
 
     LockedQueue<WorkItem> _work_queue{};
 
+    // The list is not copied into the work queue but sent from the cache
+    // param by param, so changes during the stream are sent as they are.
+    struct ListStream {
+        bool active{false};
+        uint16_t next_index{0};
+    };
+    // Protected by _all_params_mutex.
+    ListStream _list_stream{};
+    ListStream _ext_list_stream{};
+
+    static constexpr double DEFAULT_LIST_STREAM_RATE = 100.0;
+    static constexpr double MAX_LIST_STREAM_BURST_S = 0.1;
+    double _list_stream_rate{DEFAULT_LIST_STREAM_RATE};
+    double _list_stream_budget{1.0};
+    SteadyTimePoint _last_list_stream_time{};
+
     bool _parameter_debugging = false;
 };
 
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "mavlink_parameter_server.h"
+#include "mocks/sender_mock.h"
+
+using namespace mavsdk;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using MockSender = NiceMock<mavsdk::testing::MockSender>;
+
+static MavlinkAddress own_address{1, MAV_COMP_ID_AUTOPILOT1};
+static MavlinkAddress client_address{245, 190};
+
+class MavlinkParameterServerTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ON_CALL(mock_sender, get_own_system_id()).WillByDefault(Return(own_address.system_id));
+        ON_CALL(mock_sender, get_own_component_id())
+            .WillByDefault(Return(own_address.component_id));
+        ON_CALL(mock_sender, autopilot()).WillByDefault(Return(Autopilot::Px4));
+        ON_CALL(mock_sender, queue_message(_))
+            .WillByDefault(
+                Invoke([this](std::function<mavlink_message_t(MavlinkAddress, uint8_t)> fun) {
+                    auto message = fun(own_address, 0);
+                    mavlink_param_value_t param_value;
+                    mavlink_msg_param_value_decode(&message, &param_value);
+                    sent.push_back(param_value);
+                    return true;
+                }));
+    }
+
+    void provide_params(unsigned num)
+    {
+        for (unsigned i = 0; i < num; ++i) {
+            EXPECT_EQ(
+                server.provide_server_param_int("PARAM_" + std::to_string(i), i),
+                MavlinkParameterServer::Result::Success);
+        }
+    }
+
+    void request_list()
+    {
+        mavlink_message_t message;
+        mavlink_msg_param_request_list_pack(
+            client_address.system_id,
+            client_address.component_id,
+            &message,
+            own_address.system_id,
+            own_address.component_id);
+        message_handler.process_message(message);
+    }
+
+    void request_read(uint16_t index)
+    {
+        mavlink_message_t message;
+        mavlink_msg_param_request_read_pack(
+            client_address.system_id,
+            client_address.component_id,
+            &message,
+            own_address.system_id,
+            own_address.component_id,
+            "",
+            index);
+        message_handler.process_message(message);
+    }
+
+    MockSender mock_sender;
+    MavlinkMessageHandler message_handler;
+    MavlinkParameterServer server{mock_sender, message_handler};
+    std::vector<mavlink_param_value_t> sent;
+};
+
+TEST_F(MavlinkParameterServerTest, ListIsPaced)
+{
+    provide_params(200);
+    // Bursts of 0.1 s, so 100 params at once.
+    server.set_list_stream_rate(1000.0);
+
+    request_list();
+    server.do_work();
+    ASSERT_EQ(sent.size(), 100);
+
+    const auto start = std::chrono::steady_clock::now();
+    while (sent.size() < 200) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        server.do_work();
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+
+    for (uint16_t i = 0; i < 200; ++i) {
+        EXPECT_EQ(sent[i].param_index, i);
+        EXPECT_EQ(sent[i].param_count, 200);
+    }
+
+    // Done, nothing more is sent.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    server.do_work();
+    EXPECT_EQ(sent.size(), 200);
+}
+
+TEST_F(MavlinkParameterServerTest, AnswersGoFirst)
+{
+    provide_params(10);
+    server.set_list_stream_rate(10.0);
+
+    request_list();
+    server.do_work();
+    ASSERT_EQ(sent.size(), 1);
+
+    // While the list is being sent, a single request is answered right away.
+    request_read(7);
+    server.do_work();
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[1].param_index, 7);
+}
+
+TEST_F(MavlinkParameterServerTest, ChangesDuringList)
+{
+    provide_params(3);
+    server.set_list_stream_rate(10.0);
+
+    request_list();
+    server.do_work();
+    ASSERT_EQ(sent.size(), 1);
+
+    // Changed and added params are sent as they are when their turn comes.
+    EXPECT_EQ(
+        server.provide_server_param_int("PARAM_2", 42), MavlinkParameterServer::Result::Success);
+    EXPECT_EQ(
+        server.provide_server_param_int("PARAM_3", 3), MavlinkParameterServer::Result::Success);
+
+    while (sent.size() < 4) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        server.do_work();
+    }
+
+    EXPECT_EQ(sent[2].param_index, 2);
+    ParamValue value;
+    value.set_from_mavlink_param_value_bytewise(sent[2]);
+    EXPECT_EQ(value.get<int32_t>(), 42);
+
+    EXPECT_EQ(sent[3].param_index, 3);
+    EXPECT_EQ(sent[3].param_count, 4);
+}
@@ -219,6 +219,77 @@ void Mavsdk::Configuration::set_component_type(Mavsdk::ComponentType component_t
     _component_type = component_type;
 }
 
+unsigned Mavsdk::Configuration::get_callback_threads() const
+{
+    return _callback_threads;
+}
+
+void Mavsdk::Configuration::set_callback_threads(unsigned callback_threads)
+{
+    _callback_threads = callback_threads;
+}
+
+Mavsdk::CallbackSharding Mavsdk::Configuration::get_callback_sharding() const
+{
+    return _callback_sharding;
+}
+
+void Mavsdk::Configuration::set_callback_sharding(Mavsdk::CallbackSharding callback_sharding)
+{
+    _callback_sharding = callback_sharding;
+}
+
+std::string Mavsdk::Configuration::get_param_cache_directory() const
+{
+    return _param_cache_directory;
+}
+
+void Mavsdk::Configuration::set_param_cache_directory(const std::string& param_cache_directory)
+{
+    _param_cache_directory = param_cache_directory;
+}
+
+std::string Mavsdk::Configuration::get_log_cache_directory() const
+{
+    return _log_cache_directory;
+}
+
+void Mavsdk::Configuration::set_log_cache_directory(const std::string& log_cache_directory)
+{
+    _log_cache_directory = log_cache_directory;
+}
+
+std::string Mavsdk::Configuration::get_camera_definition_cache_directory() const
+{
+    return _camera_definition_cache_directory;
+}
+
+void Mavsdk::Configuration::set_camera_definition_cache_directory(
+    const std::string& camera_definition_cache_directory)
+{
+    _camera_definition_cache_directory = camera_definition_cache_directory;
+}
+
+std::vector<Mavsdk::CallbackShardMetrics> Mavsdk::callback_shard_metrics() const
+{
+    return _impl->callback_shard_metrics();
+}
+
+std::vector<Mavsdk::CallbackStats> Mavsdk::callback_stats() const
+{
+    return _impl->callback_stats();
+}
+
+void Mavsdk::reset_callback_stats()
+{
+    _impl->reset_callback_stats();
+}
+
+void Mavsdk::fleet_snapshot(FleetSnapshot& snapshot) const
+{
+    _impl->fleet_snapshot(snapshot);
+}
+
 void Mavsdk::intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
     _impl->intercept_incoming_messages_async(callback);
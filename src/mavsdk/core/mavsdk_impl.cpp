@@ -1,6 +1,9 @@
 #include "mavsdk_impl.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <mutex>
 
 #include "connection.h"
@@ -19,6 +22,37 @@ namespace mavsdk {
 
 template class CallbackList<>;
 
+namespace {
+
+// Incremented by the signal handler, every instance logs its stats when it
+// sees it change.
+std::atomic<unsigned> callback_stats_requests{0};
+
+#if !defined(WINDOWS)
+void request_callback_stats(int)
+{
+    callback_stats_requests.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+// Receive time of the message being processed on this thread, so callbacks
+// queued by its handlers know when it arrived.
+thread_local SteadyTimePoint current_receive_time{};
+
+class ReceiveTimeScope {
+public:
+    explicit ReceiveTimeScope(SteadyTimePoint receive_time)
+    {
+        current_receive_time = receive_time;
+    }
+    ~ReceiveTimeScope() { current_receive_time = SteadyTimePoint{}; }
+
+    ReceiveTimeScope(const ReceiveTimeScope&) = delete;
+    ReceiveTimeScope& operator=(const ReceiveTimeScope&) = delete;
+};
+
+} // namespace
+
 MavsdkImpl::MavsdkImpl(const Mavsdk::Configuration& configuration) :
     timeout_handler(time),
     call_every_handler(time),
@@ -40,12 +74,27 @@ MavsdkImpl::MavsdkImpl(const Mavsdk::Configuration& configuration) :
         }
     }
 
+    if (const char* env_p = std::getenv("MAVSDK_CALLBACK_STATS_SIGNAL")) {
+        if (std::string(env_p) == "1") {
+#if !defined(WINDOWS)
+            LogDebug() << "Callback stats are logged on SIGUSR1.";
+            _callback_stats_requests_seen = callback_stats_requests.load();
+            _callback_stats_signal = true;
+            std::signal(SIGUSR1, request_callback_stats);
+#else
+            LogWarn() << "Logging callback stats on signal is not supported on Windows.";
+#endif
+        }
+    }
+
     set_configuration(configuration);
 
-    _work_thread = new std::thread(&MavsdkImpl::work_thread, this);
+    // The executor needs to exist before the work thread uses it.
+    _callback_sharding = configuration.get_callback_sharding();
+    _callback_executor =
+        std::make_unique<CallbackExecutor>(time, configuration.get_callback_threads());
 
-    _process_user_callbacks_thread =
-        new std::thread(&MavsdkImpl::process_user_callbacks_thread, this);
+    _work_thread = new std::thread(&MavsdkImpl::work_thread, this);
 }
 
 MavsdkImpl::~MavsdkImpl()
@@ -54,12 +103,7 @@ MavsdkImpl::~MavsdkImpl()
 
     _should_exit = true;
 
-    if (_process_user_callbacks_thread != nullptr) {
-        _user_callback_queue.stop();
-        _process_user_callbacks_thread->join();
-        delete _process_user_callbacks_thread;
-        _process_user_callbacks_thread = nullptr;
-    }
+    _callback_executor->stop();
 
     if (_work_thread != nullptr) {
         _work_thread->join();
@@ -315,6 +359,8 @@ void MavsdkImpl::forward_message(mavlink_message_t& message, Connection* connect
 
 void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connection)
 {
+    const ReceiveTimeScope receive_time_scope{time.steady_time()};
+
     if (_message_logging_on) {
         LogDebug() << "Processing message " << message.msgid << " from "
                    << static_cast<int>(message.sysid) << "/" << static_cast<int>(message.compid);
@@ -378,6 +424,8 @@ void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connect
         return;
     }
 
+    _fleet_table.process_message(message, time.elapsed_us());
+
     std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
 
     // The only situation where we create a system with sysid 0 is when we initialize the connection
@@ -783,13 +831,13 @@ void MavsdkImpl::make_system_with_component(uint8_t system_id, uint8_t comp_id)
 void MavsdkImpl::notify_on_discover()
 {
     std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
-    _new_system_callbacks.queue([this](const auto& func) { call_user_callback(func); });
+    _new_system_callbacks.queue([this](auto&& func) { call_user_callback(std::move(func)); });
 }
 
 void MavsdkImpl::notify_on_timeout()
 {
     std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
-    _new_system_callbacks.queue([this](const auto& func) { call_user_callback(func); });
+    _new_system_callbacks.queue([this](auto&& func) { call_user_callback(std::move(func)); });
 }
 
 Mavsdk::NewSystemHandle
@@ -800,7 +848,7 @@ MavsdkImpl::subscribe_on_new_system(const Mavsdk::NewSystemCallback& callback)
     const auto handle = _new_system_callbacks.subscribe(callback);
 
     if (is_any_system_connected()) {
-        _new_system_callbacks.queue([this](const auto& func) { call_user_callback(func); });
+        _new_system_callbacks.queue([this](auto&& func) { call_user_callback(std::move(func)); });
     }
 
     return handle;
@@ -826,6 +874,8 @@ void MavsdkImpl::work_thread()
     while (!_should_exit) {
         timeout_handler.run_once();
         call_every_handler.run_once();
+        _callback_executor->check_durations(1.0, _callback_debugging);
+        log_callback_stats_if_requested();
 
         {
             std::lock_guard<std::mutex> lock(_server_components_mutex);
@@ -849,60 +899,73 @@ void MavsdkImpl::work_thread()
 }
 
 void MavsdkImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename,
+    const int linenumber,
+    UserCallbackFunction&& func,
+    const uint8_t system_id)
 {
-    auto callback_size = _user_callback_queue.size();
-    if (callback_size == 10) {
-        LogWarn()
-            << "User callback queue too slow.\n"
-               "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+    // Callbacks of the same shard key run in order. With subscription
+    // sharding the call site stands in for the stream, so all subscribers
+    // of a stream on one system share a shard.
+    uint64_t shard_key = system_id;
+    if (_callback_sharding == Mavsdk::CallbackSharding::Subscription) {
+        shard_key = (shard_key * 31 + std::hash<const char*>{}(filename)) * 31 +
+                    static_cast<uint64_t>(linenumber);
+    }
 
-    } else if (callback_size == 99) {
-        LogErr()
-            << "User callback queue overflown\n"
-               "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+    _callback_executor->post(
+        shard_key,
+        CallbackExecutor::Callback{std::move(func), filename, linenumber, current_receive_time});
+}
 
-    } else if (callback_size == 100) {
-        return;
+std::vector<Mavsdk::CallbackShardMetrics> MavsdkImpl::callback_shard_metrics() const
+{
+    std::vector<Mavsdk::CallbackShardMetrics> result;
+    for (const auto& metrics : _callback_executor->metrics()) {
+        Mavsdk::CallbackShardMetrics shard_metrics{};
+        shard_metrics.queue_depth = metrics.queue_depth;
+        shard_metrics.max_queue_depth = metrics.max_queue_depth;
+        shard_metrics.callbacks_run = metrics.callbacks_run;
+        shard_metrics.mean_queue_latency_s = metrics.mean_queue_latency_s;
+        shard_metrics.max_queue_latency_s = metrics.max_queue_latency_s;
+        result.push_back(shard_metrics);
     }
+    return result;
+}
 
-    // We only need to keep track of filename and linenumber if we're actually debugging this.
-    UserCallback user_callback =
-        _callback_debugging ? UserCallback{func, filename, linenumber} : UserCallback{func};
+std::vector<Mavsdk::CallbackStats> MavsdkImpl::callback_stats() const
+{
+    return _callback_executor->stats().stats();
+}
 
-    _user_callback_queue.enqueue(user_callback);
+void MavsdkImpl::reset_callback_stats()
+{
+    _callback_executor->stats().reset();
 }
 
-void MavsdkImpl::process_user_callbacks_thread()
+void MavsdkImpl::fleet_snapshot(Mavsdk::FleetSnapshot& snapshot) const
 {
-    while (!_should_exit) {
-        auto callback = _user_callback_queue.dequeue();
-        if (!callback) {
-            continue;
-        }
+    _fleet_table.snapshot(snapshot, time.elapsed_us());
+}
 
-        void* cookie{nullptr};
-
-        const double timeout_s = 1.0;
-        timeout_handler.add(
-            [&]() {
-                if (_callback_debugging) {
-                    LogWarn() << "Callback called from " << callback.value().filename << ":"
-                              << callback.value().linenumber << " took more than " << timeout_s
-                              << " second to run.";
-                    fflush(stdout);
-                    fflush(stderr);
-                    abort();
-                } else {
-                    LogWarn()
-                        << "Callback took more than " << timeout_s << " second to run.\n"
-                        << "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
-                }
-            },
-            timeout_s,
-            &cookie);
-        callback.value().func();
-        timeout_handler.remove(cookie);
+void MavsdkImpl::log_callback_stats_if_requested()
+{
+    if (!_callback_stats_signal) {
+        return;
+    }
+
+    const auto requests = callback_stats_requests.load(std::memory_order_relaxed);
+    if (requests == _callback_stats_requests_seen) {
+        return;
+    }
+    _callback_stats_requests_seen = requests;
+
+    for (const auto& stats : callback_stats()) {
+        LogInfo() << "Callback " << stats.location << ": " << stats.duration.count
+                  << " calls, queue delay p50/p99/max: " << stats.queue_delay.p50_s * 1e3 << "/"
+                  << stats.queue_delay.p99_s * 1e3 << "/" << stats.queue_delay.max_s * 1e3
+                  << " ms, duration p50/p99/max: " << stats.duration.p50_s * 1e3 << "/"
+                  << stats.duration.p99_s * 1e3 << "/" << stats.duration.max_s * 1e3 << " ms";
     }
 }
 
@@ -23,6 +23,8 @@
 #include "sender.h"
 #include "timeout_handler.h"
 #include "callback_list.h"
+#include "callback_executor.h"
+#include "fleet_table.h"
 #include "ping.h"
 
 namespace mavsdk {
@@ -112,8 +114,19 @@ public:
     TimeoutHandler timeout_handler;
     CallEveryHandler call_every_handler;
 
+    // The system ID is used to shard callbacks, 0 for callbacks which don't
+    // belong to a system.
     void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+        const char* filename,
+        int linenumber,
+        UserCallbackFunction&& func,
+        uint8_t system_id = 0);
+
+    std::vector<Mavsdk::CallbackShardMetrics> callback_shard_metrics() const;
+    std::vector<Mavsdk::CallbackStats> callback_stats() const;
+    void reset_callback_stats();
+
+    void fleet_snapshot(Mavsdk::FleetSnapshot& snapshot) const;
 
     void set_timeout_s(double timeout_s) { _timeout_s = timeout_s; }
 
@@ -129,7 +142,7 @@ private:
     void make_system_with_component(uint8_t system_id, uint8_t component_id);
 
     void work_thread();
-    void process_user_callbacks_thread();
+    void log_callback_stats_if_requested();
 
     void send_heartbeat();
     bool is_any_system_connected() const;
@@ -155,28 +168,18 @@ private:
 
     CallbackList<> _new_system_callbacks{};
 
-    Mavsdk::Configuration _configuration{Mavsdk::ComponentType::GroundStation};
+    FleetTable _fleet_table{};
 
-    struct UserCallback {
-        UserCallback() = default;
-        explicit UserCallback(std::function<void()> func_) : func(std::move(func_)) {}
-        UserCallback(std::function<void()> func_, std::string filename_, const int linenumber_) :
-            func(std::move(func_)),
-            filename(std::move(filename_)),
-            linenumber(linenumber_)
-        {}
-
-        std::function<void()> func{};
-        std::string filename{};
-        int linenumber{};
-    };
+    Mavsdk::Configuration _configuration{Mavsdk::ComponentType::GroundStation};
 
     std::thread* _work_thread{nullptr};
-    std::thread* _process_user_callbacks_thread{nullptr};
-    SafeQueue<UserCallback> _user_callback_queue{};
+    std::unique_ptr<CallbackExecutor> _callback_executor{};
+    Mavsdk::CallbackSharding _callback_sharding{Mavsdk::CallbackSharding::System};
 
     bool _message_logging_on{false};
     bool _callback_debugging{false};
+    bool _callback_stats_signal{false};
+    unsigned _callback_stats_requests_seen{0};
 
     mutable std::mutex _intercept_callback_mutex{};
     std::function<bool(mavlink_message_t&)> _intercept_incoming_messages_callback{nullptr};
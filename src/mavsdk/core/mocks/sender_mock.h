@@ -18,6 +18,10 @@ public:
     MOCK_METHOD(uint8_t, get_own_system_id, (), (const, override));
     MOCK_METHOD(uint8_t, get_own_component_id, (), (const, override));
     MOCK_METHOD(Autopilot, autopilot, (), (const, override));
+    Time& get_time() override { return _time; }
+
+private:
+    Time _time{};
 };
 
 } // namespace testing
@@ -7,4 +7,9 @@ PluginImplBase::PluginImplBase(System& system) : _system_impl(system.system_impl
 PluginImplBase::PluginImplBase(std::shared_ptr<System> system) : _system_impl(system->system_impl())
 {}
 
+std::shared_ptr<SystemImpl> PluginImplBase::system_impl_of(System& system)
+{
+    return system.system_impl();
+}
+
 } // namespace mavsdk
@@ -59,6 +59,9 @@ public:
     const PluginImplBase& operator=(const PluginImplBase&) = delete;
 
 protected:
+    // For impls that need to find the SystemImpl before they are constructed.
+    static std::shared_ptr<SystemImpl> system_impl_of(System& system);
+
     std::shared_ptr<SystemImpl> _system_impl;
 };
 
@@ -0,0 +1,69 @@
+#include "request_window.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mavsdk {
+
+RequestWindow::RequestWindow(unsigned max_size, unsigned initial_size) :
+    _max_size(std::max(max_size, 1u)),
+    _size(std::clamp(static_cast<double>(initial_size), 1.0, static_cast<double>(_max_size))),
+    _slow_start_threshold(static_cast<double>(_max_size))
+{}
+
+void RequestWindow::set_max_size(unsigned max_size)
+{
+    _max_size = std::max(max_size, 1u);
+    _size = std::min(_size, static_cast<double>(_max_size));
+    _slow_start_threshold = std::min(_slow_start_threshold, static_cast<double>(_max_size));
+}
+
+unsigned RequestWindow::size() const
+{
+    return static_cast<unsigned>(_size);
+}
+
+void RequestWindow::on_answer(double rtt_s)
+{
+    // RTT estimation as in RFC 6298.
+    if (!_has_rtt) {
+        _smoothed_rtt_s = rtt_s;
+        _rtt_variation_s = rtt_s / 2.0;
+        _has_rtt = true;
+    } else {
+        _rtt_variation_s = 0.75 * _rtt_variation_s + 0.25 * std::abs(_smoothed_rtt_s - rtt_s);
+        _smoothed_rtt_s = 0.875 * _smoothed_rtt_s + 0.125 * rtt_s;
+    }
+
+    if (_answers_since_loss < std::numeric_limits<unsigned>::max()) {
+        ++_answers_since_loss;
+    }
+
+    if (_size < _slow_start_threshold) {
+        _size += 1.0;
+    } else {
+        _size += 1.0 / _size;
+    }
+    _size = std::min(_size, static_cast<double>(_max_size));
+}
+
+void RequestWindow::on_loss()
+{
+    if (_answers_since_loss < size()) {
+        return;
+    }
+    _answers_since_loss = 0;
+
+    _size = std::max(_size / 2.0, 1.0);
+    _slow_start_threshold = _size;
+}
+
+double RequestWindow::retransmit_timeout_s(double min_s, double max_s) const
+{
+    if (!_has_rtt) {
+        return max_s;
+    }
+    return std::clamp(_smoothed_rtt_s + 4.0 * _rtt_variation_s, min_s, max_s);
+}
+
+} // namespace mavsdk
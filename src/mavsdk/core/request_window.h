@@ -0,0 +1,45 @@
+#pragma once
+
+#include <limits>
+
+namespace mavsdk {
+
+// Number of requests to keep in flight when each request is answered
+// individually, e.g. reading missing params or file chunks over a lossy link.
+//
+// Similar to TCP congestion control: the window grows by one per answer
+// until the first loss, after that by about one per round trip. On loss it
+// is halved, but only once per window of answers, as several requests lost
+// within one round trip are usually due to the same cause. The smoothed
+// round trip time and its variation determine how long to wait for an
+// answer before a request counts as lost.
+class RequestWindow {
+public:
+    explicit RequestWindow(unsigned max_size, unsigned initial_size = 4);
+
+    void set_max_size(unsigned max_size);
+    [[nodiscard]] unsigned max_size() const { return _max_size; }
+
+    [[nodiscard]] unsigned size() const;
+
+    void on_answer(double rtt_s);
+    void on_loss();
+
+    [[nodiscard]] double smoothed_rtt_s() const { return _smoothed_rtt_s; }
+
+    // Time to wait for an answer, clamped as there are no RTT samples yet
+    // at the beginning.
+    [[nodiscard]] double retransmit_timeout_s(double min_s, double max_s) const;
+
+private:
+    unsigned _max_size;
+    double _size;
+    double _slow_start_threshold;
+    unsigned _answers_since_loss{std::numeric_limits<unsigned>::max()};
+
+    bool _has_rtt{false};
+    double _smoothed_rtt_s{0.0};
+    double _rtt_variation_s{0.0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,67 @@
+#include "request_window.h"
+
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(RequestWindow, GrowsUntilMax)
+{
+    RequestWindow window{10, 2};
+    EXPECT_EQ(window.size(), 2);
+
+    window.on_answer(0.1);
+    window.on_answer(0.1);
+    EXPECT_EQ(window.size(), 4);
+
+    for (unsigned i = 0; i < 100; ++i) {
+        window.on_answer(0.1);
+    }
+    EXPECT_EQ(window.size(), 10);
+}
+
+TEST(RequestWindow, HalvesOnLoss)
+{
+    RequestWindow window{16, 16};
+
+    window.on_loss();
+    EXPECT_EQ(window.size(), 8);
+
+    // After a loss it only grows slowly.
+    window.on_answer(0.1);
+    EXPECT_EQ(window.size(), 8);
+    for (unsigned i = 0; i < 8; ++i) {
+        window.on_answer(0.1);
+    }
+    EXPECT_EQ(window.size(), 9);
+
+    // Only once per window of answers.
+    window.on_loss();
+    window.on_loss();
+    EXPECT_EQ(window.size(), 4);
+
+    // Never below 1.
+    for (unsigned i = 0; i < 10; ++i) {
+        for (unsigned j = 0; j < window.size(); ++j) {
+            window.on_answer(0.1);
+        }
+        window.on_loss();
+    }
+    EXPECT_EQ(window.size(), 1);
+}
+
+TEST(RequestWindow, RetransmitTimeout)
+{
+    RequestWindow window{4};
+
+    // Without samples, be conservative.
+    EXPECT_DOUBLE_EQ(window.retransmit_timeout_s(0.05, 1.0), 1.0);
+
+    for (unsigned i = 0; i < 50; ++i) {
+        window.on_answer(0.1);
+    }
+    EXPECT_NEAR(window.smoothed_rtt_s(), 0.1, 1e-6);
+    EXPECT_NEAR(window.retransmit_timeout_s(0.05, 1.0), 0.1, 0.01);
+
+    // Clamped to the minimum.
+    EXPECT_DOUBLE_EQ(window.retransmit_timeout_s(0.5, 1.0), 0.5);
+}
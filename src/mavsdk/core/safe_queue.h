@@ -1,10 +1,12 @@
 #pragma once
 
-#include <queue>
+#include <algorithm>
 #include <mutex>
 #include <optional>
 #include <condition_variable>
 #include <cstdio>
+#include <utility>
+#include <vector>
 
 namespace mavsdk {
 
@@ -21,14 +23,18 @@ public:
     void enqueue(T item)
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _queue.push(item);
+        if (_size == _slots.size()) {
+            grow();
+        }
+        _slots[(_head + _size) % _slots.size()].emplace(std::move(item));
+        ++_size;
         _condition_var.notify_one();
     }
 
     std::optional<T> dequeue()
     {
         std::unique_lock<std::mutex> lock(_mutex);
-        while (_queue.empty()) {
+        while (_size == 0) {
             if (_should_exit) {
                 return std::nullopt;
             }
@@ -38,9 +44,12 @@ public:
         if (_should_exit) {
             return std::nullopt;
         } else {
-            T item = _queue.front();
-            _queue.pop();
-            return {item};
+            auto& slot = _slots[_head];
+            std::optional<T> item{std::move(slot)};
+            slot.reset();
+            _head = (_head + 1) % _slots.size();
+            --_size;
+            return item;
         }
     }
 
@@ -56,11 +65,25 @@ public:
     std::size_t size() const
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        return _queue.size();
+        return _size;
     }
 
 private:
-    std::queue<T> _queue{};
+    // Slots are reused in a ring, so once the queue has grown to its usual
+    // depth, enqueueing and dequeueing don't allocate anymore.
+    void grow()
+    {
+        std::vector<std::optional<T>> slots(std::max<std::size_t>(8, _slots.size() * 2));
+        for (std::size_t i = 0; i < _size; ++i) {
+            slots[i] = std::move(_slots[(_head + i) % _slots.size()]);
+        }
+        _slots = std::move(slots);
+        _head = 0;
+    }
+
+    std::vector<std::optional<T>> _slots{};
+    std::size_t _head{0};
+    std::size_t _size{0};
     mutable std::mutex _mutex{};
     std::condition_variable _condition_var{};
     bool _should_exit{false};
@@ -3,6 +3,7 @@
 #include "autopilot.h"
 #include "mavlink_include.h"
 #include "mavlink_address.h"
+#include "mavsdk_time.h"
 #include <cstdint>
 #include <functional>
 
@@ -18,6 +19,7 @@ public:
     [[nodiscard]] virtual uint8_t get_own_system_id() const = 0;
     [[nodiscard]] virtual uint8_t get_own_component_id() const = 0;
     [[nodiscard]] virtual Autopilot autopilot() const = 0;
+    virtual Time& get_time() = 0;
 };
 
 } // namespace mavsdk
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace mavsdk {
+
+// Sequence lock holding a copy of a trivially copyable value.
+//
+// Readers never take a lock: they copy the value and retry if a write
+// happened in the meantime. Writers don't wait for readers either, they only
+// serialize against each other which is usually a single receive thread.
+//
+// The payload is stored in atomic words so that concurrent reads and writes
+// are not a data race, see:
+// https://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf
+template<typename T> class Seqlock {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock requires trivially copyable type");
+
+    Seqlock() : Seqlock(T{}) {}
+    explicit Seqlock(const T& value) { write_words(value); }
+    ~Seqlock() = default;
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    T load() const
+    {
+        std::array<uint64_t, num_words> words;
+        uint32_t seq_before;
+        uint32_t seq_after;
+        do {
+            seq_before = _seq.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < num_words; ++i) {
+                words[i] = _words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq_after = _seq.load(std::memory_order_relaxed);
+        } while ((seq_before & 1) != 0 || seq_before != seq_after);
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    void store(const T& value)
+    {
+        const uint32_t seq = begin_write();
+        write_words(value);
+        end_write(seq);
+    }
+
+    // Modify the value in place, e.g. to set a single member of a struct.
+    template<typename F> void update(F&& func)
+    {
+        const uint32_t seq = begin_write();
+        T value = read_words();
+        func(value);
+        write_words(value);
+        end_write(seq);
+    }
+
+    // Incremented on every write, can be used to detect changes.
+    uint32_t version() const { return _seq.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    uint32_t begin_write()
+    {
+        // An odd sequence number means a write is in progress. Another writer
+        // has to wait for that to finish which should be very short.
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        while ((seq & 1) != 0 ||
+               !_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed)) {
+            seq = _seq.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    void end_write(uint32_t seq) { _seq.store(seq + 2, std::memory_order_release); }
+
+    T read_words() const
+    {
+        std::array<uint64_t, num_words> words;
+        for (std::size_t i = 0; i < num_words; ++i) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    void write_words(const T& value)
+    {
+        std::array<uint64_t, num_words> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (std::size_t i = 0; i < num_words; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> _seq{0};
+    std::array<std::atomic<uint64_t>, num_words> _words{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,129 @@
+#include "seqlock.h"
+#include "log.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Sample {
+    double a{0.0};
+    double b{0.0};
+    float c{0.0f};
+    uint64_t d{0};
+};
+
+} // namespace
+
+TEST(Seqlock, StoreAndLoad)
+{
+    Seqlock<Sample> seqlock;
+    EXPECT_EQ(seqlock.load().d, 0);
+
+    seqlock.store(Sample{1.0, 2.0, 3.0f, 4});
+    auto sample = seqlock.load();
+    EXPECT_DOUBLE_EQ(sample.a, 1.0);
+    EXPECT_DOUBLE_EQ(sample.b, 2.0);
+    EXPECT_FLOAT_EQ(sample.c, 3.0f);
+    EXPECT_EQ(sample.d, 4);
+    EXPECT_EQ(seqlock.version(), 1);
+}
+
+TEST(Seqlock, Update)
+{
+    Seqlock<Sample> seqlock{Sample{1.0, 2.0, 3.0f, 4}};
+
+    seqlock.update([](Sample& sample) { sample.d = 42; });
+    auto sample = seqlock.load();
+    EXPECT_DOUBLE_EQ(sample.a, 1.0);
+    EXPECT_EQ(sample.d, 42);
+}
+
+TEST(Seqlock, ConcurrentReadersSeeNoTornValues)
+{
+    Seqlock<Sample> seqlock;
+    std::atomic<bool> done{false};
+
+    // Write as fast as possible to provoke torn reads.
+    std::thread writer([&]() {
+        for (uint64_t i = 1; !done; ++i) {
+            const auto value = static_cast<double>(i);
+            seqlock.store(Sample{value, value, static_cast<float>(i % 1000), i});
+        }
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<unsigned> torn{0};
+    for (unsigned r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            for (unsigned i = 0; i < 200000; ++i) {
+                const auto sample = seqlock.load();
+                if (sample.a != sample.b || sample.a != static_cast<double>(sample.d)) {
+                    ++torn;
+                }
+            }
+        });
+    }
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    done = true;
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+}
+
+TEST(Seqlock, GetterLatencyAgainstMutex)
+{
+    // Compare getter latency with 250 Hz updates from a "receive thread",
+    // the way telemetry fields are used.
+    constexpr unsigned num_reads = 1000000;
+
+    Seqlock<Sample> seqlock;
+    std::mutex mutex;
+    Sample guarded;
+
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (uint64_t i = 1; !done; ++i) {
+            seqlock.store(Sample{1.0, 2.0, 3.0f, i});
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                guarded = Sample{1.0, 2.0, 3.0f, i};
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+    });
+
+    uint64_t sum = 0;
+    auto before = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < num_reads; ++i) {
+        sum += seqlock.load().d;
+    }
+    const auto seqlock_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - before)
+                                .count();
+
+    before = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < num_reads; ++i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sum += guarded.d;
+    }
+    const auto mutex_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - before)
+                              .count();
+
+    done = true;
+    writer.join();
+
+    LogInfo() << "Getter latency: seqlock " << static_cast<double>(seqlock_ns) / num_reads
+              << " ns, mutex " << static_cast<double>(mutex_ns) / num_reads << " ns (" << sum
+              << ")";
+}
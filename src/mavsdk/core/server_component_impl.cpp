@@ -280,9 +280,9 @@ uint32_t ServerComponentImpl::get_custom_mode() const
 }
 
 void ServerComponentImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename, const int linenumber, UserCallbackFunction&& func)
 {
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    _mavsdk_impl.call_user_callback_located(filename, linenumber, std::move(func));
 }
 
 void ServerComponentImpl::register_timeout_handler(
@@ -418,4 +418,9 @@ Autopilot ServerComponentImpl::OurSender::autopilot() const
     return Autopilot::Px4;
 }
 
+Time& ServerComponentImpl::OurSender::get_time()
+{
+    return _server_component_impl.get_time();
+}
+
 } // namespace mavsdk
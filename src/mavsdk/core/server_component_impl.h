@@ -9,6 +9,7 @@
 #include "mavlink_request_message_handler.h"
 #include "mavlink_ftp_server.h"
 #include "mavsdk_time.h"
+#include "callback_list.h"
 #include "flight_mode.h"
 #include "log.h"
 #include "sender.h"
@@ -41,6 +42,7 @@ public:
         [[nodiscard]] uint8_t get_own_system_id() const override;
         [[nodiscard]] uint8_t get_own_component_id() const override;
         [[nodiscard]] Autopilot autopilot() const override;
+        Time& get_time() override;
 
         uint8_t current_target_system_id{0};
 
@@ -130,7 +132,7 @@ public:
     [[nodiscard]] uint32_t get_custom_mode() const;
 
     void call_user_callback_located(
-        const std::string& filename, const int linenumber, const std::function<void()>& func);
+        const char* filename, const int linenumber, UserCallbackFunction&& func);
 
     // Autopilot version data
     void add_capabilities(uint64_t capabilities);
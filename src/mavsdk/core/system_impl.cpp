@@ -11,6 +11,7 @@
 #include "unused.h"
 #include <cassert>
 #include <cstdlib>
+#include <filesystem>
 #include <functional>
 #include <future>
 #include <utility>
@@ -148,6 +149,16 @@ double SystemImpl::timeout_s() const
     return _mavsdk_impl.timeout_s();
 }
 
+std::string SystemImpl::log_cache_directory() const
+{
+    return _mavsdk_impl.get_configuration().get_log_cache_directory();
+}
+
+std::string SystemImpl::camera_definition_cache_directory() const
+{
+    return _mavsdk_impl.get_configuration().get_camera_definition_cache_directory();
+}
+
 void SystemImpl::enable_timesync()
 {
     _timesync.enable();
@@ -377,11 +388,12 @@ void SystemImpl::add_new_component(uint8_t component_id)
     auto res_pair = _components.insert(component_id);
     if (res_pair.second) {
         std::lock_guard<std::mutex> lock(_component_discovered_callback_mutex);
-        _component_discovered_callbacks.queue(
-            component_type(component_id), [this](const auto& func) { call_user_callback(func); });
+        _component_discovered_callbacks.queue(component_type(component_id), [this](auto&& func) {
+            call_user_callback(std::move(func));
+        });
         _component_discovered_id_callbacks.queue(
-            component_type(component_id), component_id, [this](const auto& func) {
-                call_user_callback(func);
+            component_type(component_id), component_id, [this](auto&& func) {
+                call_user_callback(std::move(func));
             });
         LogDebug() << "Component " << component_name(component_id) << " (" << int(component_id)
                    << ") added.";
@@ -402,7 +414,7 @@ SystemImpl::subscribe_component_discovered(const System::ComponentDiscoveredCall
     if (total_components() > 0) {
         for (const auto& elem : _components) {
             _component_discovered_callbacks.queue(
-                component_type(elem), [this](const auto& func) { call_user_callback(func); });
+                component_type(elem), [this](auto&& func) { call_user_callback(std::move(func)); });
         }
     }
     return handle;
@@ -423,7 +435,9 @@ SystemImpl::subscribe_component_discovered_id(const System::ComponentDiscoveredI
     if (total_components() > 0) {
         for (const auto& elem : _components) {
             _component_discovered_id_callbacks.queue(
-                component_type(elem), elem, [this](const auto& func) { call_user_callback(func); });
+                component_type(elem), elem, [this](auto&& func) {
+                    call_user_callback(std::move(func));
+                });
         }
     }
     return handle;
@@ -570,7 +584,7 @@ void SystemImpl::set_connected()
             }
 
             // We call this later to avoid deadlocks on creating the server components.
-            _mavsdk_impl.call_user_callback([this]() {
+            call_user_callback([this]() {
                 // Send a heartbeat back immediately.
                 _mavsdk_impl.start_sending_heartbeats();
             });
@@ -583,7 +597,7 @@ void SystemImpl::set_connected()
             enable_needed = true;
 
             _is_connected_callbacks.queue(
-                true, [this](const auto& func) { _mavsdk_impl.call_user_callback(func); });
+                true, [this](auto&& func) { call_user_callback(std::move(func)); });
 
         } else if (_connected) {
             refresh_timeout_handler(_heartbeat_timeout_cookie);
@@ -615,7 +629,7 @@ void SystemImpl::set_disconnected()
         _connected = false;
         _mavsdk_impl.notify_on_timeout();
         _is_connected_callbacks.queue(
-            false, [this](const auto& func) { _mavsdk_impl.call_user_callback(func); });
+            false, [this](auto&& func) { call_user_callback(std::move(func)); });
     }
 
     _mavsdk_impl.stop_sending_heartbeats();
@@ -1202,6 +1216,90 @@ void SystemImpl::set_msg_rate_async(
     send_command_async(command, callback);
 }
 
+void SystemImpl::set_msg_rates_async(
+    const std::vector<std::pair<uint16_t, double>>& message_rates,
+    const std::function<void(MavlinkCommandSender::Result)>& callback,
+    uint8_t component_id)
+{
+    send_msg_rates_async(
+        message_rates,
+        true,
+        [this, message_rates, callback, component_id](MavlinkCommandSender::Result result) {
+            if (result != MavlinkCommandSender::Result::Timeout) {
+                callback(result);
+                return;
+            }
+
+            // With a command or ack lost we don't know which ones have been
+            // applied. Setting a rate twice doesn't hurt, so send all of them
+            // again, this time waiting for each ack.
+            LogWarn() << "Setting message rates timed out, retrying one by one";
+            send_msg_rates_async(message_rates, false, callback, component_id);
+        },
+        component_id);
+}
+
+void SystemImpl::send_msg_rates_async(
+    const std::vector<std::pair<uint16_t, double>>& message_rates,
+    bool pipelined,
+    const std::function<void(MavlinkCommandSender::Result)>& callback,
+    uint8_t component_id)
+{
+    if (message_rates.empty()) {
+        callback(MavlinkCommandSender::Result::Success);
+        return;
+    }
+
+    if (_target_address.system_id == 0 && _components.empty()) {
+        callback(MavlinkCommandSender::Result::NoSystem);
+        return;
+    }
+
+    struct Aggregate {
+        std::mutex mutex{};
+        size_t remaining{0};
+        MavlinkCommandSender::Result result{MavlinkCommandSender::Result::Success};
+    };
+    auto aggregate = std::make_shared<Aggregate>();
+    aggregate->remaining = message_rates.size();
+
+    for (const auto& message_rate : message_rates) {
+        auto command = make_command_msg_rate(message_rate.first, message_rate.second, component_id);
+        command.target_system_id = get_system_id();
+
+        auto command_callback = [aggregate, callback](MavlinkCommandSender::Result result, float) {
+            if (result == MavlinkCommandSender::Result::InProgress) {
+                return;
+            }
+
+            bool done = false;
+            MavlinkCommandSender::Result final_result;
+            {
+                std::lock_guard<std::mutex> lock(aggregate->mutex);
+                // Keep the first error, but a timeout takes precedence as the
+                // caller retries in that case.
+                if (result != MavlinkCommandSender::Result::Success &&
+                    (aggregate->result == MavlinkCommandSender::Result::Success ||
+                     result == MavlinkCommandSender::Result::Timeout)) {
+                    aggregate->result = result;
+                }
+                done = --aggregate->remaining == 0;
+                final_result = aggregate->result;
+            }
+
+            if (done) {
+                callback(final_result);
+            }
+        };
+
+        if (pipelined) {
+            _command_sender.queue_pipelined_command_async(command, command_callback);
+        } else {
+            _command_sender.queue_command_async(command, command_callback);
+        }
+    }
+}
+
 MavlinkCommandSender::CommandLong
 SystemImpl::make_command_msg_rate(uint16_t message_id, double rate_hz, uint8_t component_id)
 {
@@ -1259,10 +1357,37 @@ void SystemImpl::unregister_plugin(PluginImplBase* plugin_impl)
     }
 }
 
+void SystemImpl::register_shared_plugin_impl(
+    const std::string& name, PluginImplBase* plugin_impl)
+{
+    assert(plugin_impl);
+
+    // The first impl stays shared, later ones for the same plugin keep to themselves.
+    std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
+    _shared_plugin_impls.emplace(name, plugin_impl);
+}
+
+void SystemImpl::unregister_shared_plugin_impl(
+    const std::string& name, PluginImplBase* plugin_impl)
+{
+    std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
+    auto found = _shared_plugin_impls.find(name);
+    if (found != _shared_plugin_impls.end() && found->second == plugin_impl) {
+        _shared_plugin_impls.erase(found);
+    }
+}
+
+PluginImplBase* SystemImpl::shared_plugin_impl(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
+    auto found = _shared_plugin_impls.find(name);
+    return found != _shared_plugin_impls.end() ? found->second : nullptr;
+}
+
 void SystemImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename, const int linenumber, UserCallbackFunction&& func)
 {
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    _mavsdk_impl.call_user_callback_located(filename, linenumber, std::move(func), get_system_id());
 }
 
 void SystemImpl::param_changed(const std::string& name)
@@ -1355,6 +1480,14 @@ MavlinkParameterClient* SystemImpl::param_sender(uint8_t component_id, bool exte
          component_id,
          extended});
 
+    const auto param_cache_directory = _mavsdk_impl.get_configuration().get_param_cache_directory();
+    if (!param_cache_directory.empty()) {
+        const auto filename = "params_" + std::to_string(get_system_id()) + "_" +
+                              std::to_string(component_id) + (extended ? "_ext" : "") + ".bin";
+        _mavlink_parameter_clients.back().parameter_client->set_cache_file(
+            (std::filesystem::path(param_cache_directory) / filename).string());
+    }
+
     return _mavlink_parameter_clients.back().parameter_client.get();
 }
 
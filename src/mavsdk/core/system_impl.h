@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <functional>
 #include <atomic>
+#include <string>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -103,6 +104,14 @@ public:
         const CommandResultCallback& callback,
         uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1);
 
+    // Sets the rates of several messages with pipelined commands and calls the
+    // callback once with the first error, or success if all were accepted.
+    // If anything times out, all of them are sent again one by one.
+    void set_msg_rates_async(
+        const std::vector<std::pair<uint16_t, double>>& message_rates,
+        const std::function<void(MavlinkCommandSender::Result)>& callback,
+        uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1);
+
     // Adds unique component ids
     void add_new_component(uint8_t component_id);
     size_t total_components() const;
@@ -276,8 +285,14 @@ public:
     void register_plugin(PluginImplBase* plugin_impl);
     void unregister_plugin(PluginImplBase* plugin_impl);
 
+    // Hand-written plugin extensions look up the impl of the plugin they extend by name,
+    // so that both share one impl instead of handling every message twice.
+    void register_shared_plugin_impl(const std::string& name, PluginImplBase* plugin_impl);
+    void unregister_shared_plugin_impl(const std::string& name, PluginImplBase* plugin_impl);
+    PluginImplBase* shared_plugin_impl(const std::string& name);
+
     void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+        const char* filename, int linenumber, UserCallbackFunction&& func);
 
     void send_autopilot_version_request();
     void send_autopilot_version_request_async(
@@ -295,6 +310,8 @@ public:
     const SystemImpl& operator=(const SystemImpl&) = delete;
 
     double timeout_s() const;
+    std::string log_cache_directory() const;
+    std::string camera_definition_cache_directory() const;
 
 private:
     static bool is_autopilot(uint8_t comp_id);
@@ -332,6 +349,12 @@ private:
     MavlinkCommandSender::CommandLong
     make_command_msg_rate(uint16_t message_id, double rate_hz, uint8_t component_id);
 
+    void send_msg_rates_async(
+        const std::vector<std::pair<uint16_t, double>>& message_rates,
+        bool pipelined,
+        const std::function<void(MavlinkCommandSender::Result)>& callback,
+        uint8_t component_id);
+
     static void receive_float_param(
         MavlinkParameterClient::Result result,
         ParamValue value,
@@ -396,6 +419,7 @@ private:
 
     std::mutex _plugin_impls_mutex{};
     std::vector<PluginImplBase*> _plugin_impls{};
+    std::unordered_map<std::string, PluginImplBase*> _shared_plugin_impls{};
 
     // We used set to maintain unique component ids
     std::unordered_set<uint8_t> _components{};
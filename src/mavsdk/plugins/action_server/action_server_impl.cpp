@@ -87,8 +87,8 @@ void ActionServerImpl::init()
                               ActionServer::Result::Success :
                               ActionServer::Result::CommandDenied;
 
-            _arm_disarm_callbacks.queue(result, armDisarm, [this](const auto& func) {
-                _server_component_impl->call_user_callback(func);
+            _arm_disarm_callbacks.queue(result, armDisarm, [this](auto&& func) {
+                _server_component_impl->call_user_callback(std::move(func));
             });
 
             return _server_component_impl->make_command_ack_message(command, request_ack);
@@ -100,16 +100,16 @@ void ActionServerImpl::init()
         [this](const MavlinkCommandReceiver::CommandLong& command) {
             if (_allow_takeoff) {
                 _takeoff_callbacks.queue(
-                    ActionServer::Result::Success, true, [this](const auto& func) {
-                        _server_component_impl->call_user_callback(func);
+                    ActionServer::Result::Success, true, [this](auto&& func) {
+                        _server_component_impl->call_user_callback(std::move(func));
                     });
 
                 return _server_component_impl->make_command_ack_message(
                     command, MAV_RESULT::MAV_RESULT_ACCEPTED);
             } else {
                 _takeoff_callbacks.queue(
-                    ActionServer::Result::CommandDenied, false, [this](const auto& func) {
-                        _server_component_impl->call_user_callback(func);
+                    ActionServer::Result::CommandDenied, false, [this](auto&& func) {
+                        _server_component_impl->call_user_callback(std::move(func));
                     });
 
                 return _server_component_impl->make_command_ack_message(
@@ -143,7 +143,9 @@ void ActionServerImpl::init()
                 _flight_mode_change_callbacks.queue(
                     ActionServer::Result::ParameterError,
                     request_flight_mode,
-                    [this](const auto& func) { _server_component_impl->call_user_callback(func); });
+                    [this](auto&& func) {
+                        _server_component_impl->call_user_callback(std::move(func));
+                    });
 
                 return _server_component_impl->make_command_ack_message(
                     command, MAV_RESULT::MAV_RESULT_UNSUPPORTED);
@@ -181,7 +183,9 @@ void ActionServerImpl::init()
             _flight_mode_change_callbacks.queue(
                 allow_mode ? ActionServer::Result::Success : ActionServer::Result::CommandDenied,
                 request_flight_mode,
-                [this](const auto& func) { _server_component_impl->call_user_callback(func); });
+                [this](auto&& func) {
+                    _server_component_impl->call_user_callback(std::move(func));
+                });
 
             return _server_component_impl->make_command_ack_message(
                 command,
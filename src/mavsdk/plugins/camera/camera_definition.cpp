@@ -29,6 +29,22 @@ bool CameraDefinition::load_string(const std::string& content)
     return parse_xml();
 }
 
+void CameraDefinition::load_definition(const CameraDefinition& definition)
+{
+    std::scoped_lock lock(_mutex, definition._mutex);
+
+    _parameter_map = definition._parameter_map;
+    _model = definition._model;
+    _vendor = definition._vendor;
+
+    _current_settings.clear();
+    for (const auto& parameter : _parameter_map) {
+        InternalCurrentSetting empty_setting{};
+        empty_setting.needs_updating = true;
+        _current_settings[parameter.first] = empty_setting;
+    }
+}
+
 std::string CameraDefinition::get_model() const
 {
     std::lock_guard<std::mutex> lock(_mutex);
@@ -21,6 +21,10 @@ public:
     bool load_file(const std::string& filepath);
     bool load_string(const std::string& content);
 
+    // Takes over the parsed parameters of a definition loaded before, so the
+    // XML is not parsed again. The current settings are not taken over.
+    void load_definition(const CameraDefinition& definition);
+
     std::string get_vendor() const;
     std::string get_model() const;
 
@@ -107,7 +111,8 @@ private:
 
     tinyxml2::XMLDocument _doc{};
 
-    std::unordered_map<std::string, std::shared_ptr<Parameter>> _parameter_map{};
+    // Not modified after parsing, so the parameters can be shared between definitions.
+    std::unordered_map<std::string, std::shared_ptr<const Parameter>> _parameter_map{};
 
     struct InternalCurrentSetting {
         ParamValue value{};
@@ -0,0 +1,167 @@
+#include "camera_definition_cache.h"
+#include "file_io.h"
+#include "log.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace mavsdk {
+
+namespace {
+
+constexpr std::array<char, 4> cache_file_magic{'M', 'C', 'D', '1'};
+
+std::string cache_key(const std::string& uri, uint16_t version)
+{
+    return uri + '#' + std::to_string(version);
+}
+
+// FNV-1a, so file names stay the same across builds and platforms, unlike std::hash.
+uint64_t fnv1a_64(const std::string& str)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : str) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+CameraDefinitionCache& CameraDefinitionCache::shared()
+{
+    static CameraDefinitionCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CameraDefinition> CameraDefinitionCache::get(
+    const std::string& uri,
+    uint16_t version,
+    const std::string& cache_directory,
+    const DownloadFunction& download)
+{
+    const auto key = cache_key(uri, version);
+
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& found = _entries[key];
+        if (!found) {
+            found = std::make_shared<Entry>();
+        }
+        entry = found;
+    }
+
+    // Held during the download, so the same definition is only fetched once.
+    std::lock_guard<std::mutex> entry_lock(entry->mutex);
+    if (entry->definition) {
+        return entry->definition;
+    }
+
+    const auto path = file_path(cache_directory, uri, version);
+
+    std::string content;
+    if (!path.empty() && load_file(path, key, content)) {
+        LogDebug() << "Using cached camera definition for " << uri;
+        entry->definition = parse(content);
+        if (entry->definition) {
+            return entry->definition;
+        }
+        LogWarn() << "Cached camera definition " << path << " invalid, downloading again";
+        content.clear();
+    }
+
+    if (!download(content)) {
+        return nullptr;
+    }
+
+    entry->definition = parse(content);
+    if (!entry->definition) {
+        return nullptr;
+    }
+
+    if (!path.empty() && !save_file(path, key, content)) {
+        LogWarn() << "Could not save camera definition to " << path;
+    }
+
+    return entry->definition;
+}
+
+void CameraDefinitionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+std::string CameraDefinitionCache::file_path(
+    const std::string& cache_directory, const std::string& uri, uint16_t version)
+{
+    if (cache_directory.empty()) {
+        return {};
+    }
+
+    std::stringstream filename;
+    filename << "camera_definition_" << std::hex << std::setw(16) << std::setfill('0')
+             << fnv1a_64(cache_key(uri, version)) << ".bin";
+    return (fs::path(cache_directory) / filename.str()).string();
+}
+
+std::shared_ptr<const CameraDefinition> CameraDefinitionCache::parse(const std::string& content)
+{
+    auto definition = std::make_shared<CameraDefinition>();
+    if (!definition->load_string(content)) {
+        return nullptr;
+    }
+    return definition;
+}
+
+bool CameraDefinitionCache::load_file(
+    const std::string& path, const std::string& key, std::string& content)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    // The key is stored as well, in case two keys end up with the same file name.
+    std::array<char, 4> magic{};
+    uint16_t key_size;
+    uint32_t content_size;
+    std::string file_key;
+    if (!file.read(magic.data(), magic.size()) || magic != cache_file_magic ||
+        !read_raw(file, key_size)) {
+        return false;
+    }
+    file_key.resize(key_size);
+    if (!file.read(file_key.data(), key_size) || file_key != key ||
+        !read_raw(file, content_size)) {
+        return false;
+    }
+
+    content.resize(content_size);
+    return static_cast<bool>(file.read(content.data(), content_size));
+}
+
+bool CameraDefinitionCache::save_file(
+    const std::string& path, const std::string& key, const std::string& content)
+{
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+
+    return write_file_atomically(path, [&](std::ofstream& file) {
+        file.write(cache_file_magic.data(), cache_file_magic.size());
+        write_raw(file, static_cast<uint16_t>(key.size()));
+        file.write(key.data(), static_cast<std::streamsize>(key.size()));
+        write_raw(file, static_cast<uint32_t>(content.size()));
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return true;
+    });
+}
+
+} // namespace mavsdk
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "camera_definition.h"
+
+namespace mavsdk {
+
+// Camera definitions by URI and version, shared by all cameras in the process.
+//
+// Each definition is downloaded and parsed once. Cameras take over the parsed
+// parameters with CameraDefinition::load_definition and keep their own
+// settings. If a cache directory is given, the XML is also stored there, so it
+// is not downloaded again on the next start.
+class CameraDefinitionCache {
+public:
+    using DownloadFunction = std::function<bool(std::string& content)>;
+
+    static CameraDefinitionCache& shared();
+
+    // Returns the definition from memory or from the cache directory, and only
+    // calls download if neither has it. Cameras asking for the same definition
+    // at the same time wait for the first download instead of starting their own.
+    // Returns nullptr if the download or parsing failed.
+    std::shared_ptr<const CameraDefinition> get(
+        const std::string& uri,
+        uint16_t version,
+        const std::string& cache_directory,
+        const DownloadFunction& download);
+
+    void clear();
+
+    static std::string file_path(
+        const std::string& cache_directory, const std::string& uri, uint16_t version);
+
+private:
+    struct Entry {
+        std::mutex mutex{};
+        std::shared_ptr<const CameraDefinition> definition{};
+    };
+
+    static std::shared_ptr<const CameraDefinition> parse(const std::string& content);
+    static bool load_file(const std::string& path, const std::string& key, std::string& content);
+    static bool
+    save_file(const std::string& path, const std::string& key, const std::string& content);
+
+    std::mutex _mutex{};
+    std::unordered_map<std::string, std::shared_ptr<Entry>> _entries{};
+};
+
+} // namespace mavsdk
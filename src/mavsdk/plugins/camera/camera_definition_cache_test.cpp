@@ -0,0 +1,136 @@
+#include "camera_definition_cache.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+using namespace mavsdk;
+
+static const std::string e90_unit_test_file = "src/mavsdk/plugins/camera/e90_unit_test.xml";
+static const std::string e90_uri = "http://127.0.0.1/e90_unit_test.xml";
+
+static std::string read_e90_file()
+{
+    std::ifstream file_stream(e90_unit_test_file);
+    std::string content;
+    std::getline(file_stream, content, '\0');
+    return content;
+}
+
+TEST(CameraDefinitionCache, DownloadsOnce)
+{
+    const auto content = read_e90_file();
+    ASSERT_FALSE(content.empty());
+
+    CameraDefinitionCache cache;
+    unsigned downloads = 0;
+    const auto download = [&](std::string& out) {
+        ++downloads;
+        out = content;
+        return true;
+    };
+
+    const auto first = cache.get(e90_uri, 1, "", download);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first->get_model(), "E90");
+
+    const auto second = cache.get(e90_uri, 1, "", download);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(downloads, 1);
+
+    // A new version of the definition is downloaded again.
+    EXPECT_TRUE(cache.get(e90_uri, 2, "", download));
+    EXPECT_EQ(downloads, 2);
+}
+
+TEST(CameraDefinitionCache, FailedDownloadIsRetried)
+{
+    CameraDefinitionCache cache;
+    EXPECT_FALSE(cache.get(e90_uri, 1, "", [](std::string&) { return false; }));
+
+    // Invalid XML is not cached either.
+    EXPECT_FALSE(cache.get(e90_uri, 1, "", [](std::string& out) {
+        out = "<mavlinkcamera>";
+        return true;
+    }));
+
+    const auto content = read_e90_file();
+    EXPECT_TRUE(cache.get(e90_uri, 1, "", [&](std::string& out) {
+        out = content;
+        return true;
+    }));
+}
+
+TEST(CameraDefinitionCache, LoadsFromDirectory)
+{
+    const auto directory =
+        (std::filesystem::temp_directory_path() / "mavsdk_camera_definition_cache_test").string();
+    std::filesystem::remove_all(directory);
+
+    const auto no_download = [](std::string&) { return false; };
+
+    // Nothing to save, so the directory is not created.
+    EXPECT_FALSE(CameraDefinitionCache{}.get(e90_uri, 3, directory, no_download));
+    EXPECT_FALSE(std::filesystem::exists(directory));
+
+    const auto content = read_e90_file();
+    {
+        CameraDefinitionCache cache;
+        EXPECT_TRUE(cache.get(e90_uri, 3, directory, [&](std::string& out) {
+            out = content;
+            return true;
+        }));
+    }
+    EXPECT_TRUE(
+        std::filesystem::exists(CameraDefinitionCache::file_path(directory, e90_uri, 3)));
+
+    // As if the process started again, without a connection to the camera.
+    CameraDefinitionCache cache;
+    const auto definition = cache.get(e90_uri, 3, directory, no_download);
+    ASSERT_TRUE(definition);
+    EXPECT_EQ(definition->get_vendor(), "Yuneec");
+
+    // The version is part of the key.
+    EXPECT_FALSE(cache.get(e90_uri, 4, directory, no_download));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(CameraDefinitionCache, SettingsAreNotShared)
+{
+    const auto content = read_e90_file();
+    CameraDefinitionCache cache;
+    const auto parsed = cache.get(e90_uri, 1, "", [&](std::string& out) {
+        out = content;
+        return true;
+    });
+    ASSERT_TRUE(parsed);
+
+    CameraDefinition first;
+    first.load_definition(*parsed);
+    CameraDefinition second;
+    second.load_definition(*parsed);
+
+    // Nothing is known about the settings of a new camera.
+    std::vector<std::pair<std::string, ParamValue>> unknown_params{};
+    first.get_unknown_params(unknown_params);
+    EXPECT_EQ(unknown_params.size(), 17);
+
+    first.assume_default_settings();
+    ParamValue value;
+    value.set<uint32_t>(0);
+    EXPECT_TRUE(first.set_setting("CAM_MODE", value));
+
+    ParamValue first_value;
+    EXPECT_TRUE(first.get_setting("CAM_MODE", first_value));
+    EXPECT_EQ(first_value.get<uint32_t>(), 0);
+
+    second.get_unknown_params(unknown_params);
+    EXPECT_EQ(unknown_params.size(), 17);
+
+    second.assume_default_settings();
+    ParamValue second_value;
+    EXPECT_TRUE(second.get_setting("CAM_MODE", second_value));
+    EXPECT_EQ(second_value.get<uint32_t>(), 1);
+}
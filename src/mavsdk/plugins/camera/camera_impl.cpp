@@ -1,5 +1,6 @@
 #include "camera_impl.h"
 #include "camera_definition.h"
+#include "camera_definition_cache.h"
 #include "system.h"
 #include "mavsdk_math.h"
 #include "http_loader.h"
@@ -1418,8 +1419,9 @@ void CameraImpl::process_camera_image_captured(const mavlink_message_t& message)
         std::lock_guard<std::mutex> lock(_capture_info.mutex);
         // Notify user if a new image has been captured.
         if (_capture_info.last_advertised_image_index < capture_info.index) {
-            _capture_info.callbacks.queue(
-                capture_info, [this](const auto& func) { _system_impl->call_user_callback(func); });
+            _capture_info.callbacks.queue(capture_info, [this](auto&& func) {
+                _system_impl->call_user_callback(std::move(func));
+            });
 
             if (_capture_info.last_advertised_image_index != -1) {
                 // Save captured indices that have been dropped to request later, however, don't
@@ -1439,8 +1441,9 @@ void CameraImpl::process_camera_image_captured(const mavlink_message_t& message)
 
         else if (auto it = _capture_info.missing_image_retries.find(capture_info.index);
                  it != _capture_info.missing_image_retries.end()) {
-            _capture_info.callbacks.queue(
-                capture_info, [this](const auto& func) { _system_impl->call_user_callback(func); });
+            _capture_info.callbacks.queue(capture_info, [this](auto&& func) {
+                _system_impl->call_user_callback(std::move(func));
+            });
             _capture_info.missing_image_retries.erase(it);
         }
     }
@@ -1534,15 +1537,16 @@ void CameraImpl::process_camera_information(const mavlink_message_t& message)
     _information.data.horizontal_resolution_px = camera_information.resolution_h;
     _information.data.vertical_resolution_px = camera_information.resolution_v;
 
-    _information.subscription_callbacks.queue(
-        _information.data, [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _information.subscription_callbacks.queue(_information.data, [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 
     if (should_fetch_camera_definition(camera_information.cam_definition_uri)) {
         _is_fetching_camera_definition = true;
 
         std::thread([this, camera_information]() {
-            std::string content{};
-            const auto result = fetch_camera_definition(camera_information, content);
+            std::shared_ptr<const CameraDefinition> definition{};
+            const auto result = fetch_camera_definition(camera_information, definition);
 
             if (result == Camera::Result::Success) {
                 LogDebug() << "Successfully loaded camera definition";
@@ -1553,7 +1557,7 @@ void CameraImpl::process_camera_information(const mavlink_message_t& message)
                 }
 
                 _camera_definition.reset(new CameraDefinition());
-                _camera_definition->load_string(content);
+                _camera_definition->load_definition(*definition);
                 refresh_params();
 
             } else if (result == Camera::Result::ProtocolUnsupported) {
@@ -1593,10 +1597,26 @@ bool CameraImpl::should_fetch_camera_definition(const std::string& uri) const
 }
 
 Camera::Result CameraImpl::fetch_camera_definition(
-    const mavlink_camera_information_t& camera_information, std::string& camera_definition_out)
-{
-    auto result =
-        download_definition_file(camera_information.cam_definition_uri, camera_definition_out);
+    const mavlink_camera_information_t& camera_information,
+    std::shared_ptr<const CameraDefinition>& camera_definition_out)
+{
+    // Only downloaded if no other camera has loaded this definition before and
+    // it is not in the cache directory either.
+    const std::string uri = camera_information.cam_definition_uri;
+    auto result = Camera::Result::Success;
+    camera_definition_out = CameraDefinitionCache::shared().get(
+        uri,
+        camera_information.cam_definition_version,
+        _system_impl->camera_definition_cache_directory(),
+        [this, &uri, &result](std::string& content) {
+            result = download_definition_file(uri, content);
+            return result == Camera::Result::Success;
+        });
+
+    if (!camera_definition_out && result == Camera::Result::Success) {
+        LogErr() << "Failed to parse camera definition.";
+        result = Camera::Result::Error;
+    }
 
     return result;
 }
@@ -1719,7 +1739,7 @@ void CameraImpl::notify_video_stream_info()
 
     _video_stream_info.subscription_callbacks.queue(
         _video_stream_info.data,
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void CameraImpl::check_status()
@@ -1727,8 +1747,9 @@ void CameraImpl::check_status()
     std::lock_guard<std::mutex> lock(_status.mutex);
 
     if (_status.received_camera_capture_status && _status.received_storage_information) {
-        _status.subscription_callbacks.queue(
-            _status.data, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        _status.subscription_callbacks.queue(_status.data, [this](auto&& func) {
+            _system_impl->call_user_callback(std::move(func));
+        });
 
         _status.received_camera_capture_status = false;
         _status.received_storage_information = false;
@@ -1782,7 +1803,7 @@ void CameraImpl::notify_mode()
     std::lock_guard<std::mutex> lock(_mode.mutex);
 
     _mode.subscription_callbacks.queue(
-        _mode.data, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        _mode.data, [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 bool CameraImpl::get_possible_setting_options(std::vector<std::string>& settings)
@@ -2153,8 +2174,9 @@ void CameraImpl::notify_current_settings()
         }
     }
 
-    _subscribe_current_settings.callbacks.queue(
-        current_settings, [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _subscribe_current_settings.callbacks.queue(current_settings, [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 }
 
 void CameraImpl::notify_possible_setting_options()
@@ -2175,8 +2197,9 @@ void CameraImpl::notify_possible_setting_options()
         return;
     }
 
-    _subscribe_possible_setting_options.callbacks.queue(
-        setting_options, [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _subscribe_possible_setting_options.callbacks.queue(setting_options, [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 }
 
 std::vector<Camera::SettingOptions> CameraImpl::possible_setting_options()
@@ -193,7 +193,8 @@ private:
 
     bool should_fetch_camera_definition(const std::string& uri) const;
     Camera::Result fetch_camera_definition(
-        const mavlink_camera_information_t& camera_information, std::string& camera_definition_out);
+        const mavlink_camera_information_t& camera_information,
+        std::shared_ptr<const CameraDefinition>& camera_definition_out);
     Camera::Result
     download_definition_file(const std::string& uri, std::string& camera_definition_out);
 
@@ -246,7 +246,7 @@ void ComponentInformationImpl::param_update(const std::string& name, float new_v
     const auto param_update = ComponentInformation::FloatParamUpdate{name, new_value};
 
     _float_param_update_callbacks.queue(
-        param_update, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        param_update, [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 std::pair<ComponentInformation::Result, std::vector<ComponentInformation::FloatParam>>
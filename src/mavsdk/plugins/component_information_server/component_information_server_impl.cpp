@@ -97,8 +97,8 @@ void ComponentInformationServerImpl::param_update(const std::string& name, float
 {
     std::lock_guard<std::mutex> lock(_mutex);
     ComponentInformationServer::FloatParamUpdate param_update{name, new_value};
-    _float_param_update_callbacks.queue(param_update, [this](const auto& func) {
-        _server_component_impl->call_user_callback(func);
+    _float_param_update_callbacks.queue(param_update, [this](auto&& func) {
+        _server_component_impl->call_user_callback(std::move(func));
     });
 }
 
@@ -0,0 +1,104 @@
+#include <iomanip>
+
+#include "ftp_impl.h"
+#include "plugins/ftp/ftp_ext.h"
+
+namespace mavsdk {
+
+FtpExt::FtpExt(System& system) : PluginBase(), _impl{std::make_unique<FtpImpl>(system)} {}
+
+FtpExt::FtpExt(std::shared_ptr<System> system) :
+    PluginBase(),
+    _impl{std::make_unique<FtpImpl>(system)}
+{}
+
+FtpExt::~FtpExt() {}
+
+void FtpExt::download_async(
+    std::string remote_file_path,
+    std::string local_dir,
+    bool use_burst,
+    const TransferCallback& callback)
+{
+    _impl->download_async(remote_file_path, local_dir, use_burst, callback);
+}
+
+void FtpExt::upload_async(
+    std::string local_file_path, std::string remote_dir, const TransferCallback& callback)
+{
+    _impl->upload_async(local_file_path, remote_dir, callback);
+}
+
+void FtpExt::list_directory_entries_async(
+    std::string remote_dir, const ListDirectoryEntriesCallback& callback)
+{
+    _impl->list_directory_entries_async(remote_dir, callback);
+}
+
+void FtpExt::mirror_directory_async(
+    std::string remote_dir,
+    std::string local_dir,
+    bool use_burst,
+    const MirrorCallback& callback)
+{
+    _impl->mirror_directory_async(remote_dir, local_dir, use_burst, callback);
+}
+
+bool operator==(const FtpExt::TransferProgress& lhs, const FtpExt::TransferProgress& rhs)
+{
+    return (rhs.bytes_transferred == lhs.bytes_transferred) &&
+           (rhs.total_bytes == lhs.total_bytes) &&
+           (rhs.bytes_per_second == lhs.bytes_per_second) &&
+           (rhs.retransmitted_bytes == lhs.retransmitted_bytes);
+}
+
+std::ostream& operator<<(std::ostream& str, FtpExt::TransferProgress const& transfer_progress)
+{
+    str << std::setprecision(15);
+    str << "transfer_progress:" << '\n' << "{\n";
+    str << "    bytes_transferred: " << transfer_progress.bytes_transferred << '\n';
+    str << "    total_bytes: " << transfer_progress.total_bytes << '\n';
+    str << "    bytes_per_second: " << transfer_progress.bytes_per_second << '\n';
+    str << "    retransmitted_bytes: " << transfer_progress.retransmitted_bytes << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(const FtpExt::DirectoryEntry& lhs, const FtpExt::DirectoryEntry& rhs)
+{
+    return (rhs.name == lhs.name) && (rhs.is_directory == lhs.is_directory) &&
+           (rhs.size_bytes == lhs.size_bytes);
+}
+
+std::ostream& operator<<(std::ostream& str, FtpExt::DirectoryEntry const& directory_entry)
+{
+    str << std::setprecision(15);
+    str << "directory_entry:" << '\n' << "{\n";
+    str << "    name: " << directory_entry.name << '\n';
+    str << "    is_directory: " << directory_entry.is_directory << '\n';
+    str << "    size_bytes: " << directory_entry.size_bytes << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(const FtpExt::MirrorProgress& lhs, const FtpExt::MirrorProgress& rhs)
+{
+    return (rhs.files_found == lhs.files_found) &&
+           (rhs.files_downloaded == lhs.files_downloaded) &&
+           (rhs.files_skipped == lhs.files_skipped) &&
+           (rhs.bytes_downloaded == lhs.bytes_downloaded);
+}
+
+std::ostream& operator<<(std::ostream& str, FtpExt::MirrorProgress const& mirror_progress)
+{
+    str << std::setprecision(15);
+    str << "mirror_progress:" << '\n' << "{\n";
+    str << "    files_found: " << mirror_progress.files_found << '\n';
+    str << "    files_downloaded: " << mirror_progress.files_downloaded << '\n';
+    str << "    files_skipped: " << mirror_progress.files_skipped << '\n';
+    str << "    bytes_downloaded: " << mirror_progress.bytes_downloaded << '\n';
+    str << '}';
+    return str;
+}
+
+} // namespace mavsdk
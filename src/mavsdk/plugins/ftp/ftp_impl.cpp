@@ -74,6 +74,50 @@ void FtpImpl::upload_async(
         });
 }
 
+void FtpImpl::download_async(
+    const std::string& remote_path,
+    const std::string& local_folder,
+    bool use_burst,
+    FtpExt::TransferCallback callback)
+{
+    _system_impl->mavlink_ftp_client().download_async(
+        remote_path,
+        local_folder,
+        use_burst,
+        [callback, this](
+            MavlinkFtpClient::ClientResult result, MavlinkFtpClient::ProgressData progress_data) {
+            if (callback) {
+                _system_impl->call_user_callback(
+                    [temp_callback = callback, result, progress_data, this]() {
+                        temp_callback(
+                            result_from_mavlink_ftp_result(result),
+                            transfer_progress_from_mavlink_ftp_progress_data(progress_data));
+                    });
+            }
+        });
+}
+
+void FtpImpl::upload_async(
+    const std::string& local_file_path,
+    const std::string& remote_folder,
+    FtpExt::TransferCallback callback)
+{
+    _system_impl->mavlink_ftp_client().upload_async(
+        local_file_path,
+        remote_folder,
+        [callback, this](
+            MavlinkFtpClient::ClientResult result, MavlinkFtpClient::ProgressData progress_data) {
+            if (callback) {
+                _system_impl->call_user_callback(
+                    [temp_callback = callback, result, progress_data, this]() {
+                        temp_callback(
+                            result_from_mavlink_ftp_result(result),
+                            transfer_progress_from_mavlink_ftp_progress_data(progress_data));
+                    });
+            }
+        });
+}
+
 std::pair<Ftp::Result, std::vector<std::string>> FtpImpl::list_directory(const std::string& path)
 {
     std::promise<std::pair<Ftp::Result, std::vector<std::string>>> prom;
@@ -97,6 +141,54 @@ void FtpImpl::list_directory_async(const std::string& path, Ftp::ListDirectoryCa
         });
 }
 
+void FtpImpl::list_directory_entries_async(
+    const std::string& path, FtpExt::ListDirectoryEntriesCallback callback)
+{
+    _system_impl->mavlink_ftp_client().list_directory_entries_async(
+        path, [callback, this](MavlinkFtpClient::ClientResult result, auto&& entries) {
+            if (!callback) {
+                return;
+            }
+            std::vector<FtpExt::DirectoryEntry> new_entries;
+            new_entries.reserve(entries.size());
+            for (const auto& entry : entries) {
+                new_entries.push_back(
+                    FtpExt::DirectoryEntry{entry.name, entry.is_directory, entry.size});
+            }
+            _system_impl->call_user_callback(
+                [temp_callback = callback, result, new_entries, this]() {
+                    temp_callback(result_from_mavlink_ftp_result(result), new_entries);
+                });
+        });
+}
+
+void FtpImpl::mirror_directory_async(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    bool use_burst,
+    FtpExt::MirrorCallback callback)
+{
+    _system_impl->mavlink_ftp_client().mirror_directory_async(
+        remote_dir,
+        local_dir,
+        use_burst,
+        [callback, this](
+            MavlinkFtpClient::ClientResult result, MavlinkFtpClient::MirrorProgress progress) {
+            if (callback) {
+                _system_impl->call_user_callback(
+                    [temp_callback = callback, result, progress, this]() {
+                        temp_callback(
+                            result_from_mavlink_ftp_result(result),
+                            FtpExt::MirrorProgress{
+                                progress.files_found,
+                                progress.files_downloaded,
+                                progress.files_skipped,
+                                progress.bytes_downloaded});
+                    });
+            }
+        });
+}
+
 Ftp::Result FtpImpl::create_directory(const std::string& path)
 {
     std::promise<Ftp::Result> prom{};
@@ -262,4 +354,14 @@ FtpImpl::progress_data_from_mavlink_ftp_progress_data(MavlinkFtpClient::Progress
     return {progress_data.bytes_transferred, progress_data.total_bytes};
 }
 
+FtpExt::TransferProgress FtpImpl::transfer_progress_from_mavlink_ftp_progress_data(
+    MavlinkFtpClient::ProgressData progress_data)
+{
+    return {
+        progress_data.bytes_transferred,
+        progress_data.total_bytes,
+        progress_data.bytes_per_second,
+        progress_data.retransmitted_bytes};
+}
+
 } // namespace mavsdk
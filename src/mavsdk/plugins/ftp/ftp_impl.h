@@ -6,6 +6,7 @@
 
 #include "mavlink_include.h"
 #include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_ext.h"
 #include "plugin_impl_base.h"
 
 namespace mavsdk {
@@ -43,7 +44,23 @@ public:
         const std::string& local_file_path,
         const std::string& remote_folder,
         Ftp::UploadCallback callback);
+    void download_async(
+        const std::string& remote_file_path,
+        const std::string& local_folder,
+        bool use_burst,
+        FtpExt::TransferCallback callback);
+    void upload_async(
+        const std::string& local_file_path,
+        const std::string& remote_folder,
+        FtpExt::TransferCallback callback);
     void list_directory_async(const std::string& path, Ftp::ListDirectoryCallback callback);
+    void list_directory_entries_async(
+        const std::string& path, FtpExt::ListDirectoryEntriesCallback callback);
+    void mirror_directory_async(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        bool use_burst,
+        FtpExt::MirrorCallback callback);
     void create_directory_async(const std::string& path, Ftp::ResultCallback callback);
     void remove_directory_async(const std::string& path, Ftp::ResultCallback callback);
     void remove_file_async(const std::string& path, Ftp::ResultCallback callback);
@@ -60,6 +77,8 @@ private:
     Ftp::Result result_from_mavlink_ftp_result(MavlinkFtpClient::ClientResult result);
     Ftp::ProgressData
     progress_data_from_mavlink_ftp_progress_data(MavlinkFtpClient::ProgressData progress_data);
+    FtpExt::TransferProgress
+    transfer_progress_from_mavlink_ftp_progress_data(MavlinkFtpClient::ProgressData progress_data);
 };
 
 } // namespace mavsdk
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "plugin_base.h"
+#include "plugins/ftp/ftp.h"
+
+namespace mavsdk {
+
+class System;
+class FtpImpl;
+
+/**
+ * @brief Directory listings with entry details, directory mirroring and transfers
+ * with statistics over MAVLink FTP.
+ *
+ * These are not part of the Ftp API generated from the proto files and
+ * therefore not available over mavsdk_server. They use the same FTP client
+ * of the system as Ftp, so settings such as the target component apply to
+ * both.
+ */
+class FtpExt : public PluginBase {
+public:
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * The plugin is typically created as shown below:
+     *
+     *     ```cpp
+     *     auto ftp_ext = FtpExt(system);
+     *     ```
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit FtpExt(System& system); // deprecated
+
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * The plugin is typically created as shown below:
+     *
+     *     ```cpp
+     *     auto ftp_ext = FtpExt(system);
+     *     ```
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit FtpExt(std::shared_ptr<System> system); // new
+
+    /**
+     * @brief Destructor (internal use only).
+     */
+    ~FtpExt() override;
+
+    /**
+     * @brief Entry of a remote directory.
+     */
+    struct DirectoryEntry {
+        std::string name{}; /**< @brief Name of the file or directory. */
+        bool is_directory{}; /**< @brief True if the entry is a directory. */
+        uint32_t size_bytes{}; /**< @brief Size of the file, 0 for directories. */
+    };
+
+    /**
+     * @brief Equal operator to compare two `FtpExt::DirectoryEntry` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(const FtpExt::DirectoryEntry& lhs, const FtpExt::DirectoryEntry& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `FtpExt::DirectoryEntry`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, FtpExt::DirectoryEntry const& directory_entry);
+
+    /**
+     * @brief Progress of a directory mirror.
+     */
+    struct MirrorProgress {
+        uint32_t files_found{}; /**< @brief Files found on the remote so far. */
+        uint32_t files_downloaded{}; /**< @brief Files downloaded. */
+        uint32_t files_skipped{}; /**< @brief Files skipped because the local copy is identical. */
+        uint64_t bytes_downloaded{}; /**< @brief Bytes of the downloaded files. */
+    };
+
+    /**
+     * @brief Equal operator to compare two `FtpExt::MirrorProgress` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(const FtpExt::MirrorProgress& lhs, const FtpExt::MirrorProgress& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `FtpExt::MirrorProgress`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, FtpExt::MirrorProgress const& mirror_progress);
+
+    /**
+     * @brief Progress of a download or upload, with transfer statistics.
+     */
+    struct TransferProgress {
+        uint32_t bytes_transferred{}; /**< @brief The number of bytes already transferred. */
+        uint32_t total_bytes{}; /**< @brief The total bytes to transfer. */
+        uint32_t bytes_per_second{}; /**< @brief Average throughput since the start. */
+        uint32_t retransmitted_bytes{}; /**< @brief Bytes requested or sent again after loss. */
+    };
+
+    /**
+     * @brief Equal operator to compare two `FtpExt::TransferProgress` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool
+    operator==(const FtpExt::TransferProgress& lhs, const FtpExt::TransferProgress& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `FtpExt::TransferProgress`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, FtpExt::TransferProgress const& transfer_progress);
+
+    /**
+     * @brief Callback type for download_async and upload_async.
+     */
+    using TransferCallback = std::function<void(Ftp::Result, TransferProgress)>;
+
+    /**
+     * @brief Downloads a file to local directory, like Ftp::download_async.
+     *
+     * The progress additionally contains the throughput and how many bytes had
+     * to be requested again so far.
+     */
+    void download_async(
+        std::string remote_file_path,
+        std::string local_dir,
+        bool use_burst,
+        const TransferCallback& callback);
+
+    /**
+     * @brief Uploads local file to remote directory, like Ftp::upload_async.
+     *
+     * The progress additionally contains the throughput and how many bytes had
+     * to be sent again so far.
+     */
+    void upload_async(
+        std::string local_file_path, std::string remote_dir, const TransferCallback& callback);
+
+    /**
+     * @brief Callback type for list_directory_entries_async.
+     */
+    using ListDirectoryEntriesCallback =
+        std::function<void(Ftp::Result, std::vector<DirectoryEntry>)>;
+
+    /**
+     * @brief Lists entries of a remote directory as they arrive.
+     *
+     * The callback is called with `Next` for every batch of entries received
+     * and once more with the final result and no entries.
+     */
+    void list_directory_entries_async(
+        std::string remote_dir, const ListDirectoryEntriesCallback& callback);
+
+    /**
+     * @brief Callback type for mirror_directory_async.
+     */
+    using MirrorCallback = std::function<void(Ftp::Result, MirrorProgress)>;
+
+    /**
+     * @brief Downloads a remote directory tree to a local directory.
+     *
+     * Files whose local copy has the same size and CRC32 are skipped. Listing
+     * and transfers overlap, so files are fetched while subdirectories are
+     * still being listed.
+     */
+    void mirror_directory_async(
+        std::string remote_dir,
+        std::string local_dir,
+        bool use_burst,
+        const MirrorCallback& callback);
+
+    /**
+     * @brief Copy Constructor (object is not copyable).
+     */
+    FtpExt(const FtpExt&) = delete;
+
+    /**
+     * @brief Equality operator (object is not copyable).
+     */
+    const FtpExt& operator=(const FtpExt&) = delete;
+
+private:
+    /** @private Underlying implementation, set at instantiation */
+    std::unique_ptr<FtpImpl> _impl;
+};
+
+} // namespace mavsdk
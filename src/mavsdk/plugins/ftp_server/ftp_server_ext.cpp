@@ -0,0 +1,43 @@
+#include <cmath>
+#include <iomanip>
+
+#include "ftp_server_impl.h"
+#include "plugins/ftp_server/ftp_server_ext.h"
+
+namespace mavsdk {
+
+FtpServerExt::FtpServerExt(std::shared_ptr<ServerComponent> server_component) :
+    ServerPluginBase(),
+    _impl{std::make_unique<FtpServerImpl>(server_component)}
+{}
+
+FtpServerExt::~FtpServerExt() {}
+
+FtpServer::Result FtpServerExt::set_burst_rate(double bytes_per_second) const
+{
+    return _impl->set_burst_rate(bytes_per_second);
+}
+
+FtpServerExt::BurstStats FtpServerExt::burst_stats() const
+{
+    return _impl->burst_stats();
+}
+
+bool operator==(const FtpServerExt::BurstStats& lhs, const FtpServerExt::BurstStats& rhs)
+{
+    return (rhs.bytes_sent == lhs.bytes_sent) &&
+           ((std::isnan(rhs.bytes_per_second) && std::isnan(lhs.bytes_per_second)) ||
+            rhs.bytes_per_second == lhs.bytes_per_second);
+}
+
+std::ostream& operator<<(std::ostream& str, FtpServerExt::BurstStats const& burst_stats)
+{
+    str << std::setprecision(15);
+    str << "burst_stats:" << '\n' << "{\n";
+    str << "    bytes_sent: " << burst_stats.bytes_sent << '\n';
+    str << "    bytes_per_second: " << burst_stats.bytes_per_second << '\n';
+    str << '}';
+    return str;
+}
+
+} // namespace mavsdk
@@ -27,4 +27,21 @@ FtpServer::Result FtpServerImpl::set_root_dir(const std::string& path)
     return FtpServer::Result::Success;
 }
 
+FtpServer::Result FtpServerImpl::set_burst_rate(double bytes_per_second)
+{
+    _server_component_impl->mavlink_ftp_server().set_burst_rate(bytes_per_second);
+
+    return FtpServer::Result::Success;
+}
+
+FtpServerExt::BurstStats FtpServerImpl::burst_stats()
+{
+    const auto stats = _server_component_impl->mavlink_ftp_server().burst_stats();
+
+    FtpServerExt::BurstStats burst_stats;
+    burst_stats.bytes_sent = stats.bytes_sent;
+    burst_stats.bytes_per_second = stats.bytes_per_second;
+    return burst_stats;
+}
+
 } // namespace mavsdk
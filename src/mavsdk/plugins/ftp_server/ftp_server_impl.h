@@ -1,6 +1,7 @@
 #pragma once
 
 #include "plugins/ftp_server/ftp_server.h"
+#include "plugins/ftp_server/ftp_server_ext.h"
 
 #include <string>
 #include <mutex>
@@ -18,6 +19,8 @@ public:
     void deinit() override;
 
     FtpServer::Result set_root_dir(const std::string& path);
+    FtpServer::Result set_burst_rate(double bytes_per_second);
+    FtpServerExt::BurstStats burst_stats();
 
 private:
     std::mutex _root_dir_mutex{};
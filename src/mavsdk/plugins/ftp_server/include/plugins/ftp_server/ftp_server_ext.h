@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include "server_plugin_base.h"
+#include "plugins/ftp_server/ftp_server.h"
+
+namespace mavsdk {
+
+class ServerComponent;
+class FtpServerImpl;
+
+/**
+ * @brief Burst download settings and statistics of the FTP server.
+ *
+ * These are not part of the FtpServer API generated from the proto files and
+ * therefore not available over mavsdk_server. The settings apply to the FTP
+ * server of the ServerComponent, so they are shared with any FtpServer
+ * instance created for the same component.
+ */
+class FtpServerExt : public ServerPluginBase {
+public:
+    /**
+     * @brief Constructor. Creates the plugin for a ServerComponent instance.
+     *
+     * The plugin is typically created as shown below:
+     *
+     *     ```cpp
+     *     auto ftp_server_ext = FtpServerExt(server_component);
+     *     ```
+     *
+     * @param server_component The ServerComponent instance associated with this server plugin.
+     */
+    explicit FtpServerExt(std::shared_ptr<ServerComponent> server_component);
+
+    /**
+     * @brief Destructor (internal use only).
+     */
+    ~FtpServerExt() override;
+
+    /**
+     * @brief Statistics of the burst downloads served.
+     */
+    struct BurstStats {
+        uint64_t bytes_sent{}; /**< @brief File data sent in bursts so far. */
+        double bytes_per_second{}; /**< @brief Throughput over the last second of bursting. */
+    };
+
+    /**
+     * @brief Equal operator to compare two `FtpServerExt::BurstStats` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool
+    operator==(const FtpServerExt::BurstStats& lhs, const FtpServerExt::BurstStats& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `FtpServerExt::BurstStats`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(std::ostream& str, FtpServerExt::BurstStats const& burst_stats);
+
+    /**
+     * @brief Set the rate at which burst downloads are sent.
+     *
+     * The rate is in bytes per second on the link, including the MAVLink
+     * framing, and is shared by all clients downloading at the same time.
+     * Over a serial link, baudrate / 10 is what the link can carry, so a
+     * rate somewhat below that leaves room for other messages.
+     * A rate of 0 sends bursts as fast as possible, which is the default.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    FtpServer::Result set_burst_rate(double bytes_per_second) const;
+
+    /**
+     * @brief Get statistics of the burst downloads served.
+     *
+     * This function is blocking.
+     *
+     * @return The statistics.
+     */
+    BurstStats burst_stats() const;
+
+    /**
+     * @brief Copy Constructor (object is not copyable).
+     */
+    FtpServerExt(const FtpServerExt&) = delete;
+
+    /**
+     * @brief Equality operator (object is not copyable).
+     */
+    const FtpServerExt& operator=(const FtpServerExt&) = delete;
+
+private:
+    /** @private Underlying implementation, set at instantiation */
+    std::unique_ptr<FtpServerImpl> _impl;
+};
+
+} // namespace mavsdk
@@ -196,8 +196,9 @@ Gimbal::ControlHandle GimbalImpl::subscribe_control(const Gimbal::ControlCallbac
     if (need_to_register_callback) {
         wait_for_protocol_async([=]() {
             _gimbal_protocol->control_async([this](Gimbal::ControlStatus status) {
-                _control_subscriptions.queue(
-                    status, [this](const auto& func) { _system_impl->call_user_callback(func); });
+                _control_subscriptions.queue(status, [this](auto&& func) {
+                    _system_impl->call_user_callback(std::move(func));
+                });
             });
         });
     }
@@ -224,8 +225,9 @@ Gimbal::AttitudeHandle GimbalImpl::subscribe_attitude(const Gimbal::AttitudeCall
     if (need_to_register_callback) {
         wait_for_protocol_async([=]() {
             _gimbal_protocol->attitude_async([this](Gimbal::Attitude attitude) {
-                _attitude_subscriptions.queue(
-                    attitude, [this](const auto& func) { _system_impl->call_user_callback(func); });
+                _attitude_subscriptions.queue(attitude, [this](auto&& func) {
+                    _system_impl->call_user_callback(std::move(func));
+                });
             });
         });
     }
@@ -1,58 +1,234 @@
 #include "log_files_impl.h"
+#include "file_io.h"
 #include "mavlink_address.h"
 #include "mavsdk_impl.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <ctime>
 #include <filesystem>
+#include <fstream>
+#include <optional>
 
 namespace mavsdk {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+constexpr std::array<char, 4> index_file_magic{'M', 'L', 'I', '1'};
+constexpr std::array<char, 4> partial_file_magic{'M', 'L', 'P', '1'};
+
+LogFiles::Entry entry_from_index(const LogIndexEntry& index_entry)
+{
+    LogFiles::Entry entry;
+    entry.id = index_entry.id;
+
+    // Convert milliseconds to ISO 8601 date string in UTC.
+    char buf[sizeof "2018-08-31T20:50:42Z"];
+    const time_t time_utc = index_entry.time_utc;
+    strftime(buf, sizeof buf, "%FT%TZ", gmtime(&time_utc));
+
+    entry.date = buf;
+    entry.size_bytes = index_entry.size_bytes;
+    return entry;
+}
+
+} // namespace
+
+bool LogIndex::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::array<char, 4> magic{};
+    uint16_t file_num_logs;
+    uint16_t file_last_log_num;
+    uint16_t num_entries;
+    if (!file.read(magic.data(), magic.size()) || magic != index_file_magic ||
+        !read_raw(file, file_num_logs) || !read_raw(file, file_last_log_num) ||
+        !read_raw(file, num_entries)) {
+        return false;
+    }
+
+    std::unordered_map<uint16_t, LogIndexEntry> file_entries;
+    for (unsigned i = 0; i < num_entries; ++i) {
+        LogIndexEntry entry;
+        uint16_t path_size;
+        if (!read_raw(file, entry.id) || !read_raw(file, entry.time_utc) ||
+            !read_raw(file, entry.size_bytes) || !read_raw(file, path_size)) {
+            return false;
+        }
+        entry.downloaded_path.resize(path_size);
+        if (!file.read(entry.downloaded_path.data(), path_size)) {
+            return false;
+        }
+        file_entries[entry.id] = std::move(entry);
+    }
+
+    num_logs = file_num_logs;
+    last_log_num = file_last_log_num;
+    entries = std::move(file_entries);
+    return true;
+}
+
+bool LogIndex::save(const std::string& path) const
+{
+    const bool written = write_file_atomically(path, [&](std::ofstream& file) {
+        file.write(index_file_magic.data(), index_file_magic.size());
+        write_raw(file, num_logs);
+        write_raw(file, last_log_num);
+        write_raw(file, static_cast<uint16_t>(entries.size()));
+
+        for (const auto& [id, entry] : entries) {
+            write_raw(file, entry.id);
+            write_raw(file, entry.time_utc);
+            write_raw(file, entry.size_bytes);
+            write_raw(file, static_cast<uint16_t>(entry.downloaded_path.size()));
+            file.write(
+                entry.downloaded_path.data(),
+                static_cast<std::streamsize>(entry.downloaded_path.size()));
+        }
+        return true;
+    });
+
+    if (!written) {
+        LogWarn() << "Could not write log index " << path;
+    }
+    return written;
+}
+
 LogData::LogData(
-    const LogFiles::Entry& e, const std::string& filepath, LogFiles::DownloadLogFileCallback cb) :
+    const LogFiles::Entry& e,
+    const std::string& filepath,
+    LogFiles::DownloadLogFileCallback cb,
+    uint8_t sysid,
+    uint32_t time) :
     entry(e),
+    system_id(sysid),
+    time_utc(time),
     file_path(filepath),
     user_callback(cb)
 {
-    // Reset the table
-    chunk_bin_table = std::vector<bool>(bins_in_chunk(), false);
-    file.open(file_path, std::ios::out | std::ios::binary);
+    bin_table = std::vector<bool>(total_bins(), false);
+}
+
+bool LogData::open_file()
+{
+    // Only a fresh download starts with an empty file.
+    fd = open_raw_file(
+        file_path, bins_received == 0 ? RawFileMode::Truncate : RawFileMode::Create);
+    return file_is_open();
+}
+
+bool LogData::file_is_open() const
+{
+    return fd >= 0;
 }
 
-bool LogData::file_is_open()
+uint32_t LogData::total_bins() const
 {
-    // TODO: any other checks?
-    return !(file.rdstate() & std::ofstream::failbit); // Ensure file is writable
+    uint32_t add_one_bin = entry.size_bytes % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN ? 1 : 0;
+    return entry.size_bytes / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN + add_one_bin;
 }
 
-uint32_t LogData::total_chunks() const
+uint32_t LogData::bin_size(uint32_t bin) const
 {
-    uint32_t partial_chunk = entry.size_bytes % CHUNK_SIZE;
-    uint32_t add_one_chunk = partial_chunk ? 1 : 0;
-    return entry.size_bytes / CHUNK_SIZE + add_one_chunk;
+    // Last bin might be less than a full message
+    return std::min(
+        static_cast<uint32_t>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN),
+        entry.size_bytes - bin * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
 }
 
-uint32_t LogData::bins_in_chunk() const
+std::string LogData::partial_path() const
 {
-    uint32_t size = current_chunk_size();
-    uint32_t add_one_bin = size % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN ? 1 : 0;
-    return size / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN + add_one_bin;
+    return file_path + ".part";
 }
 
-uint32_t LogData::current_chunk_size() const
+bool LogData::load_partial()
 {
-    uint32_t chunk_size = CHUNK_SIZE;
-    uint32_t chunk_remainder = entry.size_bytes % CHUNK_SIZE;
-    bool is_last_chunk = (current_chunk == total_chunks() - 1);
-    // Last chunk might be less than CHUNK_SIZE
-    if (is_last_chunk && chunk_remainder) {
-        chunk_size = entry.size_bytes % CHUNK_SIZE;
+    std::ifstream file(partial_path(), std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    // The file must belong to the same log, not just to a log with the same id.
+    std::array<char, 4> magic{};
+    uint8_t file_system_id;
+    uint32_t file_id;
+    uint32_t file_time_utc;
+    uint32_t file_size_bytes;
+    if (!file.read(magic.data(), magic.size()) || magic != partial_file_magic ||
+        !read_raw(file, file_system_id) || file_system_id != system_id ||
+        !read_raw(file, file_id) || file_id != entry.id || !read_raw(file, file_time_utc) ||
+        file_time_utc != time_utc || !read_raw(file, file_size_bytes) ||
+        file_size_bytes != entry.size_bytes) {
+        return false;
     }
 
-    return chunk_size;
+    std::vector<char> packed((total_bins() + 7) / 8);
+    if (!file.read(packed.data(), static_cast<std::streamsize>(packed.size()))) {
+        return false;
+    }
+
+    std::vector<bool> table(total_bins(), false);
+    uint32_t received = 0;
+    uint32_t bytes = 0;
+    uint32_t end_offset = 0;
+    for (uint32_t bin = 0; bin < total_bins(); ++bin) {
+        if (packed[bin / 8] & (1 << (bin % 8))) {
+            table[bin] = true;
+            ++received;
+            bytes += bin_size(bin);
+            end_offset = bin * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN + bin_size(bin);
+        }
+    }
+
+    // Someone else might have cut the file short in the meantime.
+    std::error_code ec;
+    const auto size_on_disk = fs::file_size(file_path, ec);
+    if (ec || size_on_disk < end_offset) {
+        return false;
+    }
+
+    bin_table = std::move(table);
+    bins_received = received;
+    bytes_received = bytes;
+    bytes_reported = bytes;
+    bytes_saved = bytes;
+    return true;
+}
+
+bool LogData::save_partial()
+{
+    const std::string path = partial_path();
+    const bool written = write_file_atomically(path, [&](std::ofstream& file) {
+        std::vector<char> packed((total_bins() + 7) / 8, 0);
+        for (uint32_t bin = 0; bin < total_bins(); ++bin) {
+            if (bin_table[bin]) {
+                packed[bin / 8] |= static_cast<char>(1 << (bin % 8));
+            }
+        }
+
+        file.write(partial_file_magic.data(), partial_file_magic.size());
+        write_raw(file, system_id);
+        write_raw(file, entry.id);
+        write_raw(file, time_utc);
+        write_raw(file, entry.size_bytes);
+        file.write(packed.data(), static_cast<std::streamsize>(packed.size()));
+        return true;
+    });
+
+    if (!written) {
+        LogWarn() << "Could not write " << path;
+        return false;
+    }
+
+    bytes_saved = bytes_received;
+    return true;
 }
 
 LogFilesImpl::LogFilesImpl(System& system) : PluginImplBase(system)
@@ -96,6 +272,11 @@ void LogFilesImpl::deinit()
     {
         std::lock_guard<std::mutex> lock(_download_data_mutex);
         _system_impl->unregister_timeout_handler(_download_data.timeout_cookie);
+        if (_download_data.fd >= 0) {
+            _download_data.save_partial();
+            close_raw_file(_download_data.fd);
+            _download_data.fd = -1;
+        }
     }
     _system_impl->unregister_all_mavlink_message_handlers(this);
 }
@@ -119,6 +300,14 @@ void LogFilesImpl::get_entries_async(LogFiles::GetEntriesCallback callback)
     _log_entries.clear();
     _entries_user_callback = callback;
     _total_entries = 0;
+    _listing = LogIndex{};
+    _listing_active = true;
+    _entries_from_index = false;
+
+    const auto index_path = log_index_path();
+    if (_log_index.entries.empty() && !index_path.empty() && !_log_index.load(index_path)) {
+        _log_index = LogIndex{};
+    }
 
     _system_impl->register_timeout_handler(
         [this]() { entries_timeout(); },
@@ -152,12 +341,18 @@ void LogFilesImpl::process_log_entry(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_entries_mutex);
 
+    if (!_listing_active) {
+        // Late or duplicate entries of a list that is complete already.
+        return;
+    }
+
     _system_impl->refresh_timeout_handler(_entries_timeout_cookie);
 
     // Bad data handling
     if (msg.num_logs == 0 || msg.id >= msg.num_logs) {
         LogWarn() << "No logs available";
 
+        _listing_active = false;
         _system_impl->unregister_timeout_handler(_entries_timeout_cookie);
 
         const auto cb = _entries_user_callback;
@@ -168,41 +363,140 @@ void LogFilesImpl::process_log_entry(const mavlink_message_t& message)
         return;
     }
 
-    LogFiles::Entry new_entry;
-    new_entry.id = msg.id;
+    LogIndexEntry index_entry;
+    index_entry.id = msg.id;
+    index_entry.time_utc = msg.time_utc;
+    index_entry.size_bytes = msg.size;
+
+    if (_entries_from_index) {
+        // Only the newest log can have changed, e.g. grown while still
+        // being written. Anything else is left over from the full list.
+        if (msg.id == _listing.last_log_num) {
+            add_log_entry(index_entry);
+            entries_complete();
+        }
+        return;
+    }
 
-    // Convert milliseconds to ISO 8601 date string in UTC.
-    char buf[sizeof "2018-08-31T20:50:42Z"];
-    const time_t time_utc = msg.time_utc;
-    strftime(buf, sizeof buf, "%FT%TZ", gmtime(&time_utc));
+    _listing.num_logs = msg.num_logs;
+    _listing.last_log_num = msg.last_log_num;
 
-    new_entry.date = buf;
-    new_entry.size_bytes = msg.size;
+    if (_log_entries.empty() && log_index_matches(msg)) {
+        // Same logs as last time, there is no need to list them all again.
+        LogDebug() << "Log list unchanged, using log index";
+        _entries_from_index = true;
+        for (const auto& [id, cached_entry] : _log_index.entries) {
+            add_log_entry(cached_entry);
+        }
+        if (msg.id == msg.last_log_num) {
+            entries_complete();
+        } else {
+            request_log_list(msg.last_log_num, msg.last_log_num);
+        }
+        return;
+    }
 
-    _log_entries[new_entry.id] = new_entry;
+    add_log_entry(index_entry);
     _total_entries = msg.num_logs;
 
     // Check if all entries are received
     if (_log_entries.size() == _total_entries) {
-        _system_impl->unregister_timeout_handler(_entries_timeout_cookie);
+        entries_complete();
+    }
+}
 
-        // Copy map entries into list to return
-        std::vector<LogFiles::Entry> entry_list{};
-        for (unsigned i = 0; i < _log_entries.size(); i++) {
-            entry_list.push_back(_log_entries[i]);
-        }
+bool LogFilesImpl::log_index_matches(const mavlink_log_entry_t& msg) const
+{
+    // Requires _entries_mutex
+    if (_log_index.num_logs != msg.num_logs || _log_index.last_log_num != msg.last_log_num ||
+        _log_index.entries.size() != msg.num_logs) {
+        return false;
+    }
 
-        const auto cb = _entries_user_callback;
-        if (cb) {
-            _system_impl->call_user_callback(
-                [cb, entry_list]() { cb(LogFiles::Result::Success, entry_list); });
+    const auto it = _log_index.entries.find(msg.id);
+    return it != _log_index.entries.end() && it->second.time_utc == msg.time_utc &&
+           it->second.size_bytes == msg.size;
+}
+
+void LogFilesImpl::add_log_entry(const LogIndexEntry& index_entry)
+{
+    // Requires _entries_mutex
+    _listing.entries[index_entry.id] = index_entry;
+    _log_entries[index_entry.id] = entry_from_index(index_entry);
+}
+
+void LogFilesImpl::entries_complete()
+{
+    // Requires _entries_mutex
+    _listing_active = false;
+    _system_impl->unregister_timeout_handler(_entries_timeout_cookie);
+
+    // Logs downloaded earlier stay downloaded as long as they are the same.
+    for (auto& [id, listed_entry] : _listing.entries) {
+        const auto it = _log_index.entries.find(id);
+        if (it != _log_index.entries.end() && it->second.time_utc == listed_entry.time_utc &&
+            it->second.size_bytes == listed_entry.size_bytes) {
+            listed_entry.downloaded_path = it->second.downloaded_path;
         }
     }
+    _log_index = _listing;
+
+    const auto index_path = log_index_path();
+    if (!index_path.empty() && !_log_index.save(index_path)) {
+        LogWarn() << "Could not save log index";
+    }
+
+    // Copy map entries into list to return
+    std::vector<LogFiles::Entry> entry_list{};
+    for (const auto& [id, entry] : _log_entries) {
+        entry_list.push_back(entry);
+    }
+    std::sort(entry_list.begin(), entry_list.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.id < rhs.id;
+    });
+
+    const auto cb = _entries_user_callback;
+    if (cb) {
+        _system_impl->call_user_callback(
+            [cb, entry_list]() { cb(LogFiles::Result::Success, entry_list); });
+    }
+}
+
+void LogFilesImpl::log_downloaded(const LogData& download_data)
+{
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+
+    const auto it = _log_index.entries.find(download_data.entry.id);
+    if (it == _log_index.entries.end() || it->second.time_utc != download_data.time_utc ||
+        it->second.size_bytes != download_data.entry.size_bytes) {
+        return;
+    }
+    it->second.downloaded_path = download_data.file_path;
+
+    const auto index_path = log_index_path();
+    if (!index_path.empty() && !_log_index.save(index_path)) {
+        LogWarn() << "Could not save log index";
+    }
+}
+
+std::string LogFilesImpl::log_index_path() const
+{
+    const auto log_cache_directory = _system_impl->log_cache_directory();
+    if (log_cache_directory.empty()) {
+        return {};
+    }
+
+    std::error_code ec;
+    fs::create_directories(log_cache_directory, ec);
+    return (fs::path(log_cache_directory) /
+            ("logs_" + std::to_string(_system_impl->get_system_id()) + ".idx"))
+        .string();
 }
 
 void LogFilesImpl::entries_timeout()
 {
     std::lock_guard<std::mutex> lock(_entries_mutex);
+    _listing_active = false;
 
     const auto cb = _entries_user_callback;
     if (cb) {
@@ -233,11 +527,62 @@ LogFilesImpl::download_log_file(LogFiles::Entry entry, const std::string& file_p
 void LogFilesImpl::download_log_file_async(
     LogFiles::Entry entry, const std::string& file_path, LogFiles::DownloadLogFileCallback callback)
 {
-    std::lock_guard<std::mutex> lock(_entries_mutex);
+    std::optional<LogFiles::Entry> listed_entry;
+    LogIndexEntry index_entry;
+    {
+        std::lock_guard<std::mutex> lock(_entries_mutex);
+        auto entry_it = _log_entries.find(entry.id);
+        if (entry_it != _log_entries.end()) {
+            listed_entry = entry_it->second;
+        }
+        auto index_it = _log_index.entries.find(entry.id);
+        if (index_it != _log_index.entries.end()) {
+            index_entry = index_it->second;
+        } else {
+            // Not in the index yet, e.g. while the list is still coming in, but
+            // the time is known from LOG_ENTRY anyway.
+            auto listing_it = _listing.entries.find(entry.id);
+            if (listing_it != _listing.entries.end()) {
+                index_entry.time_utc = listing_it->second.time_utc;
+            }
+        }
+    }
+
+    LogData data;
+    if (listed_entry) {
+        data = LogData(
+            listed_entry.value(),
+            file_path,
+            callback,
+            _system_impl->get_system_id(),
+            index_entry.time_utc);
+    }
+
+    std::error_code ec;
+    bool error = !listed_entry || fs::is_directory(fs::path(file_path), ec);
+
+    if (!error && fs::exists(file_path, ec)) {
+        if (index_entry.downloaded_path == file_path &&
+            fs::file_size(file_path, ec) == listed_entry->size_bytes) {
+            // Nothing new to fetch.
+            LogDebug() << "Log " << entry.id << " already downloaded to " << file_path;
+            if (callback) {
+                _system_impl->call_user_callback([callback]() {
+                    LogFiles::ProgressData progress_data;
+                    progress_data.progress = 1.0f;
+                    callback(LogFiles::Result::Success, progress_data);
+                });
+            }
+            return;
+        }
 
-    auto entry_it = _log_entries.find(entry.id);
-    bool error = entry_it == _log_entries.end() || fs::is_directory(fs::path(file_path)) ||
-                 fs::exists(file_path);
+        // Only a file we started ourselves is continued, anything else stays untouched.
+        error = !data.load_partial();
+        if (!error) {
+            LogInfo() << "Resuming download of log " << entry.id << " at "
+                      << data.bytes_received << " bytes";
+        }
+    }
 
     if (error) {
         LogErr() << "error: download_log_file_async failed";
@@ -250,9 +595,18 @@ void LogFilesImpl::download_log_file_async(
         return;
     }
 
-    _download_data = LogData(entry_it->second, file_path, callback);
+    std::lock_guard<std::mutex> download_lock(_download_data_mutex);
 
-    if (!_download_data.file_is_open()) {
+    // A new download replaces whatever was going on before.
+    _system_impl->unregister_timeout_handler(_download_data.timeout_cookie);
+    if (_download_data.fd >= 0) {
+        _download_data.save_partial();
+        close_raw_file(_download_data.fd);
+    }
+
+    _download_data = std::move(data);
+
+    if (!_download_data.open_file()) {
         if (callback) {
             _system_impl->call_user_callback([callback]() {
                 callback(LogFiles::Result::FileOpenFailed, LogFiles::ProgressData());
@@ -261,13 +615,25 @@ void LogFilesImpl::download_log_file_async(
         return;
     }
 
+    if (_download_data.bins_received == 0) {
+        // Right away, so the download can be continued even if it is cut off
+        // before the first save.
+        _download_data.save_partial();
+    }
+
     _system_impl->register_timeout_handler(
         [this]() { LogFilesImpl::data_timeout(); },
         _system_impl->timeout_s() * 1.0,
         &_download_data.timeout_cookie);
 
-    // Request the first chunk
-    request_log_data(_download_data.entry.id, 0, _download_data.current_chunk_size());
+    if (_download_data.bins_received == _download_data.total_bins()) {
+        finish_download(LogFiles::Result::Success);
+        return;
+    }
+
+    // The autopilot serves one request at a time, so the whole log is
+    // requested at once and streamed without waiting for anything.
+    request_missing_bins();
 }
 
 void LogFilesImpl::process_log_data(const mavlink_message_t& message)
@@ -277,6 +643,11 @@ void LogFilesImpl::process_log_data(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_download_data_mutex);
 
+    if (!_download_data.file_is_open()) {
+        // Nothing going on, e.g. the rest of an interrupted stream.
+        return;
+    }
+
     _system_impl->refresh_timeout_handler(_download_data.timeout_cookie);
 
     if (msg.count > MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
@@ -301,76 +672,142 @@ void LogFilesImpl::process_log_data(const mavlink_message_t& message)
         return;
     }
 
-    // Calculate current chunk
-    const uint32_t chunk = msg.ofs / CHUNK_SIZE;
-
-    if (chunk != _download_data.current_chunk) {
-        // Quietly ignore packets for out of order chunks
-        // LogErr() << "Ignored packet for out of order chunk actual/expected: " << chunk << "/"
-        //          << _download_data.current_chunk;
+    if (msg.count == 0) {
+        // End of file marker
         return;
     }
 
-    // Calculate current bin within the chunk
-    const uint16_t bin = (msg.ofs - chunk * CHUNK_SIZE) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    const uint32_t bin = msg.ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
 
-    if (bin >= _download_data.chunk_bin_table.size()) {
+    if (bin >= _download_data.bin_table.size() || msg.count != _download_data.bin_size(bin)) {
         LogErr() << "Out of range bin received: bin/size: " << bin << "/"
-                 << _download_data.chunk_bin_table.size();
+                 << _download_data.bin_table.size();
         return;
     }
 
-    if (_download_data.file.tellp() != msg.ofs) {
-        if (!_download_data.file.seekp(msg.ofs)) {
-            LogErr() << "Error while seeking to log file offset";
-            return;
+    if (bin >= _download_data.request_start && bin < _download_data.request_end) {
+        auto& time = _system_impl->get_time();
+        if (_download_data.request_bins_seen++ == 0) {
+            _download_data.first_bin_time = time.steady_time();
+            _download_data.round_trip_s = time.elapsed_since_s(_download_data.request_time);
+        } else {
+            const double elapsed_s = time.elapsed_since_s(_download_data.first_bin_time);
+            if (elapsed_s > 0.0) {
+                _download_data.bins_per_second =
+                    (_download_data.request_bins_seen - 1) / elapsed_s;
+            }
         }
     }
 
-    _download_data.file.write((char*)msg.data, msg.count);
-
     // Quietly ignore duplicate packets -- we don't want to record the bytes_written twice
-    if (!_download_data.chunk_bin_table[bin]) {
-        _download_data.chunk_bytes_written += msg.count;
-        _download_data.chunk_bin_table[bin] = true;
+    if (!_download_data.bin_table[bin]) {
+        if (write_at(_download_data.fd, msg.data, msg.count, msg.ofs) != msg.count) {
+            LogErr() << "Error while writing to log file";
+            finish_download(LogFiles::Result::FileOpenFailed);
+            return;
+        }
+        _download_data.bin_table[bin] = true;
+        ++_download_data.bins_received;
+        _download_data.bytes_received += msg.count;
     }
 
-    bool chunk_complete = _download_data.chunk_bytes_written == _download_data.current_chunk_size();
-
-    if (chunk_complete) {
-        auto result = LogFiles::Result::Next;
-
-        _download_data.current_chunk++;
-        _download_data.total_bytes_written += _download_data.chunk_bytes_written;
-        _download_data.chunk_bytes_written = 0;
-        _download_data.chunk_bin_table = std::vector<bool>(_download_data.bins_in_chunk(), false);
+    if (_download_data.bins_received == _download_data.total_bins()) {
+        finish_download(LogFiles::Result::Success);
+        return;
+    }
 
-        bool log_complete = _download_data.total_bytes_written == _download_data.entry.size_bytes;
+    if (bin + 1 == _download_data.request_end) {
+        // The autopilot is through with the last request, the gaps it left
+        // are asked for right away instead of waiting for the timeout.
+        request_missing_bins();
+    }
 
-        if (log_complete) {
-            result = LogFiles::Result::Success;
-            _download_data.file.close();
-            _system_impl->unregister_timeout_handler(_download_data.timeout_cookie);
+    if (_download_data.bytes_received - _download_data.bytes_saved >= PARTIAL_SAVE_SIZE) {
+        _download_data.save_partial();
+    }
 
-        } else {
-            // Request the next chunk
-            request_log_data(
-                _download_data.entry.id,
-                _download_data.current_chunk * CHUNK_SIZE,
-                _download_data.current_chunk_size());
-        }
+    if (_download_data.bytes_received - _download_data.bytes_reported >= CHUNK_SIZE) {
+        _download_data.bytes_reported = _download_data.bytes_received;
 
         LogFiles::ProgressData progress_data;
         progress_data.progress =
-            (float)_download_data.total_bytes_written / (float)_download_data.entry.size_bytes;
+            (float)_download_data.bytes_received / (float)_download_data.entry.size_bytes;
 
         // Update progress
         const auto cb = _download_data.user_callback;
         if (cb) {
             _system_impl->call_user_callback(
-                [cb, progress_data, result]() { cb(result, progress_data); });
+                [cb, progress_data]() { cb(LogFiles::Result::Next, progress_data); });
+        }
+    }
+}
+
+void LogFilesImpl::finish_download(LogFiles::Result result)
+{
+    // Requires _download_data_mutex
+    close_raw_file(_download_data.fd);
+    _download_data.fd = -1;
+    _system_impl->unregister_timeout_handler(_download_data.timeout_cookie);
+
+    if (result == LogFiles::Result::Success) {
+        std::error_code ec;
+        fs::remove(_download_data.partial_path(), ec);
+        log_downloaded(_download_data);
+    } else {
+        _download_data.save_partial();
+    }
+
+    LogFiles::ProgressData progress_data;
+    progress_data.progress =
+        _download_data.entry.size_bytes == 0 ?
+            1.0f :
+            (float)_download_data.bytes_received / (float)_download_data.entry.size_bytes;
+
+    const auto cb = _download_data.user_callback;
+    if (cb) {
+        _system_impl->call_user_callback(
+            [cb, progress_data, result]() { cb(result, progress_data); });
+    }
+}
+
+void LogFilesImpl::request_missing_bins()
+{
+    // Requires _download_data_mutex
+    auto& data = _download_data;
+
+    const uint32_t total_bins = data.total_bins();
+    while (data.first_missing_bin < total_bins && data.bin_table[data.first_missing_bin]) {
+        ++data.first_missing_bin;
+    }
+    if (data.first_missing_bin == total_bins) {
+        return;
+    }
+
+    // Bins we have already are streamed again if that takes less time than
+    // another request would, i.e. gaps shorter than a round trip are merged.
+    const uint32_t max_gap =
+        std::max(1u, static_cast<uint32_t>(data.round_trip_s * data.bins_per_second));
+
+    uint32_t end = data.first_missing_bin + 1;
+    uint32_t gap = 0;
+    for (uint32_t bin = end; bin < total_bins && gap < max_gap; ++bin) {
+        if (data.bin_table[bin]) {
+            ++gap;
+        } else {
+            gap = 0;
+            end = bin + 1;
         }
     }
+
+    data.request_start = data.first_missing_bin;
+    data.request_end = end;
+    data.request_time = _system_impl->get_time().steady_time();
+    data.request_bins_seen = 0;
+
+    const uint32_t start_offset = data.request_start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    const uint32_t end_offset =
+        std::min(data.entry.size_bytes, end * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+    request_log_data(data.entry.id, start_offset, end_offset - start_offset);
 }
 
 void LogFilesImpl::data_timeout()
@@ -378,17 +815,15 @@ void LogFilesImpl::data_timeout()
     std::lock_guard<std::mutex> lock(_download_data_mutex);
 
     LogErr() << "Timeout!";
-    LogErr() << "Requesting missing chunk:\t" << _download_data.current_chunk << "/"
-             << _download_data.total_chunks();
+    LogErr() << "Requesting missing data from bin:\t" << _download_data.first_missing_bin << "/"
+             << _download_data.total_bins();
 
-    // Reset chunk data
-    _download_data.chunk_bytes_written = 0;
-    _download_data.chunk_bin_table = std::vector<bool>(_download_data.bins_in_chunk(), false);
+    // The link might be gone for good, keep what we have.
+    if (_download_data.bytes_saved != _download_data.bytes_received) {
+        _download_data.save_partial();
+    }
 
-    request_log_data(
-        _download_data.entry.id,
-        _download_data.current_chunk * CHUNK_SIZE,
-        _download_data.current_chunk_size());
+    request_missing_bins();
 
     _system_impl->register_timeout_handler(
         [this]() { LogFilesImpl::data_timeout(); },
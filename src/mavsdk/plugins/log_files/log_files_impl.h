@@ -4,35 +4,84 @@
 #include "plugins/log_files/log_files.h"
 #include "plugin_impl_base.h"
 #include "system.h"
-#include <fstream>
+#include "mavsdk_time.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mavsdk {
 
 static constexpr uint32_t TABLE_BINS = 512;
+// Progress is reported every CHUNK_SIZE bytes.
 static constexpr uint32_t CHUNK_SIZE = (TABLE_BINS * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+// The state of a partial download is saved every PARTIAL_SAVE_SIZE bytes.
+static constexpr uint32_t PARTIAL_SAVE_SIZE = 64 * CHUNK_SIZE;
+
+// A log as listed by the autopilot, the id alone is reused for new logs
+// after they have been erased.
+struct LogIndexEntry {
+    uint16_t id{};
+    uint32_t time_utc{};
+    uint32_t size_bytes{};
+    // Set once the log has been downloaded completely.
+    std::string downloaded_path{};
+};
+
+struct LogIndex {
+    uint16_t num_logs{};
+    uint16_t last_log_num{};
+    std::unordered_map<uint16_t, LogIndexEntry> entries{};
+
+    [[nodiscard]] bool load(const std::string& path);
+    [[nodiscard]] bool save(const std::string& path) const;
+};
 
 struct LogData {
     LogData() = default;
     LogData(
         const LogFiles::Entry& e,
         const std::string& filepath,
-        LogFiles::DownloadLogFileCallback cb);
+        LogFiles::DownloadLogFileCallback cb,
+        uint8_t sysid,
+        uint32_t time);
 
-    bool file_is_open();
-    uint32_t current_chunk_size() const;
-    uint32_t total_chunks() const;
-    uint32_t bins_in_chunk() const;
+    bool open_file();
+    bool file_is_open() const;
+    uint32_t total_bins() const;
+    uint32_t bin_size(uint32_t bin) const;
+
+    // The bins received so far are kept next to the file, so an interrupted
+    // download can carry on where it stopped.
+    std::string partial_path() const;
+    [[nodiscard]] bool load_partial();
+    bool save_partial();
 
     LogFiles::Entry entry{};
+    uint8_t system_id{};
+    uint32_t time_utc{};
 
     std::string file_path{};
-    std::ofstream file{};
-
-    uint32_t current_chunk{};
-    std::vector<bool> chunk_bin_table{};
-
-    uint32_t chunk_bytes_written{};
-    uint32_t total_bytes_written{};
+    int fd{-1};
+
+    // One flag per LOG_DATA message over the whole file. All bins before
+    // first_missing_bin are there.
+    std::vector<bool> bin_table{};
+    uint32_t first_missing_bin{};
+    uint32_t bins_received{};
+    uint32_t bytes_received{};
+    uint32_t bytes_reported{};
+    uint32_t bytes_saved{};
+
+    // The autopilot streams the bins [request_start, request_end) of the
+    // last request. Its rate and the time until the first bin arrives decide
+    // whether a gap is worth a request of its own.
+    uint32_t request_start{};
+    uint32_t request_end{};
+    SteadyTimePoint request_time{};
+    SteadyTimePoint first_bin_time{};
+    uint32_t request_bins_seen{};
+    double round_trip_s{};
+    double bins_per_second{};
 
     void* timeout_cookie{};
 
@@ -67,18 +116,30 @@ public:
 private:
     void process_log_entry(const mavlink_message_t& message);
     void entries_timeout();
+    bool log_index_matches(const mavlink_log_entry_t& msg) const;
+    void add_log_entry(const LogIndexEntry& index_entry);
+    void entries_complete();
+    void log_downloaded(const LogData& download_data);
+    std::string log_index_path() const;
 
     void process_log_data(const mavlink_message_t& message);
     void data_timeout();
 
     void request_log_list(uint16_t index_min, uint16_t index_max);
     void request_log_data(unsigned id, unsigned start, unsigned count);
+    void request_missing_bins();
+    void finish_download(LogFiles::Result result);
 
     void request_end();
 
     std::mutex _entries_mutex;
     std::unordered_map<uint16_t, LogFiles::Entry> _log_entries;
     uint32_t _total_entries{0};
+    // The logs listed so far, and what was known from earlier listings.
+    LogIndex _listing{};
+    LogIndex _log_index{};
+    bool _listing_active{false};
+    bool _entries_from_index{false};
     void* _entries_timeout_cookie{};
     LogFiles::GetEntriesCallback _entries_user_callback{};
 
@@ -232,7 +232,7 @@ void MavlinkPassthroughImpl::unsubscribe_message(
 void MavlinkPassthroughImpl::receive_mavlink_message(const mavlink_message_t& message)
 {
     _message_subscriptions[message.msgid].queue(
-        message, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        message, [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 uint8_t MavlinkPassthroughImpl::get_our_sysid() const
@@ -1094,8 +1094,9 @@ void MissionImpl::report_progress_locked()
     }
 
     if (should_report) {
-        _mission_data.mission_progress_callbacks.queue(
-            {current, total}, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        _mission_data.mission_progress_callbacks.queue({current, total}, [this](auto&& func) {
+            _system_impl->call_user_callback(std::move(func));
+        });
         LogDebug() << "current: " << current << ", total: " << total;
     }
 }
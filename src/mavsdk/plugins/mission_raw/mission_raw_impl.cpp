@@ -82,7 +82,7 @@ void MissionRawImpl::process_mission_ack(const mavlink_message_t& message)
     // a new mission. In that case we need to notify our user.
     std::lock_guard<std::mutex> lock(_mission_changed.mutex);
     _mission_changed.callbacks.queue(
-        true, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        true, [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void MissionRawImpl::process_mission_current(const mavlink_message_t& message)
@@ -548,8 +548,8 @@ void MissionRawImpl::report_progress_current()
     }
 
     if (should_report) {
-        _mission_progress.callbacks.queue(_mission_progress.last, [this](const auto& func) {
-            _system_impl->call_user_callback(func);
+        _mission_progress.callbacks.queue(_mission_progress.last, [this](auto&& func) {
+            _system_impl->call_user_callback(std::move(func));
         });
     }
 }
@@ -171,7 +171,7 @@ void MissionRawServerImpl::process_mission_count(const mavlink_message_t& messag
         _incoming_mission_callbacks.queue(
             MissionRawServer::Result::Busy,
             MissionRawServer::MissionPlan{},
-            [this](const auto& func) { _server_component_impl->call_user_callback(func); });
+            [this](auto&& func) { _server_component_impl->call_user_callback(std::move(func)); });
         return;
     }
 
@@ -187,8 +187,8 @@ void MissionRawServerImpl::process_mission_count(const mavlink_message_t& messag
             auto converted_result = convert_result(result);
             auto converted_items = convert_items(items);
             _incoming_mission_callbacks.queue(
-                converted_result, {converted_items}, [this](const auto& func) {
-                    _server_component_impl->call_user_callback(func);
+                converted_result, {converted_items}, [this](auto&& func) {
+                    _server_component_impl->call_user_callback(std::move(func));
                 });
             _mission_completed = false;
             set_current_seq(0);
@@ -245,8 +245,8 @@ void MissionRawServerImpl::process_mission_clear(const mavlink_message_t message
         clear_all.mission_type == MAV_MISSION_TYPE_MISSION) {
         _current_mission.clear();
         _current_seq = 0;
-        _clear_all_callbacks.queue(clear_all.mission_type, [this](const auto& func) {
-            _server_component_impl->call_user_callback(func);
+        _clear_all_callbacks.queue(clear_all.mission_type, [this](auto&& func) {
+            _server_component_impl->call_user_callback(std::move(func));
         });
     }
 
@@ -357,8 +357,8 @@ void MissionRawServerImpl::set_current_seq(std::size_t seq)
     auto item = seq == _current_mission.size() ? _current_mission.back() :
                                                  _current_mission.at(_current_seq);
     auto converted_item = convert_item(item);
-    _current_item_changed_callbacks.queue(converted_item, [this](const auto& func) {
-        _server_component_impl->call_user_callback(func);
+    _current_item_changed_callbacks.queue(converted_item, [this](auto&& func) {
+        _server_component_impl->call_user_callback(std::move(func));
     });
 
     _server_component_impl->queue_message([&](MavlinkAddress mavlink_address, uint8_t channel) {
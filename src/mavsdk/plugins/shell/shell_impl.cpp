@@ -149,7 +149,7 @@ void ShellImpl::process_shell_message(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_receive.mutex);
     _receive.callbacks.queue(
-        response, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        response, [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 } // namespace mavsdk
@@ -0,0 +1,816 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+
+#include "plugin_base.h"
+#include "history_column.h"
+#include "plugins/telemetry/telemetry.h"
+
+namespace mavsdk {
+
+class System;
+class TelemetryImpl;
+
+/**
+ * @brief Telemetry functionality only available in C++.
+ *
+ * These functions are not part of the Telemetry API generated from the proto
+ * files and therefore not available over mavsdk_server.
+ *
+ * TelemetryExt works on the same implementation as the Telemetry plugin
+ * created first for the system, so messages are only decoded once and
+ * rates, histories and subscriptions are shared between the two. Create it
+ * after Telemetry and keep that Telemetry alive for as long as it is used.
+ * Without a Telemetry for the system, TelemetryExt uses one of its own.
+ */
+class TelemetryExt : public PluginBase {
+public:
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * The plugin is typically created as shown below:
+     *
+     *     ```cpp
+     *     auto telemetry_ext = TelemetryExt(system);
+     *     ```
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit TelemetryExt(System& system); // deprecated
+
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * The plugin is typically created as shown below:
+     *
+     *     ```cpp
+     *     auto telemetry_ext = TelemetryExt(system);
+     *     ```
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit TelemetryExt(std::shared_ptr<System> system); // new
+
+    /**
+     * @brief Destructor (internal use only).
+     */
+    ~TelemetryExt() override;
+
+    /**
+     * @brief Snapshot of all cached telemetry.
+     *
+     * All fields are captured together in one consistent copy. The receive times
+     * are taken from a monotonic clock and can be compared with each other.
+     */
+    struct Snapshot {
+        Telemetry::Position position{}; /**< @brief Position */
+        Telemetry::Position home{}; /**< @brief Home position */
+        Telemetry::VelocityNed velocity_ned{}; /**< @brief Velocity (NED) */
+        Telemetry::Heading heading{}; /**< @brief Heading */
+        Telemetry::PositionVelocityNed
+            position_velocity_ned{}; /**< @brief Position and velocity (NED) */
+        Telemetry::Quaternion attitude_quaternion{}; /**< @brief Attitude as quaternion */
+        Telemetry::EulerAngle attitude_euler{}; /**< @brief Attitude as Euler angles */
+        Telemetry::AngularVelocityBody
+            attitude_angular_velocity_body{}; /**< @brief Angular velocity (body) */
+        Telemetry::EulerAngle
+            camera_attitude_euler{}; /**< @brief Camera attitude as Euler angles */
+        Telemetry::Imu imu{}; /**< @brief IMU (highres) */
+        Telemetry::Imu scaled_imu{}; /**< @brief Scaled IMU */
+        Telemetry::Imu raw_imu{}; /**< @brief Raw IMU */
+        Telemetry::GpsInfo gps_info{}; /**< @brief GPS info */
+        Telemetry::RawGps raw_gps{}; /**< @brief Raw GPS */
+        Telemetry::Battery battery{}; /**< @brief Battery */
+        Telemetry::FixedwingMetrics fixedwing_metrics{}; /**< @brief Fixedwing metrics */
+        Telemetry::GroundTruth ground_truth{}; /**< @brief Ground truth */
+        Telemetry::DistanceSensor distance_sensor{}; /**< @brief Distance sensor */
+        Telemetry::ScaledPressure scaled_pressure{}; /**< @brief Scaled pressure */
+        Telemetry::Altitude altitude{}; /**< @brief Altitude */
+        Telemetry::Health health{}; /**< @brief Health */
+        Telemetry::RcStatus rc_status{}; /**< @brief RC status */
+        Telemetry::LandedState landed_state{}; /**< @brief Landed state */
+        Telemetry::VtolState vtol_state{}; /**< @brief VTOL state */
+        Telemetry::FlightMode flight_mode{}; /**< @brief Flight mode */
+        bool in_air{false}; /**< @brief In-air state */
+        bool armed{false}; /**< @brief Armed state */
+        uint64_t unix_epoch_time_us{}; /**< @brief Unix epoch time in microseconds */
+
+        uint64_t position_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t home_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t velocity_ned_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t heading_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t position_velocity_ned_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t attitude_quaternion_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t attitude_euler_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t attitude_angular_velocity_body_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t camera_attitude_euler_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t imu_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t scaled_imu_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t raw_imu_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t gps_info_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t raw_gps_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t battery_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t fixedwing_metrics_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t ground_truth_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t distance_sensor_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t scaled_pressure_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t altitude_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t health_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t rc_status_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t landed_state_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t vtol_state_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t flight_mode_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t in_air_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t armed_receive_time_us{}; /**< @brief Receive time (us) */
+        uint64_t unix_epoch_time_receive_time_us{}; /**< @brief Receive time (us) */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::Snapshot` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(const TelemetryExt::Snapshot& lhs, const TelemetryExt::Snapshot& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::Snapshot`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(std::ostream& str, TelemetryExt::Snapshot const& snapshot);
+
+    /**
+     * @brief History of 'Position' updates, stored as one column per member.
+     *
+     * Receive times use the same monotonic clock as the receive times in
+     * `Snapshot`. Autopilot times are the Unix epoch time of the autopilot at
+     * reception, both in microseconds.
+     */
+    struct PositionHistory {
+        HistoryColumn<uint64_t> receive_time_us{}; /**< @brief Receive time (us) */
+        HistoryColumn<uint64_t> autopilot_time_us{}; /**< @brief Autopilot time (us) */
+        HistoryColumn<double> latitude_deg{}; /**< @brief Latitude in degrees */
+        HistoryColumn<double> longitude_deg{}; /**< @brief Longitude in degrees */
+        HistoryColumn<float>
+            absolute_altitude_m{}; /**< @brief Altitude AMSL (above mean sea level) in metres */
+        HistoryColumn<float>
+            relative_altitude_m{}; /**< @brief Altitude relative to takeoff altitude in metres */
+    };
+
+    /**
+     * @brief History of 'EulerAngle' attitude updates, stored as one column per member.
+     */
+    struct AttitudeEulerHistory {
+        HistoryColumn<uint64_t> receive_time_us{}; /**< @brief Receive time (us) */
+        HistoryColumn<uint64_t> autopilot_time_us{}; /**< @brief Autopilot time (us) */
+        HistoryColumn<float> roll_deg{}; /**< @brief Roll angle in degrees */
+        HistoryColumn<float> pitch_deg{}; /**< @brief Pitch angle in degrees */
+        HistoryColumn<float> yaw_deg{}; /**< @brief Yaw angle in degrees */
+    };
+
+    /**
+     * @brief History of 'Battery' updates, stored as one column per member.
+     */
+    struct BatteryHistory {
+        HistoryColumn<uint64_t> receive_time_us{}; /**< @brief Receive time (us) */
+        HistoryColumn<uint64_t> autopilot_time_us{}; /**< @brief Autopilot time (us) */
+        HistoryColumn<uint32_t> id{}; /**< @brief Battery ID */
+        HistoryColumn<float> voltage_v{}; /**< @brief Voltage in volts */
+        HistoryColumn<float> current_battery_a{}; /**< @brief Battery current in Amps */
+        HistoryColumn<float> remaining_percent{}; /**< @brief Estimated battery remaining */
+    };
+
+    /**
+     * @brief Rates of several telemetry streams, to be set at once.
+     *
+     * A rate of NaN leaves the stream unchanged, 0 requests the default rate
+     * and a negative rate stops the stream.
+     */
+    struct RateProfile {
+        double position_rate_hz{double(NAN)}; /**< @brief Position rate in Hz */
+        double home_rate_hz{double(NAN)}; /**< @brief Home position rate in Hz */
+        double landed_state_rate_hz{double(NAN)}; /**< @brief Landed and VTOL state rate in Hz */
+        double attitude_quaternion_rate_hz{
+            double(NAN)}; /**< @brief Attitude quaternion rate in Hz */
+        double attitude_euler_rate_hz{double(NAN)}; /**< @brief Attitude euler angles rate in Hz */
+        double camera_attitude_rate_hz{double(NAN)}; /**< @brief Camera attitude rate in Hz */
+        double velocity_ned_rate_hz{double(NAN)}; /**< @brief Velocity (NED) rate in Hz */
+        double gps_info_rate_hz{double(NAN)}; /**< @brief GPS info rate in Hz */
+        double battery_rate_hz{double(NAN)}; /**< @brief Battery rate in Hz */
+        double actuator_control_target_rate_hz{
+            double(NAN)}; /**< @brief Actuator control target rate in Hz */
+        double actuator_output_status_rate_hz{
+            double(NAN)}; /**< @brief Actuator output status rate in Hz */
+        double odometry_rate_hz{double(NAN)}; /**< @brief Odometry rate in Hz */
+        double position_velocity_ned_rate_hz{
+            double(NAN)}; /**< @brief Position and velocity (NED) rate in Hz */
+        double ground_truth_rate_hz{double(NAN)}; /**< @brief Ground truth rate in Hz */
+        double fixedwing_metrics_rate_hz{double(NAN)}; /**< @brief Fixedwing metrics rate in Hz */
+        double imu_rate_hz{double(NAN)}; /**< @brief IMU rate in Hz */
+        double scaled_imu_rate_hz{double(NAN)}; /**< @brief Scaled IMU rate in Hz */
+        double raw_imu_rate_hz{double(NAN)}; /**< @brief Raw IMU rate in Hz */
+        double unix_epoch_time_rate_hz{double(NAN)}; /**< @brief Unix epoch time rate in Hz */
+        double distance_sensor_rate_hz{double(NAN)}; /**< @brief Distance sensor rate in Hz */
+        double scaled_pressure_rate_hz{double(NAN)}; /**< @brief Scaled pressure rate in Hz */
+        double altitude_rate_hz{double(NAN)}; /**< @brief Altitude rate in Hz */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::RateProfile` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool
+    operator==(const TelemetryExt::RateProfile& lhs, const TelemetryExt::RateProfile& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::RateProfile`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExt::RateProfile const& rate_profile);
+
+    /**
+     * @brief Subscribe to 'position' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::PositionHandle
+    subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_position
+     */
+    void unsubscribe_position(Telemetry::PositionHandle handle);
+
+    /**
+     * @brief Subscribe to 'home position' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::HomeHandle
+    subscribe_home(const Telemetry::HomeCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_home
+     */
+    void unsubscribe_home(Telemetry::HomeHandle handle);
+
+    /**
+     * @brief Subscribe to in-air updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::InAirHandle
+    subscribe_in_air(const Telemetry::InAirCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_in_air
+     */
+    void unsubscribe_in_air(Telemetry::InAirHandle handle);
+
+    /**
+     * @brief Subscribe to landed state updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::LandedStateHandle
+    subscribe_landed_state(const Telemetry::LandedStateCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_landed_state
+     */
+    void unsubscribe_landed_state(Telemetry::LandedStateHandle handle);
+
+    /**
+     * @brief Subscribe to armed updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ArmedHandle
+    subscribe_armed(const Telemetry::ArmedCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_armed
+     */
+    void unsubscribe_armed(Telemetry::ArmedHandle handle);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (quaternion), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::AttitudeQuaternionHandle subscribe_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_attitude_quaternion
+     */
+    void unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (Euler), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::AttitudeEulerHandle
+    subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_attitude_euler
+     */
+    void unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (angular velocity), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::AttitudeAngularVelocityBodyHandle subscribe_attitude_angular_velocity_body(
+        const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_attitude_angular_velocity_body
+     */
+    void unsubscribe_attitude_angular_velocity_body(
+        Telemetry::AttitudeAngularVelocityBodyHandle handle);
+
+    /**
+     * @brief Subscribe to 'camera attitude' updates (quaternion), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::CameraAttitudeQuaternionHandle subscribe_camera_attitude_quaternion(
+        const Telemetry::CameraAttitudeQuaternionCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_camera_attitude_quaternion
+     */
+    void unsubscribe_camera_attitude_quaternion(Telemetry::CameraAttitudeQuaternionHandle handle);
+
+    /**
+     * @brief Subscribe to 'camera attitude' updates (Euler), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::CameraAttitudeEulerHandle subscribe_camera_attitude_euler(
+        const Telemetry::CameraAttitudeEulerCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_camera_attitude_euler
+     */
+    void unsubscribe_camera_attitude_euler(Telemetry::CameraAttitudeEulerHandle handle);
+
+    /**
+     * @brief Subscribe to 'ground speed' updates (NED), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::VelocityNedHandle
+    subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_velocity_ned
+     */
+    void unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle);
+
+    /**
+     * @brief Subscribe to 'GPS info' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::GpsInfoHandle
+    subscribe_gps_info(const Telemetry::GpsInfoCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_gps_info
+     */
+    void unsubscribe_gps_info(Telemetry::GpsInfoHandle handle);
+
+    /**
+     * @brief Subscribe to 'Raw GPS' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::RawGpsHandle
+    subscribe_raw_gps(const Telemetry::RawGpsCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_raw_gps
+     */
+    void unsubscribe_raw_gps(Telemetry::RawGpsHandle handle);
+
+    /**
+     * @brief Subscribe to 'battery' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::BatteryHandle
+    subscribe_battery(const Telemetry::BatteryCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_battery
+     */
+    void unsubscribe_battery(Telemetry::BatteryHandle handle);
+
+    /**
+     * @brief Subscribe to 'flight mode' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::FlightModeHandle
+    subscribe_flight_mode(const Telemetry::FlightModeCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_flight_mode
+     */
+    void unsubscribe_flight_mode(Telemetry::FlightModeHandle handle);
+
+    /**
+     * @brief Subscribe to 'health' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::HealthHandle
+    subscribe_health(const Telemetry::HealthCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_health
+     */
+    void unsubscribe_health(Telemetry::HealthHandle handle);
+
+    /**
+     * @brief Subscribe to 'RC status' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::RcStatusHandle
+    subscribe_rc_status(const Telemetry::RcStatusCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_rc_status
+     */
+    void unsubscribe_rc_status(Telemetry::RcStatusHandle handle);
+
+    /**
+     * @brief Subscribe to 'actuator control target' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ActuatorControlTargetHandle subscribe_actuator_control_target(
+        const Telemetry::ActuatorControlTargetCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_actuator_control_target
+     */
+    void unsubscribe_actuator_control_target(Telemetry::ActuatorControlTargetHandle handle);
+
+    /**
+     * @brief Subscribe to 'actuator output status' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ActuatorOutputStatusHandle subscribe_actuator_output_status(
+        const Telemetry::ActuatorOutputStatusCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_actuator_output_status
+     */
+    void unsubscribe_actuator_output_status(Telemetry::ActuatorOutputStatusHandle handle);
+
+    /**
+     * @brief Subscribe to 'odometry' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::OdometryHandle
+    subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_odometry
+     */
+    void unsubscribe_odometry(Telemetry::OdometryHandle handle);
+
+    /**
+     * @brief Subscribe to 'position velocity' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::PositionVelocityNedHandle subscribe_position_velocity_ned(
+        const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_position_velocity_ned
+     */
+    void unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle);
+
+    /**
+     * @brief Subscribe to 'ground truth' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::GroundTruthHandle
+    subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_ground_truth
+     */
+    void unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle);
+
+    /**
+     * @brief Subscribe to 'fixedwing metrics' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::FixedwingMetricsHandle subscribe_fixedwing_metrics(
+        const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_fixedwing_metrics
+     */
+    void unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle);
+
+    /**
+     * @brief Subscribe to 'IMU' updates (in SI units in NED body frame), rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ImuHandle subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_imu
+     */
+    void unsubscribe_imu(Telemetry::ImuHandle handle);
+
+    /**
+     * @brief Subscribe to 'Scaled IMU' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ScaledImuHandle
+    subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_scaled_imu
+     */
+    void unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle);
+
+    /**
+     * @brief Subscribe to 'Raw IMU' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::RawImuHandle
+    subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_raw_imu
+     */
+    void unsubscribe_raw_imu(Telemetry::RawImuHandle handle);
+
+    /**
+     * @brief Subscribe to 'HealthAllOk' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::HealthAllOkHandle
+    subscribe_health_all_ok(const Telemetry::HealthAllOkCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_health_all_ok
+     */
+    void unsubscribe_health_all_ok(Telemetry::HealthAllOkHandle handle);
+
+    /**
+     * @brief Subscribe to 'unix epoch time' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::UnixEpochTimeHandle
+    subscribe_unix_epoch_time(const Telemetry::UnixEpochTimeCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_unix_epoch_time
+     */
+    void unsubscribe_unix_epoch_time(Telemetry::UnixEpochTimeHandle handle);
+
+    /**
+     * @brief Subscribe to 'Distance Sensor' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::DistanceSensorHandle subscribe_distance_sensor(
+        const Telemetry::DistanceSensorCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_distance_sensor
+     */
+    void unsubscribe_distance_sensor(Telemetry::DistanceSensorHandle handle);
+
+    /**
+     * @brief Subscribe to 'Scaled Pressure' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::ScaledPressureHandle subscribe_scaled_pressure(
+        const Telemetry::ScaledPressureCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_scaled_pressure
+     */
+    void unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle handle);
+
+    /**
+     * @brief Subscribe to 'Heading' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::HeadingHandle
+    subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_heading
+     */
+    void unsubscribe_heading(Telemetry::HeadingHandle handle);
+
+    /**
+     * @brief Subscribe to 'Altitude' updates, rate limited.
+     *
+     * Updates arriving faster than max_rate_hz are dropped before the callback is queued.
+     * This does not change the rate the vehicle sends at.
+     */
+    Telemetry::AltitudeHandle
+    subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Unsubscribe from subscribe_altitude
+     */
+    void unsubscribe_altitude(Telemetry::AltitudeHandle handle);
+
+    /**
+     * @brief Poll for a consistent 'Snapshot' of all cached telemetry (blocking).
+     *
+     * This is cheaper than calling the individual Telemetry getters one by one and the
+     * fields can't change in between.
+     *
+     * @return Snapshot of all cached telemetry.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Keep a history of the last 'Position' updates.
+     *
+     * Memory for `capacity` samples is allocated once here, older samples are
+     * overwritten. A capacity of 0 disables the history again.
+     */
+    void enable_position_history(uint32_t capacity);
+
+    /**
+     * @brief Callback type for position_history.
+     */
+    using PositionHistoryCallback = std::function<void(const PositionHistory&)>;
+
+    /**
+     * @brief Query the 'Position' history for a time range (blocking).
+     *
+     * The callback is called before this returns, with all samples received in
+     * [from_receive_time_us, to_receive_time_us). The range is copied first, so
+     * the callback doesn't hold up new samples. The columns point into that
+     * copy and are only valid inside the callback.
+     */
+    void position_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const PositionHistoryCallback& callback) const;
+
+    /**
+     * @brief Keep a history of the last 'AttitudeEuler' updates.
+     *
+     * Memory for `capacity` samples is allocated once here, older samples are
+     * overwritten. A capacity of 0 disables the history again.
+     */
+    void enable_attitude_euler_history(uint32_t capacity);
+
+    /**
+     * @brief Callback type for attitude_euler_history.
+     */
+    using AttitudeEulerHistoryCallback = std::function<void(const AttitudeEulerHistory&)>;
+
+    /**
+     * @brief Query the 'AttitudeEuler' history for a time range (blocking).
+     *
+     * The callback is called before this returns, with all samples received in
+     * [from_receive_time_us, to_receive_time_us). The range is copied first, so
+     * the callback doesn't hold up new samples. The columns point into that
+     * copy and are only valid inside the callback.
+     */
+    void attitude_euler_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const AttitudeEulerHistoryCallback& callback) const;
+
+    /**
+     * @brief Keep a history of the last 'Battery' updates.
+     *
+     * Memory for `capacity` samples is allocated once here, older samples are
+     * overwritten. A capacity of 0 disables the history again.
+     */
+    void enable_battery_history(uint32_t capacity);
+
+    /**
+     * @brief Callback type for battery_history.
+     */
+    using BatteryHistoryCallback = std::function<void(const BatteryHistory&)>;
+
+    /**
+     * @brief Query the 'Battery' history for a time range (blocking).
+     *
+     * The callback is called before this returns, with all samples received in
+     * [from_receive_time_us, to_receive_time_us). The range is copied first, so
+     * the callback doesn't hold up new samples. The columns point into that
+     * copy and are only valid inside the callback.
+     */
+    void battery_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const BatteryHistoryCallback& callback) const;
+
+    /**
+     * @brief Set the rates of several streams at once.
+     *
+     * The rate requests are sent without waiting for each other and one
+     * result is returned for all of them. The profile is remembered and set
+     * again whenever the system reconnects.
+     *
+     * This function is non-blocking. See 'set_rates' for the blocking counterpart.
+     */
+    void set_rates_async(RateProfile rate_profile, const Telemetry::ResultCallback callback);
+
+    /**
+     * @brief Set the rates of several streams at once.
+     *
+     * The rate requests are sent without waiting for each other and one
+     * result is returned for all of them. The profile is remembered and set
+     * again whenever the system reconnects.
+     *
+     * This function is blocking. See 'set_rates_async' for the non-blocking counterpart.
+     *
+     * @return Result of request.
+     */
+    Telemetry::Result set_rates(RateProfile rate_profile) const;
+
+    /**
+     * @brief Copy Constructor (object is not copyable).
+     */
+    TelemetryExt(const TelemetryExt&) = delete;
+
+    /**
+     * @brief Equality operator (object is not copyable).
+     */
+    const TelemetryExt& operator=(const TelemetryExt&) = delete;
+
+private:
+    /** @private Implementation only owned if no Telemetry existed at instantiation */
+    std::unique_ptr<TelemetryImpl> _owned_impl;
+
+    /** @private Underlying implementation, shared with Telemetry, set at instantiation */
+    TelemetryImpl* _impl;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,655 @@
+#include <cmath>
+#include <iomanip>
+
+#include "telemetry_impl.h"
+#include "plugins/telemetry/telemetry_ext.h"
+
+namespace mavsdk {
+
+TelemetryExt::TelemetryExt(System& system) : PluginBase(), _impl{TelemetryImpl::shared_impl(system)}
+{
+    // Without a Telemetry for this system there is nothing to share yet.
+    if (_impl == nullptr) {
+        _owned_impl = std::make_unique<TelemetryImpl>(system);
+        _impl = _owned_impl.get();
+    }
+}
+
+TelemetryExt::TelemetryExt(std::shared_ptr<System> system) : TelemetryExt(*system) {}
+
+TelemetryExt::~TelemetryExt() {}
+
+Telemetry::PositionHandle
+TelemetryExt::subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_position(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_position(Telemetry::PositionHandle handle)
+{
+    _impl->unsubscribe_position(handle);
+}
+
+Telemetry::HomeHandle
+TelemetryExt::subscribe_home(const Telemetry::HomeCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_home(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_home(Telemetry::HomeHandle handle)
+{
+    _impl->unsubscribe_home(handle);
+}
+
+Telemetry::InAirHandle
+TelemetryExt::subscribe_in_air(const Telemetry::InAirCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_in_air(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_in_air(Telemetry::InAirHandle handle)
+{
+    _impl->unsubscribe_in_air(handle);
+}
+
+Telemetry::LandedStateHandle TelemetryExt::subscribe_landed_state(
+    const Telemetry::LandedStateCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_landed_state(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_landed_state(Telemetry::LandedStateHandle handle)
+{
+    _impl->unsubscribe_landed_state(handle);
+}
+
+Telemetry::ArmedHandle
+TelemetryExt::subscribe_armed(const Telemetry::ArmedCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_armed(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_armed(Telemetry::ArmedHandle handle)
+{
+    _impl->unsubscribe_armed(handle);
+}
+
+Telemetry::AttitudeQuaternionHandle TelemetryExt::subscribe_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_attitude_quaternion(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle)
+{
+    _impl->unsubscribe_attitude_quaternion(handle);
+}
+
+Telemetry::AttitudeEulerHandle TelemetryExt::subscribe_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_attitude_euler(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle)
+{
+    _impl->unsubscribe_attitude_euler(handle);
+}
+
+Telemetry::AttitudeAngularVelocityBodyHandle TelemetryExt::subscribe_attitude_angular_velocity_body(
+    const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_attitude_angular_velocity_body(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_attitude_angular_velocity_body(
+    Telemetry::AttitudeAngularVelocityBodyHandle handle)
+{
+    _impl->unsubscribe_attitude_angular_velocity_body(handle);
+}
+
+Telemetry::CameraAttitudeQuaternionHandle TelemetryExt::subscribe_camera_attitude_quaternion(
+    const Telemetry::CameraAttitudeQuaternionCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_camera_attitude_quaternion(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_camera_attitude_quaternion(
+    Telemetry::CameraAttitudeQuaternionHandle handle)
+{
+    _impl->unsubscribe_camera_attitude_quaternion(handle);
+}
+
+Telemetry::CameraAttitudeEulerHandle TelemetryExt::subscribe_camera_attitude_euler(
+    const Telemetry::CameraAttitudeEulerCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_camera_attitude_euler(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_camera_attitude_euler(Telemetry::CameraAttitudeEulerHandle handle)
+{
+    _impl->unsubscribe_camera_attitude_euler(handle);
+}
+
+Telemetry::VelocityNedHandle TelemetryExt::subscribe_velocity_ned(
+    const Telemetry::VelocityNedCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_velocity_ned(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle)
+{
+    _impl->unsubscribe_velocity_ned(handle);
+}
+
+Telemetry::GpsInfoHandle
+TelemetryExt::subscribe_gps_info(const Telemetry::GpsInfoCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_gps_info(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_gps_info(Telemetry::GpsInfoHandle handle)
+{
+    _impl->unsubscribe_gps_info(handle);
+}
+
+Telemetry::RawGpsHandle
+TelemetryExt::subscribe_raw_gps(const Telemetry::RawGpsCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_raw_gps(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_raw_gps(Telemetry::RawGpsHandle handle)
+{
+    _impl->unsubscribe_raw_gps(handle);
+}
+
+Telemetry::BatteryHandle
+TelemetryExt::subscribe_battery(const Telemetry::BatteryCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_battery(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_battery(Telemetry::BatteryHandle handle)
+{
+    _impl->unsubscribe_battery(handle);
+}
+
+Telemetry::FlightModeHandle TelemetryExt::subscribe_flight_mode(
+    const Telemetry::FlightModeCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_flight_mode(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_flight_mode(Telemetry::FlightModeHandle handle)
+{
+    _impl->unsubscribe_flight_mode(handle);
+}
+
+Telemetry::HealthHandle
+TelemetryExt::subscribe_health(const Telemetry::HealthCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_health(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_health(Telemetry::HealthHandle handle)
+{
+    _impl->unsubscribe_health(handle);
+}
+
+Telemetry::RcStatusHandle
+TelemetryExt::subscribe_rc_status(const Telemetry::RcStatusCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_rc_status(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_rc_status(Telemetry::RcStatusHandle handle)
+{
+    _impl->unsubscribe_rc_status(handle);
+}
+
+Telemetry::ActuatorControlTargetHandle TelemetryExt::subscribe_actuator_control_target(
+    const Telemetry::ActuatorControlTargetCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_actuator_control_target(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_actuator_control_target(
+    Telemetry::ActuatorControlTargetHandle handle)
+{
+    _impl->unsubscribe_actuator_control_target(handle);
+}
+
+Telemetry::ActuatorOutputStatusHandle TelemetryExt::subscribe_actuator_output_status(
+    const Telemetry::ActuatorOutputStatusCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_actuator_output_status(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_actuator_output_status(Telemetry::ActuatorOutputStatusHandle handle)
+{
+    _impl->unsubscribe_actuator_output_status(handle);
+}
+
+Telemetry::OdometryHandle
+TelemetryExt::subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_odometry(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_odometry(Telemetry::OdometryHandle handle)
+{
+    _impl->unsubscribe_odometry(handle);
+}
+
+Telemetry::PositionVelocityNedHandle TelemetryExt::subscribe_position_velocity_ned(
+    const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_position_velocity_ned(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle)
+{
+    _impl->unsubscribe_position_velocity_ned(handle);
+}
+
+Telemetry::GroundTruthHandle TelemetryExt::subscribe_ground_truth(
+    const Telemetry::GroundTruthCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_ground_truth(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle)
+{
+    _impl->unsubscribe_ground_truth(handle);
+}
+
+Telemetry::FixedwingMetricsHandle TelemetryExt::subscribe_fixedwing_metrics(
+    const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_fixedwing_metrics(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle)
+{
+    _impl->unsubscribe_fixedwing_metrics(handle);
+}
+
+Telemetry::ImuHandle
+TelemetryExt::subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_imu(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_imu(Telemetry::ImuHandle handle)
+{
+    _impl->unsubscribe_imu(handle);
+}
+
+Telemetry::ScaledImuHandle
+TelemetryExt::subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_scaled_imu(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle)
+{
+    _impl->unsubscribe_scaled_imu(handle);
+}
+
+Telemetry::RawImuHandle
+TelemetryExt::subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_raw_imu(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_raw_imu(Telemetry::RawImuHandle handle)
+{
+    _impl->unsubscribe_raw_imu(handle);
+}
+
+Telemetry::HealthAllOkHandle TelemetryExt::subscribe_health_all_ok(
+    const Telemetry::HealthAllOkCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_health_all_ok(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_health_all_ok(Telemetry::HealthAllOkHandle handle)
+{
+    _impl->unsubscribe_health_all_ok(handle);
+}
+
+Telemetry::UnixEpochTimeHandle TelemetryExt::subscribe_unix_epoch_time(
+    const Telemetry::UnixEpochTimeCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_unix_epoch_time(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_unix_epoch_time(Telemetry::UnixEpochTimeHandle handle)
+{
+    _impl->unsubscribe_unix_epoch_time(handle);
+}
+
+Telemetry::DistanceSensorHandle TelemetryExt::subscribe_distance_sensor(
+    const Telemetry::DistanceSensorCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_distance_sensor(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_distance_sensor(Telemetry::DistanceSensorHandle handle)
+{
+    _impl->unsubscribe_distance_sensor(handle);
+}
+
+Telemetry::ScaledPressureHandle TelemetryExt::subscribe_scaled_pressure(
+    const Telemetry::ScaledPressureCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_scaled_pressure(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle handle)
+{
+    _impl->unsubscribe_scaled_pressure(handle);
+}
+
+Telemetry::HeadingHandle
+TelemetryExt::subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_heading(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_heading(Telemetry::HeadingHandle handle)
+{
+    _impl->unsubscribe_heading(handle);
+}
+
+Telemetry::AltitudeHandle
+TelemetryExt::subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz)
+{
+    return _impl->subscribe_altitude(callback, max_rate_hz);
+}
+
+void TelemetryExt::unsubscribe_altitude(Telemetry::AltitudeHandle handle)
+{
+    _impl->unsubscribe_altitude(handle);
+}
+
+TelemetryExt::Snapshot TelemetryExt::snapshot() const
+{
+    return _impl->snapshot();
+}
+
+void TelemetryExt::enable_position_history(uint32_t capacity)
+{
+    _impl->enable_position_history(capacity);
+}
+
+void TelemetryExt::position_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const PositionHistoryCallback& callback) const
+{
+    _impl->position_history(from_receive_time_us, to_receive_time_us, callback);
+}
+
+void TelemetryExt::enable_attitude_euler_history(uint32_t capacity)
+{
+    _impl->enable_attitude_euler_history(capacity);
+}
+
+void TelemetryExt::attitude_euler_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const AttitudeEulerHistoryCallback& callback) const
+{
+    _impl->attitude_euler_history(from_receive_time_us, to_receive_time_us, callback);
+}
+
+void TelemetryExt::enable_battery_history(uint32_t capacity)
+{
+    _impl->enable_battery_history(capacity);
+}
+
+void TelemetryExt::battery_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const BatteryHistoryCallback& callback) const
+{
+    _impl->battery_history(from_receive_time_us, to_receive_time_us, callback);
+}
+
+void TelemetryExt::set_rates_async(
+    RateProfile rate_profile, const Telemetry::ResultCallback callback)
+{
+    _impl->set_rates_async(rate_profile, callback);
+}
+
+Telemetry::Result TelemetryExt::set_rates(RateProfile rate_profile) const
+{
+    return _impl->set_rates(rate_profile);
+}
+
+bool operator==(const TelemetryExt::Snapshot& lhs, const TelemetryExt::Snapshot& rhs)
+{
+    return (rhs.position == lhs.position) &&
+           (rhs.home == lhs.home) &&
+           (rhs.velocity_ned == lhs.velocity_ned) &&
+           (rhs.heading == lhs.heading) &&
+           (rhs.position_velocity_ned == lhs.position_velocity_ned) &&
+           (rhs.attitude_quaternion == lhs.attitude_quaternion) &&
+           (rhs.attitude_euler == lhs.attitude_euler) &&
+           (rhs.attitude_angular_velocity_body == lhs.attitude_angular_velocity_body) &&
+           (rhs.camera_attitude_euler == lhs.camera_attitude_euler) &&
+           (rhs.imu == lhs.imu) &&
+           (rhs.scaled_imu == lhs.scaled_imu) &&
+           (rhs.raw_imu == lhs.raw_imu) &&
+           (rhs.gps_info == lhs.gps_info) &&
+           (rhs.raw_gps == lhs.raw_gps) &&
+           (rhs.battery == lhs.battery) &&
+           (rhs.fixedwing_metrics == lhs.fixedwing_metrics) &&
+           (rhs.ground_truth == lhs.ground_truth) &&
+           (rhs.distance_sensor == lhs.distance_sensor) &&
+           (rhs.scaled_pressure == lhs.scaled_pressure) &&
+           (rhs.altitude == lhs.altitude) &&
+           (rhs.health == lhs.health) &&
+           (rhs.rc_status == lhs.rc_status) &&
+           (rhs.landed_state == lhs.landed_state) &&
+           (rhs.vtol_state == lhs.vtol_state) &&
+           (rhs.flight_mode == lhs.flight_mode) &&
+           (rhs.in_air == lhs.in_air) &&
+           (rhs.armed == lhs.armed) &&
+           (rhs.unix_epoch_time_us == lhs.unix_epoch_time_us) &&
+           (rhs.position_receive_time_us == lhs.position_receive_time_us) &&
+           (rhs.home_receive_time_us == lhs.home_receive_time_us) &&
+           (rhs.velocity_ned_receive_time_us == lhs.velocity_ned_receive_time_us) &&
+           (rhs.heading_receive_time_us == lhs.heading_receive_time_us) &&
+           (rhs.position_velocity_ned_receive_time_us ==
+            lhs.position_velocity_ned_receive_time_us) &&
+           (rhs.attitude_quaternion_receive_time_us == lhs.attitude_quaternion_receive_time_us) &&
+           (rhs.attitude_euler_receive_time_us == lhs.attitude_euler_receive_time_us) &&
+           (rhs.attitude_angular_velocity_body_receive_time_us ==
+            lhs.attitude_angular_velocity_body_receive_time_us) &&
+           (rhs.camera_attitude_euler_receive_time_us ==
+            lhs.camera_attitude_euler_receive_time_us) &&
+           (rhs.imu_receive_time_us == lhs.imu_receive_time_us) &&
+           (rhs.scaled_imu_receive_time_us == lhs.scaled_imu_receive_time_us) &&
+           (rhs.raw_imu_receive_time_us == lhs.raw_imu_receive_time_us) &&
+           (rhs.gps_info_receive_time_us == lhs.gps_info_receive_time_us) &&
+           (rhs.raw_gps_receive_time_us == lhs.raw_gps_receive_time_us) &&
+           (rhs.battery_receive_time_us == lhs.battery_receive_time_us) &&
+           (rhs.fixedwing_metrics_receive_time_us == lhs.fixedwing_metrics_receive_time_us) &&
+           (rhs.ground_truth_receive_time_us == lhs.ground_truth_receive_time_us) &&
+           (rhs.distance_sensor_receive_time_us == lhs.distance_sensor_receive_time_us) &&
+           (rhs.scaled_pressure_receive_time_us == lhs.scaled_pressure_receive_time_us) &&
+           (rhs.altitude_receive_time_us == lhs.altitude_receive_time_us) &&
+           (rhs.health_receive_time_us == lhs.health_receive_time_us) &&
+           (rhs.rc_status_receive_time_us == lhs.rc_status_receive_time_us) &&
+           (rhs.landed_state_receive_time_us == lhs.landed_state_receive_time_us) &&
+           (rhs.vtol_state_receive_time_us == lhs.vtol_state_receive_time_us) &&
+           (rhs.flight_mode_receive_time_us == lhs.flight_mode_receive_time_us) &&
+           (rhs.in_air_receive_time_us == lhs.in_air_receive_time_us) &&
+           (rhs.armed_receive_time_us == lhs.armed_receive_time_us) &&
+           (rhs.unix_epoch_time_receive_time_us == lhs.unix_epoch_time_receive_time_us);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExt::Snapshot const& snapshot)
+{
+    str << std::setprecision(15);
+    str << "snapshot:" << '\n' << "{\n";
+    str << "    position: " << snapshot.position << '\n';
+    str << "    home: " << snapshot.home << '\n';
+    str << "    velocity_ned: " << snapshot.velocity_ned << '\n';
+    str << "    heading: " << snapshot.heading << '\n';
+    str << "    position_velocity_ned: " << snapshot.position_velocity_ned << '\n';
+    str << "    attitude_quaternion: " << snapshot.attitude_quaternion << '\n';
+    str << "    attitude_euler: " << snapshot.attitude_euler << '\n';
+    str << "    attitude_angular_velocity_body: " << snapshot.attitude_angular_velocity_body
+        << '\n';
+    str << "    camera_attitude_euler: " << snapshot.camera_attitude_euler << '\n';
+    str << "    imu: " << snapshot.imu << '\n';
+    str << "    scaled_imu: " << snapshot.scaled_imu << '\n';
+    str << "    raw_imu: " << snapshot.raw_imu << '\n';
+    str << "    gps_info: " << snapshot.gps_info << '\n';
+    str << "    raw_gps: " << snapshot.raw_gps << '\n';
+    str << "    battery: " << snapshot.battery << '\n';
+    str << "    fixedwing_metrics: " << snapshot.fixedwing_metrics << '\n';
+    str << "    ground_truth: " << snapshot.ground_truth << '\n';
+    str << "    distance_sensor: " << snapshot.distance_sensor << '\n';
+    str << "    scaled_pressure: " << snapshot.scaled_pressure << '\n';
+    str << "    altitude: " << snapshot.altitude << '\n';
+    str << "    health: " << snapshot.health << '\n';
+    str << "    rc_status: " << snapshot.rc_status << '\n';
+    str << "    landed_state: " << snapshot.landed_state << '\n';
+    str << "    vtol_state: " << snapshot.vtol_state << '\n';
+    str << "    flight_mode: " << snapshot.flight_mode << '\n';
+    str << "    in_air: " << snapshot.in_air << '\n';
+    str << "    armed: " << snapshot.armed << '\n';
+    str << "    unix_epoch_time_us: " << snapshot.unix_epoch_time_us << '\n';
+    str << "    position_receive_time_us: " << snapshot.position_receive_time_us << '\n';
+    str << "    home_receive_time_us: " << snapshot.home_receive_time_us << '\n';
+    str << "    velocity_ned_receive_time_us: " << snapshot.velocity_ned_receive_time_us << '\n';
+    str << "    heading_receive_time_us: " << snapshot.heading_receive_time_us << '\n';
+    str << "    position_velocity_ned_receive_time_us: "
+        << snapshot.position_velocity_ned_receive_time_us << '\n';
+    str << "    attitude_quaternion_receive_time_us: "
+        << snapshot.attitude_quaternion_receive_time_us << '\n';
+    str << "    attitude_euler_receive_time_us: " << snapshot.attitude_euler_receive_time_us
+        << '\n';
+    str << "    attitude_angular_velocity_body_receive_time_us: "
+        << snapshot.attitude_angular_velocity_body_receive_time_us << '\n';
+    str << "    camera_attitude_euler_receive_time_us: "
+        << snapshot.camera_attitude_euler_receive_time_us << '\n';
+    str << "    imu_receive_time_us: " << snapshot.imu_receive_time_us << '\n';
+    str << "    scaled_imu_receive_time_us: " << snapshot.scaled_imu_receive_time_us << '\n';
+    str << "    raw_imu_receive_time_us: " << snapshot.raw_imu_receive_time_us << '\n';
+    str << "    gps_info_receive_time_us: " << snapshot.gps_info_receive_time_us << '\n';
+    str << "    raw_gps_receive_time_us: " << snapshot.raw_gps_receive_time_us << '\n';
+    str << "    battery_receive_time_us: " << snapshot.battery_receive_time_us << '\n';
+    str << "    fixedwing_metrics_receive_time_us: " << snapshot.fixedwing_metrics_receive_time_us
+        << '\n';
+    str << "    ground_truth_receive_time_us: " << snapshot.ground_truth_receive_time_us << '\n';
+    str << "    distance_sensor_receive_time_us: " << snapshot.distance_sensor_receive_time_us
+        << '\n';
+    str << "    scaled_pressure_receive_time_us: " << snapshot.scaled_pressure_receive_time_us
+        << '\n';
+    str << "    altitude_receive_time_us: " << snapshot.altitude_receive_time_us << '\n';
+    str << "    health_receive_time_us: " << snapshot.health_receive_time_us << '\n';
+    str << "    rc_status_receive_time_us: " << snapshot.rc_status_receive_time_us << '\n';
+    str << "    landed_state_receive_time_us: " << snapshot.landed_state_receive_time_us << '\n';
+    str << "    vtol_state_receive_time_us: " << snapshot.vtol_state_receive_time_us << '\n';
+    str << "    flight_mode_receive_time_us: " << snapshot.flight_mode_receive_time_us << '\n';
+    str << "    in_air_receive_time_us: " << snapshot.in_air_receive_time_us << '\n';
+    str << "    armed_receive_time_us: " << snapshot.armed_receive_time_us << '\n';
+    str << "    unix_epoch_time_receive_time_us: " << snapshot.unix_epoch_time_receive_time_us
+        << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(const TelemetryExt::RateProfile& lhs, const TelemetryExt::RateProfile& rhs)
+{
+    return ((std::isnan(rhs.position_rate_hz) && std::isnan(lhs.position_rate_hz)) ||
+            rhs.position_rate_hz == lhs.position_rate_hz) &&
+           ((std::isnan(rhs.home_rate_hz) && std::isnan(lhs.home_rate_hz)) ||
+            rhs.home_rate_hz == lhs.home_rate_hz) &&
+           ((std::isnan(rhs.landed_state_rate_hz) && std::isnan(lhs.landed_state_rate_hz)) ||
+            rhs.landed_state_rate_hz == lhs.landed_state_rate_hz) &&
+           ((std::isnan(rhs.attitude_quaternion_rate_hz) &&
+             std::isnan(lhs.attitude_quaternion_rate_hz)) ||
+            rhs.attitude_quaternion_rate_hz == lhs.attitude_quaternion_rate_hz) &&
+           ((std::isnan(rhs.attitude_euler_rate_hz) && std::isnan(lhs.attitude_euler_rate_hz)) ||
+            rhs.attitude_euler_rate_hz == lhs.attitude_euler_rate_hz) &&
+           ((std::isnan(rhs.camera_attitude_rate_hz) && std::isnan(lhs.camera_attitude_rate_hz)) ||
+            rhs.camera_attitude_rate_hz == lhs.camera_attitude_rate_hz) &&
+           ((std::isnan(rhs.velocity_ned_rate_hz) && std::isnan(lhs.velocity_ned_rate_hz)) ||
+            rhs.velocity_ned_rate_hz == lhs.velocity_ned_rate_hz) &&
+           ((std::isnan(rhs.gps_info_rate_hz) && std::isnan(lhs.gps_info_rate_hz)) ||
+            rhs.gps_info_rate_hz == lhs.gps_info_rate_hz) &&
+           ((std::isnan(rhs.battery_rate_hz) && std::isnan(lhs.battery_rate_hz)) ||
+            rhs.battery_rate_hz == lhs.battery_rate_hz) &&
+           ((std::isnan(rhs.actuator_control_target_rate_hz) &&
+             std::isnan(lhs.actuator_control_target_rate_hz)) ||
+            rhs.actuator_control_target_rate_hz == lhs.actuator_control_target_rate_hz) &&
+           ((std::isnan(rhs.actuator_output_status_rate_hz) &&
+             std::isnan(lhs.actuator_output_status_rate_hz)) ||
+            rhs.actuator_output_status_rate_hz == lhs.actuator_output_status_rate_hz) &&
+           ((std::isnan(rhs.odometry_rate_hz) && std::isnan(lhs.odometry_rate_hz)) ||
+            rhs.odometry_rate_hz == lhs.odometry_rate_hz) &&
+           ((std::isnan(rhs.position_velocity_ned_rate_hz) &&
+             std::isnan(lhs.position_velocity_ned_rate_hz)) ||
+            rhs.position_velocity_ned_rate_hz == lhs.position_velocity_ned_rate_hz) &&
+           ((std::isnan(rhs.ground_truth_rate_hz) && std::isnan(lhs.ground_truth_rate_hz)) ||
+            rhs.ground_truth_rate_hz == lhs.ground_truth_rate_hz) &&
+           ((std::isnan(rhs.fixedwing_metrics_rate_hz) &&
+             std::isnan(lhs.fixedwing_metrics_rate_hz)) ||
+            rhs.fixedwing_metrics_rate_hz == lhs.fixedwing_metrics_rate_hz) &&
+           ((std::isnan(rhs.imu_rate_hz) && std::isnan(lhs.imu_rate_hz)) ||
+            rhs.imu_rate_hz == lhs.imu_rate_hz) &&
+           ((std::isnan(rhs.scaled_imu_rate_hz) && std::isnan(lhs.scaled_imu_rate_hz)) ||
+            rhs.scaled_imu_rate_hz == lhs.scaled_imu_rate_hz) &&
+           ((std::isnan(rhs.raw_imu_rate_hz) && std::isnan(lhs.raw_imu_rate_hz)) ||
+            rhs.raw_imu_rate_hz == lhs.raw_imu_rate_hz) &&
+           ((std::isnan(rhs.unix_epoch_time_rate_hz) && std::isnan(lhs.unix_epoch_time_rate_hz)) ||
+            rhs.unix_epoch_time_rate_hz == lhs.unix_epoch_time_rate_hz) &&
+           ((std::isnan(rhs.distance_sensor_rate_hz) && std::isnan(lhs.distance_sensor_rate_hz)) ||
+            rhs.distance_sensor_rate_hz == lhs.distance_sensor_rate_hz) &&
+           ((std::isnan(rhs.scaled_pressure_rate_hz) && std::isnan(lhs.scaled_pressure_rate_hz)) ||
+            rhs.scaled_pressure_rate_hz == lhs.scaled_pressure_rate_hz) &&
+           ((std::isnan(rhs.altitude_rate_hz) && std::isnan(lhs.altitude_rate_hz)) ||
+            rhs.altitude_rate_hz == lhs.altitude_rate_hz);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExt::RateProfile const& rate_profile)
+{
+    str << std::setprecision(15);
+    str << "rate_profile:" << '\n' << "{\n";
+    str << "    position_rate_hz: " << rate_profile.position_rate_hz << '\n';
+    str << "    home_rate_hz: " << rate_profile.home_rate_hz << '\n';
+    str << "    landed_state_rate_hz: " << rate_profile.landed_state_rate_hz << '\n';
+    str << "    attitude_quaternion_rate_hz: " << rate_profile.attitude_quaternion_rate_hz << '\n';
+    str << "    attitude_euler_rate_hz: " << rate_profile.attitude_euler_rate_hz << '\n';
+    str << "    camera_attitude_rate_hz: " << rate_profile.camera_attitude_rate_hz << '\n';
+    str << "    velocity_ned_rate_hz: " << rate_profile.velocity_ned_rate_hz << '\n';
+    str << "    gps_info_rate_hz: " << rate_profile.gps_info_rate_hz << '\n';
+    str << "    battery_rate_hz: " << rate_profile.battery_rate_hz << '\n';
+    str << "    actuator_control_target_rate_hz: " << rate_profile.actuator_control_target_rate_hz
+        << '\n';
+    str << "    actuator_output_status_rate_hz: " << rate_profile.actuator_output_status_rate_hz
+        << '\n';
+    str << "    odometry_rate_hz: " << rate_profile.odometry_rate_hz << '\n';
+    str << "    position_velocity_ned_rate_hz: " << rate_profile.position_velocity_ned_rate_hz
+        << '\n';
+    str << "    ground_truth_rate_hz: " << rate_profile.ground_truth_rate_hz << '\n';
+    str << "    fixedwing_metrics_rate_hz: " << rate_profile.fixedwing_metrics_rate_hz << '\n';
+    str << "    imu_rate_hz: " << rate_profile.imu_rate_hz << '\n';
+    str << "    scaled_imu_rate_hz: " << rate_profile.scaled_imu_rate_hz << '\n';
+    str << "    raw_imu_rate_hz: " << rate_profile.raw_imu_rate_hz << '\n';
+    str << "    unix_epoch_time_rate_hz: " << rate_profile.unix_epoch_time_rate_hz << '\n';
+    str << "    distance_sensor_rate_hz: " << rate_profile.distance_sensor_rate_hz << '\n';
+    str << "    scaled_pressure_rate_hz: " << rate_profile.scaled_pressure_rate_hz << '\n';
+    str << "    altitude_rate_hz: " << rate_profile.altitude_rate_hz << '\n';
+    str << '}';
+    return str;
+}
+
+} // namespace mavsdk
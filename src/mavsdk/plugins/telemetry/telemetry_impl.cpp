@@ -4,11 +4,15 @@
 #include "mavsdk_math.h"
 #include "callback_list.tpp"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <future>
 #include <string>
 #include <array>
+#include <vector>
 #include <cassert>
+#include <chrono>
 #include <unused.h>
 
 namespace mavsdk {
@@ -44,18 +48,27 @@ template class CallbackList<Telemetry::Altitude>;
 TelemetryImpl::TelemetryImpl(System& system) : PluginImplBase(system)
 {
     _system_impl->register_plugin(this);
+    _system_impl->register_shared_plugin_impl("telemetry", this);
 }
 
 TelemetryImpl::TelemetryImpl(std::shared_ptr<System> system) : PluginImplBase(std::move(system))
 {
     _system_impl->register_plugin(this);
+    _system_impl->register_shared_plugin_impl("telemetry", this);
 }
 
 TelemetryImpl::~TelemetryImpl()
 {
+    _system_impl->unregister_shared_plugin_impl("telemetry", this);
     _system_impl->unregister_plugin(this);
 }
 
+TelemetryImpl* TelemetryImpl::shared_impl(System& system)
+{
+    // Only TelemetryImpl registers under this name, so the downcast is safe.
+    return static_cast<TelemetryImpl*>(system_impl_of(system)->shared_plugin_impl("telemetry"));
+}
+
 void TelemetryImpl::init()
 {
     _system_impl->register_mavlink_message_handler(
@@ -233,6 +246,19 @@ void TelemetryImpl::enable()
     // We're going to retry until we have the Home Position.
     _system_impl->add_call_every(
         [this]() { request_home_position_again(); }, 2.0f, &_homepos_cookie);
+
+    std::optional<TelemetryExt::RateProfile> rate_profile;
+    {
+        std::lock_guard<std::mutex> lock(_rate_profile_mutex);
+        rate_profile = _rate_profile;
+    }
+    if (rate_profile) {
+        apply_rate_profile(rate_profile.value(), [](Telemetry::Result result) {
+            if (result != Telemetry::Result::Success) {
+                LogWarn() << "Setting rates again after reconnect failed: " << result;
+            }
+        });
+    }
 }
 
 void TelemetryImpl::disable()
@@ -243,12 +269,9 @@ void TelemetryImpl::disable()
 
 void TelemetryImpl::request_home_position_again()
 {
-    {
-        std::lock_guard<std::mutex> lock(_request_home_position_mutex);
-        if (_health.is_home_position_ok) {
-            _system_impl->remove_call_every(_homepos_cookie);
-            return;
-        }
+    if (_health.load().is_home_position_ok) {
+        _system_impl->remove_call_every(_homepos_cookie);
+        return;
     }
     request_home_position_async();
 }
@@ -661,6 +684,79 @@ void TelemetryImpl::set_rate_scaled_pressure_async(
         });
 }
 
+void TelemetryImpl::set_rates_async(
+    const TelemetryExt::RateProfile& rate_profile, const Telemetry::ResultCallback& callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(_rate_profile_mutex);
+        _rate_profile = rate_profile;
+    }
+
+    apply_rate_profile(rate_profile, callback);
+}
+
+Telemetry::Result TelemetryImpl::set_rates(const TelemetryExt::RateProfile& rate_profile)
+{
+    auto prom = std::promise<Telemetry::Result>();
+    auto fut = prom.get_future();
+
+    set_rates_async(rate_profile, [&prom](Telemetry::Result result) { prom.set_value(result); });
+    return fut.get();
+}
+
+void TelemetryImpl::apply_rate_profile(
+    const TelemetryExt::RateProfile& rate_profile, const Telemetry::ResultCallback& callback)
+{
+    std::vector<std::pair<uint16_t, double>> message_rates;
+
+    auto add_rate = [&message_rates](uint16_t message_id, double rate_hz) {
+        if (!std::isnan(rate_hz)) {
+            message_rates.emplace_back(message_id, rate_hz);
+        }
+    };
+
+    // Position and velocity come from the same message, see set_rate_position.
+    if (!std::isnan(rate_profile.position_rate_hz) ||
+        !std::isnan(rate_profile.velocity_ned_rate_hz)) {
+        if (!std::isnan(rate_profile.position_rate_hz)) {
+            _position_rate_hz = rate_profile.position_rate_hz;
+        }
+        if (!std::isnan(rate_profile.velocity_ned_rate_hz)) {
+            _velocity_ned_rate_hz = rate_profile.velocity_ned_rate_hz;
+        }
+        add_rate(
+            MAVLINK_MSG_ID_GLOBAL_POSITION_INT, std::max(_position_rate_hz, _velocity_ned_rate_hz));
+    }
+
+    add_rate(MAVLINK_MSG_ID_HOME_POSITION, rate_profile.home_rate_hz);
+    add_rate(MAVLINK_MSG_ID_EXTENDED_SYS_STATE, rate_profile.landed_state_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ATTITUDE_QUATERNION, rate_profile.attitude_quaternion_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ATTITUDE, rate_profile.attitude_euler_rate_hz);
+    add_rate(MAVLINK_MSG_ID_MOUNT_ORIENTATION, rate_profile.camera_attitude_rate_hz);
+    add_rate(MAVLINK_MSG_ID_GPS_RAW_INT, rate_profile.gps_info_rate_hz);
+    add_rate(MAVLINK_MSG_ID_BATTERY_STATUS, rate_profile.battery_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET, rate_profile.actuator_control_target_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS, rate_profile.actuator_output_status_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ODOMETRY, rate_profile.odometry_rate_hz);
+    add_rate(MAVLINK_MSG_ID_LOCAL_POSITION_NED, rate_profile.position_velocity_ned_rate_hz);
+    add_rate(MAVLINK_MSG_ID_HIL_STATE_QUATERNION, rate_profile.ground_truth_rate_hz);
+    add_rate(MAVLINK_MSG_ID_VFR_HUD, rate_profile.fixedwing_metrics_rate_hz);
+    add_rate(MAVLINK_MSG_ID_HIGHRES_IMU, rate_profile.imu_rate_hz);
+    add_rate(MAVLINK_MSG_ID_SCALED_IMU, rate_profile.scaled_imu_rate_hz);
+    add_rate(MAVLINK_MSG_ID_RAW_IMU, rate_profile.raw_imu_rate_hz);
+    add_rate(MAVLINK_MSG_ID_UTM_GLOBAL_POSITION, rate_profile.unix_epoch_time_rate_hz);
+    add_rate(MAVLINK_MSG_ID_DISTANCE_SENSOR, rate_profile.distance_sensor_rate_hz);
+    add_rate(MAVLINK_MSG_ID_SCALED_PRESSURE, rate_profile.scaled_pressure_rate_hz);
+    add_rate(MAVLINK_MSG_ID_ALTITUDE, rate_profile.altitude_rate_hz);
+
+    _system_impl->set_msg_rates_async(
+        message_rates, [callback](MavlinkCommandSender::Result command_result) {
+            if (callback) {
+                command_result_callback(command_result, callback);
+            }
+        });
+}
+
 Telemetry::Result
 TelemetryImpl::telemetry_result_from_command_result(MavlinkCommandSender::Result command_result)
 {
@@ -699,6 +795,39 @@ void TelemetryImpl::process_position_velocity_ned(const mavlink_message_t& messa
     mavlink_local_position_ned_t local_position;
     mavlink_msg_local_position_ned_decode(&message, &local_position);
 
+    set_health_local_position(true);
+    update_snapshot_health();
+
+    const bool decode_now = !_position_velocity_ned_subscriptions.empty();
+    receive_lazily(
+        _local_position_ned, local_position, decode_now, &TelemetryImpl::decode_local_position_ned);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _position_velocity_ned_subscriptions.queue(position_velocity_ned(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
+}
+
+void TelemetryImpl::decode_local_position_ned(
+    const mavlink_local_position_ned_t& local_position, uint64_t receive_time_us)
+{
+    const auto position_velocity = to_position_velocity_ned(local_position);
+
+    set_position_velocity_ned(position_velocity);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.position_velocity_ned = position_velocity;
+        snapshot.position_velocity_ned_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::PositionVelocityNed
+TelemetryImpl::to_position_velocity_ned(const mavlink_local_position_ned_t& local_position)
+{
     Telemetry::PositionVelocityNed position_velocity;
     position_velocity.position.north_m = local_position.x;
     position_velocity.position.east_m = local_position.y;
@@ -706,15 +835,7 @@ void TelemetryImpl::process_position_velocity_ned(const mavlink_message_t& messa
     position_velocity.velocity.north_m_s = local_position.vx;
     position_velocity.velocity.east_m_s = local_position.vy;
     position_velocity.velocity.down_m_s = local_position.vz;
-
-    set_position_velocity_ned(position_velocity);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _position_velocity_ned_subscriptions.queue(position_velocity_ned(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
-    });
-
-    set_health_local_position(true);
+    return position_velocity;
 }
 
 void TelemetryImpl::process_global_position_int(const mavlink_message_t& message)
@@ -722,40 +843,82 @@ void TelemetryImpl::process_global_position_int(const mavlink_message_t& message
     mavlink_global_position_int_t global_position_int;
     mavlink_msg_global_position_int_decode(&message, &global_position_int);
 
-    {
-        Telemetry::Position position;
-        position.latitude_deg = global_position_int.lat * 1e-7;
-        position.longitude_deg = global_position_int.lon * 1e-7;
-        position.absolute_altitude_m = global_position_int.alt * 1e-3f;
-        position.relative_altitude_m = global_position_int.relative_alt * 1e-3f;
-        set_position(position);
-    }
-
-    {
-        Telemetry::VelocityNed velocity;
-        velocity.north_m_s = global_position_int.vx * 1e-2f;
-        velocity.east_m_s = global_position_int.vy * 1e-2f;
-        velocity.down_m_s = global_position_int.vz * 1e-2f;
-        set_velocity_ned(velocity);
-    }
-
-    {
-        Telemetry::Heading heading;
-        heading.heading_deg = (global_position_int.hdg != std::numeric_limits<uint16_t>::max()) ?
-                                  static_cast<double>(global_position_int.hdg) * 1e-2 :
-                                  static_cast<double>(NAN);
-        set_heading(heading);
+    const bool decode_now = !_position_subscriptions.empty() ||
+                            !_velocity_ned_subscriptions.empty() ||
+                            !_heading_subscriptions.empty() ||
+                            _position_history_enabled;
+    receive_lazily(
+        _global_position_int,
+        global_position_int,
+        decode_now,
+        &TelemetryImpl::decode_global_position_int);
+
+    if (!decode_now) {
+        return;
     }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _position_subscriptions.queue(
-        position(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        position(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
     _velocity_ned_subscriptions.queue(
-        velocity_ned(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        velocity_ned(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
     _heading_subscriptions.queue(
-        heading(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        heading(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_global_position_int(
+    const mavlink_global_position_int_t& global_position_int, uint64_t receive_time_us)
+{
+    const auto position = to_position(global_position_int);
+    set_position(position, receive_time_us);
+
+    const auto velocity = to_velocity_ned(global_position_int);
+    set_velocity_ned(velocity);
+
+    const auto heading = to_heading(global_position_int);
+    set_heading(heading);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.position = position;
+        snapshot.position_receive_time_us = receive_time_us;
+        snapshot.velocity_ned = velocity;
+        snapshot.velocity_ned_receive_time_us = receive_time_us;
+        snapshot.heading = heading;
+        snapshot.heading_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::Position
+TelemetryImpl::to_position(const mavlink_global_position_int_t& global_position_int)
+{
+    Telemetry::Position position;
+    position.latitude_deg = global_position_int.lat * 1e-7;
+    position.longitude_deg = global_position_int.lon * 1e-7;
+    position.absolute_altitude_m = global_position_int.alt * 1e-3f;
+    position.relative_altitude_m = global_position_int.relative_alt * 1e-3f;
+    return position;
+}
+
+Telemetry::VelocityNed
+TelemetryImpl::to_velocity_ned(const mavlink_global_position_int_t& global_position_int)
+{
+    Telemetry::VelocityNed velocity;
+    velocity.north_m_s = global_position_int.vx * 1e-2f;
+    velocity.east_m_s = global_position_int.vy * 1e-2f;
+    velocity.down_m_s = global_position_int.vz * 1e-2f;
+    return velocity;
+}
+
+Telemetry::Heading
+TelemetryImpl::to_heading(const mavlink_global_position_int_t& global_position_int)
+{
+    Telemetry::Heading heading;
+    heading.heading_deg = (global_position_int.hdg != std::numeric_limits<uint16_t>::max()) ?
+                              static_cast<double>(global_position_int.hdg) * 1e-2 :
+                              static_cast<double>(NAN);
+    return heading;
 }
 
 void TelemetryImpl::process_home_position(const mavlink_message_t& message)
@@ -772,9 +935,17 @@ void TelemetryImpl::process_home_position(const mavlink_message_t& message)
 
     set_health_home_position(true);
 
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.home = new_pos;
+        snapshot.home_receive_time_us = receive_time_us;
+        snapshot.health = _health.load();
+        snapshot.health_receive_time_us = receive_time_us;
+    });
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _home_position_subscriptions.queue(
-        home(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        home(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_attitude(const mavlink_message_t& message)
@@ -782,32 +953,122 @@ void TelemetryImpl::process_attitude(const mavlink_message_t& message)
     mavlink_attitude_t attitude;
     mavlink_msg_attitude_decode(&message, &attitude);
 
+    const bool decode_now = !_attitude_euler_angle_subscriptions.empty() ||
+                            !_attitude_angular_velocity_body_subscriptions.empty() ||
+                            _attitude_euler_history_enabled;
+    receive_lazily(_attitude, attitude, decode_now, &TelemetryImpl::decode_attitude);
+
+    if (!decode_now) {
+        return;
+    }
+
+    _attitude_euler_angle_subscriptions.queue(attitude_euler(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
+
+    _attitude_angular_velocity_body_subscriptions.queue(
+        attitude_angular_velocity_body(),
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_attitude(const mavlink_attitude_t& attitude, uint64_t receive_time_us)
+{
+    const auto euler_angle = to_euler_angle(attitude);
+    set_attitude_euler(euler_angle, receive_time_us);
+
+    const auto angular_velocity_body = to_angular_velocity_body(attitude);
+
+    std::lock_guard<std::mutex> lock(_attitude_angular_velocity_body_mutex);
+    const bool newest = newest_attitude_angular_velocity_body(_attitude.sequence());
+    if (newest) {
+        set_attitude_angular_velocity_body(angular_velocity_body);
+    }
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.attitude_euler = euler_angle;
+        snapshot.attitude_euler_receive_time_us = receive_time_us;
+        if (newest) {
+            snapshot.attitude_angular_velocity_body = angular_velocity_body;
+            snapshot.attitude_angular_velocity_body_receive_time_us = receive_time_us;
+        }
+    });
+}
+
+Telemetry::EulerAngle TelemetryImpl::to_euler_angle(const mavlink_attitude_t& attitude)
+{
     Telemetry::EulerAngle euler_angle;
     euler_angle.roll_deg = to_deg_from_rad(attitude.roll);
     euler_angle.pitch_deg = to_deg_from_rad(attitude.pitch);
     euler_angle.yaw_deg = to_deg_from_rad(attitude.yaw);
     euler_angle.timestamp_us = static_cast<uint64_t>(attitude.time_boot_ms) * 1000;
-    set_attitude_euler(euler_angle);
+    return euler_angle;
+}
 
+Telemetry::AngularVelocityBody
+TelemetryImpl::to_angular_velocity_body(const mavlink_attitude_t& attitude)
+{
     Telemetry::AngularVelocityBody angular_velocity_body;
     angular_velocity_body.roll_rad_s = attitude.rollspeed;
     angular_velocity_body.pitch_rad_s = attitude.pitchspeed;
     angular_velocity_body.yaw_rad_s = attitude.yawspeed;
-    set_attitude_angular_velocity_body(angular_velocity_body);
+    return angular_velocity_body;
+}
+
+void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message)
+{
+    mavlink_attitude_quaternion_t mavlink_attitude_quaternion;
+    mavlink_msg_attitude_quaternion_decode(&message, &mavlink_attitude_quaternion);
+
+    const bool decode_now = !_attitude_quaternion_angle_subscriptions.empty() ||
+                            !_attitude_angular_velocity_body_subscriptions.empty();
+    receive_lazily(
+        _attitude_quaternion_payload,
+        mavlink_attitude_quaternion,
+        decode_now,
+        &TelemetryImpl::decode_attitude_quaternion);
 
-    _attitude_euler_angle_subscriptions.queue(
-        attitude_euler(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _attitude_quaternion_angle_subscriptions.queue(attitude_quaternion(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 
     _attitude_angular_velocity_body_subscriptions.queue(
         attitude_angular_velocity_body(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
-void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message)
+void TelemetryImpl::decode_attitude_quaternion(
+    const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion, uint64_t receive_time_us)
 {
-    mavlink_attitude_quaternion_t mavlink_attitude_quaternion;
-    mavlink_msg_attitude_quaternion_decode(&message, &mavlink_attitude_quaternion);
+    const auto quaternion = to_quaternion(mavlink_attitude_quaternion);
+    const auto angular_velocity_body = to_angular_velocity_body(mavlink_attitude_quaternion);
+
+    set_attitude_quaternion(quaternion);
+
+    std::lock_guard<std::mutex> lock(_attitude_angular_velocity_body_mutex);
+    const bool newest =
+        newest_attitude_angular_velocity_body(_attitude_quaternion_payload.sequence());
+    if (newest) {
+        set_attitude_angular_velocity_body(angular_velocity_body);
+    }
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.attitude_quaternion = quaternion;
+        snapshot.attitude_quaternion_receive_time_us = receive_time_us;
+        if (newest) {
+            snapshot.attitude_angular_velocity_body = angular_velocity_body;
+            snapshot.attitude_angular_velocity_body_receive_time_us = receive_time_us;
+        }
+    });
+}
 
+Telemetry::Quaternion
+TelemetryImpl::to_quaternion(const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion)
+{
     Telemetry::Quaternion quaternion;
     quaternion.w = mavlink_attitude_quaternion.q1;
     quaternion.x = mavlink_attitude_quaternion.q2;
@@ -815,31 +1076,52 @@ void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message
     quaternion.z = mavlink_attitude_quaternion.q4;
     quaternion.timestamp_us =
         static_cast<uint64_t>(mavlink_attitude_quaternion.time_boot_ms) * 1000;
+    return quaternion;
+}
 
+Telemetry::AngularVelocityBody TelemetryImpl::to_angular_velocity_body(
+    const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion)
+{
     Telemetry::AngularVelocityBody angular_velocity_body;
     angular_velocity_body.roll_rad_s = mavlink_attitude_quaternion.rollspeed;
     angular_velocity_body.pitch_rad_s = mavlink_attitude_quaternion.pitchspeed;
     angular_velocity_body.yaw_rad_s = mavlink_attitude_quaternion.yawspeed;
+    return angular_velocity_body;
+}
 
-    set_attitude_quaternion(quaternion);
+void TelemetryImpl::process_altitude(const mavlink_message_t& message)
+{
+    mavlink_altitude_t mavlink_altitude;
+    mavlink_msg_altitude_decode(&message, &mavlink_altitude);
 
-    set_attitude_angular_velocity_body(angular_velocity_body);
+    const bool decode_now = !_altitude_subscriptions.empty();
+    receive_lazily(
+        _altitude_payload, mavlink_altitude, decode_now, &TelemetryImpl::decode_altitude);
 
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _attitude_quaternion_angle_subscriptions.queue(attitude_quaternion(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
-    });
+    if (!decode_now) {
+        return;
+    }
 
-    _attitude_angular_velocity_body_subscriptions.queue(
-        attitude_angular_velocity_body(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _altitude_subscriptions.queue(
+        altitude(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
-void TelemetryImpl::process_altitude(const mavlink_message_t& message)
+void TelemetryImpl::decode_altitude(
+    const mavlink_altitude_t& mavlink_altitude, uint64_t receive_time_us)
 {
-    mavlink_altitude_t mavlink_altitude;
-    mavlink_msg_altitude_decode(&message, &mavlink_altitude);
+    const auto new_altitude = to_altitude(mavlink_altitude);
+
+    set_altitude(new_altitude);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.altitude = new_altitude;
+        snapshot.altitude_receive_time_us = receive_time_us;
+    });
+}
 
+Telemetry::Altitude TelemetryImpl::to_altitude(const mavlink_altitude_t& mavlink_altitude)
+{
     Telemetry::Altitude new_altitude;
     new_altitude.altitude_monotonic_m = mavlink_altitude.altitude_monotonic;
     new_altitude.altitude_amsl_m = mavlink_altitude.altitude_amsl;
@@ -847,12 +1129,7 @@ void TelemetryImpl::process_altitude(const mavlink_message_t& message)
     new_altitude.altitude_relative_m = mavlink_altitude.altitude_relative;
     new_altitude.altitude_terrain_m = mavlink_altitude.altitude_terrain;
     new_altitude.bottom_clearance_m = mavlink_altitude.bottom_clearance;
-
-    set_altitude(new_altitude);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _altitude_subscriptions.queue(
-        altitude(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_altitude;
 }
 
 void TelemetryImpl::process_mount_orientation(const mavlink_message_t& message)
@@ -867,15 +1144,16 @@ void TelemetryImpl::process_mount_orientation(const mavlink_message_t& message)
     euler_angle.yaw_deg = mount_orientation.yaw_absolute;
 
     set_camera_attitude_euler_angle(euler_angle);
+    update_snapshot_camera_attitude(euler_angle);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _camera_attitude_quaternion_subscriptions.queue(
         camera_attitude_quaternion(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
     _camera_attitude_euler_angle_subscriptions.queue(
         camera_attitude_euler(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_gimbal_device_attitude_status(const mavlink_message_t& message)
@@ -901,21 +1179,50 @@ void TelemetryImpl::process_gimbal_device_attitude_status(const mavlink_message_
     telemetry_euler_angle.yaw_deg = euler_angle.yaw_deg;
 
     set_camera_attitude_euler_angle(telemetry_euler_angle);
+    update_snapshot_camera_attitude(telemetry_euler_angle);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _camera_attitude_quaternion_subscriptions.queue(
         camera_attitude_quaternion(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
     _camera_attitude_euler_angle_subscriptions.queue(
         camera_attitude_euler(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
 {
     mavlink_highres_imu_t highres_imu;
     mavlink_msg_highres_imu_decode(&message, &highres_imu);
+
+    const bool decode_now = !_imu_reading_ned_subscriptions.empty();
+    receive_lazily(_highres_imu, highres_imu, decode_now, &TelemetryImpl::decode_highres_imu);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _imu_reading_ned_subscriptions.queue(
+        imu(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_highres_imu(
+    const mavlink_highres_imu_t& highres_imu, uint64_t receive_time_us)
+{
+    const auto new_imu = to_imu(highres_imu);
+
+    set_imu_reading_ned(new_imu);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.imu = new_imu;
+        snapshot.imu_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::Imu TelemetryImpl::to_imu(const mavlink_highres_imu_t& highres_imu)
+{
     Telemetry::Imu new_imu;
     new_imu.acceleration_frd.forward_m_s2 = highres_imu.xacc;
     new_imu.acceleration_frd.right_m_s2 = highres_imu.yacc;
@@ -928,18 +1235,42 @@ void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
     new_imu.magnetic_field_frd.down_gauss = highres_imu.zmag;
     new_imu.temperature_degc = highres_imu.temperature;
     new_imu.timestamp_us = highres_imu.time_usec;
-
-    set_imu_reading_ned(new_imu);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _imu_reading_ned_subscriptions.queue(
-        imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
 {
     mavlink_scaled_imu_t scaled_imu_reading;
     mavlink_msg_scaled_imu_decode(&message, &scaled_imu_reading);
+
+    const bool decode_now = !_scaled_imu_subscriptions.empty();
+    receive_lazily(
+        _scaled_imu_payload, scaled_imu_reading, decode_now, &TelemetryImpl::decode_scaled_imu);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _scaled_imu_subscriptions.queue(
+        scaled_imu(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_scaled_imu(
+    const mavlink_scaled_imu_t& scaled_imu_reading, uint64_t receive_time_us)
+{
+    const auto new_imu = to_imu(scaled_imu_reading);
+
+    set_scaled_imu(new_imu);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.scaled_imu = new_imu;
+        snapshot.scaled_imu_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::Imu TelemetryImpl::to_imu(const mavlink_scaled_imu_t& scaled_imu_reading)
+{
     Telemetry::Imu new_imu;
     new_imu.acceleration_frd.forward_m_s2 = scaled_imu_reading.xacc;
     new_imu.acceleration_frd.right_m_s2 = scaled_imu_reading.yacc;
@@ -952,18 +1283,41 @@ void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
     new_imu.magnetic_field_frd.down_gauss = scaled_imu_reading.zmag;
     new_imu.temperature_degc = static_cast<float>(scaled_imu_reading.temperature) * 1e-2f;
     new_imu.timestamp_us = static_cast<uint64_t>(scaled_imu_reading.time_boot_ms) * 1000;
-
-    set_scaled_imu(new_imu);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _scaled_imu_subscriptions.queue(
-        scaled_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
 {
     mavlink_raw_imu_t raw_imu_reading;
     mavlink_msg_raw_imu_decode(&message, &raw_imu_reading);
+
+    const bool decode_now = !_raw_imu_subscriptions.empty();
+    receive_lazily(_raw_imu_payload, raw_imu_reading, decode_now, &TelemetryImpl::decode_raw_imu);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _raw_imu_subscriptions.queue(
+        raw_imu(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_raw_imu(
+    const mavlink_raw_imu_t& raw_imu_reading, uint64_t receive_time_us)
+{
+    const auto new_imu = to_imu(raw_imu_reading);
+
+    set_raw_imu(new_imu);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.raw_imu = new_imu;
+        snapshot.raw_imu_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::Imu TelemetryImpl::to_imu(const mavlink_raw_imu_t& raw_imu_reading)
+{
     Telemetry::Imu new_imu;
     new_imu.acceleration_frd.forward_m_s2 = raw_imu_reading.xacc;
     new_imu.acceleration_frd.right_m_s2 = raw_imu_reading.yacc;
@@ -976,12 +1330,7 @@ void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
     new_imu.magnetic_field_frd.down_gauss = raw_imu_reading.zmag;
     new_imu.temperature_degc = static_cast<float>(raw_imu_reading.temperature) * 1e-2f;
     new_imu.timestamp_us = raw_imu_reading.time_usec;
-
-    set_raw_imu(new_imu);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _raw_imu_subscriptions.queue(
-        raw_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_imu;
 }
 
 void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
@@ -1048,12 +1397,22 @@ void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
         set_health_global_position(gps_ok);
     }
 
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.gps_info = new_gps_info;
+        snapshot.gps_info_receive_time_us = receive_time_us;
+        snapshot.raw_gps = raw_gps_info;
+        snapshot.raw_gps_receive_time_us = receive_time_us;
+        snapshot.health = _health.load();
+        snapshot.health_receive_time_us = receive_time_us;
+    });
+
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
         _gps_info_subscriptions.queue(
-            gps_info(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            gps_info(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
         _raw_gps_subscriptions.queue(
-            raw_gps(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            raw_gps(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
     }
 
     _system_impl->refresh_timeout_handler(_gps_raw_timeout_cookie);
@@ -1064,16 +1423,43 @@ void TelemetryImpl::process_ground_truth(const mavlink_message_t& message)
     mavlink_hil_state_quaternion_t hil_state_quaternion;
     mavlink_msg_hil_state_quaternion_decode(&message, &hil_state_quaternion);
 
-    Telemetry::GroundTruth new_ground_truth;
-    new_ground_truth.latitude_deg = hil_state_quaternion.lat * 1e-7;
-    new_ground_truth.longitude_deg = hil_state_quaternion.lon * 1e-7;
-    new_ground_truth.absolute_altitude_m = hil_state_quaternion.alt * 1e-3f;
+    const bool decode_now = !_ground_truth_subscriptions.empty();
+    receive_lazily(
+        _hil_state_quaternion,
+        hil_state_quaternion,
+        decode_now,
+        &TelemetryImpl::decode_hil_state_quaternion);
 
-    set_ground_truth(new_ground_truth);
+    if (!decode_now) {
+        return;
+    }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _ground_truth_subscriptions.queue(
-        ground_truth(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        ground_truth(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+}
+
+void TelemetryImpl::decode_hil_state_quaternion(
+    const mavlink_hil_state_quaternion_t& hil_state_quaternion, uint64_t receive_time_us)
+{
+    const auto new_ground_truth = to_ground_truth(hil_state_quaternion);
+
+    set_ground_truth(new_ground_truth);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.ground_truth = new_ground_truth;
+        snapshot.ground_truth_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::GroundTruth
+TelemetryImpl::to_ground_truth(const mavlink_hil_state_quaternion_t& hil_state_quaternion)
+{
+    Telemetry::GroundTruth new_ground_truth;
+    new_ground_truth.latitude_deg = hil_state_quaternion.lat * 1e-7;
+    new_ground_truth.longitude_deg = hil_state_quaternion.lon * 1e-7;
+    new_ground_truth.absolute_altitude_m = hil_state_quaternion.alt * 1e-3f;
+    return new_ground_truth;
 }
 
 void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
@@ -1081,20 +1467,11 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
     mavlink_extended_sys_state_t extended_sys_state;
     mavlink_msg_extended_sys_state_decode(&message, &extended_sys_state);
 
-    {
-        Telemetry::LandedState landed_state = to_landed_state(extended_sys_state);
-        set_landed_state(landed_state);
-
-        Telemetry::VtolState vtol_state = to_vtol_state(extended_sys_state);
-        set_vtol_state(vtol_state);
-    }
+    const Telemetry::LandedState new_landed_state = to_landed_state(extended_sys_state);
+    set_landed_state(new_landed_state);
 
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _landed_state_subscriptions.queue(
-        landed_state(), [this](const auto& func) { _system_impl->call_user_callback(func); });
-
-    _vtol_state_subscriptions.queue(
-        vtol_state(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    const Telemetry::VtolState new_vtol_state = to_vtol_state(extended_sys_state);
+    set_vtol_state(new_vtol_state);
 
     if (extended_sys_state.landed_state == MAV_LANDED_STATE_IN_AIR ||
         extended_sys_state.landed_state == MAV_LANDED_STATE_TAKEOFF ||
@@ -1105,24 +1482,63 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
     }
     // If landed_state is undefined, we use what we have received last.
 
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.landed_state = new_landed_state;
+        snapshot.landed_state_receive_time_us = receive_time_us;
+        snapshot.vtol_state = new_vtol_state;
+        snapshot.vtol_state_receive_time_us = receive_time_us;
+        snapshot.in_air = _in_air;
+        snapshot.in_air_receive_time_us = receive_time_us;
+    });
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _landed_state_subscriptions.queue(
+        landed_state(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+
+    _vtol_state_subscriptions.queue(
+        vtol_state(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
+
     _in_air_subscriptions.queue(
-        in_air(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        in_air(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
 {
     mavlink_vfr_hud_t vfr_hud;
     mavlink_msg_vfr_hud_decode(&message, &vfr_hud);
 
+    const bool decode_now = !_fixedwing_metrics_subscriptions.empty();
+    receive_lazily(_vfr_hud, vfr_hud, decode_now, &TelemetryImpl::decode_vfr_hud);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _fixedwing_metrics_subscriptions.queue(fixedwing_metrics(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
+}
+
+void TelemetryImpl::decode_vfr_hud(const mavlink_vfr_hud_t& vfr_hud, uint64_t receive_time_us)
+{
+    const auto new_fixedwing_metrics = to_fixedwing_metrics(vfr_hud);
+
+    set_fixedwing_metrics(new_fixedwing_metrics);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.fixedwing_metrics = new_fixedwing_metrics;
+        snapshot.fixedwing_metrics_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::FixedwingMetrics TelemetryImpl::to_fixedwing_metrics(const mavlink_vfr_hud_t& vfr_hud)
+{
     Telemetry::FixedwingMetrics new_fixedwing_metrics;
     new_fixedwing_metrics.airspeed_m_s = vfr_hud.airspeed;
     new_fixedwing_metrics.throttle_percentage = vfr_hud.throttle * 1e-2f;
     new_fixedwing_metrics.climb_rate_m_s = vfr_hud.climb;
-
-    set_fixedwing_metrics(new_fixedwing_metrics);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _fixedwing_metrics_subscriptions.queue(
-        fixedwing_metrics(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return new_fixedwing_metrics;
 }
 
 void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
@@ -1130,7 +1546,8 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
     mavlink_sys_status_t sys_status;
     mavlink_msg_sys_status_decode(&message, &sys_status);
 
-    if (!_has_bat_status) {
+    const bool battery_from_sys_status = !_has_bat_status;
+    if (battery_from_sys_status) {
         Telemetry::Battery new_battery;
         new_battery.voltage_v = sys_status.voltage_battery * 1e-3f;
         new_battery.remaining_percent = sys_status.battery_remaining;
@@ -1139,8 +1556,9 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
 
         {
             std::lock_guard<std::mutex> lock(_subscription_mutex);
-            _battery_subscriptions.queue(
-                battery(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            _battery_subscriptions.queue(battery(), [this](auto&& func) {
+                _system_impl->call_user_callback(std::move(func));
+            });
         }
     }
 
@@ -1196,14 +1614,28 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
 
     set_rc_status({rc_ok}, std::nullopt);
 
+    const bool armable = sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_PREARM_CHECK;
+    set_health_armable(armable);
+
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        if (battery_from_sys_status) {
+            snapshot.battery = _battery.load();
+            snapshot.battery_receive_time_us = receive_time_us;
+        }
+        snapshot.rc_status = _rc_status.load();
+        snapshot.rc_status_receive_time_us = receive_time_us;
+        snapshot.health = _health.load();
+        snapshot.health_receive_time_us = receive_time_us;
+    });
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _rc_status_subscriptions.queue(
-        rc_status(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        rc_status(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
-    const bool armable = sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_PREARM_CHECK;
-    set_health_armable(armable);
-    _health_all_ok_subscriptions.queue(
-        health_all_ok(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _health_all_ok_subscriptions.queue(health_all_ok(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 }
 
 bool TelemetryImpl::sys_status_present_enabled_health(
@@ -1257,10 +1689,16 @@ void TelemetryImpl::process_battery_status(const mavlink_message_t& message)
 
     set_battery(new_battery);
 
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.battery = new_battery;
+        snapshot.battery_receive_time_us = receive_time_us;
+    });
+
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
         _battery_subscriptions.queue(
-            battery(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            battery(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
     }
 }
 
@@ -1273,21 +1711,34 @@ void TelemetryImpl::process_heartbeat(const mavlink_message_t& message)
     mavlink_heartbeat_t heartbeat;
     mavlink_msg_heartbeat_decode(&message, &heartbeat);
 
-    set_armed(((heartbeat.base_mode & MAV_MODE_FLAG_SAFETY_ARMED) ? true : false));
+    const bool new_armed = (heartbeat.base_mode & MAV_MODE_FLAG_SAFETY_ARMED) != 0;
+    set_armed(new_armed);
+
+    const auto new_flight_mode =
+        telemetry_flight_mode_from_flight_mode(_system_impl->get_flight_mode());
+
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.armed = new_armed;
+        snapshot.armed_receive_time_us = receive_time_us;
+        snapshot.flight_mode = new_flight_mode;
+        snapshot.flight_mode_receive_time_us = receive_time_us;
+    });
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _armed_subscriptions.queue(
-        armed(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        armed(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
-    _flight_mode_subscriptions.queue(
-        telemetry_flight_mode_from_flight_mode(_system_impl->get_flight_mode()),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _flight_mode_subscriptions.queue(new_flight_mode, [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 
     _health_subscriptions.queue(
-        health(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        health(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
-    _health_all_ok_subscriptions.queue(
-        health_all_ok(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _health_all_ok_subscriptions.queue(health_all_ok(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 }
 
 void TelemetryImpl::receive_statustext(const MavlinkStatustextHandler::Statustext& statustext)
@@ -1331,7 +1782,7 @@ void TelemetryImpl::receive_statustext(const MavlinkStatustextHandler::Statustex
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _status_text_subscriptions.queue(
-        status_text(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        status_text(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
@@ -1341,11 +1792,17 @@ void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
 
     if (rc_channels.rssi != std::numeric_limits<uint8_t>::max()) {
         set_rc_status(std::nullopt, {rc_channels.rssi});
+
+        const auto receive_time_us = _system_impl->get_time().elapsed_us();
+        _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+            snapshot.rc_status = _rc_status.load();
+            snapshot.rc_status_receive_time_us = receive_time_us;
+        });
     }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _rc_status_subscriptions.queue(
-        rc_status(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        rc_status(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 
     _system_impl->refresh_timeout_handler(_rc_channels_timeout_cookie);
 }
@@ -1356,10 +1813,12 @@ void TelemetryImpl::process_unix_epoch_time(const mavlink_message_t& message)
     mavlink_msg_utm_global_position_decode(&message, &utm_global_position);
 
     set_unix_epoch_time_us(utm_global_position.time);
+    update_snapshot_unix_epoch_time(utm_global_position.time);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _unix_epoch_time_subscriptions.queue(
-        unix_epoch_time(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _unix_epoch_time_subscriptions.queue(unix_epoch_time(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 
     _system_impl->refresh_timeout_handler(_unix_epoch_timeout_cookie);
 }
@@ -1383,7 +1842,7 @@ void TelemetryImpl::process_actuator_control_target(const mavlink_message_t& mes
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _actuator_control_target_subscriptions.queue(
         actuator_control_target(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& message)
@@ -1403,8 +1862,8 @@ void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& mess
     set_actuator_output_status(active, actuators);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _actuator_output_status_subscriptions.queue(actuator_output_status(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
+    _actuator_output_status_subscriptions.queue(actuator_output_status(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
     });
 }
 
@@ -1455,7 +1914,7 @@ void TelemetryImpl::process_odometry(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _odometry_subscriptions.queue(
-        odometry(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        odometry(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
@@ -1475,9 +1934,16 @@ void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
 
     set_distance_sensor(distance_sensor_struct);
 
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.distance_sensor = distance_sensor_struct;
+        snapshot.distance_sensor_receive_time_us = receive_time_us;
+    });
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _distance_sensor_subscriptions.queue(
-        distance_sensor(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _distance_sensor_subscriptions.queue(distance_sensor(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
 }
 
 Telemetry::EulerAngle
@@ -1695,6 +2161,39 @@ void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
     mavlink_scaled_pressure_t scaled_pressure_msg;
     mavlink_msg_scaled_pressure_decode(&message, &scaled_pressure_msg);
 
+    const bool decode_now = !_scaled_pressure_subscriptions.empty();
+    receive_lazily(
+        _scaled_pressure_payload,
+        scaled_pressure_msg,
+        decode_now,
+        &TelemetryImpl::decode_scaled_pressure);
+
+    if (!decode_now) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _scaled_pressure_subscriptions.queue(scaled_pressure(), [this](auto&& func) {
+        _system_impl->call_user_callback(std::move(func));
+    });
+}
+
+void TelemetryImpl::decode_scaled_pressure(
+    const mavlink_scaled_pressure_t& scaled_pressure_msg, uint64_t receive_time_us)
+{
+    auto scaled_pressure_struct = to_scaled_pressure(scaled_pressure_msg);
+
+    set_scaled_pressure(scaled_pressure_struct);
+
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.scaled_pressure = scaled_pressure_struct;
+        snapshot.scaled_pressure_receive_time_us = receive_time_us;
+    });
+}
+
+Telemetry::ScaledPressure
+TelemetryImpl::to_scaled_pressure(const mavlink_scaled_pressure_t& scaled_pressure_msg)
+{
     Telemetry::ScaledPressure scaled_pressure_struct{};
 
     scaled_pressure_struct.timestamp_us =
@@ -1705,12 +2204,7 @@ void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
         static_cast<float>(scaled_pressure_msg.temperature) * 1e-2f;
     scaled_pressure_struct.differential_pressure_temperature_deg =
         static_cast<float>(scaled_pressure_msg.temperature_press_diff) * 1e-2f;
-
-    set_scaled_pressure(scaled_pressure_struct);
-
-    std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _scaled_pressure_subscriptions.queue(
-        scaled_pressure(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    return scaled_pressure_struct;
 }
 
 Telemetry::LandedState
@@ -1791,6 +2285,7 @@ void TelemetryImpl::receive_param_cal_gyro(MavlinkParameterClient::Result result
 
     bool ok = (value != 0);
     set_health_gyrometer_calibration(ok);
+    update_snapshot_health();
 }
 
 void TelemetryImpl::receive_param_cal_accel(MavlinkParameterClient::Result result, int value)
@@ -1802,6 +2297,7 @@ void TelemetryImpl::receive_param_cal_accel(MavlinkParameterClient::Result resul
 
     bool ok = (value != 0);
     set_health_accelerometer_calibration(ok);
+    update_snapshot_health();
 }
 
 void TelemetryImpl::receive_param_cal_mag(MavlinkParameterClient::Result result, int value)
@@ -1813,6 +2309,7 @@ void TelemetryImpl::receive_param_cal_mag(MavlinkParameterClient::Result result,
 
     bool ok = (value != 0);
     set_health_magnetometer_calibration(ok);
+    update_snapshot_health();
 }
 
 void TelemetryImpl::receive_param_cal_mag_offset_x(
@@ -1827,6 +2324,7 @@ void TelemetryImpl::receive_param_cal_mag_offset_x(
     _ap_calibration.mag_offset.x = {value};
     if (_ap_calibration.mag_offset.received_all()) {
         set_health_magnetometer_calibration(_ap_calibration.mag_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1842,6 +2340,7 @@ void TelemetryImpl::receive_param_cal_mag_offset_y(
     _ap_calibration.mag_offset.y = {value};
     if (_ap_calibration.mag_offset.received_all()) {
         set_health_magnetometer_calibration(_ap_calibration.mag_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1857,6 +2356,7 @@ void TelemetryImpl::receive_param_cal_mag_offset_z(
     _ap_calibration.mag_offset.z = {value};
     if (_ap_calibration.mag_offset.received_all()) {
         set_health_magnetometer_calibration(_ap_calibration.mag_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1872,6 +2372,7 @@ void TelemetryImpl::receive_param_cal_accel_offset_x(
     _ap_calibration.accel_offset.x = {value};
     if (_ap_calibration.accel_offset.received_all()) {
         set_health_accelerometer_calibration(_ap_calibration.accel_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1887,6 +2388,7 @@ void TelemetryImpl::receive_param_cal_accel_offset_y(
     _ap_calibration.accel_offset.y = {value};
     if (_ap_calibration.accel_offset.received_all()) {
         set_health_accelerometer_calibration(_ap_calibration.accel_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1902,6 +2404,7 @@ void TelemetryImpl::receive_param_cal_accel_offset_z(
     _ap_calibration.accel_offset.z = {value};
     if (_ap_calibration.accel_offset.received_all()) {
         set_health_accelerometer_calibration(_ap_calibration.accel_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1917,6 +2420,7 @@ void TelemetryImpl::receive_param_cal_gyro_offset_x(
     _ap_calibration.gyro_offset.x = {value};
     if (_ap_calibration.gyro_offset.received_all()) {
         set_health_gyrometer_calibration(_ap_calibration.gyro_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1932,6 +2436,7 @@ void TelemetryImpl::receive_param_cal_gyro_offset_y(
     _ap_calibration.gyro_offset.y = {value};
     if (_ap_calibration.gyro_offset.received_all()) {
         set_health_gyrometer_calibration(_ap_calibration.gyro_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1947,6 +2452,7 @@ void TelemetryImpl::receive_param_cal_gyro_offset_z(
     _ap_calibration.gyro_offset.z = {value};
     if (_ap_calibration.gyro_offset.received_all()) {
         set_health_gyrometer_calibration(_ap_calibration.gyro_offset.calibrated());
+        update_snapshot_health();
     }
 }
 
@@ -1964,6 +2470,7 @@ void TelemetryImpl::receive_param_hitl(MavlinkParameterClient::Result result, in
         set_health_accelerometer_calibration(true);
         set_health_gyrometer_calibration(true);
         set_health_magnetometer_calibration(true);
+        update_snapshot_health();
     }
     _has_received_hitl_param = true;
 }
@@ -1974,6 +2481,7 @@ void TelemetryImpl::receive_gps_raw_timeout()
         const bool position_ok = false;
         set_health_local_position(position_ok);
         set_health_global_position(position_ok);
+        update_snapshot_health();
     }
 }
 
@@ -1981,66 +2489,72 @@ void TelemetryImpl::receive_unix_epoch_timeout()
 {
     const uint64_t unix_epoch = 0;
     set_unix_epoch_time_us(unix_epoch);
+    update_snapshot_unix_epoch_time(unix_epoch);
 }
 
 Telemetry::PositionVelocityNed TelemetryImpl::position_velocity_ned() const
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    return _position_velocity_ned;
+    return load_latest(_local_position_ned, _position_velocity_ned, &to_position_velocity_ned);
 }
 
 void TelemetryImpl::set_position_velocity_ned(Telemetry::PositionVelocityNed position_velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    _position_velocity_ned = position_velocity_ned;
+    _position_velocity_ned.store(position_velocity_ned);
 }
 
 Telemetry::Position TelemetryImpl::position() const
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    return _position;
+    return load_latest(_global_position_int, _position, &to_position);
 }
 
-void TelemetryImpl::set_position(Telemetry::Position position)
+void TelemetryImpl::set_position(Telemetry::Position position, uint64_t receive_time_us)
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    _position = position;
+    _position.store(position);
+
+    if (!_position_history_enabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_position_history_mutex);
+    if (_position_history) {
+        _position_history->push(
+            receive_time_us,
+            autopilot_time_us(),
+            position.latitude_deg,
+            position.longitude_deg,
+            position.absolute_altitude_m,
+            position.relative_altitude_m);
+    }
 }
 
 Telemetry::Heading TelemetryImpl::heading() const
 {
-    std::lock_guard<std::mutex> lock(_heading_mutex);
-    return _heading;
+    return load_latest(_global_position_int, _heading, &to_heading);
 }
 
 void TelemetryImpl::set_heading(Telemetry::Heading heading)
 {
-    std::lock_guard<std::mutex> lock(_heading_mutex);
-    _heading = heading;
+    _heading.store(heading);
 }
 
 Telemetry::Altitude TelemetryImpl::altitude() const
 {
-    std::lock_guard<std::mutex> lock(_altitude_mutex);
-    return _altitude;
+    return load_latest(_altitude_payload, _altitude, &to_altitude);
 }
 
 void TelemetryImpl::set_altitude(Telemetry::Altitude altitude)
 {
-    std::lock_guard<std::mutex> lock(_altitude_mutex);
-    _altitude = altitude;
+    _altitude.store(altitude);
 }
 
 Telemetry::Position TelemetryImpl::home() const
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    return _home_position;
+    return _home_position.load();
 }
 
 void TelemetryImpl::set_home_position(Telemetry::Position home_position)
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    _home_position = home_position;
+    _home_position.store(home_position);
 }
 
 bool TelemetryImpl::armed() const
@@ -2077,73 +2591,92 @@ void TelemetryImpl::set_armed(bool armed_new)
 
 Telemetry::Quaternion TelemetryImpl::attitude_quaternion() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    return _attitude_quaternion;
+    return load_latest(_attitude_quaternion_payload, _attitude_quaternion, &to_quaternion);
 }
 
 Telemetry::AngularVelocityBody TelemetryImpl::attitude_angular_velocity_body() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_angular_velocity_body_mutex);
-    return _attitude_angular_velocity_body;
+    // Only the payload received last has the current angular velocity.
+    if (_attitude.sequence() > _attitude_quaternion_payload.sequence()) {
+        return load_latest(_attitude, _attitude_angular_velocity_body, &to_angular_velocity_body);
+    }
+    return load_latest(
+        _attitude_quaternion_payload, _attitude_angular_velocity_body, &to_angular_velocity_body);
 }
 
 Telemetry::GroundTruth TelemetryImpl::ground_truth() const
 {
-    std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    return _ground_truth;
+    return load_latest(_hil_state_quaternion, _ground_truth, &to_ground_truth);
 }
 
 Telemetry::FixedwingMetrics TelemetryImpl::fixedwing_metrics() const
 {
-    std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    return _fixedwing_metrics;
+    return load_latest(_vfr_hud, _fixedwing_metrics, &to_fixedwing_metrics);
 }
 
 Telemetry::EulerAngle TelemetryImpl::attitude_euler() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_euler_mutex);
-    return _attitude_euler;
+    return load_latest(_attitude, _attitude_euler, &to_euler_angle);
 }
 
 void TelemetryImpl::set_attitude_quaternion(Telemetry::Quaternion quaternion)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_quaternion = quaternion;
+    _attitude_quaternion.store(quaternion);
 }
 
-void TelemetryImpl::set_attitude_euler(Telemetry::EulerAngle euler)
+void TelemetryImpl::set_attitude_euler(Telemetry::EulerAngle euler, uint64_t receive_time_us)
 {
-    std::lock_guard<std::mutex> lock(_attitude_euler_mutex);
-    _attitude_euler = euler;
+    _attitude_euler.store(euler);
+
+    if (!_attitude_euler_history_enabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_attitude_euler_history_mutex);
+    if (_attitude_euler_history) {
+        _attitude_euler_history->push(
+            receive_time_us,
+            autopilot_time_us(),
+            euler.roll_deg,
+            euler.pitch_deg,
+            euler.yaw_deg);
+    }
 }
 
 void TelemetryImpl::set_attitude_angular_velocity_body(
     Telemetry::AngularVelocityBody angular_velocity_body)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_angular_velocity_body = angular_velocity_body;
+    _attitude_angular_velocity_body.store(angular_velocity_body);
+}
+
+bool TelemetryImpl::newest_attitude_angular_velocity_body(uint64_t sequence)
+{
+    // Requires _attitude_angular_velocity_body_mutex
+    if (sequence < _attitude_angular_velocity_body_sequence) {
+        return false;
+    }
+    _attitude_angular_velocity_body_sequence = sequence;
+    return true;
 }
 
 void TelemetryImpl::set_ground_truth(Telemetry::GroundTruth ground_truth)
 {
-    std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    _ground_truth = ground_truth;
+    _ground_truth.store(ground_truth);
 }
 
 void TelemetryImpl::set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics)
 {
-    std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    _fixedwing_metrics = fixedwing_metrics;
+    _fixedwing_metrics.store(fixedwing_metrics);
 }
 
 Telemetry::Quaternion TelemetryImpl::camera_attitude_quaternion() const
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
+    const auto camera_attitude_euler_angle = _camera_attitude_euler_angle.load();
 
     auto euler_angle = EulerAngle{};
-    euler_angle.roll_deg = _camera_attitude_euler_angle.roll_deg;
-    euler_angle.pitch_deg = _camera_attitude_euler_angle.pitch_deg;
-    euler_angle.yaw_deg = _camera_attitude_euler_angle.yaw_deg;
+    euler_angle.roll_deg = camera_attitude_euler_angle.roll_deg;
+    euler_angle.pitch_deg = camera_attitude_euler_angle.pitch_deg;
+    euler_angle.yaw_deg = camera_attitude_euler_angle.yaw_deg;
 
     auto quaternion = to_quaternion_from_euler_angle(euler_angle);
 
@@ -2152,106 +2685,104 @@ Telemetry::Quaternion TelemetryImpl::camera_attitude_quaternion() const
     telemetry_quaternion.x = quaternion.x;
     telemetry_quaternion.y = quaternion.y;
     telemetry_quaternion.z = quaternion.z;
-    telemetry_quaternion.timestamp_us = _camera_attitude_euler_angle.timestamp_us;
+    telemetry_quaternion.timestamp_us = camera_attitude_euler_angle.timestamp_us;
 
     return telemetry_quaternion;
 }
 
 Telemetry::EulerAngle TelemetryImpl::camera_attitude_euler() const
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
-
-    return _camera_attitude_euler_angle;
+    return _camera_attitude_euler_angle.load();
 }
 
 void TelemetryImpl::set_camera_attitude_euler_angle(Telemetry::EulerAngle euler_angle)
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
-    _camera_attitude_euler_angle = euler_angle;
+    _camera_attitude_euler_angle.store(euler_angle);
 }
 
 Telemetry::VelocityNed TelemetryImpl::velocity_ned() const
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    return _velocity_ned;
+    return load_latest(_global_position_int, _velocity_ned, &to_velocity_ned);
 }
 
 void TelemetryImpl::set_velocity_ned(Telemetry::VelocityNed velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    _velocity_ned = velocity_ned;
+    _velocity_ned.store(velocity_ned);
 }
 
 Telemetry::Imu TelemetryImpl::imu() const
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    return _imu_reading_ned;
+    return load_latest(_highres_imu, _imu_reading_ned, &to_imu);
 }
 
 void TelemetryImpl::set_imu_reading_ned(Telemetry::Imu imu_reading_ned)
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    _imu_reading_ned = imu_reading_ned;
+    _imu_reading_ned.store(imu_reading_ned);
 }
 
 Telemetry::Imu TelemetryImpl::scaled_imu() const
 {
-    std::lock_guard<std::mutex> lock(_scaled_imu_mutex);
-    return _scaled_imu;
+    return load_latest(_scaled_imu_payload, _scaled_imu, &to_imu);
 }
 
 void TelemetryImpl::set_scaled_imu(Telemetry::Imu scaled_imu)
 {
-    std::lock_guard<std::mutex> lock(_scaled_imu_mutex);
-    _scaled_imu = scaled_imu;
+    _scaled_imu.store(scaled_imu);
 }
 
 Telemetry::Imu TelemetryImpl::raw_imu() const
 {
-    std::lock_guard<std::mutex> lock(_raw_imu_mutex);
-    return _raw_imu;
+    return load_latest(_raw_imu_payload, _raw_imu, &to_imu);
 }
 
 void TelemetryImpl::set_raw_imu(Telemetry::Imu raw_imu)
 {
-    std::lock_guard<std::mutex> lock(_raw_imu_mutex);
-    _raw_imu = raw_imu;
+    _raw_imu.store(raw_imu);
 }
 
 Telemetry::GpsInfo TelemetryImpl::gps_info() const
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    return _gps_info;
+    return _gps_info.load();
 }
 
 void TelemetryImpl::set_gps_info(Telemetry::GpsInfo gps_info)
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    _gps_info = gps_info;
+    _gps_info.store(gps_info);
 }
 
 Telemetry::RawGps TelemetryImpl::raw_gps() const
 {
-    std::lock_guard<std::mutex> lock(_raw_gps_mutex);
-    return _raw_gps;
+    return _raw_gps.load();
 }
 
 void TelemetryImpl::set_raw_gps(Telemetry::RawGps raw_gps)
 {
-    std::lock_guard<std::mutex> lock(_raw_gps_mutex);
-    _raw_gps = raw_gps;
+    _raw_gps.store(raw_gps);
 }
 
 Telemetry::Battery TelemetryImpl::battery() const
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    return _battery;
+    return _battery.load();
 }
 
 void TelemetryImpl::set_battery(Telemetry::Battery battery)
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    _battery = battery;
+    _battery.store(battery);
+
+    if (!_battery_history_enabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_battery_history_mutex);
+    if (_battery_history) {
+        _battery_history->push(
+            _system_impl->get_time().elapsed_us(),
+            autopilot_time_us(),
+            battery.id,
+            battery.voltage_v,
+            battery.current_battery_a,
+            battery.remaining_percent);
+    }
 }
 
 Telemetry::FlightMode TelemetryImpl::flight_mode() const
@@ -2261,16 +2792,15 @@ Telemetry::FlightMode TelemetryImpl::flight_mode() const
 
 Telemetry::Health TelemetryImpl::health() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    return _health;
+    return _health.load();
 }
 
 bool TelemetryImpl::health_all_ok() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    if (_health.is_gyrometer_calibration_ok && _health.is_accelerometer_calibration_ok &&
-        _health.is_magnetometer_calibration_ok && _health.is_local_position_ok &&
-        _health.is_global_position_ok && _health.is_home_position_ok) {
+    const auto health = _health.load();
+    if (health.is_gyrometer_calibration_ok && health.is_accelerometer_calibration_ok &&
+        health.is_magnetometer_calibration_ok && health.is_local_position_ok &&
+        health.is_global_position_ok && health.is_home_position_ok) {
         return true;
     } else {
         return false;
@@ -2279,13 +2809,11 @@ bool TelemetryImpl::health_all_ok() const
 
 Telemetry::RcStatus TelemetryImpl::rc_status() const
 {
-    std::lock_guard<std::mutex> lock(_rc_status_mutex);
-    return _rc_status;
+    return _rc_status.load();
 }
 
 uint64_t TelemetryImpl::unix_epoch_time() const
 {
-    std::lock_guard<std::mutex> lock(_unix_epoch_time_mutex);
     return _unix_epoch_time_us;
 }
 
@@ -2309,108 +2837,344 @@ Telemetry::Odometry TelemetryImpl::odometry() const
 
 Telemetry::DistanceSensor TelemetryImpl::distance_sensor() const
 {
-    std::lock_guard<std::mutex> lock(_distance_sensor_mutex);
-    return _distance_sensor;
+    return _distance_sensor.load();
 }
 
 Telemetry::ScaledPressure TelemetryImpl::scaled_pressure() const
 {
-    std::lock_guard<std::mutex> lock(_scaled_pressure_mutex);
-    return _scaled_pressure;
+    return load_latest(_scaled_pressure_payload, _scaled_pressure, &to_scaled_pressure);
 }
 
 void TelemetryImpl::set_health_local_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_local_position_ok = ok;
+    _health.update([&](Telemetry::Health& health) { health.is_local_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_global_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_global_position_ok = ok;
+    _health.update([&](Telemetry::Health& health) { health.is_global_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_home_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_home_position_ok = ok;
+    _health.update([&](Telemetry::Health& health) { health.is_home_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_gyrometer_calibration(bool ok)
 {
     _has_received_gyro_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_gyrometer_calibration_ok = (ok || _hitl_enabled);
+    _health.update([&](Telemetry::Health& health) {
+        health.is_gyrometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 void TelemetryImpl::set_health_accelerometer_calibration(bool ok)
 {
     _has_received_accel_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_accelerometer_calibration_ok = (ok || _hitl_enabled);
+    _health.update([&](Telemetry::Health& health) {
+        health.is_accelerometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 void TelemetryImpl::set_health_magnetometer_calibration(bool ok)
 {
     _has_received_mag_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_magnetometer_calibration_ok = (ok || _hitl_enabled);
+    _health.update([&](Telemetry::Health& health) {
+        health.is_magnetometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 void TelemetryImpl::set_health_armable(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_armable = ok;
+    _health.update([&](Telemetry::Health& health) { health.is_armable = ok; });
 }
 
 Telemetry::VtolState TelemetryImpl::vtol_state() const
 {
-    std::lock_guard<std::mutex> lock(_vtol_state_mutex);
-    return _vtol_state;
+    return _vtol_state.load();
 }
 
 void TelemetryImpl::set_vtol_state(Telemetry::VtolState vtol_state)
 {
-    std::lock_guard<std::mutex> lock(_vtol_state_mutex);
-    _vtol_state = vtol_state;
+    _vtol_state.store(vtol_state);
+}
+
+void TelemetryImpl::update_snapshot_health()
+{
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.health = _health.load();
+        snapshot.health_receive_time_us = receive_time_us;
+    });
+}
+
+void TelemetryImpl::update_snapshot_camera_attitude(const Telemetry::EulerAngle& euler_angle)
+{
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.camera_attitude_euler = euler_angle;
+        snapshot.camera_attitude_euler_receive_time_us = receive_time_us;
+    });
+}
+
+void TelemetryImpl::update_snapshot_unix_epoch_time(uint64_t time_us)
+{
+    const auto receive_time_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.unix_epoch_time_us = time_us;
+        snapshot.unix_epoch_time_receive_time_us = receive_time_us;
+    });
+}
+
+TelemetryExt::Snapshot TelemetryImpl::snapshot() const
+{
+    auto snapshot = _snapshot.load();
+
+    // Payloads that haven't been decoded on receive only end up in this copy.
+    if (const auto pending = _global_position_int.load_pending()) {
+        snapshot.position = to_position(pending->payload);
+        snapshot.position_receive_time_us = pending->receive_time_us;
+        snapshot.velocity_ned = to_velocity_ned(pending->payload);
+        snapshot.velocity_ned_receive_time_us = pending->receive_time_us;
+        snapshot.heading = to_heading(pending->payload);
+        snapshot.heading_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _local_position_ned.load_pending()) {
+        snapshot.position_velocity_ned = to_position_velocity_ned(pending->payload);
+        snapshot.position_velocity_ned_receive_time_us = pending->receive_time_us;
+    }
+
+    const bool attitude_newest = _attitude.sequence() > _attitude_quaternion_payload.sequence();
+    if (const auto pending = _attitude.load_pending()) {
+        snapshot.attitude_euler = to_euler_angle(pending->payload);
+        snapshot.attitude_euler_receive_time_us = pending->receive_time_us;
+        if (attitude_newest) {
+            snapshot.attitude_angular_velocity_body = to_angular_velocity_body(pending->payload);
+            snapshot.attitude_angular_velocity_body_receive_time_us = pending->receive_time_us;
+        }
+    }
+    if (const auto pending = _attitude_quaternion_payload.load_pending()) {
+        snapshot.attitude_quaternion = to_quaternion(pending->payload);
+        snapshot.attitude_quaternion_receive_time_us = pending->receive_time_us;
+        if (!attitude_newest) {
+            snapshot.attitude_angular_velocity_body = to_angular_velocity_body(pending->payload);
+            snapshot.attitude_angular_velocity_body_receive_time_us = pending->receive_time_us;
+        }
+    }
+
+    if (const auto pending = _altitude_payload.load_pending()) {
+        snapshot.altitude = to_altitude(pending->payload);
+        snapshot.altitude_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _highres_imu.load_pending()) {
+        snapshot.imu = to_imu(pending->payload);
+        snapshot.imu_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _scaled_imu_payload.load_pending()) {
+        snapshot.scaled_imu = to_imu(pending->payload);
+        snapshot.scaled_imu_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _raw_imu_payload.load_pending()) {
+        snapshot.raw_imu = to_imu(pending->payload);
+        snapshot.raw_imu_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _hil_state_quaternion.load_pending()) {
+        snapshot.ground_truth = to_ground_truth(pending->payload);
+        snapshot.ground_truth_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _vfr_hud.load_pending()) {
+        snapshot.fixedwing_metrics = to_fixedwing_metrics(pending->payload);
+        snapshot.fixedwing_metrics_receive_time_us = pending->receive_time_us;
+    }
+    if (const auto pending = _scaled_pressure_payload.load_pending()) {
+        snapshot.scaled_pressure = to_scaled_pressure(pending->payload);
+        snapshot.scaled_pressure_receive_time_us = pending->receive_time_us;
+    }
+
+    return snapshot;
+}
+
+// Unless there is someone to hand the values to right away, only the payload
+// is stored. Getters and the snapshot then convert it into a local value.
+template<typename Payload>
+void TelemetryImpl::receive_lazily(
+    LazyPayload<Payload>& lazy_payload,
+    const Payload& payload,
+    bool decode_now,
+    void (TelemetryImpl::*decode)(const Payload&, uint64_t))
+{
+    lazy_payload.receive(
+        payload,
+        _system_impl->get_time().elapsed_us(),
+        ++_receive_sequence,
+        decode_now,
+        [this, decode](const Payload& received, uint64_t receive_time_us) {
+            (this->*decode)(received, receive_time_us);
+        });
+}
+
+template<typename Payload, typename Value>
+Value TelemetryImpl::load_latest(
+    const LazyPayload<Payload>& lazy_payload,
+    const Seqlock<Value>& decoded,
+    Value (*convert)(const Payload&))
+{
+    if (const auto pending = lazy_payload.load_pending()) {
+        return convert(pending->payload);
+    }
+    return decoded.load();
+}
+
+uint64_t TelemetryImpl::autopilot_time_us()
+{
+    return static_cast<uint64_t>(
+        _system_impl->get_autopilot_time().now().time_since_epoch() / std::chrono::microseconds(1));
+}
+
+void TelemetryImpl::enable_position_history(uint32_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(_position_history_mutex);
+        _position_history =
+            (capacity > 0) ? std::make_unique<PositionHistoryRing>(capacity) : nullptr;
+    }
+    // Every sample needs to be decoded to be recorded, and without a history
+    // the lock isn't taken for every sample.
+    _position_history_enabled = capacity > 0;
+}
+
+void TelemetryImpl::position_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const TelemetryExt::PositionHistoryCallback& callback) const
+{
+    // Copied so that the callback runs without the lock and can't stall the receive thread.
+    PositionHistoryRing range{0};
+    {
+        std::lock_guard<std::mutex> lock(_position_history_mutex);
+        if (_position_history) {
+            const auto& ring = *_position_history;
+            range = ring.copy(
+                ring.lower_bound<0>(from_receive_time_us), ring.lower_bound<0>(to_receive_time_us));
+        }
+    }
+
+    TelemetryExt::PositionHistory history{};
+    history.receive_time_us = range.column<0>(0, range.size());
+    history.autopilot_time_us = range.column<1>(0, range.size());
+    history.latitude_deg = range.column<2>(0, range.size());
+    history.longitude_deg = range.column<3>(0, range.size());
+    history.absolute_altitude_m = range.column<4>(0, range.size());
+    history.relative_altitude_m = range.column<5>(0, range.size());
+    callback(history);
+}
+
+void TelemetryImpl::enable_attitude_euler_history(uint32_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(_attitude_euler_history_mutex);
+        _attitude_euler_history =
+            (capacity > 0) ? std::make_unique<AttitudeEulerHistoryRing>(capacity) : nullptr;
+    }
+    // Every sample needs to be decoded to be recorded, and without a history
+    // the lock isn't taken for every sample.
+    _attitude_euler_history_enabled = capacity > 0;
+}
+
+void TelemetryImpl::attitude_euler_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const TelemetryExt::AttitudeEulerHistoryCallback& callback) const
+{
+    // Copied so that the callback runs without the lock and can't stall the receive thread.
+    AttitudeEulerHistoryRing range{0};
+    {
+        std::lock_guard<std::mutex> lock(_attitude_euler_history_mutex);
+        if (_attitude_euler_history) {
+            const auto& ring = *_attitude_euler_history;
+            range = ring.copy(
+                ring.lower_bound<0>(from_receive_time_us), ring.lower_bound<0>(to_receive_time_us));
+        }
+    }
+
+    TelemetryExt::AttitudeEulerHistory history{};
+    history.receive_time_us = range.column<0>(0, range.size());
+    history.autopilot_time_us = range.column<1>(0, range.size());
+    history.roll_deg = range.column<2>(0, range.size());
+    history.pitch_deg = range.column<3>(0, range.size());
+    history.yaw_deg = range.column<4>(0, range.size());
+    callback(history);
+}
+
+void TelemetryImpl::enable_battery_history(uint32_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(_battery_history_mutex);
+        _battery_history =
+            (capacity > 0) ? std::make_unique<BatteryHistoryRing>(capacity) : nullptr;
+    }
+    // Saves taking the lock for every sample while there is no history.
+    _battery_history_enabled = capacity > 0;
+}
+
+void TelemetryImpl::battery_history(
+    uint64_t from_receive_time_us,
+    uint64_t to_receive_time_us,
+    const TelemetryExt::BatteryHistoryCallback& callback) const
+{
+    // Copied so that the callback runs without the lock and can't stall the receive thread.
+    BatteryHistoryRing range{0};
+    {
+        std::lock_guard<std::mutex> lock(_battery_history_mutex);
+        if (_battery_history) {
+            const auto& ring = *_battery_history;
+            range = ring.copy(
+                ring.lower_bound<0>(from_receive_time_us), ring.lower_bound<0>(to_receive_time_us));
+        }
+    }
+
+    TelemetryExt::BatteryHistory history{};
+    history.receive_time_us = range.column<0>(0, range.size());
+    history.autopilot_time_us = range.column<1>(0, range.size());
+    history.id = range.column<2>(0, range.size());
+    history.voltage_v = range.column<3>(0, range.size());
+    history.current_battery_a = range.column<4>(0, range.size());
+    history.remaining_percent = range.column<5>(0, range.size());
+    callback(history);
 }
 
 Telemetry::LandedState TelemetryImpl::landed_state() const
 {
-    std::lock_guard<std::mutex> lock(_landed_state_mutex);
-    return _landed_state;
+    return _landed_state.load();
 }
 
 void TelemetryImpl::set_landed_state(Telemetry::LandedState landed_state)
 {
-    std::lock_guard<std::mutex> lock(_landed_state_mutex);
-    _landed_state = landed_state;
+    _landed_state.store(landed_state);
 }
 
 void TelemetryImpl::set_rc_status(
     std::optional<bool> maybe_available, std::optional<float> maybe_signal_strength_percent)
 {
-    std::lock_guard<std::mutex> lock(_rc_status_mutex);
-
-    if (maybe_available) {
-        _rc_status.is_available = maybe_available.value();
-        if (maybe_available.value()) {
-            _rc_status.was_available_once = true;
+    _rc_status.update([&](Telemetry::RcStatus& rc_status) {
+        if (maybe_available) {
+            rc_status.is_available = maybe_available.value();
+            if (maybe_available.value()) {
+                rc_status.was_available_once = true;
+            }
         }
-    }
 
-    if (maybe_signal_strength_percent) {
-        _rc_status.signal_strength_percent = maybe_signal_strength_percent.value();
-    }
+        if (maybe_signal_strength_percent) {
+            rc_status.signal_strength_percent = maybe_signal_strength_percent.value();
+        }
+    });
 }
 
 void TelemetryImpl::set_unix_epoch_time_us(uint64_t time_us)
 {
-    std::lock_guard<std::mutex> lock(_unix_epoch_time_mutex);
     _unix_epoch_time_us = time_us;
 }
 
@@ -2436,21 +3200,19 @@ void TelemetryImpl::set_odometry(Telemetry::Odometry& odometry)
 
 void TelemetryImpl::set_distance_sensor(Telemetry::DistanceSensor& distance_sensor)
 {
-    std::lock_guard<std::mutex> lock(_distance_sensor_mutex);
-    _distance_sensor = distance_sensor;
+    _distance_sensor.store(distance_sensor);
 }
 
 void TelemetryImpl::set_scaled_pressure(Telemetry::ScaledPressure& scaled_pressure)
 {
-    std::lock_guard<std::mutex> lock(_scaled_pressure_mutex);
-    _scaled_pressure = scaled_pressure;
+    _scaled_pressure.store(scaled_pressure);
 }
 
 Telemetry::PositionVelocityNedHandle TelemetryImpl::subscribe_position_velocity_ned(
-    const Telemetry::PositionVelocityNedCallback& callback)
+    const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _position_velocity_ned_subscriptions.subscribe(callback);
+    return _position_velocity_ned_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle)
@@ -2460,10 +3222,10 @@ void TelemetryImpl::unsubscribe_position_velocity_ned(Telemetry::PositionVelocit
 }
 
 Telemetry::PositionHandle
-TelemetryImpl::subscribe_position(const Telemetry::PositionCallback& callback)
+TelemetryImpl::subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _position_subscriptions.subscribe(callback);
+    return _position_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_position(Telemetry::PositionHandle handle)
@@ -2472,10 +3234,11 @@ void TelemetryImpl::unsubscribe_position(Telemetry::PositionHandle handle)
     _position_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::HomeHandle TelemetryImpl::subscribe_home(const Telemetry::PositionCallback& callback)
+Telemetry::HomeHandle
+TelemetryImpl::subscribe_home(const Telemetry::PositionCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _home_position_subscriptions.subscribe(callback);
+    return _home_position_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_home(Telemetry::HomeHandle handle)
@@ -2484,10 +3247,11 @@ void TelemetryImpl::unsubscribe_home(Telemetry::HomeHandle handle)
     _home_position_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::InAirHandle TelemetryImpl::subscribe_in_air(const Telemetry::InAirCallback& callback)
+Telemetry::InAirHandle
+TelemetryImpl::subscribe_in_air(const Telemetry::InAirCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _in_air_subscriptions.subscribe(callback);
+    return _in_air_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_in_air(Telemetry::InAirHandle handle)
@@ -2509,10 +3273,11 @@ void TelemetryImpl::unsubscribe_status_text(Handle<Telemetry::StatusText> handle
     _status_text_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::ArmedHandle TelemetryImpl::subscribe_armed(const Telemetry::ArmedCallback& callback)
+Telemetry::ArmedHandle
+TelemetryImpl::subscribe_armed(const Telemetry::ArmedCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _armed_subscriptions.subscribe(callback);
+    return _armed_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_armed(Telemetry::ArmedHandle handle)
@@ -2521,11 +3286,11 @@ void TelemetryImpl::unsubscribe_armed(Telemetry::ArmedHandle handle)
     _armed_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::AttitudeQuaternionHandle
-TelemetryImpl::subscribe_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback)
+Telemetry::AttitudeQuaternionHandle TelemetryImpl::subscribe_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_quaternion_angle_subscriptions.subscribe(callback);
+    return _attitude_quaternion_angle_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle)
@@ -2534,11 +3299,11 @@ void TelemetryImpl::unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternio
     _attitude_quaternion_angle_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::AttitudeEulerHandle
-TelemetryImpl::subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback)
+Telemetry::AttitudeEulerHandle TelemetryImpl::subscribe_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_euler_angle_subscriptions.subscribe(callback);
+    return _attitude_euler_angle_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle)
@@ -2549,10 +3314,10 @@ void TelemetryImpl::unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle ha
 
 Telemetry::AttitudeAngularVelocityBodyHandle
 TelemetryImpl::subscribe_attitude_angular_velocity_body(
-    const Telemetry::AttitudeAngularVelocityBodyCallback& callback)
+    const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_angular_velocity_body_subscriptions.subscribe(callback);
+    return _attitude_angular_velocity_body_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_attitude_angular_velocity_body(
@@ -2562,11 +3327,11 @@ void TelemetryImpl::unsubscribe_attitude_angular_velocity_body(
     _attitude_angular_velocity_body_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::FixedwingMetricsHandle
-TelemetryImpl::subscribe_fixedwing_metrics(const Telemetry::FixedwingMetricsCallback& callback)
+Telemetry::FixedwingMetricsHandle TelemetryImpl::subscribe_fixedwing_metrics(
+    const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _fixedwing_metrics_subscriptions.subscribe(callback);
+    return _fixedwing_metrics_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle)
@@ -2575,11 +3340,11 @@ void TelemetryImpl::unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHan
     _fixedwing_metrics_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::GroundTruthHandle
-TelemetryImpl::subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback)
+Telemetry::GroundTruthHandle TelemetryImpl::subscribe_ground_truth(
+    const Telemetry::GroundTruthCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _ground_truth_subscriptions.subscribe(callback);
+    return _ground_truth_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle)
@@ -2589,10 +3354,10 @@ void TelemetryImpl::unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle
 }
 
 Telemetry::AttitudeQuaternionHandle TelemetryImpl::subscribe_camera_attitude_quaternion(
-    const Telemetry::AttitudeQuaternionCallback& callback)
+    const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _camera_attitude_quaternion_subscriptions.subscribe(callback);
+    return _camera_attitude_quaternion_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_camera_attitude_quaternion(
@@ -2602,11 +3367,11 @@ void TelemetryImpl::unsubscribe_camera_attitude_quaternion(
     _camera_attitude_quaternion_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::AttitudeEulerHandle
-TelemetryImpl::subscribe_camera_attitude_euler(const Telemetry::AttitudeEulerCallback& callback)
+Telemetry::AttitudeEulerHandle TelemetryImpl::subscribe_camera_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _camera_attitude_euler_angle_subscriptions.subscribe(callback);
+    return _camera_attitude_euler_angle_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_camera_attitude_euler(Telemetry::AttitudeEulerHandle handle)
@@ -2615,11 +3380,11 @@ void TelemetryImpl::unsubscribe_camera_attitude_euler(Telemetry::AttitudeEulerHa
     _camera_attitude_euler_angle_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::VelocityNedHandle
-TelemetryImpl::subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback)
+Telemetry::VelocityNedHandle TelemetryImpl::subscribe_velocity_ned(
+    const Telemetry::VelocityNedCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _velocity_ned_subscriptions.subscribe(callback);
+    return _velocity_ned_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle)
@@ -2628,10 +3393,11 @@ void TelemetryImpl::unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle
     _velocity_ned_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::ImuHandle TelemetryImpl::subscribe_imu(const Telemetry::ImuCallback& callback)
+Telemetry::ImuHandle
+TelemetryImpl::subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _imu_reading_ned_subscriptions.subscribe(callback);
+    return _imu_reading_ned_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_imu(Telemetry::ImuHandle handle)
@@ -2640,11 +3406,11 @@ void TelemetryImpl::unsubscribe_imu(Telemetry::ImuHandle handle)
     return _imu_reading_ned_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::ScaledImuHandle
-TelemetryImpl::subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback)
+Telemetry::ScaledImuHandle TelemetryImpl::subscribe_scaled_imu(
+    const Telemetry::ScaledImuCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _scaled_imu_subscriptions.subscribe(callback);
+    return _scaled_imu_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle)
@@ -2653,10 +3419,11 @@ void TelemetryImpl::unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle)
     _scaled_imu_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::RawImuHandle TelemetryImpl::subscribe_raw_imu(const Telemetry::RawImuCallback& callback)
+Telemetry::RawImuHandle
+TelemetryImpl::subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _raw_imu_subscriptions.subscribe(callback);
+    return _raw_imu_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_raw_imu(Telemetry::RawImuHandle handle)
@@ -2666,10 +3433,10 @@ void TelemetryImpl::unsubscribe_raw_imu(Telemetry::RawImuHandle handle)
 }
 
 Telemetry::GpsInfoHandle
-TelemetryImpl::subscribe_gps_info(const Telemetry::GpsInfoCallback& callback)
+TelemetryImpl::subscribe_gps_info(const Telemetry::GpsInfoCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _gps_info_subscriptions.subscribe(callback);
+    return _gps_info_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_gps_info(Telemetry::GpsInfoHandle handle)
@@ -2678,10 +3445,11 @@ void TelemetryImpl::unsubscribe_gps_info(Telemetry::GpsInfoHandle handle)
     _gps_info_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::RawGpsHandle TelemetryImpl::subscribe_raw_gps(const Telemetry::RawGpsCallback& callback)
+Telemetry::RawGpsHandle
+TelemetryImpl::subscribe_raw_gps(const Telemetry::RawGpsCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _raw_gps_subscriptions.subscribe(callback);
+    return _raw_gps_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_raw_gps(Telemetry::RawGpsHandle handle)
@@ -2691,10 +3459,10 @@ void TelemetryImpl::unsubscribe_raw_gps(Telemetry::RawGpsHandle handle)
 }
 
 Telemetry::BatteryHandle
-TelemetryImpl::subscribe_battery(const Telemetry::BatteryCallback& callback)
+TelemetryImpl::subscribe_battery(const Telemetry::BatteryCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _battery_subscriptions.subscribe(callback);
+    return _battery_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_battery(Telemetry::BatteryHandle handle)
@@ -2703,11 +3471,11 @@ void TelemetryImpl::unsubscribe_battery(Telemetry::BatteryHandle handle)
     _battery_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::FlightModeHandle
-TelemetryImpl::subscribe_flight_mode(const Telemetry::FlightModeCallback& callback)
+Telemetry::FlightModeHandle TelemetryImpl::subscribe_flight_mode(
+    const Telemetry::FlightModeCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _flight_mode_subscriptions.subscribe(callback);
+    return _flight_mode_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_flight_mode(Telemetry::FlightModeHandle handle)
@@ -2716,10 +3484,11 @@ void TelemetryImpl::unsubscribe_flight_mode(Telemetry::FlightModeHandle handle)
     _flight_mode_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::HealthHandle TelemetryImpl::subscribe_health(const Telemetry::HealthCallback& callback)
+Telemetry::HealthHandle
+TelemetryImpl::subscribe_health(const Telemetry::HealthCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _health_subscriptions.subscribe(callback);
+    return _health_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_health(Telemetry::HealthHandle handle)
@@ -2728,11 +3497,11 @@ void TelemetryImpl::unsubscribe_health(Telemetry::HealthHandle handle)
     _health_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::HealthAllOkHandle
-TelemetryImpl::subscribe_health_all_ok(const Telemetry::HealthAllOkCallback& callback)
+Telemetry::HealthAllOkHandle TelemetryImpl::subscribe_health_all_ok(
+    const Telemetry::HealthAllOkCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _health_all_ok_subscriptions.subscribe(callback);
+    return _health_all_ok_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_health_all_ok(Telemetry::HealthAllOkHandle handle)
@@ -2741,11 +3510,11 @@ void TelemetryImpl::unsubscribe_health_all_ok(Telemetry::HealthAllOkHandle handl
     _health_all_ok_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::VtolStateHandle
-TelemetryImpl::subscribe_vtol_state(const Telemetry::VtolStateCallback& callback)
+Telemetry::VtolStateHandle TelemetryImpl::subscribe_vtol_state(
+    const Telemetry::VtolStateCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _vtol_state_subscriptions.subscribe(callback);
+    return _vtol_state_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_vtol_state(Telemetry::VtolStateHandle handle)
@@ -2754,11 +3523,11 @@ void TelemetryImpl::unsubscribe_vtol_state(Telemetry::VtolStateHandle handle)
     _vtol_state_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::LandedStateHandle
-TelemetryImpl::subscribe_landed_state(const Telemetry::LandedStateCallback& callback)
+Telemetry::LandedStateHandle TelemetryImpl::subscribe_landed_state(
+    const Telemetry::LandedStateCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _landed_state_subscriptions.subscribe(callback);
+    return _landed_state_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_landed_state(Telemetry::LandedStateHandle handle)
@@ -2768,10 +3537,10 @@ void TelemetryImpl::unsubscribe_landed_state(Telemetry::LandedStateHandle handle
 }
 
 Telemetry::RcStatusHandle
-TelemetryImpl::subscribe_rc_status(const Telemetry::RcStatusCallback& callback)
+TelemetryImpl::subscribe_rc_status(const Telemetry::RcStatusCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _rc_status_subscriptions.subscribe(callback);
+    return _rc_status_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_rc_status(Telemetry::RcStatusHandle handle)
@@ -2780,11 +3549,11 @@ void TelemetryImpl::unsubscribe_rc_status(Telemetry::RcStatusHandle handle)
     _rc_status_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::UnixEpochTimeHandle
-TelemetryImpl::subscribe_unix_epoch_time(const Telemetry::UnixEpochTimeCallback& callback)
+Telemetry::UnixEpochTimeHandle TelemetryImpl::subscribe_unix_epoch_time(
+    const Telemetry::UnixEpochTimeCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _unix_epoch_time_subscriptions.subscribe(callback);
+    return _unix_epoch_time_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_unix_epoch_time(Telemetry::UnixEpochTimeHandle handle)
@@ -2794,10 +3563,10 @@ void TelemetryImpl::unsubscribe_unix_epoch_time(Telemetry::UnixEpochTimeHandle h
 }
 
 Telemetry::ActuatorControlTargetHandle TelemetryImpl::subscribe_actuator_control_target(
-    const Telemetry::ActuatorControlTargetCallback& callback)
+    const Telemetry::ActuatorControlTargetCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _actuator_control_target_subscriptions.subscribe(callback);
+    return _actuator_control_target_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_actuator_control_target(
@@ -2808,10 +3577,10 @@ void TelemetryImpl::unsubscribe_actuator_control_target(
 }
 
 Telemetry::ActuatorOutputStatusHandle TelemetryImpl::subscribe_actuator_output_status(
-    const Telemetry::ActuatorOutputStatusCallback& callback)
+    const Telemetry::ActuatorOutputStatusCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _actuator_output_status_subscriptions.subscribe(callback);
+    return _actuator_output_status_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_actuator_output_status(Telemetry::ActuatorOutputStatusHandle handle)
@@ -2821,10 +3590,10 @@ void TelemetryImpl::unsubscribe_actuator_output_status(Telemetry::ActuatorOutput
 }
 
 Telemetry::OdometryHandle
-TelemetryImpl::subscribe_odometry(const Telemetry::OdometryCallback& callback)
+TelemetryImpl::subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _odometry_subscriptions.subscribe(callback);
+    return _odometry_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_odometry(Telemetry::OdometryHandle handle)
@@ -2833,11 +3602,11 @@ void TelemetryImpl::unsubscribe_odometry(Telemetry::OdometryHandle handle)
     _odometry_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::DistanceSensorHandle
-TelemetryImpl::subscribe_distance_sensor(const Telemetry::DistanceSensorCallback& callback)
+Telemetry::DistanceSensorHandle TelemetryImpl::subscribe_distance_sensor(
+    const Telemetry::DistanceSensorCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _distance_sensor_subscriptions.subscribe(callback);
+    return _distance_sensor_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_distance_sensor(Telemetry::DistanceSensorHandle handle)
@@ -2846,11 +3615,11 @@ void TelemetryImpl::unsubscribe_distance_sensor(Telemetry::DistanceSensorHandle
     _distance_sensor_subscriptions.unsubscribe(handle);
 }
 
-Telemetry::ScaledPressureHandle
-TelemetryImpl::subscribe_scaled_pressure(const Telemetry::ScaledPressureCallback& callback)
+Telemetry::ScaledPressureHandle TelemetryImpl::subscribe_scaled_pressure(
+    const Telemetry::ScaledPressureCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _scaled_pressure_subscriptions.subscribe(callback);
+    return _scaled_pressure_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle handle)
@@ -2860,10 +3629,10 @@ void TelemetryImpl::unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle
 }
 
 Telemetry::HeadingHandle
-TelemetryImpl::subscribe_heading(const Telemetry::HeadingCallback& callback)
+TelemetryImpl::subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _heading_subscriptions.subscribe(callback);
+    return _heading_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_heading(Telemetry::HeadingHandle handle)
@@ -2873,10 +3642,10 @@ void TelemetryImpl::unsubscribe_heading(Telemetry::HeadingHandle handle)
 }
 
 Telemetry::AltitudeHandle
-TelemetryImpl::subscribe_altitude(const Telemetry::AltitudeCallback& callback)
+TelemetryImpl::subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _altitude_subscriptions.subscribe(callback);
+    return _altitude_subscriptions.subscribe(callback, max_rate_hz);
 }
 
 void TelemetryImpl::unsubscribe_altitude(Telemetry::AltitudeHandle handle)
@@ -2935,14 +3704,11 @@ std::pair<Telemetry::Result, Telemetry::GpsGlobalOrigin> TelemetryImpl::get_gps_
 
 void TelemetryImpl::check_calibration()
 {
-    {
-        std::lock_guard<std::mutex> lock(_health_mutex);
-        if ((_has_received_gyro_calibration && _has_received_accel_calibration &&
-             _has_received_mag_calibration) ||
-            _hitl_enabled) {
-            _system_impl->remove_call_every(_calibration_cookie);
-            return;
-        }
+    if ((_has_received_gyro_calibration && _has_received_accel_calibration &&
+         _has_received_mag_calibration) ||
+        _hitl_enabled) {
+        _system_impl->remove_call_every(_calibration_cookie);
+        return;
     }
     if (_system_impl->has_autopilot()) {
         if (_system_impl->autopilot() == Autopilot::ArduPilot) {
@@ -1,14 +1,19 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <optional>
 
 #include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry/telemetry_ext.h"
 #include "mavlink_include.h"
 #include "plugin_impl_base.h"
 #include "system.h"
 #include "callback_list.h"
+#include "seqlock.h"
+#include "columnar_ringbuffer.h"
+#include "lazy_payload.h"
 
 namespace mavsdk {
 
@@ -20,6 +25,9 @@ public:
     explicit TelemetryImpl(std::shared_ptr<System> system);
     ~TelemetryImpl() override;
 
+    // The impl of the first Telemetry created for this system, which TelemetryExt attaches to.
+    static TelemetryImpl* shared_impl(System& system);
+
     void init() override;
     void deinit() override;
 
@@ -78,6 +86,10 @@ public:
     void set_rate_unix_epoch_time_async(double rate_hz, Telemetry::ResultCallback callback);
     void set_rate_altitude_async(double rate_hz, Telemetry::ResultCallback callback);
 
+    void set_rates_async(
+        const TelemetryExt::RateProfile& rate_profile, const Telemetry::ResultCallback& callback);
+    Telemetry::Result set_rates(const TelemetryExt::RateProfile& rate_profile);
+
     void get_gps_global_origin_async(const Telemetry::GetGpsGlobalOriginCallback callback);
     std::pair<Telemetry::Result, Telemetry::GpsGlobalOrigin> get_gps_global_origin();
 
@@ -115,93 +127,126 @@ public:
     uint64_t unix_epoch_time() const;
     Telemetry::Heading heading() const;
     Telemetry::Altitude altitude() const;
-
-    Telemetry::PositionVelocityNedHandle
-    subscribe_position_velocity_ned(const Telemetry::PositionVelocityNedCallback& callback);
+    TelemetryExt::Snapshot snapshot() const;
+
+    void enable_position_history(uint32_t capacity);
+    void position_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const TelemetryExt::PositionHistoryCallback& callback) const;
+    void enable_attitude_euler_history(uint32_t capacity);
+    void attitude_euler_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const TelemetryExt::AttitudeEulerHistoryCallback& callback) const;
+    void enable_battery_history(uint32_t capacity);
+    void battery_history(
+        uint64_t from_receive_time_us,
+        uint64_t to_receive_time_us,
+        const TelemetryExt::BatteryHistoryCallback& callback) const;
+
+    Telemetry::PositionVelocityNedHandle subscribe_position_velocity_ned(
+        const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle);
-    Telemetry::PositionHandle subscribe_position(const Telemetry::PositionCallback& callback);
+    Telemetry::PositionHandle
+    subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_position(Telemetry::PositionHandle handle);
-    Telemetry::HomeHandle subscribe_home(const Telemetry::PositionCallback& callback);
+    Telemetry::HomeHandle
+    subscribe_home(const Telemetry::PositionCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_home(Telemetry::HomeHandle handle);
-    Telemetry::InAirHandle subscribe_in_air(const Telemetry::InAirCallback& callback);
+    Telemetry::InAirHandle
+    subscribe_in_air(const Telemetry::InAirCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_in_air(Telemetry::InAirHandle handle);
     Telemetry::StatusTextHandle
     subscribe_status_text(const Telemetry::StatusTextCallback& callback);
     void unsubscribe_status_text(Telemetry::StatusTextHandle handle);
-    Telemetry::ArmedHandle subscribe_armed(const Telemetry::ArmedCallback& callback);
+    Telemetry::ArmedHandle
+    subscribe_armed(const Telemetry::ArmedCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_armed(Telemetry::ArmedHandle handle);
-    Telemetry::AttitudeQuaternionHandle
-    subscribe_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback);
+    Telemetry::AttitudeQuaternionHandle subscribe_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle);
-    Telemetry::AttitudeEulerHandle
-    subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback);
+    Telemetry::AttitudeEulerHandle subscribe_attitude_euler(
+        const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle);
     Telemetry::AttitudeAngularVelocityBodyHandle subscribe_attitude_angular_velocity_body(
-        const Telemetry::AttitudeAngularVelocityBodyCallback& callback);
+        const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz = 0.0);
     void
     unsubscribe_attitude_angular_velocity_body(Telemetry::AttitudeAngularVelocityBodyHandle handle);
-    Telemetry::FixedwingMetricsHandle
-    subscribe_fixedwing_metrics(const Telemetry::FixedwingMetricsCallback& callback);
+    Telemetry::FixedwingMetricsHandle subscribe_fixedwing_metrics(
+        const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle);
-    Telemetry::GroundTruthHandle
-    subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback);
+    Telemetry::GroundTruthHandle subscribe_ground_truth(
+        const Telemetry::GroundTruthCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle);
-    Telemetry::AttitudeQuaternionHandle
-    subscribe_camera_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback);
+    Telemetry::AttitudeQuaternionHandle subscribe_camera_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_camera_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle);
-    Telemetry::AttitudeEulerHandle
-    subscribe_camera_attitude_euler(const Telemetry::AttitudeEulerCallback& callback);
+    Telemetry::AttitudeEulerHandle subscribe_camera_attitude_euler(
+        const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_camera_attitude_euler(Telemetry::AttitudeEulerHandle handle);
-    Telemetry::VelocityNedHandle
-    subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback);
+    Telemetry::VelocityNedHandle subscribe_velocity_ned(
+        const Telemetry::VelocityNedCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle);
-    Telemetry::ImuHandle subscribe_imu(const Telemetry::ImuCallback& callback);
+    Telemetry::ImuHandle
+    subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_imu(Telemetry::ImuHandle handle);
-    Telemetry::ScaledImuHandle subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback);
+    Telemetry::ScaledImuHandle
+    subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle);
-    Telemetry::RawImuHandle subscribe_raw_imu(const Telemetry::RawImuCallback& callback);
+    Telemetry::RawImuHandle
+    subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_raw_imu(Telemetry::RawImuHandle handle);
-    Telemetry::GpsInfoHandle subscribe_gps_info(const Telemetry::GpsInfoCallback& callback);
+    Telemetry::GpsInfoHandle
+    subscribe_gps_info(const Telemetry::GpsInfoCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_gps_info(Telemetry::GpsInfoHandle handle);
-    Telemetry::RawGpsHandle subscribe_raw_gps(const Telemetry::RawGpsCallback& callback);
+    Telemetry::RawGpsHandle
+    subscribe_raw_gps(const Telemetry::RawGpsCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_raw_gps(Telemetry::RawGpsHandle handle);
-    Telemetry::BatteryHandle subscribe_battery(const Telemetry::BatteryCallback& callback);
+    Telemetry::BatteryHandle
+    subscribe_battery(const Telemetry::BatteryCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_battery(Telemetry::BatteryHandle handle);
     Telemetry::FlightModeHandle
-    subscribe_flight_mode(const Telemetry::FlightModeCallback& callback);
+    subscribe_flight_mode(const Telemetry::FlightModeCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_flight_mode(Telemetry::FlightModeHandle handle);
-    Telemetry::HealthHandle subscribe_health(const Telemetry::HealthCallback& callback);
+    Telemetry::HealthHandle
+    subscribe_health(const Telemetry::HealthCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_health(Telemetry::HealthHandle handle);
-    Telemetry::HealthAllOkHandle
-    subscribe_health_all_ok(const Telemetry::HealthAllOkCallback& callback);
+    Telemetry::HealthAllOkHandle subscribe_health_all_ok(
+        const Telemetry::HealthAllOkCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_health_all_ok(Telemetry::HealthAllOkHandle handle);
-    Telemetry::VtolStateHandle subscribe_vtol_state(const Telemetry::VtolStateCallback& callback);
+    Telemetry::VtolStateHandle
+    subscribe_vtol_state(const Telemetry::VtolStateCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_vtol_state(Telemetry::VtolStateHandle handle);
-    Telemetry::LandedStateHandle
-    subscribe_landed_state(const Telemetry::LandedStateCallback& callback);
+    Telemetry::LandedStateHandle subscribe_landed_state(
+        const Telemetry::LandedStateCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_landed_state(Telemetry::LandedStateHandle handle);
-    Telemetry::RcStatusHandle subscribe_rc_status(const Telemetry::RcStatusCallback& callback);
+    Telemetry::RcStatusHandle
+    subscribe_rc_status(const Telemetry::RcStatusCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_rc_status(Telemetry::RcStatusHandle handle);
-    Telemetry::UnixEpochTimeHandle
-    subscribe_unix_epoch_time(const Telemetry::UnixEpochTimeCallback& callback);
+    Telemetry::UnixEpochTimeHandle subscribe_unix_epoch_time(
+        const Telemetry::UnixEpochTimeCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_unix_epoch_time(Telemetry::UnixEpochTimeHandle handle);
-    Telemetry::ActuatorControlTargetHandle
-    subscribe_actuator_control_target(const Telemetry::ActuatorControlTargetCallback& callback);
+    Telemetry::ActuatorControlTargetHandle subscribe_actuator_control_target(
+        const Telemetry::ActuatorControlTargetCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_actuator_control_target(Telemetry::ActuatorControlTargetHandle handle);
-    Telemetry::ActuatorOutputStatusHandle
-    subscribe_actuator_output_status(const Telemetry::ActuatorOutputStatusCallback& callback);
+    Telemetry::ActuatorOutputStatusHandle subscribe_actuator_output_status(
+        const Telemetry::ActuatorOutputStatusCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_actuator_output_status(Telemetry::ActuatorOutputStatusHandle handle);
-    Telemetry::OdometryHandle subscribe_odometry(const Telemetry::OdometryCallback& callback);
+    Telemetry::OdometryHandle
+    subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_odometry(Telemetry::OdometryHandle handle);
-    Telemetry::DistanceSensorHandle
-    subscribe_distance_sensor(const Telemetry::DistanceSensorCallback& callback);
+    Telemetry::DistanceSensorHandle subscribe_distance_sensor(
+        const Telemetry::DistanceSensorCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_distance_sensor(Telemetry::DistanceSensorHandle handle);
-    Telemetry::ScaledPressureHandle
-    subscribe_scaled_pressure(const Telemetry::ScaledPressureCallback& callback);
+    Telemetry::ScaledPressureHandle subscribe_scaled_pressure(
+        const Telemetry::ScaledPressureCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle handle);
-    Telemetry::HeadingHandle subscribe_heading(const Telemetry::HeadingCallback& callback);
+    Telemetry::HeadingHandle
+    subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_heading(Telemetry::HeadingHandle handle);
-    Telemetry::AltitudeHandle subscribe_altitude(const Telemetry::AltitudeCallback& callback);
+    Telemetry::AltitudeHandle
+    subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz = 0.0);
     void unsubscribe_altitude(Telemetry::AltitudeHandle handle);
 
     TelemetryImpl(const TelemetryImpl&) = delete;
@@ -209,7 +254,7 @@ public:
 
 private:
     void set_position_velocity_ned(Telemetry::PositionVelocityNed position_velocity_ned);
-    void set_position(Telemetry::Position position);
+    void set_position(Telemetry::Position position, uint64_t receive_time_us);
     void set_home_position(Telemetry::Position home_position);
     void set_in_air(bool in_air);
     void set_vtol_state(Telemetry::VtolState vtol_state);
@@ -217,8 +262,9 @@ private:
     void set_status_text(Telemetry::StatusText status_text);
     void set_armed(bool armed);
     void set_attitude_quaternion(Telemetry::Quaternion quaternion);
-    void set_attitude_euler(Telemetry::EulerAngle euler);
+    void set_attitude_euler(Telemetry::EulerAngle euler, uint64_t receive_time_us);
     void set_attitude_angular_velocity_body(Telemetry::AngularVelocityBody angular_velocity_body);
+    bool newest_attitude_angular_velocity_body(uint64_t sequence);
     void set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics);
     void set_ground_truth(Telemetry::GroundTruth ground_truth);
     void set_camera_attitude_euler_angle(Telemetry::EulerAngle euler_angle);
@@ -246,20 +292,55 @@ private:
     void set_heading(Telemetry::Heading heading);
     void set_altitude(Telemetry::Altitude altitude);
 
+    // For the handlers that have no other fields to publish with these.
+    void update_snapshot_health();
+    void update_snapshot_camera_attitude(const Telemetry::EulerAngle& euler_angle);
+    void update_snapshot_unix_epoch_time(uint64_t time_us);
+
+    template<typename Payload>
+    void receive_lazily(
+        LazyPayload<Payload>& lazy_payload,
+        const Payload& payload,
+        bool decode_now,
+        void (TelemetryImpl::*decode)(const Payload&, uint64_t));
+
+    // The pending payload converted, or the decoded value if nothing is pending.
+    template<typename Payload, typename Value>
+    static Value load_latest(
+        const LazyPayload<Payload>& lazy_payload,
+        const Seqlock<Value>& decoded,
+        Value (*convert)(const Payload&));
+
+    uint64_t autopilot_time_us();
+
     void process_position_velocity_ned(const mavlink_message_t& message);
+    void decode_local_position_ned(
+        const mavlink_local_position_ned_t& local_position, uint64_t receive_time_us);
     void process_global_position_int(const mavlink_message_t& message);
+    void decode_global_position_int(
+        const mavlink_global_position_int_t& global_position_int, uint64_t receive_time_us);
     void process_home_position(const mavlink_message_t& message);
     void process_attitude(const mavlink_message_t& message);
+    void decode_attitude(const mavlink_attitude_t& attitude, uint64_t receive_time_us);
     void process_attitude_quaternion(const mavlink_message_t& message);
+    void decode_attitude_quaternion(
+        const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion, uint64_t receive_time_us);
     void process_gimbal_device_attitude_status(const mavlink_message_t& message);
     void process_mount_orientation(const mavlink_message_t& message);
     void process_imu_reading_ned(const mavlink_message_t& message);
+    void decode_highres_imu(const mavlink_highres_imu_t& highres_imu, uint64_t receive_time_us);
     void process_scaled_imu(const mavlink_message_t& message);
+    void decode_scaled_imu(
+        const mavlink_scaled_imu_t& scaled_imu_reading, uint64_t receive_time_us);
     void process_raw_imu(const mavlink_message_t& message);
+    void decode_raw_imu(const mavlink_raw_imu_t& raw_imu_reading, uint64_t receive_time_us);
     void process_gps_raw_int(const mavlink_message_t& message);
     void process_ground_truth(const mavlink_message_t& message);
+    void decode_hil_state_quaternion(
+        const mavlink_hil_state_quaternion_t& hil_state_quaternion, uint64_t receive_time_us);
     void process_extended_sys_state(const mavlink_message_t& message);
     void process_fixedwing_metrics(const mavlink_message_t& message);
+    void decode_vfr_hud(const mavlink_vfr_hud_t& vfr_hud, uint64_t receive_time_us);
     void process_sys_status(const mavlink_message_t& message);
     void process_battery_status(const mavlink_message_t& message);
     void process_heartbeat(const mavlink_message_t& message);
@@ -270,7 +351,10 @@ private:
     void process_odometry(const mavlink_message_t& message);
     void process_distance_sensor(const mavlink_message_t& message);
     void process_scaled_pressure(const mavlink_message_t& message);
+    void decode_scaled_pressure(
+        const mavlink_scaled_pressure_t& scaled_pressure_msg, uint64_t receive_time_us);
     void process_altitude(const mavlink_message_t& message);
+    void decode_altitude(const mavlink_altitude_t& mavlink_altitude, uint64_t receive_time_us);
     void receive_param_cal_gyro(MavlinkParameterClient::Result result, int value);
     void receive_param_cal_accel(MavlinkParameterClient::Result result, int value);
     void receive_param_cal_mag(MavlinkParameterClient::Result result, int value);
@@ -302,6 +386,9 @@ private:
     static bool sys_status_present_enabled_health(
         const mavlink_sys_status_t& sys_status, MAV_SYS_STATUS_SENSOR flag);
 
+    void apply_rate_profile(
+        const TelemetryExt::RateProfile& rate_profile, const Telemetry::ResultCallback& callback);
+
     static Telemetry::Result
     telemetry_result_from_command_result(MavlinkCommandSender::Result command_result);
 
@@ -311,83 +398,110 @@ private:
     static Telemetry::LandedState to_landed_state(mavlink_extended_sys_state_t extended_sys_state);
     static Telemetry::VtolState to_vtol_state(mavlink_extended_sys_state_t extended_sys_state);
 
-    static Telemetry::FlightMode telemetry_flight_mode_from_flight_mode(FlightMode flight_mode);
-
-    // Make all fields thread-safe using mutexs
-    // The mutexs are mutable so that the lock can get aqcuired in
-    // methods marked const.
-    mutable std::mutex _position_mutex{};
-    Telemetry::Position _position{};
+    // Conversions of lazily decoded payloads, which readers can do on their own.
+    static Telemetry::PositionVelocityNed
+    to_position_velocity_ned(const mavlink_local_position_ned_t& local_position);
+    static Telemetry::Position
+    to_position(const mavlink_global_position_int_t& global_position_int);
+    static Telemetry::VelocityNed
+    to_velocity_ned(const mavlink_global_position_int_t& global_position_int);
+    static Telemetry::Heading to_heading(const mavlink_global_position_int_t& global_position_int);
+    static Telemetry::EulerAngle to_euler_angle(const mavlink_attitude_t& attitude);
+    static Telemetry::AngularVelocityBody
+    to_angular_velocity_body(const mavlink_attitude_t& attitude);
+    static Telemetry::Quaternion
+    to_quaternion(const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion);
+    static Telemetry::AngularVelocityBody
+    to_angular_velocity_body(const mavlink_attitude_quaternion_t& mavlink_attitude_quaternion);
+    static Telemetry::Altitude to_altitude(const mavlink_altitude_t& mavlink_altitude);
+    static Telemetry::Imu to_imu(const mavlink_highres_imu_t& highres_imu);
+    static Telemetry::Imu to_imu(const mavlink_scaled_imu_t& scaled_imu_reading);
+    static Telemetry::Imu to_imu(const mavlink_raw_imu_t& raw_imu_reading);
+    static Telemetry::GroundTruth
+    to_ground_truth(const mavlink_hil_state_quaternion_t& hil_state_quaternion);
+    static Telemetry::FixedwingMetrics to_fixedwing_metrics(const mavlink_vfr_hud_t& vfr_hud);
+    static Telemetry::ScaledPressure
+    to_scaled_pressure(const mavlink_scaled_pressure_t& scaled_pressure_msg);
 
-    mutable std::mutex _heading_mutex{};
-    Telemetry::Heading _heading{};
-
-    mutable std::mutex _position_velocity_ned_mutex{};
-    Telemetry::PositionVelocityNed _position_velocity_ned{};
+    static Telemetry::FlightMode telemetry_flight_mode_from_flight_mode(FlightMode flight_mode);
 
-    mutable std::mutex _home_position_mutex{};
-    Telemetry::Position _home_position{};
+    // Telemetry fields are written by the receive thread and polled by users,
+    // possibly at high rates. Seqlocks let the getters read without taking a
+    // lock. Types which are not trivially copyable still need a mutex.
+    Seqlock<Telemetry::Position> _position{};
+    Seqlock<Telemetry::Heading> _heading{};
+    Seqlock<Telemetry::PositionVelocityNed> _position_velocity_ned{};
+    Seqlock<Telemetry::Position> _home_position{};
+    Seqlock<Telemetry::Quaternion> _attitude_quaternion{};
+    Seqlock<Telemetry::EulerAngle> _attitude_euler{};
+    Seqlock<Telemetry::EulerAngle> _camera_attitude_euler_angle{};
+    Seqlock<Telemetry::AngularVelocityBody> _attitude_angular_velocity_body{};
+    Seqlock<Telemetry::GroundTruth> _ground_truth{};
+    Seqlock<Telemetry::FixedwingMetrics> _fixedwing_metrics{};
+    Seqlock<Telemetry::VelocityNed> _velocity_ned{};
+    Seqlock<Telemetry::Imu> _imu_reading_ned{};
+    Seqlock<Telemetry::Imu> _scaled_imu{};
+    Seqlock<Telemetry::Imu> _raw_imu{};
+    Seqlock<Telemetry::GpsInfo> _gps_info{};
+    Seqlock<Telemetry::RawGps> _raw_gps{};
+    Seqlock<Telemetry::Battery> _battery{};
+    Seqlock<Telemetry::Health> _health{};
+    Seqlock<Telemetry::VtolState> _vtol_state{Telemetry::VtolState::Undefined};
+    Seqlock<Telemetry::LandedState> _landed_state{Telemetry::LandedState::Unknown};
+    Seqlock<Telemetry::RcStatus> _rc_status{};
+    Seqlock<Telemetry::DistanceSensor> _distance_sensor{};
+    Seqlock<Telemetry::ScaledPressure> _scaled_pressure{};
+    Seqlock<Telemetry::Altitude> _altitude{};
+
+    // All of the above in one place for consistent reads across fields. Each
+    // message handler publishes what it received here once, together with the
+    // receive time.
+    Seqlock<TelemetryExt::Snapshot> _snapshot{};
+
+    // Opt-in histories, columns are: receive time, autopilot time, then the
+    // members of the sample. Only allocated once enabled.
+    using PositionHistoryRing =
+        ColumnarRingbuffer<uint64_t, uint64_t, double, double, float, float>;
+    using AttitudeEulerHistoryRing = ColumnarRingbuffer<uint64_t, uint64_t, float, float, float>;
+    using BatteryHistoryRing =
+        ColumnarRingbuffer<uint64_t, uint64_t, uint32_t, float, float, float>;
+
+    mutable std::mutex _position_history_mutex{};
+    std::unique_ptr<PositionHistoryRing> _position_history{};
+    mutable std::mutex _attitude_euler_history_mutex{};
+    std::unique_ptr<AttitudeEulerHistoryRing> _attitude_euler_history{};
+    mutable std::mutex _battery_history_mutex{};
+    std::unique_ptr<BatteryHistoryRing> _battery_history{};
+    std::atomic<bool> _position_history_enabled{false};
+    std::atomic<bool> _attitude_euler_history_enabled{false};
+    std::atomic<bool> _battery_history_enabled{false};
+
+    // Latest payloads of frequent messages which are only decoded when needed.
+    LazyPayload<mavlink_global_position_int_t> _global_position_int{};
+    LazyPayload<mavlink_local_position_ned_t> _local_position_ned{};
+    LazyPayload<mavlink_attitude_t> _attitude{};
+    LazyPayload<mavlink_attitude_quaternion_t> _attitude_quaternion_payload{};
+    LazyPayload<mavlink_altitude_t> _altitude_payload{};
+    LazyPayload<mavlink_highres_imu_t> _highres_imu{};
+    LazyPayload<mavlink_scaled_imu_t> _scaled_imu_payload{};
+    LazyPayload<mavlink_raw_imu_t> _raw_imu_payload{};
+    LazyPayload<mavlink_hil_state_quaternion_t> _hil_state_quaternion{};
+    LazyPayload<mavlink_vfr_hud_t> _vfr_hud{};
+    LazyPayload<mavlink_scaled_pressure_t> _scaled_pressure_payload{};
+    std::atomic<uint64_t> _receive_sequence{0};
+
+    // ATTITUDE and ATTITUDE_QUATERNION both carry the angular velocity, the
+    // one received last wins, no matter in which order they are decoded.
+    std::mutex _attitude_angular_velocity_body_mutex{};
+    uint64_t _attitude_angular_velocity_body_sequence{0};
 
-    // If possible, just use atomic instead of a mutex.
     std::atomic_bool _in_air{false};
     std::atomic_bool _armed{false};
 
     mutable std::mutex _status_text_mutex{};
     Telemetry::StatusText _status_text{};
 
-    mutable std::mutex _attitude_quaternion_mutex{};
-    Telemetry::Quaternion _attitude_quaternion{};
-
-    mutable std::mutex _attitude_euler_mutex{};
-    Telemetry::EulerAngle _attitude_euler{};
-
-    mutable std::mutex _camera_attitude_euler_angle_mutex{};
-    Telemetry::EulerAngle _camera_attitude_euler_angle{};
-
-    mutable std::mutex _attitude_angular_velocity_body_mutex{};
-    Telemetry::AngularVelocityBody _attitude_angular_velocity_body{};
-
-    mutable std::mutex _ground_truth_mutex{};
-    Telemetry::GroundTruth _ground_truth{};
-
-    mutable std::mutex _fixedwing_metrics_mutex{};
-    Telemetry::FixedwingMetrics _fixedwing_metrics{};
-
-    mutable std::mutex _velocity_ned_mutex{};
-    Telemetry::VelocityNed _velocity_ned{};
-
-    mutable std::mutex _imu_reading_ned_mutex{};
-    Telemetry::Imu _imu_reading_ned{};
-
-    mutable std::mutex _scaled_imu_mutex{};
-    Telemetry::Imu _scaled_imu{};
-
-    mutable std::mutex _raw_imu_mutex{};
-    Telemetry::Imu _raw_imu{};
-
-    mutable std::mutex _gps_info_mutex{};
-    Telemetry::GpsInfo _gps_info{};
-
-    mutable std::mutex _raw_gps_mutex{};
-    Telemetry::RawGps _raw_gps{};
-
-    mutable std::mutex _battery_mutex{};
-    Telemetry::Battery _battery{};
-
-    mutable std::mutex _health_mutex{};
-    Telemetry::Health _health{};
-
-    mutable std::mutex _vtol_state_mutex{};
-    Telemetry::VtolState _vtol_state{Telemetry::VtolState::Undefined};
-
-    mutable std::mutex _landed_state_mutex{};
-    Telemetry::LandedState _landed_state{Telemetry::LandedState::Unknown};
-
-    mutable std::mutex _rc_status_mutex{};
-    Telemetry::RcStatus _rc_status{};
-
-    mutable std::mutex _unix_epoch_time_mutex{};
-    uint64_t _unix_epoch_time_us{};
+    std::atomic<uint64_t> _unix_epoch_time_us{0};
 
     mutable std::mutex _actuator_control_target_mutex{};
     Telemetry::ActuatorControlTarget _actuator_control_target{};
@@ -398,16 +512,9 @@ private:
     mutable std::mutex _odometry_mutex{};
     Telemetry::Odometry _odometry{};
 
-    mutable std::mutex _distance_sensor_mutex{};
-    Telemetry::DistanceSensor _distance_sensor{};
-
-    mutable std::mutex _scaled_pressure_mutex{};
-    Telemetry::ScaledPressure _scaled_pressure{};
-
-    mutable std::mutex _altitude_mutex{};
-    Telemetry::Altitude _altitude{};
-
-    mutable std::mutex _request_home_position_mutex{};
+    // Set again on reconnect.
+    std::mutex _rate_profile_mutex{};
+    std::optional<TelemetryExt::RateProfile> _rate_profile{};
 
     std::atomic<bool> _hitl_enabled{false};
 
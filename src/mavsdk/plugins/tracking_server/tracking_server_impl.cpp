@@ -259,8 +259,8 @@ TrackingServerImpl::process_track_point_command(const MavlinkCommandReceiver::Co
     _tracking_point_command_sysid = command.origin_system_id;
     _tracking_point_command_compid = command.origin_component_id;
 
-    _tracking_point_callbacks.queue(track_point, [this](const auto& func) {
-        _server_component_impl->call_user_callback(func);
+    _tracking_point_callbacks.queue(track_point, [this](auto&& func) {
+        _server_component_impl->call_user_callback(std::move(func));
     });
 
     // We don't send an ack but leave that to the user.
@@ -284,8 +284,8 @@ std::optional<mavlink_command_ack_t> TrackingServerImpl::process_track_rectangle
     _tracking_rectangle_command_sysid = command.origin_system_id;
     _tracking_rectangle_command_compid = command.origin_component_id;
 
-    _tracking_rectangle_callbacks.queue(track_rectangle, [this](const auto& func) {
-        _server_component_impl->call_user_callback(func);
+    _tracking_rectangle_callbacks.queue(track_rectangle, [this](auto&& func) {
+        _server_component_impl->call_user_callback(std::move(func));
     });
 
     // We don't send an ack but leave that to the user.
@@ -307,7 +307,7 @@ TrackingServerImpl::process_track_off_command(const MavlinkCommandReceiver::Comm
     _tracking_off_command_compid = command.origin_component_id;
 
     _tracking_off_callbacks.queue(
-        0, [this](const auto& func) { _server_component_impl->call_user_callback(func); });
+        0, [this](auto&& func) { _server_component_impl->call_user_callback(std::move(func)); });
 
     // We don't send an ack but leave that to the user.
     return std::nullopt;
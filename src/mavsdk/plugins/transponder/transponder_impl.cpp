@@ -104,7 +104,7 @@ void TransponderImpl::process_transponder(const mavlink_message_t& message)
     set_transponder(adsbVehicle);
 
     _transponder_subscriptions.queue(
-        transponder(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        transponder(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
 }
 
 Transponder::Result
@@ -103,7 +103,7 @@ void WinchImpl::process_status(const mavlink_message_t& message)
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
         _status_subscriptions.queue(
-            status(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            status(), [this](auto&& func) { _system_impl->call_user_callback(std::move(func)); });
     }
 }
 
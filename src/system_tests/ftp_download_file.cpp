@@ -7,6 +7,7 @@
 #include <fstream>
 #include <thread>
 #include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_ext.h"
 #include "plugins/ftp_server/ftp_server.h"
 #include "fs_helpers.h"
 
@@ -144,6 +145,73 @@ TEST(SystemTest, FtpDownloadBigFile)
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+TEST(SystemTest, FtpDownloadResumeChangedFile)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 50000));
+    ASSERT_TRUE(reset_directories(temp_dir_downloaded));
+
+    // A partial download of which one block got changed in the meantime.
+    ASSERT_TRUE(create_temp_file(temp_dir_downloaded / temp_file, 40000));
+    {
+        std::fstream partial(
+            temp_dir_downloaded / temp_file, std::ios::in | std::ios::out | std::ios::binary);
+        partial.seekp(1000);
+        partial.put('x');
+    }
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    auto prom = std::promise<Ftp::Result>();
+    auto fut = prom.get_future();
+    uint32_t first_progress = 0;
+    ftp.download_async(
+        temp_file.string(),
+        temp_dir_downloaded.string(),
+        false,
+        [&prom, &first_progress](Ftp::Result result, Ftp::ProgressData progress_data) {
+            if (result != Ftp::Result::Next) {
+                prom.set_value(result);
+            } else if (first_progress == 0) {
+                first_progress = progress_data.bytes_transferred;
+            }
+        });
+
+    auto future_status = fut.wait_for(std::chrono::seconds(20));
+    ASSERT_EQ(future_status, std::future_status::ready);
+    EXPECT_EQ(fut.get(), Ftp::Result::Success);
+
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_provided / temp_file, temp_dir_downloaded / temp_file));
+
+    // The first 32 KiB block has the changed byte, the rest of what was there
+    // already is reported as transferred right away. Only the changed block
+    // and the missing tail are read again.
+    EXPECT_EQ(first_progress, 40000u - 32768u);
+    EXPECT_EQ(50000u - first_progress, 32768u + 10000u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
 TEST(SystemTest, FtpDownloadBigFileLossy)
 {
     ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 10000));
@@ -207,6 +275,151 @@ TEST(SystemTest, FtpDownloadBigFileLossy)
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+TEST(SystemTest, FtpDownloadTwoClients)
+{
+    const fs::path other_temp_file = "other_data.bin";
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 50000));
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / other_temp_file, 40000, 7));
+    ASSERT_TRUE(reset_directories(temp_dir_downloaded));
+    ASSERT_TRUE(reset_directories(temp_dir_downloaded / "other"));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    // A second client, e.g. an uplink on a companion computer, with its own address.
+    auto other_config = Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation};
+    other_config.set_system_id(other_config.get_system_id() + 1);
+    Mavsdk mavsdk_other{other_config};
+    mavsdk_other.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(mavsdk_other.add_any_connection("udp://:17001"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17001"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto ftp = Ftp{maybe_system.value()};
+
+    auto maybe_other_system = mavsdk_other.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_other_system);
+    auto other_ftp = Ftp{maybe_other_system.value()};
+
+    auto prom = std::promise<Ftp::Result>();
+    auto fut = prom.get_future();
+    ftp.download_async(
+        temp_file.string(),
+        temp_dir_downloaded.string(),
+        true,
+        [&prom](Ftp::Result result, Ftp::ProgressData) {
+            if (result != Ftp::Result::Next) {
+                prom.set_value(result);
+            }
+        });
+
+    auto other_prom = std::promise<Ftp::Result>();
+    auto other_fut = other_prom.get_future();
+    other_ftp.download_async(
+        other_temp_file.string(),
+        (temp_dir_downloaded / "other").string(),
+        false,
+        [&other_prom](Ftp::Result result, Ftp::ProgressData) {
+            if (result != Ftp::Result::Next) {
+                other_prom.set_value(result);
+            }
+        });
+
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(20)), std::future_status::ready);
+    ASSERT_EQ(other_fut.wait_for(std::chrono::seconds(20)), std::future_status::ready);
+    EXPECT_EQ(fut.get(), Ftp::Result::Success);
+    EXPECT_EQ(other_fut.get(), Ftp::Result::Success);
+
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_provided / temp_file, temp_dir_downloaded / temp_file));
+    EXPECT_TRUE(are_files_identical(
+        temp_dir_provided / other_temp_file, temp_dir_downloaded / "other" / other_temp_file));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST(SystemTest, FtpMirrorDirectory)
+{
+    const fs::path remote_tree = temp_dir_provided / "tree";
+    ASSERT_TRUE(reset_directories(remote_tree));
+    ASSERT_TRUE(reset_directories(temp_dir_downloaded));
+
+    const std::vector<fs::path> files{
+        "top.bin", "a/one.bin", "a/deep/two.bin", "b/three.bin", "b/same.bin"};
+    for (size_t i = 0; i < files.size(); ++i) {
+        ASSERT_TRUE(
+            create_temp_file(remote_tree / files[i], 1000 + i * 3000, static_cast<uint8_t>(i)));
+    }
+    fs::create_directories(remote_tree / "empty");
+
+    // This one is there already and should not be downloaded again.
+    ASSERT_TRUE(create_temp_file(temp_dir_downloaded / "b/same.bin", 1000 + 4 * 3000, 4));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp_ext = FtpExt{system};
+
+    auto prom = std::promise<std::pair<Ftp::Result, FtpExt::MirrorProgress>>();
+    auto fut = prom.get_future();
+    ftp_ext.mirror_directory_async(
+        "tree",
+        temp_dir_downloaded.string(),
+        false,
+        [&prom](Ftp::Result result, FtpExt::MirrorProgress progress) {
+            if (result != Ftp::Result::Next) {
+                prom.set_value({result, progress});
+            } else {
+                LogDebug() << "Mirrored " << progress.files_downloaded + progress.files_skipped
+                           << "/" << progress.files_found << " files";
+            }
+        });
+
+    auto future_status = fut.wait_for(std::chrono::seconds(20));
+    ASSERT_EQ(future_status, std::future_status::ready);
+    const auto [result, progress] = fut.get();
+    EXPECT_EQ(result, Ftp::Result::Success);
+    EXPECT_EQ(progress.files_found, files.size());
+    EXPECT_EQ(progress.files_downloaded, files.size() - 1);
+    EXPECT_EQ(progress.files_skipped, 1u);
+
+    for (const auto& file : files) {
+        EXPECT_TRUE(are_files_identical(remote_tree / file, temp_dir_downloaded / file));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
 TEST(SystemTest, FtpDownloadStopAndTryAgain)
 {
     ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 1000));
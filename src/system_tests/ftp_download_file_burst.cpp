@@ -2,12 +2,14 @@
 #include "mavsdk.h"
 #include <filesystem>
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <fstream>
 #include <thread>
 #include "plugins/ftp/ftp.h"
 #include "plugins/ftp_server/ftp_server.h"
+#include "plugins/ftp_server/ftp_server_ext.h"
 #include "fs_helpers.h"
 
 using namespace mavsdk;
@@ -207,6 +209,165 @@ TEST(SystemTest, FtpDownloadBurstBigFileLossy)
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+TEST(SystemTest, FtpDownloadBurstBigFileLossSpike)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 100000));
+    ASSERT_TRUE(reset_directories(temp_dir_downloaded));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    // The link drops out for a while in the middle of the burst.
+    unsigned counter = 0;
+    auto drop_a_stretch = [&counter](mavlink_message_t& message) {
+        if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+            return true;
+        }
+        ++counter;
+        return counter < 100 || counter > 300;
+    };
+
+    mavsdk_groundstation.intercept_incoming_messages_async(drop_a_stretch);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    auto prom = std::promise<Ftp::Result>();
+    auto fut = prom.get_future();
+    ftp.download_async(
+        ("" / temp_file).string(),
+        temp_dir_downloaded.string(),
+        true,
+        [&prom](Ftp::Result result, Ftp::ProgressData progress_data) {
+            if (result != Ftp::Result::Next) {
+                prom.set_value(result);
+            } else {
+                LogDebug() << "Download progress: " << progress_data.bytes_transferred << "/"
+                           << progress_data.total_bytes << " bytes";
+            }
+        });
+
+    auto future_status = fut.wait_for(std::chrono::seconds(30));
+    ASSERT_EQ(future_status, std::future_status::ready);
+    EXPECT_EQ(fut.get(), Ftp::Result::Success);
+
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_provided / temp_file, temp_dir_downloaded / temp_file));
+
+    // Before going out of scope, we need to make sure to no longer access the
+    // drop_a_stretch callback which accesses the local counter variable.
+    mavsdk_groundstation.intercept_incoming_messages_async(nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST(SystemTest, FtpDownloadBurstRates)
+{
+    constexpr unsigned file_size = 50000;
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, file_size));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    // Drop every nth FTP message, 0 for none.
+    std::atomic<unsigned> drop_every{0};
+    unsigned counter = 0;
+    auto drop_some = [&drop_every, &counter](mavlink_message_t& message) {
+        if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL || drop_every == 0) {
+            return true;
+        }
+        return ++counter % drop_every != 0;
+    };
+
+    mavsdk_groundstation.intercept_incoming_messages_async(drop_some);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+    auto ftp_server_ext = FtpServerExt{mavsdk_autopilot.server_component()};
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    // Several burst rates, 0 being unlimited, with and without loss. The
+    // server must stay below the configured rate, the short budget it may
+    // save up is what the tolerance is for.
+    constexpr double rate_tolerance = 1.25;
+    for (const unsigned every : {0u, 20u, 5u}) {
+        for (const double rate : {0.0, 200000.0, 50000.0}) {
+            ASSERT_TRUE(reset_directories(temp_dir_downloaded));
+            drop_every = every;
+            EXPECT_EQ(ftp_server_ext.set_burst_rate(rate), FtpServer::Result::Success);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            auto prom = std::promise<Ftp::Result>();
+            auto fut = prom.get_future();
+            ftp.download_async(
+                temp_file.string(),
+                temp_dir_downloaded.string(),
+                true,
+                [&prom](Ftp::Result result, Ftp::ProgressData) {
+                    if (result != Ftp::Result::Next) {
+                        prom.set_value(result);
+                    }
+                });
+
+            auto future_status = fut.wait_for(std::chrono::seconds(30));
+            ASSERT_EQ(future_status, std::future_status::ready);
+            EXPECT_EQ(fut.get(), Ftp::Result::Success);
+
+            const double elapsed_s =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            LogInfo() << "Burst rate " << rate / 1000.0 << " kB/s, dropping "
+                      << (every == 0 ? 0.0 : 100.0 / every) << "%: goodput "
+                      << file_size / elapsed_s / 1000.0 << " kB/s, server at "
+                      << ftp_server_ext.burst_stats().bytes_per_second / 1000.0 << " kB/s";
+
+            EXPECT_TRUE(are_files_identical(
+                temp_dir_provided / temp_file, temp_dir_downloaded / temp_file));
+
+            if (rate > 0.0) {
+                EXPECT_LE(ftp_server_ext.burst_stats().bytes_per_second, rate * rate_tolerance);
+            }
+        }
+    }
+
+    // Before going out of scope, we need to make sure to no longer access the
+    // drop_some callback which accesses local variables.
+    mavsdk_groundstation.intercept_incoming_messages_async(nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
 TEST(SystemTest, FtpDownloadBurstStopAndTryAgain)
 {
     constexpr int file_size = 1000;
@@ -1,5 +1,6 @@
 #include "log.h"
 #include "mavsdk.h"
+#include <atomic>
 #include <filesystem>
 #include <gtest/gtest.h>
 #include <chrono>
@@ -209,6 +210,302 @@ TEST(SystemTest, FtpUploadBigFileLossy)
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+TEST(SystemTest, FtpUploadLargeFileLossyThroughput)
+{
+    constexpr unsigned file_size = 200000;
+    ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, file_size));
+    ASSERT_TRUE(reset_directories(temp_dir_provided));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    unsigned counter = 0;
+    auto drop_some = [&counter](mavlink_message_t&) { return counter++ % 10; };
+
+    mavsdk_groundstation.intercept_incoming_messages_async(drop_some);
+    mavsdk_groundstation.intercept_outgoing_messages_async(drop_some);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        auto prom = std::promise<Ftp::Result>();
+        auto fut = prom.get_future();
+        ftp.upload_async(
+            (temp_dir_to_upload / temp_file).string(),
+            "./",
+            [&prom](Ftp::Result result, Ftp::ProgressData progress_data) {
+                if (result != Ftp::Result::Next) {
+                    prom.set_value(result);
+                } else {
+                    LogDebug() << "Upload progress: " << progress_data.bytes_transferred << "/"
+                               << progress_data.total_bytes << " bytes";
+                }
+            });
+
+        auto future_status = fut.wait_for(std::chrono::seconds(60));
+        ASSERT_EQ(future_status, std::future_status::ready);
+        EXPECT_EQ(fut.get(), Ftp::Result::Success);
+
+        const double elapsed_s =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LogInfo() << "Uploaded " << file_size << " bytes in " << elapsed_s << " s, "
+                  << file_size / elapsed_s / 1000.0 << " kB/s";
+
+        EXPECT_TRUE(
+            are_files_identical(temp_dir_to_upload / temp_file, temp_dir_provided / temp_file));
+    }
+
+    mavsdk_groundstation.intercept_incoming_messages_async(nullptr);
+    mavsdk_groundstation.intercept_outgoing_messages_async(nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST(SystemTest, FtpUploadCorruptedOnServer)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, 10000));
+    ASSERT_TRUE(reset_directories(temp_dir_provided));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    // One write arrives with a changed byte, it is still acked and written
+    // to the file. Only the checksum at the end can tell.
+    std::atomic<bool> corrupted{false};
+    auto corrupt_first_write = [&corrupted](mavlink_message_t& message) {
+        if (corrupted || message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+            return true;
+        }
+        mavlink_file_transfer_protocol_t ftp_message;
+        mavlink_msg_file_transfer_protocol_decode(&message, &ftp_message);
+
+        // The opcode is the 4th byte of the payload, the data starts at the 13th.
+        constexpr uint8_t write_file_opcode = 7;
+        if (ftp_message.payload[3] == write_file_opcode) {
+            ftp_message.payload[12] ^= 0xff;
+            mavlink_msg_file_transfer_protocol_encode(
+                message.sysid, message.compid, &message, &ftp_message);
+            corrupted = true;
+        }
+        return true;
+    };
+
+    mavsdk_autopilot.intercept_incoming_messages_async(corrupt_first_write);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    {
+        auto prom = std::promise<Ftp::Result>();
+        auto fut = prom.get_future();
+        ftp.upload_async(
+            (temp_dir_to_upload / temp_file).string(),
+            "",
+            [&prom](Ftp::Result result, Ftp::ProgressData) {
+                if (result != Ftp::Result::Next) {
+                    prom.set_value(result);
+                }
+            });
+
+        auto future_status = fut.wait_for(std::chrono::seconds(10));
+        ASSERT_EQ(future_status, std::future_status::ready);
+        EXPECT_EQ(fut.get(), Ftp::Result::ProtocolError);
+    }
+
+    EXPECT_TRUE(corrupted);
+    EXPECT_FALSE(
+        are_files_identical(temp_dir_to_upload / temp_file, temp_dir_provided / temp_file));
+
+    mavsdk_autopilot.intercept_incoming_messages_async(nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+// Uploads with the existing server setup and returns the first progress, which
+// is what did not need to be written again if something was there already.
+static Ftp::Result upload_resumed(Ftp& ftp, uint32_t& first_progress)
+{
+    first_progress = 0;
+    auto prom = std::promise<Ftp::Result>();
+    auto fut = prom.get_future();
+    ftp.upload_async(
+        (temp_dir_to_upload / temp_file).string(),
+        "",
+        [&prom, &first_progress](Ftp::Result result, Ftp::ProgressData progress_data) {
+            if (result != Ftp::Result::Next) {
+                prom.set_value(result);
+            } else if (first_progress == 0) {
+                first_progress = progress_data.bytes_transferred;
+            }
+        });
+
+    if (fut.wait_for(std::chrono::seconds(20)) != std::future_status::ready) {
+        return Ftp::Result::Timeout;
+    }
+    return fut.get();
+}
+
+TEST(SystemTest, FtpUploadResumeChangedFile)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, 50000));
+    ASSERT_TRUE(reset_directories(temp_dir_provided));
+
+    // A partial upload of which one block got changed in the meantime.
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 40000));
+    {
+        std::fstream partial(
+            temp_dir_provided / temp_file, std::ios::in | std::ios::out | std::ios::binary);
+        partial.seekp(1000);
+        partial.put('x');
+    }
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    uint32_t first_progress;
+    EXPECT_EQ(upload_resumed(ftp, first_progress), Ftp::Result::Success);
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_to_upload / temp_file, temp_dir_provided / temp_file));
+
+    // Only the first 32 KiB block with the changed byte and the missing tail
+    // are written again.
+    EXPECT_EQ(first_progress, 40000u - 32768u);
+    EXPECT_EQ(50000u - first_progress, 32768u + 10000u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST(SystemTest, FtpUploadResumeRemoteFileLonger)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, 50000));
+    ASSERT_TRUE(reset_directories(temp_dir_provided));
+
+    // Same start, but longer than the file to upload, so it has to be
+    // created again instead of only being written to.
+    ASSERT_TRUE(create_temp_file(temp_dir_provided / temp_file, 60000));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    uint32_t first_progress;
+    EXPECT_EQ(upload_resumed(ftp, first_progress), Ftp::Result::Success);
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_to_upload / temp_file, temp_dir_provided / temp_file));
+
+    // Nothing is skipped, the first progress is the first full chunk written.
+    EXPECT_EQ(first_progress, 239u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST(SystemTest, FtpUploadResumeNoRemoteFile)
+{
+    ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, 50000));
+    ASSERT_TRUE(reset_directories(temp_dir_provided));
+
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto ftp_server = FtpServer{mavsdk_autopilot.server_component()};
+    ftp_server.set_root_dir(temp_dir_provided.string());
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto ftp = Ftp{system};
+
+    // Opening the file for writing fails, so it is created instead.
+    uint32_t first_progress;
+    EXPECT_EQ(upload_resumed(ftp, first_progress), Ftp::Result::Success);
+    EXPECT_TRUE(
+        are_files_identical(temp_dir_to_upload / temp_file, temp_dir_provided / temp_file));
+
+    // Nothing is skipped, the first progress is the first full chunk written.
+    EXPECT_EQ(first_progress, 239u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
 TEST(SystemTest, FtpUploadStopAndTryAgain)
 {
     ASSERT_TRUE(create_temp_file(temp_dir_to_upload / temp_file, 1000));
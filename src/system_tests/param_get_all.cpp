@@ -3,6 +3,7 @@
 #include "plugins/param/param.h"
 #include "plugins/param_server/param_server.h"
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
 #include <vector>
 #include <thread>
@@ -183,3 +184,83 @@ TEST(SystemTest, ParamGetAllLossy)
 
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
+
+TEST(SystemTest, ParamGetAllManyLossy)
+{
+    Mavsdk mavsdk_groundstation{Mavsdk::Configuration{Mavsdk::ComponentType::GroundStation}};
+    mavsdk_groundstation.set_timeout_s(reduced_timeout_s);
+
+    Mavsdk mavsdk_autopilot{Mavsdk::Configuration{Mavsdk::ComponentType::Autopilot}};
+    mavsdk_autopilot.set_timeout_s(reduced_timeout_s);
+
+    // Drop every 20th message, so 5% in each direction.
+    std::atomic<unsigned> counter{0};
+    auto drop_some = [&counter](mavlink_message_t&) { return (counter++ % 20) != 0; };
+
+    // Requests are counted before they might be dropped.
+    std::atomic<unsigned> num_list_requests{0};
+    std::atomic<unsigned> num_read_requests{0};
+    mavsdk_groundstation.intercept_incoming_messages_async(drop_some);
+    mavsdk_groundstation.intercept_outgoing_messages_async([&](mavlink_message_t& message) {
+        if (message.msgid == MAVLINK_MSG_ID_PARAM_REQUEST_LIST) {
+            ++num_list_requests;
+        } else if (message.msgid == MAVLINK_MSG_ID_PARAM_REQUEST_READ) {
+            ++num_read_requests;
+        }
+        return drop_some(message);
+    });
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto param_server = ParamServer{mavsdk_autopilot.server_component()};
+
+    auto maybe_system = mavsdk_groundstation.first_autopilot(10.0);
+    ASSERT_TRUE(maybe_system);
+    auto system = maybe_system.value();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    constexpr unsigned num_params = 1000;
+    std::map<std::string, int> test_int_params;
+    for (unsigned i = 0; i < num_params; ++i) {
+        const auto id = std::string("TEST_MANY") + std::to_string(i);
+        test_int_params[id] = static_cast<int>(i);
+        EXPECT_EQ(
+            param_server.provide_param_int(id, static_cast<int>(i)), ParamServer::Result::Success);
+    }
+
+    {
+        auto param_sender = Param{system};
+        param_sender.select_component(1, Param::ProtocolVersion::V1);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto all_params = param_sender.get_all_params();
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        EXPECT_TRUE(all_params.float_params.empty());
+        ASSERT_EQ(all_params.int_params.size(), num_params);
+        std::map<std::string, int> received_int_params;
+        for (const auto& param : all_params.int_params) {
+            received_int_params[param.name] = param.value;
+        }
+        EXPECT_EQ(received_int_params, test_int_params);
+
+        LogInfo() << "Got " << all_params.int_params.size() << " params with 5% loss in "
+                  << duration.count() << " ms, using " << num_list_requests << " list and "
+                  << num_read_requests << " read requests";
+
+        // The list is requested once, plus retries if that request is lost, and
+        // only the params lost on the way are requested one by one. Re-requesting
+        // the whole list, or requesting every param, would exceed this.
+        EXPECT_LE(num_list_requests, 3u);
+        EXPECT_LT(num_read_requests, num_params / 5);
+    }
+
+    mavsdk_groundstation.intercept_incoming_messages_async(nullptr);
+    mavsdk_groundstation.intercept_outgoing_messages_async(nullptr);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}